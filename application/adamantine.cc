@@ -6,6 +6,7 @@
 
 #include "MaterialStates.hh"
 #include "utils.hh"
+#include <dispatch.hh>
 #include <validate_input_database.hh>
 
 #include <boost/program_options.hpp>
@@ -15,6 +16,8 @@
 #include <Kokkos_Core.hpp>
 
 #include <filesystem>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 #ifdef ADAMANTINE_WITH_ADIAK
@@ -137,6 +140,7 @@ int main(int argc, char *argv[])
   initialize_timers(communicator, timers);
   timers[adamantine::main].start();
   bool profiling = false;
+  std::string timer_filename;
   try
   {
     namespace boost_po = boost::program_options;
@@ -208,6 +212,8 @@ int main(int argc, char *argv[])
       // PropertyTreeInput profiling.timer
       if (profiling_database.get("timer", false))
         profiling = true;
+      // PropertyTreeInput profiling.timer_file
+      timer_filename = profiling_database.get("timer_file", "");
 #ifdef ADAMANTINE_WITH_CALIPER
       // PropertyTreeInput profiling.caliper
       auto caliper_optional_string =
@@ -219,6 +225,10 @@ int main(int argc, char *argv[])
 #ifdef ADAMANTINE_WITH_CALIPER
     caliper_manager.start();
 #endif
+    // Only the main timer queries the clock if the timing information is not
+    // output.
+    for (unsigned int i = adamantine::main + 1; i < timers.size(); ++i)
+      timers[i].set_enabled(profiling);
 
     boost::optional<boost::property_tree::ptree &> ensemble_optional_database =
         database.get_child_optional("ensemble");
@@ -236,7 +246,9 @@ int main(int argc, char *argv[])
     int const dim = geometry_database.get<int>("dim");
 
     // Get the polynomial order used in the material properties
-    auto const [p_order, n_material_states] =
+    int p_order = 0;
+    int n_material_states = 0;
+    std::tie(p_order, n_material_states) =
         get_p_order_and_n_material_states(database.get_child("materials"));
     adamantine::ASSERT_THROW(p_order < 5,
                              "Material properties have too many coefficients.");
@@ -254,870 +266,64 @@ int main(int argc, char *argv[])
       adiak::value("MemorySpace", "Host");
 #endif
 
-    if (dim == 2)
+    if (ensemble_calc)
     {
-      if (ensemble_calc)
-      {
-        if (rank == 0)
-          std::cout << "Starting ensemble simulation" << std::endl;
-        if (memory_space == "device")
-        {
-          // TODO: Add device version of run_ensemble and call it here
-          adamantine::ASSERT_THROW(
-              false, "Error: Device version of ensemble simulations not "
-                     "yet implemented.");
-        }
-        else
-        {
-          switch (p_order)
-          {
-          // p_order case
-          case 0:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<2, 0, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<2, 0, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<2, 0, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 1:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<2, 1, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<2, 1, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<2, 1, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 2:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<2, 2, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<2, 2, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<2, 2, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 3:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<2, 3, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<2, 3, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<2, 3, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          default:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<2, 4, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<2, 4, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<2, 4, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-          }
-          }
-        }
-      }
-      else
-      {
-        if (rank == 0)
-          std::cout << "Starting non-ensemble simulation" << std::endl;
-
-        if (memory_space == "device")
-        {
-          switch (p_order)
-          {
-          // p_order case
-          case 0:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 0, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 0, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 0, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 1:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 1, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 1, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 1, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 2:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 2, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 2, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 2, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 3:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 3, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 3, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 3, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          default:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 4, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 4, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 4, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-          }
-          }
-        }
-        else
-        {
-          switch (p_order)
-          {
-          // p_order case
-          case 0:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 0, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 0, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 0, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 1:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 1, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 1, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 1, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 2:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 2, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 2, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 2, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 3:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 3, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 3, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 3, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          default:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<2, 4, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<2, 4, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<2, 4, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-          }
-          }
-        }
-      }
+      if (rank == 0)
+        std::cout << "Starting ensemble simulation" << std::endl;
+      // TODO: Add device version of run_ensemble and call it here
+      adamantine::ASSERT_THROW(memory_space != "device",
+                               "Error: Device version of ensemble simulations "
+                               "not yet implemented.");
     }
-    else
-    {
-      if (ensemble_calc)
-      {
-        if (rank == 0)
-          std::cout << "Starting ensemble simulation" << std::endl;
-
-        if (memory_space == "device")
-        {
-          // TODO: Add device version of run_ensemble and call it here
-          adamantine::ASSERT_THROW(
-              false, "Error: Device version of ensemble simulations not "
-                     "yet implemented.");
-        }
-        else
-        {
-          switch (p_order)
-          {
-          // p_order case
-          case 0:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<3, 0, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<3, 0, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<3, 0, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 1:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<3, 1, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<3, 1, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<3, 1, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 2:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<3, 2, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<3, 2, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<3, 2, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 3:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<3, 3, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<3, 3, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<3, 3, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          default:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run_ensemble<3, 4, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run_ensemble<3, 4, adamantine::SolidLiquid,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-              break;
-            }
-            default:
-            {
-              run_ensemble<3, 4, adamantine::SolidLiquidPowder,
-                           dealii::MemorySpace::Host>(communicator, database,
-                                                      timers);
-            }
-            }
-          }
-          }
-        }
-      }
-      else
-      {
-        if (rank == 0)
-          std::cout << "Starting non-ensemble simulation" << std::endl;
-
-        if (memory_space == "device")
+    else if (rank == 0)
+      std::cout << "Starting non-ensemble simulation" << std::endl;
+
+    // Only the specializations selected at configure time are instantiated.
+    // The dispatch functions throw an exception if the input file requires a
+    // specialization that is not available.
+    adamantine::dispatch_dim(
+        dim,
+        [&](auto dim_constant)
         {
-          switch (p_order)
-          {
-          // p_order case
-          case 0:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 0, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 0, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 0, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 1:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 1, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 1, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 2:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 2, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 2, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 2, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 3:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 3, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 3, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 3, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          default:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 4, adamantine::Solid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 4, adamantine::SolidLiquid, dealii::MemorySpace::Default>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 4, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Default>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          }
-        }
-        else
-        {
-          switch (p_order)
-          {
-          // p_order case
-          case 0:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 0, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 0, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 0, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 1:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 1, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 1, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 1, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 2:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 2, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 2, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 2, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          case 3:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 3, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 3, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 3, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-
-            break;
-          }
-          // p_order case
-          default:
-          {
-            switch (n_material_states)
-            {
-            case 1:
-            {
-              run<3, 4, adamantine::Solid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            case 2:
-            {
-              run<3, 4, adamantine::SolidLiquid, dealii::MemorySpace::Host>(
-                  communicator, database, timers);
-              break;
-            }
-            default:
-            {
-              run<3, 4, adamantine::SolidLiquidPowder,
-                  dealii::MemorySpace::Host>(communicator, database, timers);
-            }
-            }
-          }
-          }
-        }
-      }
-    }
+          adamantine::dispatch_p_order(
+              p_order,
+              [&](auto p_order_constant)
+              {
+                adamantine::dispatch_material_states(
+                    n_material_states,
+                    [&](auto material_states_tag)
+                    {
+                      adamantine::dispatch_memory_space(
+                          memory_space,
+                          [&](auto memory_space_tag)
+                          {
+                            int constexpr dim_value =
+                                decltype(dim_constant)::value;
+                            int constexpr p_order_value =
+                                decltype(p_order_constant)::value;
+                            using MaterialStates =
+                                typename decltype(material_states_tag)::type;
+                            using MemorySpaceType =
+                                typename decltype(memory_space_tag)::type;
+                            if (ensemble_calc)
+                            {
+                              if constexpr (std::is_same_v<
+                                                MemorySpaceType,
+                                                dealii::MemorySpace::Host>)
+                                run_ensemble<dim_value, p_order_value,
+                                             MaterialStates, MemorySpaceType>(
+                                    communicator, database, timers);
+                            }
+                            else
+                            {
+                              run<dim_value, p_order_value, MaterialStates,
+                                  MemorySpaceType>(communicator, database,
+                                                   timers);
+                            }
+                          });
+                    });
+              });
+        });
 
     if (rank == 0)
       std::cout << "Simulation done" << std::endl;
@@ -1160,8 +366,11 @@ int main(int argc, char *argv[])
 
   timers[adamantine::main].stop();
   if (profiling == true)
-    for (auto &timer : timers)
-      timer.print();
+  {
+    adamantine::print_timers(timers);
+    if (!timer_filename.empty())
+      adamantine::write_timers(timers, timer_filename);
+  }
 
 #ifdef ADAMANTINE_WITH_ADIAK
   adiak::fini();
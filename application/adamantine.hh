@@ -16,6 +16,7 @@
 #include <ThermalPhysics.hh>
 #include <ThermalPhysicsInterface.hh>
 #include <Timer.hh>
+#include <dispatch.hh>
 #include <ensemble_management.hh>
 #include <experimental_data_utils.hh>
 #include <material_deposition.hh>
@@ -27,8 +28,8 @@
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/symmetric_tensor.h>
 #include <deal.II/base/types.h>
-#include <deal.II/distributed/cell_data_transfer.templates.h>
-#include <deal.II/distributed/solution_transfer.h>
+#include <deal.II/distributed/grid_refinement.h>
+#include <deal.II/fe/fe_values.h>
 #include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/grid/grid_refinement.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
@@ -89,7 +90,7 @@ void output_pvtu(
       post_processor.template write_output<typename Kokkos::View<
           double **, typename MemorySpaceType::kokkos_space>::array_layout>(
           n_time_step, time, temperature, displacement,
-          mechanical_physics->get_stress_tensor(),
+          mechanical_physics->get_plasticity_state(),
           material_properties.get_state(), material_properties.get_dofs_map(),
           material_properties.get_dof_handler());
     }
@@ -108,7 +109,7 @@ void output_pvtu(
     post_processor.template write_mechanical_output<typename Kokkos::View<
         double **, typename MemorySpaceType::kokkos_space>::array_layout>(
         n_time_step, time, displacement,
-        mechanical_physics->get_stress_tensor(),
+        mechanical_physics->get_plasticity_state(),
         material_properties.get_state(), material_properties.get_dofs_map(),
         material_properties.get_dof_handler());
   }
@@ -157,7 +158,7 @@ void output_pvtu(
       post_processor.template write_output<typename Kokkos::View<
           double **, typename MemorySpaceType::kokkos_space>::array_layout>(
           n_time_step, time, temperature_host, displacement,
-          mechanical_physics->get_stress_tensor(), state_host,
+          mechanical_physics->get_plasticity_state(), state_host,
           material_properties.get_dofs_map(),
           material_properties.get_dof_handler());
     }
@@ -176,39 +177,82 @@ void output_pvtu(
     post_processor.template write_mechanical_output<typename Kokkos::View<
         double **, typename MemorySpaceType::kokkos_space>::array_layout>(
         n_time_step, time, displacement,
-        mechanical_physics->get_stress_tensor(), state_host,
+        mechanical_physics->get_plasticity_state(), state_host,
         material_properties.get_dofs_map(),
         material_properties.get_dof_handler());
   }
   timers[adamantine::output].stop();
 }
 
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void setup_mechanical_dofs(
+    std::unique_ptr<
+        adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>> const
+        &thermal_physics,
+    dealii::LinearAlgebra::distributed::Vector<double, MemorySpaceType> const
+        &temperature,
+    std::unique_ptr<adamantine::MechanicalPhysics<dim, p_order, MaterialStates,
+                                                  MemorySpaceType>> const
+        &mechanical_physics)
+{
+  // The temperature only needs to be copied when it does not live on the host.
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    mechanical_physics->setup_dofs(thermal_physics->get_dof_handler(),
+                                   temperature,
+                                   thermal_physics->get_has_melted_vector());
+  }
+  else
+  {
+    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+        temperature_host(temperature.get_partitioner());
+    temperature_host.import(temperature, dealii::VectorOperation::insert);
+    mechanical_physics->setup_dofs(thermal_physics->get_dof_handler(),
+                                   temperature_host,
+                                   thermal_physics->get_has_melted_vector());
+  }
+}
+
 // inlining this function so we can have in the header
 inline void initialize_timers(MPI_Comm const &communicator,
                               std::vector<adamantine::Timer> &timers)
 {
+  // The sections are nested: the last argument is the index of the enclosing
+  // section.
   timers.push_back(adamantine::Timer(communicator, "Main"));
-  timers.push_back(adamantine::Timer(communicator, "Refinement"));
-  timers.push_back(adamantine::Timer(communicator, "Add Material, Search"));
-  timers.push_back(adamantine::Timer(communicator, "Add Material, Activate"));
-  timers.push_back(
-      adamantine::Timer(communicator, "Data Assimilation, Exp. Data"));
   timers.push_back(
-      adamantine::Timer(communicator, "Data Assimilation, DOF Mapping"));
-  timers.push_back(
-      adamantine::Timer(communicator, "Data Assimilation, Cov. Sparsity"));
-  timers.push_back(
-      adamantine::Timer(communicator, "Data Assimilation, Exp. Cov."));
-  timers.push_back(
-      adamantine::Timer(communicator, "Data Assimilation, Update Ensemble"));
-  timers.push_back(adamantine::Timer(communicator, "Evolve One Time Step"));
+      adamantine::Timer(communicator, "Refinement", adamantine::main));
+  timers.push_back(adamantine::Timer(
+      communicator, "Refinement, Add Material Search", adamantine::refine));
+  timers.push_back(adamantine::Timer(communicator, "Add Material, Search",
+                                     adamantine::add_material_activate));
+  timers.push_back(adamantine::Timer(communicator, "Add Material, Activate",
+                                     adamantine::main));
+  timers.push_back(adamantine::Timer(
+      communicator, "Data Assimilation, Exp. Data", adamantine::main));
+  timers.push_back(adamantine::Timer(
+      communicator, "Data Assimilation, DOF Mapping", adamantine::main));
   timers.push_back(adamantine::Timer(
-      communicator, "Evolve One Time Step: evaluate_thermal_physics"));
+      communicator, "Data Assimilation, Cov. Sparsity", adamantine::main));
   timers.push_back(adamantine::Timer(
-      communicator, "Evolve One Time Step: id_minus_tau_J_inverse"));
+      communicator, "Data Assimilation, Exp. Cov.", adamantine::main));
   timers.push_back(adamantine::Timer(
-      communicator, "Evolve One Time Step: evaluate_material_properties"));
-  timers.push_back(adamantine::Timer(communicator, "Output"));
+      communicator, "Data Assimilation, Update Ensemble", adamantine::main));
+  timers.push_back(adamantine::Timer(communicator, "Evolve One Time Step",
+                                     adamantine::main));
+  timers.push_back(adamantine::Timer(communicator, "evaluate_thermal_physics",
+                                     adamantine::evol_time));
+  timers.push_back(adamantine::Timer(communicator, "id_minus_tau_J_inverse",
+                                     adamantine::evol_time));
+  timers.push_back(adamantine::Timer(
+      communicator, "evaluate_material_properties", adamantine::evol_time));
+  timers.push_back(adamantine::Timer(communicator, "Mechanical Preconditioner",
+                                     adamantine::evol_time));
+  timers.push_back(adamantine::Timer(communicator, "Mechanical Solve",
+                                     adamantine::evol_time));
+  timers.push_back(
+      adamantine::Timer(communicator, "Output", adamantine::main));
 }
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
@@ -260,54 +304,26 @@ initialize_thermal_physics(
     adamantine::MaterialProperty<dim, p_order, MaterialStates, MemorySpaceType>
         &material_properties)
 {
-  switch (fe_degree)
-  {
-  case 1:
-  {
-    return initialize_quadrature<dim, p_order, 1, MaterialStates,
-                                 MemorySpaceType>(
-        quadrature_type, communicator, database, geometry, material_properties);
-  }
-  case 2:
-  {
-    return initialize_quadrature<dim, p_order, 2, MaterialStates,
-                                 MemorySpaceType>(
-        quadrature_type, communicator, database, geometry, material_properties);
-  }
-  case 3:
-  {
-    return initialize_quadrature<dim, p_order, 3, MaterialStates,
-                                 MemorySpaceType>(
-        quadrature_type, communicator, database, geometry, material_properties);
-  }
-  case 4:
-  {
-    return initialize_quadrature<dim, p_order, 4, MaterialStates,
-                                 MemorySpaceType>(
-        quadrature_type, communicator, database, geometry, material_properties);
-  }
-  default:
-  {
-    adamantine::ASSERT_THROW(fe_degree == 5,
-                             "fe_degree should be between 1 and 5.");
-    return initialize_quadrature<dim, p_order, 5, MaterialStates,
-                                 MemorySpaceType>(
-        quadrature_type, communicator, database, geometry, material_properties);
-  }
-  }
+  return adamantine::dispatch_fe_degree(
+      fe_degree,
+      [&](auto fe_degree_constant)
+      {
+        return initialize_quadrature<dim, p_order,
+                                     decltype(fe_degree_constant)::value,
+                                     MaterialStates, MemorySpaceType>(
+            quadrature_type, communicator, database, geometry,
+            material_properties);
+      });
 }
 
 template <int dim, int p_order, typename MaterialStates,
           typename MemorySpaceType>
-void refine_and_transfer(
-    std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
+void execute_mesh_change_pass(
+    std::vector<
+        adamantine::ThermalPhysicsInterface<dim, MemorySpaceType> *> const
         &thermal_physics,
     std::unique_ptr<adamantine::MechanicalPhysics<
-        dim, p_order, MaterialStates, MemorySpaceType>> &mechanical_physics,
-    adamantine::MaterialProperty<dim, p_order, MaterialStates, MemorySpaceType>
-        &material_properties,
-    dealii::DoFHandler<dim> &dof_handler,
-    dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
+        dim, p_order, MaterialStates, MemorySpaceType>> &mechanical_physics)
 {
 #ifdef ADAMANTINE_WITH_CALIPER
   CALI_CXX_MARK_FUNCTION;
@@ -316,101 +332,13 @@ void refine_and_transfer(
   dealii::parallel::distributed::Triangulation<dim> &triangulation =
       dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
           const_cast<dealii::Triangulation<dim> &>(
-              dof_handler.get_triangulation()));
-
-  // Update the material state from the ThermalOperator to MaterialProperty
-  // because, for now, we need to use state from MaterialProperty to perform the
-  // transfer to the refined mesh.
-  thermal_physics->set_state_to_material_properties();
-
-  // Transfer of the solution
-  dealii::parallel::distributed::SolutionTransfer<
-      dim, dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
-      solution_transfer(dof_handler);
-
-  // Transfer material state
-  unsigned int const direction_data_size = 2;
-  unsigned int const phase_history_data_size = 1;
-  unsigned int constexpr n_material_states = MaterialStates::n_material_states;
-  std::vector<std::vector<double>> data_to_transfer;
-  std::vector<double> dummy_cell_data(n_material_states + direction_data_size +
-                                          phase_history_data_size,
-                                      std::numeric_limits<double>::infinity());
-  auto state_host = Kokkos::create_mirror_view_and_copy(
-      Kokkos::HostSpace{}, material_properties.get_state());
-  unsigned int cell_id = 0;
-  unsigned int activated_cell_id = 0;
-  for (auto const &cell : dof_handler.active_cell_iterators())
-  {
-    if (cell->is_locally_owned())
-    {
-      std::vector<double> cell_data(n_material_states + direction_data_size +
-                                    phase_history_data_size);
-      for (unsigned int i = 0; i < n_material_states; ++i)
-        cell_data[i] = state_host(i, cell_id);
-      if (cell->active_fe_index() == 0)
-      {
-        cell_data[n_material_states] =
-            thermal_physics->get_deposition_cos(activated_cell_id);
-        cell_data[n_material_states + 1] =
-            thermal_physics->get_deposition_sin(activated_cell_id);
-
-        if (thermal_physics->get_has_melted(activated_cell_id))
-          cell_data[n_material_states + direction_data_size] = 1.0;
-        else
-          cell_data[n_material_states + direction_data_size] = 0.0;
-
-        ++activated_cell_id;
-      }
-      else
-      {
-        cell_data[n_material_states] = std::numeric_limits<double>::infinity();
-        cell_data[n_material_states + 1] =
-            std::numeric_limits<double>::infinity();
-        cell_data[n_material_states + direction_data_size] =
-            std::numeric_limits<double>::infinity();
-      }
-      data_to_transfer.push_back(cell_data);
-      ++cell_id;
-    }
-    else
-    {
-      data_to_transfer.push_back(dummy_cell_data);
-    }
-  }
-
-  // Prepare the Triangulation and the diffent data transfer objects for
-  // refinement
-  triangulation.prepare_coarsening_and_refinement();
-  // Prepare for refinement of the solution
-  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
-      solution_host;
-  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
-  {
-    // We need to apply the constraints before the mesh transfer
-    thermal_physics->get_affine_constraints().distribute(solution);
-    // We need to update the ghost values before we can do the interpolation on
-    // the new mesh.
-    solution.update_ghost_values();
-    solution_transfer.prepare_for_coarsening_and_refinement(solution);
-  }
-  else
-  {
-    solution_host.reinit(solution.get_partitioner());
-    solution_host.import(solution, dealii::VectorOperation::insert);
-    // We need to apply the constraints before the mesh transfer
-    thermal_physics->get_affine_constraints().distribute(solution_host);
-    // We need to update the ghost values before we can do the interpolation on
-    // the new mesh.
-    solution_host.update_ghost_values();
-    solution_transfer.prepare_for_coarsening_and_refinement(solution_host);
-  }
-
-  dealii::parallel::distributed::CellDataTransfer<
-      dim, dim, std::vector<std::vector<double>>>
-      cell_data_trans(triangulation);
-  cell_data_trans.prepare_for_coarsening_and_refinement(data_to_transfer);
+              thermal_physics[0]->get_dof_handler().get_triangulation()));
 
+  // Attach the data of the physics to the Triangulation. The refinement,
+  // coarsening, and future FE indices have already been set. All the physics
+  // share the Triangulation, so the mesh is changed only once.
+  for (auto physics : thermal_physics)
+    physics->mesh_change_prepare_pass();
   if (mechanical_physics)
   {
     mechanical_physics->prepare_transfer_mpi();
@@ -419,102 +347,13 @@ void refine_and_transfer(
 #ifdef ADAMANTINE_WITH_CALIPER
   CALI_MARK_BEGIN("refine triangulation");
 #endif
-  // Execute the refinement
   triangulation.execute_coarsening_and_refinement();
 #ifdef ADAMANTINE_WITH_CALIPER
   CALI_MARK_END("refine triangulation");
 #endif
 
-  // Update the AffineConstraints and resize the solution
-  thermal_physics->setup_dofs();
-  thermal_physics->initialize_dof_vector(0., solution);
-
-  // Update MaterialProperty DoFHandler and resize the state vectors
-  material_properties.reinit_dofs();
-
-  // Interpolate the solution
-  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
-  {
-    solution_transfer.interpolate(solution);
-  }
-  else
-  {
-    solution_host.reinit(solution.get_partitioner());
-    solution_transfer.interpolate(solution_host);
-    solution.import(solution_host, dealii::VectorOperation::insert);
-  }
-
-  // Unpack the material state and repopulate the material state
-  std::vector<std::vector<double>> transferred_data(
-      triangulation.n_active_cells(),
-      std::vector<double>(n_material_states + direction_data_size +
-                          phase_history_data_size));
-  cell_data_trans.unpack(transferred_data);
-  auto state = material_properties.get_state();
-  state_host = Kokkos::create_mirror_view(state);
-  unsigned int total_cell_id = 0;
-  cell_id = 0;
-  std::vector<double> transferred_cos;
-  std::vector<double> transferred_sin;
-  std::vector<bool> has_melted;
-  for (auto const &cell : dof_handler.active_cell_iterators())
-  {
-    if (cell->is_locally_owned())
-    {
-      for (unsigned int i = 0; i < n_material_states; ++i)
-      {
-        state_host(i, cell_id) = transferred_data[total_cell_id][i];
-      }
-      if (cell->active_fe_index() == 0)
-      {
-        transferred_cos.push_back(
-            transferred_data[total_cell_id][n_material_states]);
-        transferred_sin.push_back(
-            transferred_data[total_cell_id][n_material_states + 1]);
-
-        // Convert from double back to bool
-        if (transferred_data[total_cell_id]
-                            [n_material_states + direction_data_size] > 0.5)
-          has_melted.push_back(true);
-        else
-          has_melted.push_back(false);
-      }
-      ++cell_id;
-    }
-    ++total_cell_id;
-  }
-
-  // Update the deposition cos and sin
-  thermal_physics->set_material_deposition_orientation(transferred_cos,
-                                                       transferred_sin);
-
-  // Update the melted indicator
-  thermal_physics->set_has_melted_vector(has_melted);
-
-  // Copy the data back to material_property
-  Kokkos::deep_copy(state, state_host);
-
-  // Update the material states in the ThermalOperator
-  thermal_physics->get_state_from_material_properties();
-
-#if ADAMANTINE_DEBUG
-  // Check that we are not losing material
-  cell_id = 0;
-  for (auto const &cell : dof_handler.active_cell_iterators())
-  {
-    if (cell->is_locally_owned())
-    {
-      double material_ratio = 0.;
-      for (unsigned int i = 0; i < n_material_states; ++i)
-      {
-        material_ratio += state_host(i, cell_id);
-      }
-      ASSERT(std::abs(material_ratio - 1.) < 1e-14, "Material is lost.");
-      ++cell_id;
-    }
-  }
-#endif
-
+  for (auto physics : thermal_physics)
+    physics->mesh_change_complete_pass();
   if (mechanical_physics)
   {
     mechanical_physics->complete_transfer_mpi();
@@ -588,26 +427,100 @@ compute_cells_to_refine(
   return cells_to_refine;
 }
 
+template <int dim, typename MemorySpaceType>
+void compute_cell_temperature_indicators(
+    dealii::DoFHandler<dim> const &dof_handler,
+    dealii::AffineConstraints<double> const &affine_constraints,
+    dealii::LA::distributed::Vector<double, MemorySpaceType> const &solution,
+    std::vector<double> &cell_max_temperature,
+    std::vector<double> &cell_temperature_jump)
+{
+  // For each locally owned cell, compute the maximum temperature and an
+  // estimate of the temperature variation across the cell, i.e., the product
+  // of the cell diameter and of the largest temperature gradient. Cells
+  // without material (FE_Nothing) are cold and have no gradient.
+  unsigned int const n_active_cells =
+      dof_handler.get_triangulation().n_active_cells();
+  cell_max_temperature.assign(n_active_cells,
+                              -std::numeric_limits<double>::max());
+  cell_temperature_jump.assign(n_active_cells, 0.);
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      temperature(solution.get_partitioner());
+  temperature.import(solution, dealii::VectorOperation::insert);
+  affine_constraints.distribute(temperature);
+  temperature.update_ghost_values();
+
+  auto const &fe = dof_handler.get_fe(0);
+  dealii::FEValues<dim> fe_values(fe, dealii::QGauss<dim>(fe.degree + 1),
+                                  dealii::update_values |
+                                      dealii::update_gradients);
+  unsigned int const n_q_points = fe_values.n_quadrature_points;
+  std::vector<double> values(n_q_points);
+  std::vector<dealii::Tensor<1, dim>> gradients(n_q_points);
+  for (auto const &cell : dof_handler.active_cell_iterators() |
+                              dealii::IteratorFilters::ActiveFEIndexEqualTo(
+                                  0, /* locally owned */ true))
+  {
+    fe_values.reinit(cell);
+    fe_values.get_function_values(temperature, values);
+    fe_values.get_function_gradients(temperature, gradients);
+    double max_temperature = -std::numeric_limits<double>::max();
+    double max_gradient = 0.;
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      max_temperature = std::max(max_temperature, values[q]);
+      max_gradient = std::max(max_gradient, gradients[q].norm());
+    }
+    cell_max_temperature[cell->active_cell_index()] = max_temperature;
+    cell_temperature_jump[cell->active_cell_index()] =
+        cell->diameter() * max_gradient;
+  }
+}
+
+/**
+ * Material deposited during a mesh change. No material is deposited if
+ * activation_start is equal to activation_end.
+ */
+template <int dim>
+struct MaterialActivation
+{
+  std::vector<dealii::BoundingBox<dim>> const &material_deposition_boxes;
+  std::vector<double> const &deposition_cos;
+  std::vector<double> const &deposition_sin;
+  unsigned int activation_start;
+  unsigned int activation_end;
+  /**
+   * Temperature of the new material for each thermal physics.
+   */
+  std::vector<double> new_material_temperatures;
+};
+
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
           typename MemorySpaceType>
 void refine_mesh(
-    std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
+    std::vector<
+        adamantine::ThermalPhysicsInterface<dim, MemorySpaceType> *> const
         &thermal_physics,
     std::unique_ptr<adamantine::MechanicalPhysics<
         dim, p_order, MaterialStates, MemorySpaceType>> &mechanical_physics,
-    adamantine::MaterialProperty<dim, p_order, MaterialStates, MemorySpaceType>
-        &material_properties,
-    dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
+    std::vector<
+        dealii::LA::distributed::Vector<double, MemorySpaceType> *> const
+        &solutions,
     std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> const
         &heat_sources,
     double const time, double const next_refinement_time,
     unsigned int const time_steps_refinement,
-    boost::property_tree::ptree const &refinement_database)
+    boost::property_tree::ptree const &refinement_database,
+    bool const refine, MaterialActivation<dim> const &activation,
+    std::vector<adamantine::Timer> &timers)
 {
 #ifdef ADAMANTINE_WITH_CALIPER
   CALI_CXX_MARK_FUNCTION;
 #endif
-  dealii::DoFHandler<dim> &dof_handler = thermal_physics->get_dof_handler();
+  // All the physics share the mesh and the first one owns the DoFHandler.
+  unsigned int const n_physics = thermal_physics.size();
+  dealii::DoFHandler<dim> &dof_handler = thermal_physics[0]->get_dof_handler();
   dealii::parallel::distributed::Triangulation<dim> &triangulation =
       dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
           const_cast<dealii::Triangulation<dim> &>(
@@ -616,47 +529,247 @@ void refine_mesh(
   // PropertyTreeInput refinement.n_refinements
   unsigned int const n_refinements =
       refinement_database.get("n_refinements", 2);
+  // PropertyTreeInput refinement.coarsen_after_beam
+  const bool coarsen_after_beam =
+      refinement_database.get<bool>("coarsen_after_beam", false);
+  // PropertyTreeInput refinement.coarsening_temperature
+  double const coarsening_temperature = refinement_database.get(
+      "coarsening_temperature", std::numeric_limits<double>::max());
+  // PropertyTreeInput refinement.coarsening_temperature_jump
+  double const coarsening_temperature_jump = refinement_database.get(
+      "coarsening_temperature_jump", std::numeric_limits<double>::max());
+  // PropertyTreeInput refinement.max_n_active_cells
+  dealii::types::global_cell_index const max_n_active_cells =
+      refinement_database.get<dealii::types::global_cell_index>(
+          "max_n_active_cells", 0);
+  bool const use_temperature_indicators =
+      (coarsening_temperature < std::numeric_limits<double>::max()) ||
+      (coarsening_temperature_jump < std::numeric_limits<double>::max()) ||
+      (max_n_active_cells > 0);
+
+  // The refinement, the coarsening, and the activation of the cells are done
+  // in a single mesh change: the degrees of freedom and the operators are
+  // rebuilt only once at the end. p4est refines a cell at most once per call to
+  // execute_coarsening_and_refinement(), so we still need one pass per level of
+  // refinement but the passes only move the data attached to the cells. The
+  // cells are activated during the last pass.
+  bool const add_material =
+      activation.activation_start < activation.activation_end;
+  unsigned int const n_passes =
+      std::max(refine ? n_refinements : 0u, add_material ? 1u : 0u);
+  if (n_passes == 0)
+    return;
 
-  for (unsigned int i = 0; i < n_refinements; ++i)
+  // The temperature indicators need the degrees of freedom, they are computed
+  // on the current mesh and they are only used during the first pass. A cell
+  // can only be coarsened if it can be coarsened for all the physics.
+  std::vector<double> cell_max_temperature;
+  std::vector<double> cell_temperature_jump;
+  if (refine && coarsen_after_beam && use_temperature_indicators)
   {
-    // Compute the cells to be refined.
-    auto cells_to_refine =
-        compute_cells_to_refine(triangulation, time, next_refinement_time,
-                                time_steps_refinement, heat_sources);
-
-    // PropertyTreeInput refinement.coarsen_after_beam
-    const bool coarsen_after_beam =
-        refinement_database.get<bool>("coarsen_after_beam", false);
-
-    // If coarsening is allowed, set the coarsening flag everywhere
-    if (coarsen_after_beam)
+    std::vector<double> physics_max_temperature;
+    std::vector<double> physics_temperature_jump;
+    for (unsigned int k = 0; k < n_physics; ++k)
     {
-      for (auto cell : dealii::filter_iterators(
-               triangulation.active_cell_iterators(),
-               dealii::IteratorFilters::LocallyOwnedCell()))
+      compute_cell_temperature_indicators(
+          dof_handler, thermal_physics[k]->get_affine_constraints(),
+          *solutions[k], physics_max_temperature, physics_temperature_jump);
+      if (k == 0)
       {
-        if (cell->level() > 0)
-          cell->set_coarsen_flag();
+        cell_max_temperature.swap(physics_max_temperature);
+        cell_temperature_jump.swap(physics_temperature_jump);
+      }
+      else
+      {
+        for (unsigned int c = 0; c < cell_max_temperature.size(); ++c)
+        {
+          cell_max_temperature[c] =
+              std::max(cell_max_temperature[c], physics_max_temperature[c]);
+          cell_temperature_jump[c] =
+              std::max(cell_temperature_jump[c], physics_temperature_jump[c]);
+        }
       }
     }
+  }
 
-    // Flag the cells for refinement.
-    for (auto &cell : cells_to_refine)
+  // The owner of the DoFHandler clears the MatrixFree object shared by all
+  // the physics, so it needs to start the mesh change last.
+  for (unsigned int k = n_physics; k > 0; --k)
+    thermal_physics[k - 1]->mesh_change_start(*solutions[k - 1]);
+  for (unsigned int i = 0; i < n_passes; ++i)
+  {
+    if (refine)
     {
-      if (coarsen_after_beam)
-        cell->clear_coarsen_flag();
+      // Compute the cells to be refined.
+      auto cells_to_refine =
+          compute_cells_to_refine(triangulation, time, next_refinement_time,
+                                  time_steps_refinement, heat_sources);
+
+      // If coarsening is allowed, set the coarsening flag on the cells that are
+      // not on the path of the beams. When temperature criteria are given,
+      // only cells that have cooled down and whose temperature is smooth are
+      // coarsened, so that the fine cells in the wake of the melt pool are
+      // kept.
+      if (coarsen_after_beam && ((i == 0) || !use_temperature_indicators))
+      {
+        for (auto cell : dealii::filter_iterators(
+                 triangulation.active_cell_iterators(),
+                 dealii::IteratorFilters::LocallyOwnedCell()))
+        {
+          if (cell->level() > 0)
+          {
+            if (use_temperature_indicators)
+            {
+              unsigned int const cell_index = cell->active_cell_index();
+              if ((cell_max_temperature[cell_index] < coarsening_temperature) &&
+                  (cell_temperature_jump[cell_index] <
+                   coarsening_temperature_jump))
+                cell->set_coarsen_flag();
+            }
+            else
+            {
+              cell->set_coarsen_flag();
+            }
+          }
+        }
 
-      if (cell->level() < static_cast<int>(n_refinements))
-        cell->set_refine_flag();
+        // If the mesh is larger than the target size, coarsen the additional
+        // cells with the smallest temperature variation. Cells on the path of
+        // the beams, cells on the coarsest level, cells that are hotter than
+        // the coarsening temperature, and cells without material are never
+        // selected.
+        dealii::types::global_cell_index const n_global_active_cells =
+            triangulation.n_global_active_cells();
+        if ((max_n_active_cells > 0) &&
+            (n_global_active_cells > max_n_active_cells))
+        {
+          dealii::Vector<float> criteria(triangulation.n_active_cells());
+          for (auto cell : dealii::filter_iterators(
+                   dof_handler.active_cell_iterators(),
+                   dealii::IteratorFilters::LocallyOwnedCell()))
+          {
+            unsigned int const cell_index = cell->active_cell_index();
+            bool const keep =
+                (cell->level() == 0) || (cell->active_fe_index() != 0) ||
+                (cell_max_temperature[cell_index] >= coarsening_temperature);
+            criteria[cell_index] = keep ? std::numeric_limits<float>::max()
+                                        : cell_temperature_jump[cell_index];
+          }
+          for (auto &cell : cells_to_refine)
+            criteria[cell->active_cell_index()] =
+                std::numeric_limits<float>::max();
+
+          // Coarsening 2^dim children removes 2^dim - 1 cells.
+          double const n_children = std::pow(2., dim);
+          double const n_extra_cells =
+              static_cast<double>(n_global_active_cells - max_n_active_cells);
+          double const coarsen_fraction =
+              std::min(1., n_extra_cells /
+                               static_cast<double>(n_global_active_cells) *
+                               n_children / (n_children - 1.));
+          dealii::parallel::distributed::GridRefinement::
+              refine_and_coarsen_fixed_number(triangulation, criteria, 0.,
+                                              coarsen_fraction);
+          // Only the coarsening flags are wanted, the refinement flags are set
+          // using the path of the beams below. When the fraction is larger than
+          // the number of cells that can be coarsened, the threshold reaches
+          // the largest criterion, so the coarsening flags of the hot cells
+          // are cleared.
+          for (auto cell : dealii::filter_iterators(
+                   triangulation.active_cell_iterators(),
+                   dealii::IteratorFilters::LocallyOwnedCell()))
+          {
+            cell->clear_refine_flag();
+            if (cell_max_temperature[cell->active_cell_index()] >=
+                coarsening_temperature)
+              cell->clear_coarsen_flag();
+          }
+        }
+      }
+
+      // Flag the cells for refinement.
+      for (auto &cell : cells_to_refine)
+      {
+        if (coarsen_after_beam)
+          cell->clear_coarsen_flag();
+
+        if (cell->level() < static_cast<int>(n_refinements))
+          cell->set_refine_flag();
+      }
+    }
+
+    if (add_material && (i == n_passes - 1))
+    {
+      // Compute the elements to activate.
+      // TODO Right now, we compute the list of cells that get activated for
+      // the entire material deposition. We should restrict the list to the
+      // cells that are activated between activation_start and activation_end.
+      // The search is timed under the section of the mesh change.
+      adamantine::Timer &search_timer =
+          refine ? timers[adamantine::refine_add_material_search]
+                 : timers[adamantine::add_material_search];
+      search_timer.start();
+      auto elements_to_activate = adamantine::get_elements_to_activate(
+          dof_handler, activation.material_deposition_boxes);
+      search_timer.stop();
+
+      for (auto physics : thermal_physics)
+      {
+        // For now assume that all deposited material has never been melted
+        // (may or may not be reasonable)
+        std::vector<bool> has_melted(activation.deposition_cos.size(), false);
+
+        physics->mesh_change_activate(
+            elements_to_activate, activation.deposition_cos,
+            activation.deposition_sin, has_melted, activation.activation_start,
+            activation.activation_end);
+      }
     }
 
-    // Execute the refinement and transfer the solution onto the new mesh.
-    refine_and_transfer(thermal_physics, mechanical_physics,
-                        material_properties, dof_handler, solution);
+    // Execute the pass and move the data onto the new mesh.
+    execute_mesh_change_pass(thermal_physics, mechanical_physics);
   }
 
-  // Recompute the inverse of the mass matrix
-  thermal_physics->compute_inverse_mass_matrix();
+  // Rebuild the degrees of freedom and the operators. The owner of the
+  // DoFHandler needs to be rebuilt first.
+  for (unsigned int k = 0; k < n_physics; ++k)
+    thermal_physics[k]->mesh_change_end(
+        activation.new_material_temperatures[k], *solutions[k]);
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void refine_mesh(
+    std::vector<
+        adamantine::ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+        &thermal_physics,
+    std::unique_ptr<adamantine::MechanicalPhysics<
+        dim, p_order, MaterialStates, MemorySpaceType>> &mechanical_physics,
+    std::vector<
+        dealii::LA::distributed::Vector<double, MemorySpaceType> *> const
+        &solutions,
+    std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> const
+        &heat_sources,
+    double const time, double const next_refinement_time,
+    unsigned int const time_steps_refinement,
+    boost::property_tree::ptree const &refinement_database,
+    bool const refine, MaterialActivation<dim> const &activation,
+    std::vector<adamantine::Timer> &timers)
+{
+  if (thermal_physics.empty())
+    return;
+
+  adamantine::dispatch_fe_degree(
+      thermal_physics[0]->get_fe_degree(),
+      [&](auto fe_degree_constant)
+      {
+        refine_mesh<dim, p_order, decltype(fe_degree_constant)::value,
+                    MaterialStates>(thermal_physics, mechanical_physics,
+                                    solutions, heat_sources, time,
+                                    next_refinement_time, time_steps_refinement,
+                                    refinement_database, refine, activation,
+                                    timers);
+      });
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -666,65 +779,22 @@ void refine_mesh(
         &thermal_physics,
     std::unique_ptr<adamantine::MechanicalPhysics<
         dim, p_order, MaterialStates, MemorySpaceType>> &mechanical_physics,
-    adamantine::MaterialProperty<dim, p_order, MaterialStates, MemorySpaceType>
-        &material_properties,
     dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
     std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> const
         &heat_sources,
     double const time, double const next_refinement_time,
     unsigned int const time_steps_refinement,
-    boost::property_tree::ptree const &refinement_database)
+    boost::property_tree::ptree const &refinement_database,
+    bool const refine, MaterialActivation<dim> const &activation,
+    std::vector<adamantine::Timer> &timers)
 {
   if (!thermal_physics)
     return;
 
-  switch (thermal_physics->get_fe_degree())
-  {
-  case 1:
-  {
-    refine_mesh<dim, p_order, 1, MaterialStates>(
-        thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
-    break;
-  }
-  case 2:
-  {
-    refine_mesh<dim, p_order, 2, MaterialStates>(
-        thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
-    break;
-  }
-  case 3:
-  {
-    refine_mesh<dim, p_order, 3, MaterialStates>(
-        thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
-    break;
-  }
-  case 4:
-  {
-    refine_mesh<dim, p_order, 4, MaterialStates>(
-        thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
-    break;
-  }
-  case 5:
-  {
-    refine_mesh<dim, p_order, 5, MaterialStates>(
-        thermal_physics, mechanical_physics, material_properties, solution,
-        heat_sources, time, next_refinement_time, time_steps_refinement,
-        refinement_database);
-    break;
-  }
-  default:
-  {
-    adamantine::ASSERT_THROW(false, "fe_degree should be between 1 and 5.");
-  }
-  }
+  refine_mesh<dim, p_order, MaterialStates, MemorySpaceType>(
+      {thermal_physics.get()}, mechanical_physics, {&solution}, heat_sources,
+      time, next_refinement_time, time_steps_refinement, refinement_database,
+      refine, activation, timers);
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -823,10 +893,17 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
     // PropertyTreeInput discretization.mechanical.fe_degree
     unsigned int const fe_degree =
         discretization_database.get<unsigned int>("mechanical.fe_degree");
+    // PropertyTreeInput discretization.mechanical.matrix_free
+    bool const matrix_free =
+        discretization_database.get("mechanical.matrix_free", false);
+    // PropertyTreeInput discretization.mechanical.preconditioner
+    std::string const preconditioner =
+        discretization_database.get<std::string>("mechanical.preconditioner",
+                                                 "");
     mechanical_physics = std::make_unique<adamantine::MechanicalPhysics<
         dim, p_order, MaterialStates, MemorySpaceType>>(
         communicator, fe_degree, geometry, material_properties,
-        material_reference_temps);
+        material_reference_temps, matrix_free, preconditioner);
     post_processor_database.put("mechanical_output", true);
   }
 
@@ -912,20 +989,20 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
         "Mechanical simulation cannot be restarted from a file");
     if (use_thermal_physics)
     {
+      // The mechanical simulation uses the FE indices of the thermal
+      // simulation to find the cells with material.
+      adamantine::ASSERT_THROW(
+          !thermal_physics->use_quiet_elements(),
+          "Quiet elements are not supported by the mechanical simulation");
       // Thermo-mechanical simulation
-      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
-          temperature_host(temperature.get_partitioner());
-      temperature_host.import(temperature, dealii::VectorOperation::insert);
-      mechanical_physics->setup_dofs(thermal_physics->get_dof_handler(),
-                                     temperature_host,
-                                     thermal_physics->get_has_melted_vector());
+      setup_mechanical_dofs(thermal_physics, temperature, mechanical_physics);
     }
     else
     {
       // Mechanical only simulation
       mechanical_physics->setup_dofs();
     }
-    displacement = mechanical_physics->solve();
+    displacement = mechanical_physics->solve(&timers);
   }
 
   unsigned int progress = 0;
@@ -996,30 +1073,13 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
     if ((time + time_step) > duration)
       time_step = duration - time;
 
-    // Refine the mesh the first time we get in the loop and after
-    // time_steps_refinement time steps.
-    if (((n_time_step == 1) || ((n_time_step % time_steps_refinement) == 0)) &&
-        use_thermal_physics)
-    {
-      timers[adamantine::refine].start();
-      double next_refinement_time = time + time_steps_refinement * time_step;
-      refine_mesh(thermal_physics, mechanical_physics, material_properties,
-                  temperature, heat_sources, time, next_refinement_time,
-                  time_steps_refinement, refinement_database);
-      timers[adamantine::refine].stop();
-      if ((rank == 0) && (verbose_output == true))
-      {
-        std::cout << "n_time_step: " << n_time_step << " time: " << time
-                  << " n_dofs after mesh refinement: "
-                  << thermal_physics->get_dof_handler().n_dofs() << std::endl;
-      }
-    }
-
-    // Add material if necessary.
+    // Compute the material that needs to be added.
     // We use an epsilon to get the "expected" behavior when the deposition
     // time and the time match should match exactly but don't because of
     // floating point accuracy.
     timers[adamantine::add_material_activate].start();
+    unsigned int activation_start = 0;
+    unsigned int activation_end = 0;
     if (time > activation_time_end)
     {
       // If we use scan_path_for_duration, we may need to read the scan path
@@ -1069,81 +1129,91 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
 
       double const eps = time_step / 1e10;
 
-      auto activation_start =
+      activation_start =
           std::lower_bound(deposition_times.begin(), deposition_times.end(),
                            time - eps) -
           deposition_times.begin();
       activation_time_end =
           std::min(time + std::max(activation_time, time_step), duration) - eps;
-      auto activation_end =
+      activation_end =
           std::lower_bound(deposition_times.begin(), deposition_times.end(),
                            activation_time_end) -
           deposition_times.begin();
-      if (activation_start < activation_end)
-      {
-        if (use_thermal_physics)
-        {
-#ifdef ADAMANTINE_WITH_CALIPER
-          CALI_MARK_BEGIN("add material");
-#endif
-          // Compute the elements to activate.
-          // TODO Right now, we compute the list of cells that get activated for
-          // the entire material deposition. We should restrict the list to the
-          // cells that are activated between activation_start and
-          // activation_end.
-          timers[adamantine::add_material_search].start();
-          auto elements_to_activate = adamantine::get_elements_to_activate(
-              thermal_physics->get_dof_handler(), material_deposition_boxes);
-          timers[adamantine::add_material_search].stop();
-
-          // For now assume that all deposited material has never been melted
-          // (may or may not be reasonable)
-          std::vector<bool> has_melted(deposition_cos.size(), false);
-
-          thermal_physics->add_material_start(
-              elements_to_activate, deposition_cos, deposition_sin, has_melted,
-              activation_start, activation_end, temperature);
-
-          if (use_mechanical_physics)
-          {
-            mechanical_physics->prepare_transfer_mpi();
-          }
+    }
+    timers[adamantine::add_material_activate].stop();
+    bool const add_material =
+        use_thermal_physics && (activation_start < activation_end);
+    bool const quiet_elements =
+        use_thermal_physics && thermal_physics->use_quiet_elements();
 
+    // Refine the mesh the first time we get in the loop and after
+    // time_steps_refinement time steps. Unless quiet elements are used, the
+    // material is added during the same mesh change.
+    bool const refinement_step =
+        ((n_time_step == 1) || ((n_time_step % time_steps_refinement) == 0)) &&
+        use_thermal_physics;
+    bool const mesh_change_add_material = add_material && !quiet_elements;
+    if (refinement_step || mesh_change_add_material)
+    {
+      adamantine::Timer &mesh_change_timer =
+          refinement_step ? timers[adamantine::refine]
+                          : timers[adamantine::add_material_activate];
+      mesh_change_timer.start();
 #ifdef ADAMANTINE_WITH_CALIPER
-          CALI_MARK_BEGIN("refine triangulation");
-#endif
-          dealii::parallel::distributed::Triangulation<dim> &triangulation =
-              dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
-                  const_cast<dealii::Triangulation<dim> &>(
-                      thermal_physics->get_dof_handler().get_triangulation()));
-          triangulation.execute_coarsening_and_refinement();
-#ifdef ADAMANTINE_WITH_CALIPER
-          CALI_MARK_END("refine triangulation");
+      if (mesh_change_add_material)
+        CALI_MARK_BEGIN("add material");
 #endif
-
-          thermal_physics->add_material_end(new_material_temperature,
-                                            temperature);
-
-          if (use_mechanical_physics)
-          {
-            mechanical_physics->complete_transfer_mpi();
-          }
-
+      double next_refinement_time = time + time_steps_refinement * time_step;
+      MaterialActivation<dim> const activation{
+          material_deposition_boxes, deposition_cos, deposition_sin,
+          activation_start,
+          mesh_change_add_material ? activation_end : activation_start,
+          {new_material_temperature}};
+      refine_mesh(thermal_physics, mechanical_physics, temperature,
+                  heat_sources, time, next_refinement_time,
+                  time_steps_refinement, refinement_database, refinement_step,
+                  activation, timers);
 #ifdef ADAMANTINE_WITH_CALIPER
-          CALI_MARK_END("add material");
+      if (mesh_change_add_material)
+        CALI_MARK_END("add material");
 #endif
-        }
-      }
-
-      if ((rank == 0) && (verbose_output == true) &&
-          (activation_end - activation_start > 0) && use_thermal_physics)
+      mesh_change_timer.stop();
+      mesh_change_timer.record_load(
+          thermal_physics->get_locally_owned_weight());
+      if ((rank == 0) && (verbose_output == true))
       {
         std::cout << "n_time_step: " << n_time_step << " time: " << time
-                  << " n_dofs after cell activation: "
+                  << " n_dofs after mesh change: "
                   << thermal_physics->get_dof_handler().n_dofs() << std::endl;
       }
     }
-    timers[adamantine::add_material_activate].stop();
+
+    // With quiet elements, the cells are already meshed and only the
+    // coefficients of the activated cells need to be updated.
+    if (add_material && quiet_elements)
+    {
+      timers[adamantine::add_material_activate].start();
+#ifdef ADAMANTINE_WITH_CALIPER
+      CALI_MARK_BEGIN("add material");
+#endif
+      // Compute the elements to activate.
+      timers[adamantine::add_material_search].start();
+      auto elements_to_activate = adamantine::get_elements_to_activate(
+          thermal_physics->get_quiet_cell_iterators(),
+          material_deposition_boxes);
+      timers[adamantine::add_material_search].stop();
+
+      thermal_physics->activate_quiet_cells(
+          elements_to_activate, deposition_cos, deposition_sin,
+          activation_start, activation_end, new_material_temperature,
+          temperature);
+#ifdef ADAMANTINE_WITH_CALIPER
+      CALI_MARK_END("add material");
+#endif
+      timers[adamantine::add_material_activate].stop();
+      timers[adamantine::add_material_activate].record_load(
+          thermal_physics->get_locally_owned_weight());
+    }
 
     // If thermomechanics are being solved, mark cells that are above the
     // solidus as cells that should have their reference temperature reset.
@@ -1175,18 +1245,14 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
         {
           // Update the material state
           thermal_physics->set_state_to_material_properties();
-          dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
-              temperature_host(temperature.get_partitioner());
-          temperature_host.import(temperature, dealii::VectorOperation::insert);
-          mechanical_physics->setup_dofs(
-              thermal_physics->get_dof_handler(), temperature_host,
-              thermal_physics->get_has_melted_vector());
+          setup_mechanical_dofs(thermal_physics, temperature,
+                                mechanical_physics);
         }
         else
         {
           mechanical_physics->setup_dofs();
         }
-        displacement = mechanical_physics->solve();
+        displacement = mechanical_physics->solve(&timers);
       }
     }
 
@@ -1248,6 +1314,19 @@ run(MPI_Comm const &communicator, boost::property_tree::ptree const &database,
 
   post_processor->write_pvd();
 
+  // PropertyTreeInput discretization.thermal.mixed_precision_validation
+  if (use_thermal_physics &&
+      discretization_database.get("thermal.mixed_precision_validation", false))
+  {
+    double const difference = thermal_physics->get_mixed_precision_difference();
+    if (rank == 0)
+    {
+      std::cout << "Largest relative difference between the single and the "
+                   "double precision thermal operators: "
+                << difference << std::endl;
+    }
+  }
+
   // This is only used for integration test
   if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
   {
@@ -1396,9 +1475,11 @@ run_ensemble(MPI_Comm const &global_communicator,
                             first_local_member, my_color);
 
   // ------ Set up the ensemble members -----
-  // There might be a more efficient way to share some of these objects
-  // between ensemble members. For now, we'll do the simpler approach of
-  // duplicating everything.
+  // The ensemble members on a processor share the mesh, the DoFHandler, the
+  // constraints, and the MatrixFree object of the first local member. Each
+  // member owns its material state, its heat sources, and its solution.
+  adamantine::Geometry<dim> geometry(local_communicator, geometry_database,
+                                     units_optional_database);
 
   // Create a new property tree database for each ensemble member
   std::vector<boost::property_tree::ptree> database_ensemble =
@@ -1413,8 +1494,6 @@ run_ensemble(MPI_Comm const &global_communicator,
   std::vector<std::vector<std::shared_ptr<adamantine::HeatSource<dim>>>>
       heat_sources_ensemble(local_ensemble_size);
 
-  std::vector<std::unique_ptr<adamantine::Geometry<dim>>> geometry_ensemble;
-
   std::vector<std::unique_ptr<adamantine::MaterialProperty<
       dim, p_order, MaterialStates, MemorySpaceType>>>
       material_properties_ensemble;
@@ -1540,19 +1619,19 @@ run_ensemble(MPI_Comm const &global_communicator,
 
     solution_augmented_ensemble[member].collect_sizes();
 
-    geometry_ensemble.push_back(std::make_unique<adamantine::Geometry<dim>>(
-        local_communicator, geometry_database, units_optional_database));
-
     material_properties_ensemble.push_back(
         std::make_unique<adamantine::MaterialProperty<
             dim, p_order, MaterialStates, MemorySpaceType>>(
-            local_communicator, geometry_ensemble.back()->get_triangulation(),
+            local_communicator, geometry.get_triangulation(),
             material_database));
 
     thermal_physics_ensemble[member] = initialize_thermal_physics<dim>(
         fe_degree, quadrature_type, local_communicator,
-        database_ensemble[member], *geometry_ensemble[member],
+        database_ensemble[member], geometry,
         *material_properties_ensemble[member]);
+    if (member > 0)
+      thermal_physics_ensemble[member]->share_discretization(
+          *thermal_physics_ensemble[0]);
     heat_sources_ensemble[member] =
         thermal_physics_ensemble[member]->get_heat_sources();
 
@@ -1563,18 +1642,36 @@ run_ensemble(MPI_Comm const &global_communicator,
           database_ensemble[member].get("materials.initial_temperature", 300.),
           solution_augmented_ensemble[member].block(base_state));
     }
-    else
-    {
+    solution_augmented_ensemble[member].collect_sizes();
+  }
+
+  // The members are evolved, refined, and checkpointed together.
+  std::vector<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType> *>
+      members(local_ensemble_size);
+  std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+      member_solutions(local_ensemble_size);
+  for (unsigned int member = 0; member < local_ensemble_size; ++member)
+  {
+    members[member] = thermal_physics_ensemble[member].get();
+    member_solutions[member] =
+        &solution_augmented_ensemble[member].block(base_state);
+  }
+
+  if (restart == true)
+  {
 #ifdef ADAMANTINE_WITH_CALIPER
-      CALI_MARK_BEGIN("restart from file");
+    CALI_MARK_BEGIN("restart from file");
 #endif
-      thermal_physics_ensemble[member]->load_checkpoint(
-          restart_filename + '_' + std::to_string(member),
-          solution_augmented_ensemble[member].block(base_state));
+    thermal_physics_ensemble[0]->load_ensemble_checkpoint(
+        restart_filename + '_' + std::to_string(first_local_member), members,
+        member_solutions);
 #ifdef ADAMANTINE_WITH_CALIPER
-      CALI_MARK_END("restart from file");
+    CALI_MARK_END("restart from file");
 #endif
-    }
+  }
+
+  for (unsigned int member = 0; member < local_ensemble_size; ++member)
+  {
     solution_augmented_ensemble[member].collect_sizes();
 
     // For now we only output temperature
@@ -1729,28 +1826,13 @@ run_ensemble(MPI_Comm const &global_communicator,
       post_processor_database.get("time_steps_between_output", 1);
 
   // ----- Deposit material -----
-  // For now assume that all ensemble members share the same geometry (they
-  // have independent adamantine::Geometry objects, but all are constructed
-  // from identical parameters), base new additions on the 0th ensemble member
-  // since all the sources use the same scan path.
+  // All ensemble members share the same geometry, base new additions on the
+  // 0th ensemble member since all the sources use the same scan path.
   auto [material_deposition_boxes, deposition_times, deposition_cos,
         deposition_sin] =
       adamantine::create_material_deposition_boxes<dim>(
           geometry_database, heat_sources_ensemble[0]);
 
-  timers[adamantine::add_material_search].start();
-  std::vector<std::vector<
-      std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>>>
-      elements_to_activate_ensemble(local_ensemble_size);
-  for (unsigned int member = 0; member < local_ensemble_size; ++member)
-  {
-    elements_to_activate_ensemble[member] =
-        adamantine::get_elements_to_activate(
-            thermal_physics_ensemble[member]->get_dof_handler(),
-            material_deposition_boxes);
-  }
-  timers[adamantine::add_material_search].stop();
-
   // ----- Compute bounding heat sources -----
   // When using AMR, we refine the cells that the heat sources intersect. Since
   // each ensemble members can have slightly different sources, we create a new
@@ -1774,43 +1856,13 @@ run_ensemble(MPI_Comm const &global_communicator,
     if ((time + time_step) > duration)
       time_step = duration - time;
 
-    // ----- Refine the mesh if necessary -----
-    // Refine the mesh the first time we get in the loop and after
-    // time_steps_refinement time steps.
-    if ((n_time_step == 1) || ((n_time_step % time_steps_refinement) == 0))
-    {
-      timers[adamantine::refine].start();
-      double const next_refinement_time =
-          time + time_steps_refinement * time_step;
-
-      for (unsigned int member = 0; member < local_ensemble_size; ++member)
-      {
-        // FIXME
-        std::unique_ptr<adamantine::MechanicalPhysics<
-            dim, p_order, MaterialStates, MemorySpaceType>>
-            dummy;
-        refine_mesh(thermal_physics_ensemble[member], dummy,
-                    *material_properties_ensemble[member],
-                    solution_augmented_ensemble[member].block(base_state),
-                    bounding_heat_sources, time, next_refinement_time,
-                    time_steps_refinement, refinement_database);
-        solution_augmented_ensemble[member].collect_sizes();
-      }
-
-      timers[adamantine::refine].stop();
-      if ((global_rank == 0) && (verbose_output == true))
-      {
-        std::cout << "n_time_step: " << n_time_step << " time: " << time
-                  << " n_dofs: "
-                  << thermal_physics_ensemble[0]->get_dof_handler().n_dofs()
-                  << std::endl;
-      }
-    }
-
+    // ----- Compute the material that needs to be added -----
     // We use an epsilon to get the "expected" behavior when the deposition
     // time and the time match should match exactly but don't because of
     // floating point accuracy.
     timers[adamantine::add_material_activate].start();
+    unsigned int activation_start = 0;
+    unsigned int activation_end = 0;
     if (time > activation_time_end)
     {
       // If we use scan_path_for_duration, we may need to read the scan path
@@ -1869,87 +1921,110 @@ run_ensemble(MPI_Comm const &global_communicator,
       }
 
       double const eps = time_step / 1e12;
-      auto activation_start =
+      activation_start =
           std::lower_bound(deposition_times.begin(), deposition_times.end(),
                            time - eps) -
           deposition_times.begin();
       activation_time_end =
           std::min(time + std::max(activation_time, time_step), duration) - eps;
-      auto activation_end =
+      activation_end =
           std::lower_bound(deposition_times.begin(), deposition_times.end(),
                            activation_time_end) -
           deposition_times.begin();
-      if (activation_start < activation_end)
-      {
-#ifdef ADAMANTINE_WITH_CALIPER
-        CALI_MARK_BEGIN("add material");
-#endif
-        for (unsigned int member = 0; member < local_ensemble_size; ++member)
-        {
-          // Compute the elements to activate.
-          // TODO Right now, we compute the list of cells that get activated
-          // for the entire material deposition. We should restrict the list
-          // to the cells that are activated between activation_start and
-          // activation_end.
-          auto elements_to_activate = adamantine::get_elements_to_activate(
-              thermal_physics_ensemble[member]->get_dof_handler(),
-              material_deposition_boxes);
-          // For now assume that all deposited material has never been
-          // melted (may or may not be reasonable)
-          std::vector<bool> has_melted(deposition_cos.size(), false);
-
-          thermal_physics_ensemble[member]->add_material_start(
-              elements_to_activate, deposition_cos, deposition_sin, has_melted,
-              activation_start, activation_end,
-              solution_augmented_ensemble[member].block(base_state));
-
-#ifdef ADAMANTINE_WITH_CALIPER
-          CALI_MARK_BEGIN("refine triangulation");
-#endif
-          dealii::DoFHandler<dim> &dof_handler =
-              thermal_physics_ensemble[member]->get_dof_handler();
-          dealii::parallel::distributed::Triangulation<dim> &triangulation =
-              dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
-                  const_cast<dealii::Triangulation<dim> &>(
-                      dof_handler.get_triangulation()));
-
-          triangulation.execute_coarsening_and_refinement();
-#ifdef ADAMANTINE_WITH_CALIPER
-          CALI_MARK_END("refine triangulation");
-#endif
+    }
+    timers[adamantine::add_material_activate].stop();
+    bool const add_material = activation_start < activation_end;
+    bool const quiet_elements =
+        thermal_physics_ensemble[0]->use_quiet_elements();
 
-          thermal_physics_ensemble[member]->add_material_end(
-              database_ensemble[member].get(
-                  "materials.new_material_temperature", 300.),
-              solution_augmented_ensemble[member].block(base_state));
+    // ----- Refine the mesh and add material if necessary -----
+    // Refine the mesh the first time we get in the loop and after
+    // time_steps_refinement time steps. Unless quiet elements are used, the
+    // material is added during the same mesh change.
+    bool const refinement_step =
+        (n_time_step == 1) || ((n_time_step % time_steps_refinement) == 0);
+    bool const mesh_change_add_material = add_material && !quiet_elements;
+    if (refinement_step || mesh_change_add_material)
+    {
+      adamantine::Timer &mesh_change_timer =
+          refinement_step ? timers[adamantine::refine]
+                          : timers[adamantine::add_material_activate];
+      mesh_change_timer.start();
+      double const next_refinement_time =
+          time + time_steps_refinement * time_step;
 
-          solution_augmented_ensemble[member].collect_sizes();
-        }
-#ifdef ADAMANTINE_WITH_CALIPER
-        CALI_MARK_END("add material");
-#endif
+      // The shared mesh is changed once for all the members.
+      // FIXME
+      std::unique_ptr<adamantine::MechanicalPhysics<
+          dim, p_order, MaterialStates, MemorySpaceType>>
+          dummy;
+      std::vector<double> new_material_temperatures(local_ensemble_size);
+      for (unsigned int member = 0; member < local_ensemble_size; ++member)
+      {
+        // PropertyTreeInput materials.new_material_temperature
+        new_material_temperatures[member] = database_ensemble[member].get(
+            "materials.new_material_temperature", 300.);
       }
+      MaterialActivation<dim> const activation{
+          material_deposition_boxes, deposition_cos, deposition_sin,
+          activation_start,
+          mesh_change_add_material ? activation_end : activation_start,
+          new_material_temperatures};
+      refine_mesh(members, dummy, member_solutions, bounding_heat_sources,
+                  time, next_refinement_time, time_steps_refinement,
+                  refinement_database, refinement_step, activation, timers);
+      for (unsigned int member = 0; member < local_ensemble_size; ++member)
+        solution_augmented_ensemble[member].collect_sizes();
 
-      if ((global_rank == 0) && (verbose_output == true) &&
-          (activation_end - activation_start > 0))
+      mesh_change_timer.stop();
+      if ((global_rank == 0) && (verbose_output == true))
       {
-        std::cout << "n_dofs after cell activation: "
+        std::cout << "n_time_step: " << n_time_step << " time: " << time
+                  << " n_dofs: "
                   << thermal_physics_ensemble[0]->get_dof_handler().n_dofs()
                   << std::endl;
       }
     }
-    timers[adamantine::add_material_activate].stop();
+
+    // With quiet elements, the cells are already meshed and only the
+    // coefficients of the activated cells need to be updated.
+    if (add_material && quiet_elements)
+    {
+      timers[adamantine::add_material_activate].start();
+#ifdef ADAMANTINE_WITH_CALIPER
+      CALI_MARK_BEGIN("add material");
+#endif
+      // Compute the elements to activate. The members share the mesh so the
+      // elements are the same for all the members.
+      timers[adamantine::add_material_search].start();
+      auto elements_to_activate = adamantine::get_elements_to_activate(
+          thermal_physics_ensemble[0]->get_quiet_cell_iterators(),
+          material_deposition_boxes);
+      timers[adamantine::add_material_search].stop();
+      for (unsigned int member = 0; member < local_ensemble_size; ++member)
+      {
+        // PropertyTreeInput materials.new_material_temperature
+        double const new_material_temperature = database_ensemble[member].get(
+            "materials.new_material_temperature", 300.);
+        thermal_physics_ensemble[member]->activate_quiet_cells(
+            elements_to_activate, deposition_cos, deposition_sin,
+            activation_start, activation_end, new_material_temperature,
+            solution_augmented_ensemble[member].block(base_state));
+      }
+#ifdef ADAMANTINE_WITH_CALIPER
+      CALI_MARK_END("add material");
+#endif
+      timers[adamantine::add_material_activate].stop();
+    }
 
     // ----- Evolve the solution by one time step -----
     double const old_time = time;
     timers[adamantine::evol_time].start();
 
-    for (unsigned int member = 0; member < local_ensemble_size; ++member)
-    {
-      time = thermal_physics_ensemble[member]->evolve_one_time_step(
-          old_time, time_step,
-          solution_augmented_ensemble[member].block(base_state), timers);
-    }
+    // The operators of the members are applied in a single sweep over the
+    // mesh when possible.
+    time = thermal_physics_ensemble[0]->evolve_ensemble_one_time_step(
+        old_time, time_step, members, member_solutions, timers);
     timers[adamantine::evol_time].stop();
 
     // ----- Perform data assimilation -----
@@ -2195,12 +2270,11 @@ run_ensemble(MPI_Comm const &global_communicator,
           checkpoint_overwrite
               ? checkpoint_filename
               : checkpoint_filename + '_' + std::to_string(n_time_step);
-      for (unsigned int member = 0; member < local_ensemble_size; ++member)
-      {
-        thermal_physics_ensemble[member]->save_checkpoint(
-            filename_prefix + '_' + std::to_string(first_local_member + member),
-            solution_augmented_ensemble[member].block(base_state));
-      }
+      // The mesh is shared by the members on this processor, it is saved once
+      // with the data of all the members.
+      thermal_physics_ensemble[0]->save_ensemble_checkpoint(
+          filename_prefix + '_' + std::to_string(first_local_member), members,
+          member_solutions);
       std::ofstream file{filename_prefix + "_time.txt"};
       boost::archive::text_oarchive oa{file};
       oa << time;
@@ -0,0 +1,179 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+// Benchmark comparing the sparse and the matrix-free MechanicalOperator. For
+// each degree of the finite element, we measure the time spent in reinit(),
+// i.e. the assembly of the sparse matrix or the setup of the MatrixFree
+// object, and the time spent in vmult().
+
+#include <Geometry.hh>
+#include <MaterialProperty.hh>
+#include <MaterialStates.hh>
+#include <MechanicalOperator.hh>
+#include <Timer.hh>
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_nothing.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <boost/program_options.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+int constexpr dim = 3;
+using MechanicalOperatorType =
+    adamantine::MechanicalOperator<dim, 0, adamantine::Solid,
+                                   dealii::MemorySpace::Host>;
+
+/**
+ * Return the maximum over the processors of the time spent in @p kernel.
+ */
+template <typename Kernel>
+double time_kernel(MPI_Comm communicator, unsigned int n_repetitions,
+                   Kernel const &kernel)
+{
+  adamantine::Timer timer(communicator, "kernel");
+  timer.start();
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    kernel();
+  timer.stop();
+
+  return timer.compute_statistics().max / n_repetitions;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(
+      argc, argv, dealii::numbers::invalid_unsigned_int);
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  unsigned int const rank =
+      dealii::Utilities::MPI::this_mpi_process(communicator);
+
+  namespace boost_po = boost::program_options;
+  unsigned int n_divisions = 8;
+  unsigned int n_repetitions = 10;
+  unsigned int max_fe_degree = 3;
+  boost_po::options_description description("Options:");
+  description.add_options()("help,h", "Produce help message.")(
+      "n-divisions", boost_po::value<unsigned int>(&n_divisions),
+      "Number of cells in each direction.")(
+      "n-repetitions", boost_po::value<unsigned int>(&n_repetitions),
+      "Number of calls of vmult.")(
+      "max-fe-degree", boost_po::value<unsigned int>(&max_fe_degree),
+      "Largest degree of the finite element.");
+  boost_po::variables_map map;
+  boost_po::store(boost_po::parse_command_line(argc, argv, description), map);
+  boost_po::notify(map);
+  if (map.count("help") == 1)
+  {
+    if (rank == 0)
+      std::cout << description << std::endl;
+    return 0;
+  }
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 1.);
+  geometry_database.put("length_divisions", n_divisions);
+  geometry_database.put("height", 1.);
+  geometry_database.put("height_divisions", n_divisions);
+  geometry_database.put("width", 1.);
+  geometry_database.put("width_divisions", n_divisions);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<dim> geometry(communicator, geometry_database,
+                                     units_optional_database);
+  auto const &triangulation = geometry.get_triangulation();
+  for (auto cell : triangulation.cell_iterators())
+  {
+    cell->set_material_id(0);
+    cell->set_user_index(static_cast<int>(adamantine::Solid::State::solid));
+  }
+
+  // Create the MaterialProperty
+  boost::property_tree::ptree material_database;
+  material_database.put("property_format", "polynomial");
+  material_database.put("n_materials", 1);
+  material_database.put("material_0.solid.lame_first_parameter", 2.);
+  material_database.put("material_0.solid.lame_second_parameter", 3.);
+  adamantine::MaterialProperty<dim, 0, adamantine::Solid,
+                               dealii::MemorySpace::Host>
+      material_properties(communicator, triangulation, material_database);
+
+  std::vector<double> const reference_temperatures;
+  for (unsigned int fe_degree = 1; fe_degree <= max_fe_degree; ++fe_degree)
+  {
+    dealii::hp::FECollection<dim> fe_collection;
+    fe_collection.push_back(
+        dealii::FESystem<dim>(dealii::FE_Q<dim>(fe_degree) ^ dim));
+    fe_collection.push_back(
+        dealii::FESystem<dim>(dealii::FE_Nothing<dim>() ^ dim));
+    dealii::DoFHandler<dim> dof_handler(triangulation);
+    dof_handler.distribute_dofs(fe_collection);
+    dealii::AffineConstraints<double> affine_constraints(
+        dealii::DoFTools::extract_locally_relevant_dofs(dof_handler));
+    dealii::DoFTools::make_hanging_node_constraints(dof_handler,
+                                                    affine_constraints);
+    dealii::VectorTools::interpolate_boundary_values(
+        dof_handler, 4, dealii::Functions::ZeroFunction<dim>(dim),
+        affine_constraints);
+    affine_constraints.close();
+    dealii::hp::QCollection<dim> q_collection;
+    q_collection.push_back(dealii::QGauss<dim>(fe_degree + 1));
+    q_collection.push_back(dealii::QGauss<dim>(1));
+
+    for (bool const matrix_free : {false, true})
+    {
+      MechanicalOperatorType mechanical_operator(
+          communicator, material_properties, reference_temperatures,
+          matrix_free);
+      double const setup_time = time_kernel(
+          communicator, 1,
+          [&]()
+          {
+            mechanical_operator.reinit(dof_handler, affine_constraints,
+                                       q_collection);
+          });
+
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> src;
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst;
+      if (matrix_free)
+      {
+        mechanical_operator.initialize_dof_vector(src);
+        mechanical_operator.initialize_dof_vector(dst);
+      }
+      else
+      {
+        src.reinit(dof_handler.locally_owned_dofs(), communicator);
+        dst.reinit(dof_handler.locally_owned_dofs(), communicator);
+      }
+      src = 1.;
+      double const vmult_time =
+          time_kernel(communicator, n_repetitions,
+                      [&]() { mechanical_operator.vmult(dst, src); });
+
+      if (rank == 0)
+      {
+        std::cout << (matrix_free ? "matrix-free" : "sparse")
+                  << " fe_degree " << fe_degree << " n_dofs "
+                  << dof_handler.n_dofs() << ": setup " << setup_time
+                  << " s, vmult " << vmult_time << " s, "
+                  << dof_handler.n_dofs() / vmult_time << " DoFs/s"
+                  << std::endl;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,464 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+// Benchmark of the hot kernels of the thermal simulation:
+// ThermalOperator::vmult, MaterialProperty::update,
+// ThermalPhysics::evolve_one_time_step, and
+// ThermalPhysics::compute_inverse_mass_matrix. The kernels are run for all the
+// combinations of fe_degree, p_order, MaterialStates, and property format. The
+// scaling with respect to the number of threads and of processors is obtained
+// by running the benchmark with different values of DEAL_II_NUM_THREADS and of
+// MPI ranks. The results can be written to a json file and compared to a
+// baseline written by a previous run.
+
+#include <Geometry.hh>
+#include <MaterialProperty.hh>
+#include <MaterialStates.hh>
+#include <ThermalOperator.hh>
+#include <ThermalPhysics.hh>
+#include <Timer.hh>
+#include <types.hh>
+#include <utils.hh>
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+
+#include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/**
+ * Parameters of the benchmark read from the command line.
+ */
+struct BenchmarkOptions
+{
+  unsigned int n_divisions = 8;
+  unsigned int n_repetitions = 10;
+  unsigned int fe_degree = 0;
+  int p_order = -1;
+  std::string material_states = "all";
+  std::string property_format = "all";
+};
+
+/**
+ * Result of a kernel for a given configuration. The time is the maximum over
+ * the processors of the time per call in seconds.
+ */
+struct BenchmarkResult
+{
+  std::string kernel;
+  unsigned int fe_degree;
+  unsigned int p_order;
+  std::string material_states;
+  std::string property_format;
+  dealii::types::global_dof_index n_dofs;
+  unsigned int n_processes;
+  unsigned int n_threads;
+  double time;
+  double dofs_per_second;
+  double gb_per_second;
+
+  std::string key() const
+  {
+    return kernel + "_fe" + std::to_string(fe_degree) + "_p" +
+           std::to_string(p_order) + "_" + material_states + "_" +
+           property_format + "_np" + std::to_string(n_processes) + "_nt" +
+           std::to_string(n_threads);
+  }
+};
+
+template <typename MaterialStates>
+std::string get_material_states_name()
+{
+  if constexpr (std::is_same_v<MaterialStates, adamantine::Solid>)
+    return "solid";
+  else if constexpr (std::is_same_v<MaterialStates, adamantine::SolidLiquid>)
+    return "solid_liquid";
+  else
+    return "solid_liquid_powder";
+}
+
+boost::property_tree::ptree
+create_material_database(unsigned int n_material_states, bool use_table,
+                         int p_order)
+{
+  // Create a property string whose length exercises p_order or the table
+  // interpolation.
+  auto property = [&](double value)
+  {
+    std::string property_string;
+    if (use_table)
+    {
+      for (unsigned int i = 0; i < 4; ++i)
+      {
+        property_string += (i == 0 ? "" : "|") +
+                           std::to_string(300. + 500. * i) + "," +
+                           std::to_string(value * (1. + 0.1 * i));
+      }
+    }
+    else
+    {
+      property_string = std::to_string(value);
+      for (int i = 1; i <= p_order; ++i)
+        property_string += "," + std::to_string(value * std::pow(1e-4, i));
+    }
+    return property_string;
+  };
+
+  boost::property_tree::ptree database;
+  database.put("property_format", use_table ? "table" : "polynomial");
+  database.put("n_materials", 1);
+  std::vector<std::string> const states = {"solid", "liquid", "powder"};
+  for (unsigned int s = 0; s < n_material_states; ++s)
+  {
+    std::string const prefix = "material_0." + states[s] + ".";
+    database.put(prefix + "density", property(7500.));
+    database.put(prefix + "specific_heat", property(500.));
+    database.put(prefix + "thermal_conductivity_x", property(20.));
+    database.put(prefix + "thermal_conductivity_y", property(20.));
+    database.put(prefix + "thermal_conductivity_z", property(20.));
+  }
+  database.put("material_0.solidus", 1675.);
+  database.put("material_0.liquidus", 1708.);
+  database.put("material_0.latent_heat", 2.9e5);
+
+  return database;
+}
+
+boost::property_tree::ptree create_thermal_database()
+{
+  boost::property_tree::ptree database;
+  database.put("sources.n_beams", 1);
+  database.put("sources.beam_0.type", "goldak");
+  database.put("sources.beam_0.depth", 1e-3);
+  database.put("sources.beam_0.diameter", 1e-3);
+  database.put("sources.beam_0.max_power", 1000.);
+  database.put("sources.beam_0.absorption_efficiency", 0.3);
+  database.put("sources.beam_0.scan_path_file", "bench_scan_path.txt");
+  database.put("sources.beam_0.scan_path_file_format", "segment");
+  database.put("boundary.type", "adiabatic");
+  database.put("time_stepping.method", "rk_fourth_order");
+
+  return database;
+}
+
+/**
+ * Call @p kernel @p n_repetitions times and return the maximum over the
+ * processors of the time per call.
+ */
+template <typename Kernel>
+double time_kernel(MPI_Comm communicator, unsigned int n_repetitions,
+                   Kernel const &kernel)
+{
+  // Warm up
+  kernel();
+  adamantine::Timer timer(communicator, "kernel");
+  timer.start();
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    kernel();
+  timer.stop();
+
+  return timer.compute_statistics().max / n_repetitions;
+}
+
+template <int p_order, int fe_degree, typename MaterialStates, bool use_table>
+void run_configuration(MPI_Comm communicator, BenchmarkOptions const &options,
+                       std::vector<BenchmarkResult> &results)
+{
+  int constexpr dim = 3;
+  using MemorySpaceType = dealii::MemorySpace::Host;
+
+  // Build the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 1e-2);
+  geometry_database.put("length_divisions", options.n_divisions);
+  geometry_database.put("height", 1e-2);
+  geometry_database.put("height_divisions", options.n_divisions);
+  geometry_database.put("width", 1e-2);
+  geometry_database.put("width_divisions", options.n_divisions);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<dim> geometry(communicator, geometry_database,
+                                     units_optional_database);
+
+  // Build the MaterialProperty
+  adamantine::MaterialProperty<dim, p_order, MaterialStates, MemorySpaceType>
+      material_properties(
+          communicator, geometry.get_triangulation(),
+          create_material_database(MaterialStates::n_material_states,
+                                   use_table, p_order));
+
+  // Build the ThermalPhysics
+  boost::property_tree::ptree const database = create_thermal_database();
+  adamantine::ThermalPhysics<dim, p_order, fe_degree, MaterialStates,
+                             MemorySpaceType, dealii::QGauss<1>>
+      thermal_physics(communicator, database, geometry, material_properties);
+  thermal_physics.setup();
+  dealii::LA::distributed::Vector<double, MemorySpaceType> temperature;
+  thermal_physics.initialize_dof_vector(1000., temperature);
+
+  // Build a ThermalOperator sharing the DoFHandler of the ThermalPhysics
+  dealii::hp::QCollection<1> q_collection;
+  q_collection.push_back(dealii::QGauss<1>(fe_degree + 1));
+  q_collection.push_back(dealii::QGauss<1>(fe_degree + 1));
+  adamantine::ThermalOperator<dim, use_table, p_order, fe_degree,
+                              MaterialStates, MemorySpaceType>
+      thermal_operator(communicator, adamantine::BoundaryType::adiabatic,
+                       material_properties,
+                       thermal_physics.get_heat_sources());
+  auto &dof_handler = thermal_physics.get_dof_handler();
+  auto &affine_constraints = thermal_physics.get_affine_constraints();
+  thermal_operator.reinit(dof_handler, affine_constraints, q_collection);
+  unsigned int const n_active_cells =
+      geometry.get_triangulation().n_locally_owned_active_cells();
+  thermal_operator.set_material_deposition_orientation(
+      std::vector<double>(n_active_cells, 1.),
+      std::vector<double>(n_active_cells, 0.));
+  thermal_operator.compute_inverse_mass_matrix(dof_handler, affine_constraints);
+  thermal_operator.get_state_from_material_properties();
+  dealii::LA::distributed::Vector<double, MemorySpaceType> dst;
+  thermal_operator.initialize_dof_vector(dst);
+
+  std::vector<adamantine::Timer> timers;
+  for (unsigned int i = 0; i < adamantine::Timing::n_timers; ++i)
+    timers.push_back(adamantine::Timer(communicator, "benchmark"));
+  double const time_step = 1e-6;
+  double time = 0.;
+
+  // The bandwidth is estimated from the number of vectors read and written by
+  // each kernel. The data associated with the cells and the quadrature points
+  // is ignored, so the values are lower bounds.
+  std::vector<std::tuple<std::string, double, std::function<void()>>> kernels;
+  kernels.emplace_back("vmult", 3.,
+                       [&]() { thermal_operator.vmult(dst, temperature); });
+  kernels.emplace_back(
+      "material_property_update", 2.,
+      [&]() { material_properties.update(dof_handler, temperature); });
+  kernels.emplace_back("evolve_one_time_step", 4. * 3. + 5.,
+                       [&]()
+                       {
+                         time = thermal_physics.evolve_one_time_step(
+                             time, time_step, temperature, timers);
+                       });
+  kernels.emplace_back("compute_inverse_mass_matrix", 2.,
+                       [&]()
+                       { thermal_physics.compute_inverse_mass_matrix(); });
+
+  dealii::types::global_dof_index const n_dofs = dof_handler.n_dofs();
+  for (auto const &[name, n_vectors, kernel] : kernels)
+  {
+    BenchmarkResult result;
+    result.kernel = name;
+    result.fe_degree = fe_degree;
+    result.p_order = p_order;
+    result.material_states = get_material_states_name<MaterialStates>();
+    result.property_format = use_table ? "table" : "polynomial";
+    result.n_dofs = n_dofs;
+    result.n_processes = dealii::Utilities::MPI::n_mpi_processes(communicator);
+    result.n_threads = dealii::MultithreadInfo::n_threads();
+    result.time = time_kernel(communicator, options.n_repetitions, kernel);
+    result.dofs_per_second = n_dofs / result.time;
+    result.gb_per_second = n_vectors * sizeof(double) * n_dofs / result.time /
+                           1e9;
+    results.push_back(result);
+  }
+}
+
+template <int p_order, typename MaterialStates, bool use_table,
+          int... fe_degrees>
+void run_fe_degrees(MPI_Comm communicator, BenchmarkOptions const &options,
+                    std::vector<BenchmarkResult> &results,
+                    std::integer_sequence<int, fe_degrees...>)
+{
+  (
+      [&]()
+      {
+        if ((options.fe_degree == 0) ||
+            (options.fe_degree == static_cast<unsigned int>(fe_degrees)))
+          run_configuration<p_order, fe_degrees, MaterialStates, use_table>(
+              communicator, options, results);
+      }(),
+      ...);
+}
+
+template <typename MaterialStates, int... p_orders>
+void run_p_orders(MPI_Comm communicator, BenchmarkOptions const &options,
+                  std::vector<BenchmarkResult> &results,
+                  std::integer_sequence<int, p_orders...>)
+{
+  using fe_degrees = std::integer_sequence<int, 1, 2, 3, 4, 5>;
+  // The p_order is not used by the table format.
+  if (options.property_format != "polynomial" && options.p_order <= 0)
+    run_fe_degrees<0, MaterialStates, true>(communicator, options, results,
+                                            fe_degrees{});
+  if (options.property_format != "table")
+  {
+    (
+        [&]()
+        {
+          if ((options.p_order < 0) || (options.p_order == p_orders))
+            run_fe_degrees<p_orders, MaterialStates, false>(
+                communicator, options, results, fe_degrees{});
+        }(),
+        ...);
+  }
+}
+
+template <typename MaterialStates>
+void run_material_states(MPI_Comm communicator,
+                         BenchmarkOptions const &options,
+                         std::vector<BenchmarkResult> &results)
+{
+  if ((options.material_states == "all") ||
+      (options.material_states == get_material_states_name<MaterialStates>()))
+    run_p_orders<MaterialStates>(communicator, options, results,
+                                 std::integer_sequence<int, 0, 1, 2, 3, 4>{});
+}
+
+void write_results(std::vector<BenchmarkResult> const &results,
+                   std::string const &filename)
+{
+  std::ofstream file(filename);
+  file << "[\n";
+  for (unsigned int i = 0; i < results.size(); ++i)
+  {
+    auto const &r = results[i];
+    file << "  {\"key\": \"" << r.key() << "\", \"kernel\": \"" << r.kernel
+         << "\", \"fe_degree\": " << r.fe_degree
+         << ", \"p_order\": " << r.p_order << ", \"material_states\": \""
+         << r.material_states << "\", \"property_format\": \""
+         << r.property_format << "\", \"n_dofs\": " << r.n_dofs
+         << ", \"n_processes\": " << r.n_processes
+         << ", \"n_threads\": " << r.n_threads << ", \"time\": " << r.time
+         << ", \"dofs_per_second\": " << r.dofs_per_second
+         << ", \"gb_per_second\": " << r.gb_per_second << "}"
+         << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  file << "]\n";
+}
+
+/**
+ * Compare the results to the baseline and return the number of kernels that
+ * are slower than the baseline by more than @p tolerance (relative).
+ */
+unsigned int compare_to_baseline(std::vector<BenchmarkResult> const &results,
+                                 std::string const &filename, double tolerance)
+{
+  boost::property_tree::ptree baseline_database;
+  boost::property_tree::json_parser::read_json(filename, baseline_database);
+  std::map<std::string, double> baseline;
+  for (auto const &entry : baseline_database)
+  {
+    baseline[entry.second.get<std::string>("key")] =
+        entry.second.get<double>("time");
+  }
+
+  unsigned int n_regressions = 0;
+  for (auto const &r : results)
+  {
+    auto const it = baseline.find(r.key());
+    if (it == baseline.end())
+      continue;
+    double const ratio = r.time / it->second;
+    if (ratio > 1. + tolerance)
+    {
+      std::cout << "REGRESSION " << r.key() << ": " << r.time << " s vs "
+                << it->second << " s (x" << ratio << ")" << std::endl;
+      ++n_regressions;
+    }
+  }
+
+  return n_regressions;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(
+      argc, argv, dealii::numbers::invalid_unsigned_int);
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  unsigned int const rank =
+      dealii::Utilities::MPI::this_mpi_process(communicator);
+
+  namespace boost_po = boost::program_options;
+  BenchmarkOptions options;
+  std::string output_filename;
+  std::string baseline_filename;
+  double tolerance = 0.1;
+  boost_po::options_description description("Options:");
+  description.add_options()("help,h", "Produce help message.")(
+      "n-divisions", boost_po::value<unsigned int>(&options.n_divisions),
+      "Number of cells in each direction.")(
+      "n-repetitions", boost_po::value<unsigned int>(&options.n_repetitions),
+      "Number of calls of each kernel.")(
+      "fe-degree", boost_po::value<unsigned int>(&options.fe_degree),
+      "Only run this degree of the finite element (1 to 5).")(
+      "p-order", boost_po::value<int>(&options.p_order),
+      "Only run this polynomial order of the material properties (0 to 4).")(
+      "material-states", boost_po::value<std::string>(&options.material_states),
+      "Only run these material states: solid, solid_liquid, or "
+      "solid_liquid_powder.")(
+      "property-format", boost_po::value<std::string>(&options.property_format),
+      "Only run this format of the material properties: table or "
+      "polynomial.")("output,o", boost_po::value<std::string>(&output_filename),
+                     "Name of the json file where the results are written.")(
+      "baseline,b", boost_po::value<std::string>(&baseline_filename),
+      "Name of the json file containing the baseline results.")(
+      "tolerance", boost_po::value<double>(&tolerance),
+      "Relative slowdown compared to the baseline that is reported as a "
+      "regression (default value: 0.1).");
+  boost_po::variables_map map;
+  boost_po::store(boost_po::command_line_parser(argc, argv)
+                      .options(description)
+                      .allow_unregistered()
+                      .run(),
+                  map);
+  boost_po::notify(map);
+  if (map.count("help") == 1)
+  {
+    if (rank == 0)
+      std::cout << description << std::endl;
+    return 0;
+  }
+
+  std::vector<BenchmarkResult> results;
+  run_material_states<adamantine::Solid>(communicator, options, results);
+  run_material_states<adamantine::SolidLiquid>(communicator, options, results);
+  run_material_states<adamantine::SolidLiquidPowder>(communicator, options,
+                                                     results);
+
+  unsigned int n_regressions = 0;
+  if (rank == 0)
+  {
+    for (auto const &r : results)
+    {
+      std::cout << r.key() << ": n_dofs " << r.n_dofs << " time " << r.time
+                << " s, " << r.dofs_per_second << " DoFs/s, "
+                << r.gb_per_second << " GB/s" << std::endl;
+    }
+
+    if (!output_filename.empty())
+      write_results(results, output_filename);
+
+    if (!baseline_filename.empty())
+      n_regressions =
+          compare_to_baseline(results, baseline_filename, tolerance);
+  }
+  n_regressions = dealii::Utilities::MPI::max(n_regressions, communicator);
+
+  return n_regressions == 0 ? 0 : 1;
+}
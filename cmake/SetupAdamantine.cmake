@@ -13,3 +13,81 @@ set(CMAKE_CXX_FLAGS "")
 set(CMAKE_CXX_FLAGS_RELEASE "")
 set(CMAKE_CXX_FLAGS_DEBUG "")
 set(CMAKE_EXE_LINKER_FLAGS "")
+
+#### Instantiated specializations ############################################
+# The classes are instantiated for the Cartesian product of the following
+# lists. Restricting the lists reduces the compilation time and the size of the
+# executable. The executable stops with an error if the input file requires a
+# specialization that has not been instantiated.
+set(ADAMANTINE_DIMS "2;3" CACHE STRING "Dimensions to instantiate")
+set(ADAMANTINE_P_ORDERS "0;1;2;3;4" CACHE STRING
+  "Polynomial orders of the material properties to instantiate")
+set(ADAMANTINE_FE_DEGREES "1;2;3;4;5" CACHE STRING
+  "Finite element degrees of the thermal simulation to instantiate")
+set(ADAMANTINE_MATERIAL_STATES "Solid;SolidLiquid;SolidLiquidPowder" CACHE
+  STRING "Material states to instantiate")
+set(ADAMANTINE_MEMORY_SPACES "Host;Device" CACHE STRING
+  "Memory spaces to instantiate")
+
+# Check that the list NAME is not empty and that it only contains the values
+# given after PREFIX. Set NAME_SEQ to the Boost.Preprocessor sequence of the
+# values with PREFIX prepended.
+set(ADAMANTINE_INSTANTIATE_SUBSET OFF)
+function(adamantine_instantiation_list NAME PREFIX)
+  set(VALUES ${${NAME}})
+  if ("${VALUES}" STREQUAL "")
+    message(FATAL_ERROR "${NAME} cannot be empty. Valid values are: ${ARGN}")
+  endif()
+  list(REMOVE_DUPLICATES VALUES)
+  set(SEQ "")
+  foreach(VALUE ${VALUES})
+    if (NOT VALUE IN_LIST ARGN)
+      message(FATAL_ERROR
+        "Invalid value ${VALUE} in ${NAME}. Valid values are: ${ARGN}")
+    endif()
+    string(APPEND SEQ "(${PREFIX}${VALUE})")
+  endforeach()
+  list(LENGTH VALUES N_VALUES)
+  list(LENGTH ARGN N_VALID_VALUES)
+  if (NOT N_VALUES EQUAL N_VALID_VALUES)
+    set(ADAMANTINE_INSTANTIATE_SUBSET ON PARENT_SCOPE)
+  endif()
+  set(${NAME}_SEQ "${SEQ}" PARENT_SCOPE)
+  message(STATUS "${NAME}: ${VALUES}")
+endfunction()
+
+adamantine_instantiation_list(ADAMANTINE_DIMS "" 2 3)
+adamantine_instantiation_list(ADAMANTINE_P_ORDERS "" 0 1 2 3 4)
+adamantine_instantiation_list(ADAMANTINE_FE_DEGREES "" 1 2 3 4 5)
+adamantine_instantiation_list(ADAMANTINE_MATERIAL_STATES "adamantine::"
+  Solid SolidLiquid SolidLiquidPowder)
+adamantine_instantiation_list(ADAMANTINE_MEMORY_SPACES "" Host Device)
+
+foreach(STATE Solid SolidLiquid SolidLiquidPowder)
+  string(REGEX REPLACE "([a-z])([A-Z])" "\\1_\\2" FLAG ${STATE})
+  string(TOUPPER ${FLAG} FLAG)
+  if (STATE IN_LIST ADAMANTINE_MATERIAL_STATES)
+    set(ADAMANTINE_INSTANTIATE_${FLAG} ON)
+  else()
+    set(ADAMANTINE_INSTANTIATE_${FLAG} OFF)
+  endif()
+endforeach()
+if ("Host" IN_LIST ADAMANTINE_MEMORY_SPACES)
+  set(ADAMANTINE_INSTANTIATE_HOST ON)
+else()
+  set(ADAMANTINE_INSTANTIATE_HOST OFF)
+endif()
+if ("Device" IN_LIST ADAMANTINE_MEMORY_SPACES)
+  set(ADAMANTINE_INSTANTIATE_DEVICE ON)
+else()
+  set(ADAMANTINE_INSTANTIATE_DEVICE OFF)
+endif()
+
+# The tests and the benchmarks use specializations directly.
+if (ADAMANTINE_INSTANTIATE_SUBSET AND
+    (ADAMANTINE_ENABLE_TESTS OR ADAMANTINE_ENABLE_BENCHMARKS))
+  message(FATAL_ERROR "The tests and the benchmarks require all the "
+    "specializations to be instantiated. Use the default values of "
+    "ADAMANTINE_DIMS, ADAMANTINE_P_ORDERS, ADAMANTINE_FE_DEGREES, "
+    "ADAMANTINE_MATERIAL_STATES, and ADAMANTINE_MEMORY_SPACES.")
+endif()
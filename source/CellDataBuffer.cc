@@ -0,0 +1,158 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <CellDataBuffer.hh>
+#include <instantiation.hh>
+#include <utils.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace adamantine
+{
+template <int dim>
+void CellDataBuffer<dim>::reinit(unsigned int n_cells, unsigned int stride,
+                                 double value)
+{
+  _n_cells = n_cells;
+  _stride = stride;
+  _default_value = value;
+  _data.assign(static_cast<std::size_t>(_n_cells) * _stride, value);
+}
+
+template <int dim>
+void CellDataBuffer<dim>::clear()
+{
+  _n_cells = 0;
+  _data.clear();
+  _data.shrink_to_fit();
+}
+
+template <int dim>
+void CellDataBuffer<dim>::prepare_for_coarsening_and_refinement(
+    dealii::parallel::distributed::Triangulation<dim> &triangulation,
+    RefinementStrategy refinement_strategy,
+    CoarseningStrategy coarsening_strategy)
+{
+  _refinement_strategy = std::move(refinement_strategy);
+  _coarsening_strategy = std::move(coarsening_strategy);
+  register_data_attach(triangulation);
+}
+
+template <int dim>
+void CellDataBuffer<dim>::unpack(
+    dealii::parallel::distributed::Triangulation<dim> &triangulation)
+{
+  ASSERT(_handle != dealii::numbers::invalid_unsigned_int,
+         "No data is attached to the triangulation.");
+
+  reinit(triangulation.n_active_cells(), _stride, _default_value);
+
+  auto unpack =
+      [this, parent_values = std::vector<double>(_stride)](
+          cell_iterator const &cell, internal::CellStatus<dim> const status,
+          boost::iterator_range<std::vector<char>::const_iterator> const
+              &data_range) mutable
+  {
+    // The received data is not necessarily aligned so it is always copied.
+    char const *cell_data = &*data_range.begin();
+    std::size_t const n_bytes = _stride * sizeof(double);
+    if (status == internal::cell_will_be_refined<dim>)
+    {
+      std::memcpy(parent_values.data(), cell_data, n_bytes);
+      for (unsigned int i = 0; i < cell->n_children(); ++i)
+      {
+        unsigned int const child_index = cell->child(i)->active_cell_index();
+        if (_refinement_strategy)
+          _refinement_strategy(
+              cell, i, dealii::make_array_view(std::as_const(parent_values)),
+              (*this)[child_index]);
+        else
+          std::copy(parent_values.begin(), parent_values.end(),
+                    (*this)[child_index].begin());
+      }
+    }
+    else
+      std::memcpy((*this)[cell->active_cell_index()].data(), cell_data,
+                  n_bytes);
+  };
+
+  triangulation.notify_ready_to_unpack(_handle, unpack);
+  _handle = dealii::numbers::invalid_unsigned_int;
+  _refinement_strategy = nullptr;
+  _coarsening_strategy = nullptr;
+}
+
+template <int dim>
+void CellDataBuffer<dim>::prepare_for_serialization(
+    dealii::parallel::distributed::Triangulation<dim> &triangulation)
+{
+  register_data_attach(triangulation);
+  // The triangulation keeps the data until it is saved and the handle is only
+  // valid during the deserialization.
+  _handle = dealii::numbers::invalid_unsigned_int;
+}
+
+template <int dim>
+void CellDataBuffer<dim>::deserialize(
+    dealii::parallel::distributed::Triangulation<dim> &triangulation)
+{
+  // The data must be registered to get the handle used during the
+  // serialization. The pack function is never called.
+  register_data_attach(triangulation);
+  unpack(triangulation);
+}
+
+template <int dim>
+void CellDataBuffer<dim>::register_data_attach(
+    dealii::parallel::distributed::Triangulation<dim> &triangulation)
+{
+  ASSERT(_handle == dealii::numbers::invalid_unsigned_int,
+         "The data is already attached to the triangulation.");
+  ASSERT(_stride > 0, "The buffer has not been initialized.");
+
+  auto pack = [this, parent_values = std::vector<double>(_stride),
+               children_values =
+                   std::vector<dealii::ArrayView<double const>>()](
+                  cell_iterator const &cell,
+                  internal::CellStatus<dim> const status) mutable
+  {
+    std::vector<char> buffer(_stride * sizeof(double));
+    if (status == internal::children_will_be_coarsened<dim>)
+    {
+      // The children are active, the parent gets the values computed by the
+      // coarsening strategy.
+      children_values.clear();
+      for (unsigned int i = 0; i < cell->n_children(); ++i)
+        children_values.push_back(
+            std::as_const(*this)[cell->child(i)->active_cell_index()]);
+      if (_coarsening_strategy)
+        _coarsening_strategy(cell, children_values,
+                             dealii::make_array_view(parent_values));
+      else
+        std::copy(children_values[0].begin(), children_values[0].end(),
+                  parent_values.begin());
+      std::memcpy(buffer.data(), parent_values.data(), buffer.size());
+    }
+    else
+      std::memcpy(buffer.data(),
+                  std::as_const(*this)[cell->active_cell_index()].data(),
+                  buffer.size());
+
+    return buffer;
+  };
+
+  _handle = triangulation.register_data_attach(
+      pack, /* returns_variable_size_data */ false);
+}
+
+template <int dim>
+std::size_t CellDataBuffer<dim>::memory_consumption() const
+{
+  return sizeof(*this) + _data.capacity() * sizeof(double);
+}
+} // namespace adamantine
+
+INSTANTIATE_DIM(CellDataBuffer)
@@ -0,0 +1,211 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef CELL_DATA_BUFFER_HH
+#define CELL_DATA_BUFFER_HH
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/distributed/tria.h>
+
+#include <functional>
+#include <vector>
+
+namespace adamantine
+{
+namespace internal
+{
+#if (DEAL_II_VERSION_MAJOR == 9) && (DEAL_II_VERSION_MINOR == 5)
+template <int dim>
+using CellStatus = typename dealii::Triangulation<dim>::CellStatus;
+
+template <int dim>
+CellStatus<dim> constexpr cell_will_be_refined =
+    dealii::Triangulation<dim>::CELL_REFINE;
+
+template <int dim>
+CellStatus<dim> constexpr children_will_be_coarsened =
+    dealii::Triangulation<dim>::CELL_COARSEN;
+#else
+template <int dim>
+using CellStatus = dealii::CellStatus;
+
+template <int dim>
+CellStatus<dim> constexpr cell_will_be_refined =
+    dealii::CellStatus::cell_will_be_refined;
+
+template <int dim>
+CellStatus<dim> constexpr children_will_be_coarsened =
+    dealii::CellStatus::children_will_be_coarsened;
+#endif
+} // namespace internal
+
+/**
+ * This class stores a fixed number of values for each active cell of a
+ * Triangulation in a single contiguous buffer. The values of a cell are
+ * contiguous and the cells are indexed by their active cell index. The buffer
+ * can be attached to the Triangulation to be transferred during refinement,
+ * coarsening, and repartitioning, or to be serialized. Because every cell has
+ * the same number of values, the data is attached as fixed size data.
+ */
+template <int dim>
+class CellDataBuffer
+{
+public:
+  using cell_iterator = typename dealii::Triangulation<dim>::cell_iterator;
+
+  /**
+   * Function used to compute the values of the child @p child of the cell
+   * @p parent when @p parent is refined.
+   */
+  using RefinementStrategy =
+      std::function<void(cell_iterator const &parent, unsigned int const child,
+                         dealii::ArrayView<double const> const &parent_values,
+                         dealii::ArrayView<double> const &child_values)>;
+
+  /**
+   * Function used to compute the values of the cell @p parent when its
+   * children are coarsened. The values of the children are given in the order
+   * of the children.
+   */
+  using CoarseningStrategy = std::function<void(
+      cell_iterator const &parent,
+      std::vector<dealii::ArrayView<double const>> const &children_values,
+      dealii::ArrayView<double> const &parent_values)>;
+
+  /**
+   * Resize the buffer to @p n_cells cells with @p stride values each. All the
+   * values are set to @p value. The same value is used for the cells that are
+   * not unpacked by unpack() and deserialize().
+   */
+  void reinit(unsigned int n_cells, unsigned int stride, double value = 0.);
+
+  /**
+   * Free the memory of the buffer.
+   */
+  void clear();
+
+  /**
+   * Return the number of cells.
+   */
+  unsigned int n_cells() const;
+
+  /**
+   * Return the number of values per cell.
+   */
+  unsigned int stride() const;
+
+  /**
+   * Return the values of the cell with the active cell index @p cell.
+   */
+  dealii::ArrayView<double> operator[](unsigned int cell);
+
+  /**
+   * Same as above but const.
+   */
+  dealii::ArrayView<double const> operator[](unsigned int cell) const;
+
+  /**
+   * Attach the buffer to @p triangulation before the triangulation is refined,
+   * coarsened, or repartitioned. If no strategy is given, the children of a
+   * refined cell inherit the values of the parent and the parent of coarsened
+   * cells inherits the values of the first child.
+   */
+  void prepare_for_coarsening_and_refinement(
+      dealii::parallel::distributed::Triangulation<dim> &triangulation,
+      RefinementStrategy refinement_strategy = RefinementStrategy(),
+      CoarseningStrategy coarsening_strategy = CoarseningStrategy());
+
+  /**
+   * Resize the buffer to the new number of active cells of @p triangulation
+   * and unpack the data attached by prepare_for_coarsening_and_refinement().
+   */
+  void unpack(dealii::parallel::distributed::Triangulation<dim> &triangulation);
+
+  /**
+   * Attach the buffer to @p triangulation before the triangulation is saved.
+   */
+  void prepare_for_serialization(
+      dealii::parallel::distributed::Triangulation<dim> &triangulation);
+
+  /**
+   * Resize the buffer to the number of active cells of @p triangulation and
+   * unpack the data saved with the triangulation. The buffer must have been
+   * initialized with the stride used during the serialization. The buffers
+   * need to be deserialized in the same order they have been serialized.
+   */
+  void
+  deserialize(dealii::parallel::distributed::Triangulation<dim> &triangulation);
+
+  /**
+   * Return the memory used by the buffer in bytes.
+   */
+  std::size_t memory_consumption() const;
+
+private:
+  /**
+   * Register the pack function with @p triangulation.
+   */
+  void register_data_attach(
+      dealii::parallel::distributed::Triangulation<dim> &triangulation);
+
+  /**
+   * Number of cells.
+   */
+  unsigned int _n_cells = 0;
+  /**
+   * Number of values per cell.
+   */
+  unsigned int _stride = 0;
+  /**
+   * Value of the cells that have not been unpacked.
+   */
+  double _default_value = 0.;
+  /**
+   * Handle returned by the triangulation when the data is attached.
+   */
+  unsigned int _handle = dealii::numbers::invalid_unsigned_int;
+  /**
+   * Strategy used when a cell is refined.
+   */
+  RefinementStrategy _refinement_strategy;
+  /**
+   * Strategy used when cells are coarsened.
+   */
+  CoarseningStrategy _coarsening_strategy;
+  /**
+   * Values of all the cells.
+   */
+  std::vector<double> _data;
+};
+
+template <int dim>
+inline unsigned int CellDataBuffer<dim>::n_cells() const
+{
+  return _n_cells;
+}
+
+template <int dim>
+inline unsigned int CellDataBuffer<dim>::stride() const
+{
+  return _stride;
+}
+
+template <int dim>
+inline dealii::ArrayView<double>
+CellDataBuffer<dim>::operator[](unsigned int cell)
+{
+  return dealii::ArrayView<double>(
+      _data.data() + static_cast<std::size_t>(cell) * _stride, _stride);
+}
+
+template <int dim>
+inline dealii::ArrayView<double const>
+CellDataBuffer<dim>::operator[](unsigned int cell) const
+{
+  return dealii::ArrayView<double const>(
+      _data.data() + static_cast<std::size_t>(cell) * _stride, _stride);
+}
+} // namespace adamantine
+
+#endif
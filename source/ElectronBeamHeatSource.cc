@@ -21,12 +21,15 @@ ElectronBeamHeatSource<dim>::ElectronBeamHeatSource(
 template <int dim>
 void ElectronBeamHeatSource<dim>::update_time(double time)
 {
-  _beam_center = this->_scan_path.value(time);
-  double segment_power_modifier = this->_scan_path.get_power_modifier(time);
-  _alpha =
-      -this->_beam.absorption_efficiency * this->_beam.max_power *
-      segment_power_modifier * _log_01 /
-      (dealii::numbers::PI * this->_beam.radius_squared * this->_beam.depth);
+  this->update_beam_centers(time);
+  _alphas.resize(this->_power_modifiers.size());
+  for (unsigned int i = 0; i < _alphas.size(); ++i)
+  {
+    _alphas[i] =
+        -this->_beam.absorption_efficiency * this->_beam.max_power *
+        this->_power_modifiers[i] * _log_01 /
+        (dealii::numbers::PI * this->_beam.radius_squared * this->_beam.depth);
+  }
 }
 
 template <int dim>
@@ -43,18 +46,24 @@ double ElectronBeamHeatSource<dim>::value(dealii::Point<dim> const &point,
     double const distribution_z = -3. * std::pow(z / this->_beam.depth, 2) -
                                   2. * (z / this->_beam.depth) + 1.;
 
-    double xpy_squared =
-        std::pow(point[axis<dim>::x] - _beam_center[axis<dim>::x], 2);
-    if constexpr (dim == 3)
+    double heat_source = 0.;
+    for (unsigned int i = 0; i < _alphas.size(); ++i)
     {
-      xpy_squared +=
-          std::pow(point[axis<dim>::y] - _beam_center[axis<dim>::y], 2);
-    }
+      auto const &beam_center = this->_beam_centers[i];
+      double xpy_squared =
+          std::pow(point[axis<dim>::x] - beam_center[axis<dim>::x], 2);
+      if constexpr (dim == 3)
+      {
+        xpy_squared +=
+            std::pow(point[axis<dim>::y] - beam_center[axis<dim>::y], 2);
+      }
 
-    // Electron beam heat source equation
-    double heat_source =
-        _alpha * std::exp(_log_01 * xpy_squared / this->_beam.radius_squared) *
-        distribution_z;
+      // Electron beam heat source equation
+      heat_source += _alphas[i] *
+                     std::exp(_log_01 * xpy_squared /
+                              this->_beam.radius_squared) *
+                     distribution_z;
+    }
 
     return heat_source;
   }
@@ -64,22 +73,7 @@ template <int dim>
 dealii::BoundingBox<dim>
 ElectronBeamHeatSource<dim>::get_bounding_box(double const scaling_factor) const
 {
-  if constexpr (dim == 2)
-  {
-    return {{{_beam_center[axis<dim>::x] - scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::z] - scaling_factor * this->_beam.depth},
-             {_beam_center[axis<dim>::x] + scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::z]}}};
-  }
-  else
-  {
-    return {{{_beam_center[axis<dim>::x] - scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::y] - scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::z] - scaling_factor * this->_beam.depth},
-             {_beam_center[axis<dim>::x] + scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::y] + scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::z]}}};
-  }
+  return this->get_beam_centers_bounding_box(scaling_factor);
 }
 } // namespace adamantine
 
@@ -7,7 +7,7 @@
 
 #include <HeatSource.hh>
 
-#include <limits>
+#include <vector>
 
 namespace adamantine
 {
@@ -54,8 +54,10 @@ public:
   get_bounding_box(double const scaling_factor) const final;
 
 private:
-  dealii::Point<3> _beam_center;
-  double _alpha = std::numeric_limits<double>::signaling_NaN();
+  /**
+   * Prefactor of the power density associated with each beam center.
+   */
+  std::vector<double> _alphas;
   double const _log_01 = std::log(0.1);
 };
 } // namespace adamantine
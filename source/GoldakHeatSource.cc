@@ -21,11 +21,15 @@ GoldakHeatSource<dim>::GoldakHeatSource(
 template <int dim>
 void GoldakHeatSource<dim>::update_time(double time)
 {
-  _beam_center = this->_scan_path.value(time);
-  double segment_power_modifier = this->_scan_path.get_power_modifier(time);
-  _alpha = 2.0 * this->_beam.absorption_efficiency * this->_beam.max_power *
-           segment_power_modifier /
-           (this->_beam.radius_squared * this->_beam.depth * _pi_over_3_to_1p5);
+  this->update_beam_centers(time);
+  _alphas.resize(this->_power_modifiers.size());
+  for (unsigned int i = 0; i < _alphas.size(); ++i)
+  {
+    _alphas[i] =
+        2.0 * this->_beam.absorption_efficiency * this->_beam.max_power *
+        this->_power_modifiers[i] /
+        (this->_beam.radius_squared * this->_beam.depth * _pi_over_3_to_1p5);
+  }
 }
 
 template <int dim>
@@ -39,18 +43,24 @@ double GoldakHeatSource<dim>::value(dealii::Point<dim> const &point,
   }
   else
   {
-    double xpy_squared =
-        std::pow(point[axis<dim>::x] - _beam_center[axis<dim>::x], 2);
-    if (dim == 3)
+    double const z_term = -3.0 * std::pow(z / this->_beam.depth, 2);
+    double heat_source = 0.;
+    for (unsigned int i = 0; i < _alphas.size(); ++i)
     {
-      xpy_squared +=
-          std::pow(point[axis<dim>::y] - _beam_center[axis<dim>::y], 2);
-    }
+      auto const &beam_center = this->_beam_centers[i];
+      double xpy_squared =
+          std::pow(point[axis<dim>::x] - beam_center[axis<dim>::x], 2);
+      if (dim == 3)
+      {
+        xpy_squared +=
+            std::pow(point[axis<dim>::y] - beam_center[axis<dim>::y], 2);
+      }
 
-    // Goldak heat source equation
-    double heat_source =
-        _alpha * std::exp(-3.0 * xpy_squared / this->_beam.radius_squared +
-                          -3.0 * std::pow(z / this->_beam.depth, 2));
+      // Goldak heat source equation
+      heat_source +=
+          _alphas[i] *
+          std::exp(-3.0 * xpy_squared / this->_beam.radius_squared + z_term);
+    }
 
     return heat_source;
   }
@@ -60,22 +70,7 @@ template <int dim>
 dealii::BoundingBox<dim>
 GoldakHeatSource<dim>::get_bounding_box(double const scaling_factor) const
 {
-  if constexpr (dim == 2)
-  {
-    return {{{_beam_center[axis<dim>::x] - scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::z] - scaling_factor * this->_beam.depth},
-             {_beam_center[axis<dim>::x] + scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::z]}}};
-  }
-  else
-  {
-    return {{{_beam_center[axis<dim>::x] - scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::y] - scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::z] - scaling_factor * this->_beam.depth},
-             {_beam_center[axis<dim>::x] + scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::y] + scaling_factor * this->_beam.radius,
-              _beam_center[axis<dim>::z]}}};
-  }
+  return this->get_beam_centers_bounding_box(scaling_factor);
 }
 
 } // namespace adamantine
@@ -7,7 +7,7 @@
 
 #include <HeatSource.hh>
 
-#include <limits>
+#include <vector>
 
 namespace adamantine
 {
@@ -53,8 +53,10 @@ public:
   get_bounding_box(double const scaling_factor) const final;
 
 private:
-  dealii::Point<3> _beam_center;
-  double _alpha = std::numeric_limits<double>::signaling_NaN();
+  /**
+   * Prefactor of the power density associated with each beam center.
+   */
+  std::vector<double> _alphas;
   double const _pi_over_3_to_1p5 = std::pow(dealii::numbers::PI / 3.0, 1.5);
 };
 } // namespace adamantine
@@ -12,6 +12,10 @@
 #include <deal.II/base/bounding_box.h>
 #include <deal.II/base/point.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 namespace adamantine
 {
 /**
@@ -46,6 +50,7 @@ public:
    *   - <B>max_power</B>: double in \f$[0, \infty)\f$
    *   - <B>input_file</B>: name of the file that contains the scan path
    *     segments
+   *   - <B>time_averaged</B>: boolean (optional)
    * \param[in] units_optional_database may contain the following entries:
    *   - <B>heat_source.dimension</B>
    *   - <B>heat_source.power</B>
@@ -58,7 +63,9 @@ public:
         // PropertyTreeInput sources.beam_X.scan_path_format
         _scan_path(beam_database.get<std::string>("scan_path_file"),
                    beam_database.get<std::string>("scan_path_file_format"),
-                   units_optional_database)
+                   units_optional_database),
+        // PropertyTreeInput sources.beam_X.time_averaged
+        _time_averaged(beam_database.get("time_averaged", false))
   {
   }
 
@@ -101,7 +108,43 @@ public:
   virtual dealii::BoundingBox<dim>
   get_bounding_box(double const scaling_factor) const = 0;
 
+  /**
+   * Return true if the power density is averaged over the path swept by the
+   * beam during a time window instead of being evaluated at a single time.
+   */
+  bool is_time_averaged() const;
+
+  /**
+   * Set the time window [@p start_time, @p start_time + @p duration] over which
+   * the beam is swept when the source is time averaged. The window is usually
+   * the current time step, so that every stage of the time step sees the same
+   * source.
+   */
+  void set_sweep_window(double const start_time, double const duration);
+
 protected:
+  /**
+   * Compute the positions of the beam center and the associated power
+   * modifiers used to evaluate the source at @p time. If the source is not
+   * time averaged, there is a single center. Otherwise, @p time is ignored and
+   * the sweep window is divided into intervals of equal duration such that two
+   * consecutive centers are at most half a radius apart. The centers are the
+   * positions of the beam at the midpoint of the intervals and the weights of
+   * the midpoint rule are included in the power modifiers. This way the energy
+   * deposited during a large time step is spread along the segment of the scan
+   * path traversed during the time step instead of being concentrated where
+   * the beam is at the beginning of each stage.
+   */
+  void update_beam_centers(double const time);
+
+  /**
+   * Return the bounding box of all the beam centers, enlarged by @p
+   * scaling_factor times the radius and the depth of the beam.
+   */
+  dealii::BoundingBox<dim>
+  get_beam_centers_bounding_box(double const scaling_factor) const;
+
+
   /**
    * Structure of the physical properties of the beam heat source.
    */
@@ -111,6 +154,32 @@ protected:
    * The scan path for the heat source.
    */
   ScanPath _scan_path;
+
+  /**
+   * Flag is true if the source is averaged over the time window.
+   */
+  bool _time_averaged = false;
+
+  /**
+   * Beginning of the time window over which the source is averaged.
+   */
+  double _sweep_start_time = 0.;
+
+  /**
+   * Duration of the time window over which the source is averaged.
+   */
+  double _sweep_duration = 0.;
+
+  /**
+   * Positions of the beam center used to evaluate the source.
+   */
+  std::vector<dealii::Point<3>> _beam_centers;
+
+  /**
+   * Power modifiers associated with the positions in _beam_centers, including
+   * the quadrature weights.
+   */
+  std::vector<double> _power_modifiers;
 };
 
 template <int dim>
@@ -132,6 +201,89 @@ inline void HeatSource<dim>::set_beam_properties(
   _beam.set_from_database(database);
 }
 
+template <int dim>
+inline bool HeatSource<dim>::is_time_averaged() const
+{
+  return _time_averaged;
+}
+
+template <int dim>
+inline void HeatSource<dim>::set_sweep_window(double const start_time,
+                                              double const duration)
+{
+  _sweep_start_time = start_time;
+  _sweep_duration = duration;
+}
+
+template <int dim>
+void HeatSource<dim>::update_beam_centers(double const time)
+{
+  _beam_centers.clear();
+  _power_modifiers.clear();
+
+  if (_time_averaged && (_sweep_duration > 0.))
+  {
+    double const end_time = _sweep_start_time + _sweep_duration;
+    double const path_length =
+        _scan_path.get_path_length(_sweep_start_time, end_time);
+    unsigned int const n_intervals = std::max(
+        1u, static_cast<unsigned int>(
+                std::ceil(path_length / (0.5 * _beam.radius))));
+    double const interval_duration = _sweep_duration / n_intervals;
+    for (unsigned int i = 0; i < n_intervals; ++i)
+    {
+      double const t = _sweep_start_time + (i + 0.5) * interval_duration;
+      double const power_modifier = _scan_path.get_power_modifier(t);
+      // Skip the positions where the beam is off. This also skips the
+      // positions after the end of the scan path.
+      if (power_modifier != 0.)
+      {
+        _beam_centers.push_back(_scan_path.value(t));
+        _power_modifiers.push_back(power_modifier / n_intervals);
+      }
+    }
+  }
+
+  if (_beam_centers.empty())
+  {
+    _beam_centers.push_back(_scan_path.value(time));
+    _power_modifiers.push_back(_scan_path.get_power_modifier(time));
+  }
+}
+
+template <int dim>
+dealii::BoundingBox<dim> HeatSource<dim>::get_beam_centers_bounding_box(
+    double const scaling_factor) const
+{
+  dealii::Point<3> min_point = _beam_centers[0];
+  dealii::Point<3> max_point = _beam_centers[0];
+  for (auto const &center : _beam_centers)
+  {
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      min_point[d] = std::min(min_point[d], center[d]);
+      max_point[d] = std::max(max_point[d], center[d]);
+    }
+  }
+
+  if constexpr (dim == 2)
+  {
+    return {{{min_point[axis<dim>::x] - scaling_factor * _beam.radius,
+              min_point[axis<dim>::z] - scaling_factor * _beam.depth},
+             {max_point[axis<dim>::x] + scaling_factor * _beam.radius,
+              max_point[axis<dim>::z]}}};
+  }
+  else
+  {
+    return {{{min_point[axis<dim>::x] - scaling_factor * _beam.radius,
+              min_point[axis<dim>::y] - scaling_factor * _beam.radius,
+              min_point[axis<dim>::z] - scaling_factor * _beam.depth},
+             {max_point[axis<dim>::x] + scaling_factor * _beam.radius,
+              max_point[axis<dim>::y] + scaling_factor * _beam.radius,
+              max_point[axis<dim>::z]}}};
+  }
+}
+
 } // namespace adamantine
 
 #endif
@@ -6,13 +6,48 @@
 #include <instantiation.hh>
 #include <utils.hh>
 
+#include <memory>
+#include <type_traits>
+
 namespace adamantine
 {
 template <typename MemorySpaceType>
 ImplicitOperator<MemorySpaceType>::ImplicitOperator(
-    std::shared_ptr<Operator<MemorySpaceType>> explicit_operator, bool jfnk)
-    : _jfnk(jfnk), _explicit_operator(explicit_operator)
+    std::shared_ptr<Operator<MemorySpaceType>> explicit_operator, bool jfnk,
+    bool symmetric)
+    : _jfnk(jfnk), _symmetric(symmetric), _explicit_operator(explicit_operator)
+{
+}
+
+template <typename MemorySpaceType>
+void ImplicitOperator<MemorySpaceType>::set_inverse_mass_matrix(
+    std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
+        inverse_mass_matrix)
 {
+  _inverse_mass_matrix = inverse_mass_matrix;
+  if (!_symmetric)
+    return;
+
+  // The reciprocal is not a vector operation so the mass matrix is computed on
+  // the host.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      mass_matrix_host(_inverse_mass_matrix->get_partitioner());
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+    mass_matrix_host = *_inverse_mass_matrix;
+  else
+    mass_matrix_host.import_elements(*_inverse_mass_matrix,
+                                     dealii::VectorOperation::insert);
+  for (unsigned int i = 0; i < mass_matrix_host.locally_owned_size(); ++i)
+    mass_matrix_host.local_element(i) = 1. / mass_matrix_host.local_element(i);
+
+  using VectorType = dealii::LA::distributed::Vector<double, MemorySpaceType>;
+  _mass_matrix =
+      std::make_shared<VectorType>(_inverse_mass_matrix->get_partitioner());
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+    *_mass_matrix = mass_matrix_host;
+  else
+    _mass_matrix->import_elements(mass_matrix_host,
+                                  dealii::VectorOperation::insert);
 }
 
 template <typename MemorySpaceType>
@@ -37,6 +72,8 @@ void ImplicitOperator<MemorySpaceType>::vmult(
   dst.scale(*_inverse_mass_matrix);
   dst *= -_tau;
   dst += src;
+  if (_symmetric)
+    dst.scale(*_mass_matrix);
 }
 
 template <typename MemorySpaceType>
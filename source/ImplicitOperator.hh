@@ -12,14 +12,17 @@ namespace adamantine
 /**
  * This class uses an operator \f$F\f$ and creates an operator
  * \f$I-\tau M^{-1} \frac{F}{dy}\f$. This operator is then inverted when using
- * an implicit time stepping scheme.
+ * an implicit time stepping scheme. If the symmetric form is used, the operator
+ * is multiplied by the mass matrix, i.e., it becomes \f$M-\tau \frac{F}{dy}\f$
+ * which is symmetric positive definite for the heat equation and can be
+ * inverted using the conjugate gradient method.
  */
 template <typename MemorySpaceType>
 class ImplicitOperator : public Operator<MemorySpaceType>
 {
 public:
   ImplicitOperator(std::shared_ptr<Operator<MemorySpaceType>> explicit_operator,
-                   bool jfnk);
+                   bool jfnk, bool symmetric = false);
 
   dealii::types::global_dof_index m() const override;
 
@@ -53,12 +56,23 @@ public:
       std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
           inverse_mass_matrix);
 
+  /**
+   * Return a shared pointer to the mass matrix. The mass matrix is only
+   * available when the symmetric form is used.
+   */
+  std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
+  get_mass_matrix() const;
+
 private:
   /**
    * Flag to switch between Jacobian-Free Newton Krylov method and exact
    * Jacobian method.
    */
   bool _jfnk;
+  /**
+   * Flag is true if the operator is multiplied by the mass matrix.
+   */
+  bool _symmetric;
   /**
    * Parameter of the Runge-Kutta method used.
    */
@@ -68,6 +82,12 @@ private:
    */
   std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
       _inverse_mass_matrix;
+  /**
+   * Shared pointer of the mass matrix. The pointer is null if the symmetric
+   * form is not used.
+   */
+  std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
+      _mass_matrix;
   /**
    * Shared pointer of the operator \f$F\f$.
    */
@@ -95,11 +115,10 @@ inline void ImplicitOperator<MemorySpaceType>::set_tau(double tau)
 }
 
 template <typename MemorySpaceType>
-inline void ImplicitOperator<MemorySpaceType>::set_inverse_mass_matrix(
-    std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
-        inverse_mass_matrix)
+inline std::shared_ptr<dealii::LA::distributed::Vector<double, MemorySpaceType>>
+ImplicitOperator<MemorySpaceType>::get_mass_matrix() const
 {
-  _inverse_mass_matrix = inverse_mass_matrix;
+  return _mass_matrix;
 }
 } // namespace adamantine
 
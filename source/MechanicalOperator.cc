@@ -12,6 +12,7 @@
 #include <deal.II/differentiation/ad.h>
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/fe_update_flags.h>
+#include <deal.II/fe/mapping_q1.h>
 #include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/hp/fe_values.h>
@@ -19,6 +20,7 @@
 #include <deal.II/lac/affine_constraints.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/sparsity_tools.h>
+#include <deal.II/matrix_free/evaluation_flags.h>
 #include <deal.II/physics/elasticity/standard_tensors.h>
 
 namespace adamantine
@@ -29,10 +31,11 @@ MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
     MechanicalOperator(MPI_Comm const &communicator,
                        MaterialProperty<dim, p_order, MaterialStates,
                                         MemorySpaceType> &material_properties,
-                       std::vector<double> const &reference_temperatures)
+                       std::vector<double> const &reference_temperatures,
+                       bool matrix_free)
     : _communicator(communicator),
       _reference_temperatures(reference_temperatures),
-      _material_properties(material_properties)
+      _material_properties(material_properties), _matrix_free_mode(matrix_free)
 {
 }
 
@@ -42,12 +45,28 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::reinit(
     dealii::DoFHandler<dim> const &dof_handler,
     dealii::AffineConstraints<double> const &affine_constraints,
     dealii::hp::QCollection<dim> const &q_collection,
-    std::vector<std::shared_ptr<BodyForce<dim>>> const &body_forces)
+    std::vector<std::shared_ptr<BodyForce<dim>>> const &body_forces,
+    unsigned int mesh_generation)
 {
   _dof_handler = &dof_handler;
   _affine_constraints = &affine_constraints;
   _q_collection = &q_collection;
-  assemble_system(body_forces);
+  // The operator, the locally relevant DoFs, and the map between the thermal
+  // and the mechanical cells only depend on the mesh and the DoFs. If they are
+  // unchanged, only the right-hand-side needs to be assembled.
+  if ((mesh_generation == dealii::numbers::invalid_unsigned_int) ||
+      (mesh_generation != _mesh_generation))
+  {
+    _locally_relevant_dofs =
+        dealii::DoFTools::extract_locally_relevant_dofs(*_dof_handler);
+    _cell_indices.clear();
+    if (_matrix_free_mode)
+      setup_matrix_free();
+    else
+      assemble_matrix();
+    _mesh_generation = mesh_generation;
+  }
+  assemble_rhs(body_forces);
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -57,7 +76,13 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::vmult(
     dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
         &src) const
 {
-  _system_matrix.vmult(dst, src);
+  if (_matrix_free_mode)
+  {
+    dst = 0.;
+    vmult_add(dst, src);
+  }
+  else
+    _system_matrix.vmult(dst, src);
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -67,7 +92,14 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::Tvmult(
     dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
         &src) const
 {
-  _system_matrix.Tvmult(dst, src);
+  if (_matrix_free_mode)
+  {
+    // The operator is symmetric
+    dst = 0.;
+    vmult_add(dst, src);
+  }
+  else
+    _system_matrix.Tvmult(dst, src);
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -78,7 +110,18 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
         dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
             &src) const
 {
-  _system_matrix.vmult_add(dst, src);
+  if (_matrix_free_mode)
+  {
+    _matrix_free.cell_loop(&MechanicalOperator::cell_local_apply, this, dst,
+                           src);
+    // Because cell_loop resolves the constraints, the constrained dofs are not
+    // called they stay at zero. Thus, we need to force the value on the
+    // constrained dofs by hand.
+    for (auto const dof : _matrix_free.get_constrained_dofs())
+      dst.local_element(dof) += src.local_element(dof);
+  }
+  else
+    _system_matrix.vmult_add(dst, src);
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -89,7 +132,10 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
         dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
             &src) const
 {
-  _system_matrix.Tvmult_add(dst, src);
+  if (_matrix_free_mode)
+    vmult_add(dst, src);
+  else
+    _system_matrix.Tvmult_add(dst, src);
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -109,19 +155,16 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
 template <int dim, int p_order, typename MaterialStates,
           typename MemorySpaceType>
 void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
-    assemble_system(
-        std::vector<std::shared_ptr<BodyForce<dim>>> const &body_forces)
+    assemble_matrix()
 {
   // Create the sparsity pattern. Since we use a Trilinos matrix we don't need
   // the sparsity pattern to outlive the sparse matrix.
   auto locally_owned_dofs = _dof_handler->locally_owned_dofs();
-  auto locally_relevant_dofs =
-      dealii::DoFTools::extract_locally_relevant_dofs(*_dof_handler);
-  dealii::DynamicSparsityPattern dsp(locally_relevant_dofs);
+  dealii::DynamicSparsityPattern dsp(_locally_relevant_dofs);
   dealii::DoFTools::make_sparsity_pattern(*_dof_handler, dsp,
                                           *_affine_constraints, false);
   dealii::SparsityTools::distribute_sparsity_pattern(
-      dsp, locally_owned_dofs, _communicator, locally_relevant_dofs);
+      dsp, locally_owned_dofs, _communicator, _locally_relevant_dofs);
 
   _system_matrix.reinit(locally_owned_dofs, dsp, _communicator);
 
@@ -136,7 +179,7 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
   std::vector<dealii::types::global_dof_index> local_dof_indices(dofs_per_cell);
 
   // Loop over the locally owned cells that are not FE_Nothing and assemble the
-  // sparse matrix and the right-hand-side
+  // sparse matrix
   for (auto const &cell : _dof_handler->active_cell_iterators() |
                               dealii::IteratorFilters::ActiveFEIndexEqualTo(
                                   0, /* locally owned */ true))
@@ -181,9 +224,161 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
         cell_matrix, local_dof_indices, _system_matrix);
   }
 
+  _system_matrix.compress(dealii::VectorOperation::add);
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MechanicalOperator<dim, p_order, MaterialStates,
+                        MemorySpaceType>::setup_matrix_free()
+{
+  typename dealii::MatrixFree<dim, double>::AdditionalData matrix_free_data;
+  matrix_free_data.tasks_parallel_scheme =
+      dealii::MatrixFree<dim, double>::AdditionalData::partition_color;
+  matrix_free_data.mapping_update_flags =
+      dealii::update_gradients | dealii::update_JxW_values;
+  _matrix_free.reinit(dealii::StaticMappingQ1<dim>::mapping, *_dof_handler,
+                      *_affine_constraints, *_q_collection, matrix_free_data);
+
+  // The Lamé parameters are constant on each cell, so we evaluate them once
+  // per cell batch instead of at every matrix-vector multiplication.
+  unsigned int const n_cells = _matrix_free.n_cell_batches();
+  _lambda.resize(n_cells);
+  _mu.resize(n_cells);
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+  {
+    _lambda[cell] = 0.;
+    _mu[cell] = 0.;
+    for (unsigned int i = 0;
+         i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+    {
+      auto const dof_cell = _matrix_free.get_cell_iterator(cell, i);
+      if (dof_cell->active_fe_index() == 0)
+      {
+        typename dealii::Triangulation<dim>::active_cell_iterator const
+            cell_it = dof_cell;
+        _lambda[cell][i] = _material_properties.get_mechanical_property(
+            cell_it, StateProperty::lame_first_parameter);
+        _mu[cell][i] = _material_properties.get_mechanical_property(
+            cell_it, StateProperty::lame_second_parameter);
+      }
+    }
+  }
+
+  // Compute the inverse of the diagonal
+  auto &inverse_diagonal = _inverse_diagonal.get_vector();
+  _matrix_free.initialize_dof_vector(inverse_diagonal);
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dummy;
+  _matrix_free.cell_loop(&MechanicalOperator::cell_local_diagonal, this,
+                         inverse_diagonal, dummy);
+  for (auto const dof : _matrix_free.get_constrained_dofs())
+    inverse_diagonal.local_element(dof) = 1.;
+  for (auto &value : inverse_diagonal)
+    value = (std::abs(value) > 0.) ? 1. / value : 1.;
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
+    apply_elasticity_tensor(
+        dealii::FEEvaluation<dim, -1, 0, dim, double> &fe_eval,
+        unsigned int cell) const
+{
+  auto const lambda = _lambda[cell];
+  auto const two_mu = 2. * _mu[cell];
+  for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+  {
+    // sigma = lambda tr(epsilon) I + 2 mu epsilon
+    auto stress = fe_eval.get_symmetric_gradient(q);
+    auto const lambda_trace = lambda * dealii::trace(stress);
+    stress *= two_mu;
+    for (unsigned int d = 0; d < dim; ++d)
+      stress[d][d] += lambda_trace;
+    fe_eval.submit_symmetric_gradient(stress, q);
+  }
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
+    cell_local_apply(
+        dealii::MatrixFree<dim, double> const &data,
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> &dst,
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+            &src,
+        std::pair<unsigned int, unsigned int> const &cell_range) const
+{
+  // Get the subrange of cells associated with the fe index 0
+  std::pair<unsigned int, unsigned int> cell_subrange =
+      data.create_cell_subrange_hp_by_index(cell_range, 0);
+  dealii::FEEvaluation<dim, -1, 0, dim, double> fe_eval(data);
+
+  for (unsigned int cell = cell_subrange.first; cell < cell_subrange.second;
+       ++cell)
+  {
+    fe_eval.reinit(cell);
+    fe_eval.gather_evaluate(src, dealii::EvaluationFlags::gradients);
+    apply_elasticity_tensor(fe_eval, cell);
+    fe_eval.integrate_scatter(dealii::EvaluationFlags::gradients, dst);
+  }
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
+    cell_local_diagonal(
+        dealii::MatrixFree<dim, double> const &data,
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> &dst,
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+            & /*src*/,
+        std::pair<unsigned int, unsigned int> const &cell_range) const
+{
+  // Get the subrange of cells associated with the fe index 0
+  std::pair<unsigned int, unsigned int> cell_subrange =
+      data.create_cell_subrange_hp_by_index(cell_range, 0);
+  dealii::FEEvaluation<dim, -1, 0, dim, double> fe_eval(data);
+  dealii::AlignedVector<dealii::VectorizedArray<double>> diagonal(
+      fe_eval.dofs_per_cell);
+
+  for (unsigned int cell = cell_subrange.first; cell < cell_subrange.second;
+       ++cell)
+  {
+    fe_eval.reinit(cell);
+    // Apply the local operator to each unit vector and keep the diagonal entry
+    for (unsigned int i = 0; i < fe_eval.dofs_per_cell; ++i)
+    {
+      for (unsigned int j = 0; j < fe_eval.dofs_per_cell; ++j)
+        fe_eval.begin_dof_values()[j] = 0.;
+      fe_eval.begin_dof_values()[i] = 1.;
+      fe_eval.evaluate(dealii::EvaluationFlags::gradients);
+      apply_elasticity_tensor(fe_eval, cell);
+      fe_eval.integrate(dealii::EvaluationFlags::gradients);
+      diagonal[i] = fe_eval.begin_dof_values()[i];
+    }
+    for (unsigned int i = 0; i < fe_eval.dofs_per_cell; ++i)
+      fe_eval.begin_dof_values()[i] = diagonal[i];
+    fe_eval.distribute_local_to_global(dst);
+  }
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
+    assemble_rhs(
+        std::vector<std::shared_ptr<BodyForce<dim>>> const &body_forces)
+{
+  auto locally_owned_dofs = _dof_handler->locally_owned_dofs();
+  dealii::hp::FEValues<dim> displacement_hp_fe_values(
+      _dof_handler->get_fe_collection(), *_q_collection,
+      dealii::update_values | dealii::update_gradients |
+          dealii::update_JxW_values);
+  unsigned int const dofs_per_cell =
+      _dof_handler->get_fe_collection().max_dofs_per_cell();
+  std::vector<dealii::types::global_dof_index> local_dof_indices(dofs_per_cell);
+
   // Assemble the rhs
   dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
-      assembled_rhs(locally_owned_dofs, locally_relevant_dofs, _communicator);
+      assembled_rhs(locally_owned_dofs, _locally_relevant_dofs, _communicator);
   dealii::Vector<double> cell_rhs(dofs_per_cell);
   // If the list of reference temperatures is non-empty, we solve the
   // thermo-elastic problem.
@@ -201,28 +396,31 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
     // equal to zero. We need to translate these indices to be used with the
     // mechanical DoFHandler. This is simplified by the fact that both the
     // thermal and the mechanical simulation use the same Triangulation and have
-    // the same cells locally owned.
+    // the same cells locally owned. The map only depends on the mesh, so it is
+    // only rebuilt when the mesh has changed.
     auto &triangulation = _dof_handler->get_triangulation();
-    unsigned int const n_local_active_cells = triangulation.n_active_cells();
-    std::vector<unsigned int> cell_indices(n_local_active_cells);
-    unsigned int cell_index = 0;
-    for (auto const &tria_cell :
-         triangulation.active_cell_iterators() |
-             dealii::IteratorFilters::LocallyOwnedCell())
+    if (_cell_indices.empty())
     {
-      dealii::TriaIterator<dealii::DoFCellAccessor<dim, dim, false>>
-          temperature_cell(&triangulation, tria_cell->level(),
-                           tria_cell->index(), _thermal_dof_handler);
-      if (temperature_cell->active_fe_index() == 0)
+      _cell_indices.resize(triangulation.n_active_cells());
+      unsigned int cell_index = 0;
+      for (auto const &tria_cell :
+           triangulation.active_cell_iterators() |
+               dealii::IteratorFilters::LocallyOwnedCell())
       {
         dealii::TriaIterator<dealii::DoFCellAccessor<dim, dim, false>>
-            displacement_cell(&triangulation, tria_cell->level(),
-                              tria_cell->index(), _dof_handler);
-        if (displacement_cell->active_fe_index() == 0)
+            temperature_cell(&triangulation, tria_cell->level(),
+                             tria_cell->index(), _thermal_dof_handler);
+        if (temperature_cell->active_fe_index() == 0)
         {
-          cell_indices[displacement_cell->active_cell_index()] = cell_index;
+          dealii::TriaIterator<dealii::DoFCellAccessor<dim, dim, false>>
+              displacement_cell(&triangulation, tria_cell->level(),
+                                tria_cell->index(), _dof_handler);
+          if (displacement_cell->active_fe_index() == 0)
+          {
+            _cell_indices[displacement_cell->active_cell_index()] = cell_index;
+          }
+          ++cell_index;
         }
-        ++cell_index;
       }
     }
 
@@ -246,7 +444,7 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
       // is not in the unmelted substrate, the reference temperature depends
       // on the material.
       double reference_temperature =
-          _has_melted[cell_indices[cell->active_cell_index()]]
+          _has_melted[_cell_indices[cell->active_cell_index()]]
               ? _reference_temperatures[temperature_cell->material_id()]
               : initial_temperature;
 
@@ -326,12 +524,19 @@ void MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
     }
   }
 
-  _system_matrix.compress(dealii::VectorOperation::add);
   assembled_rhs.compress(dealii::VectorOperation::add);
 
   // When solving the system, we don't want ghost entries
-  _system_rhs.reinit(_dof_handler->locally_owned_dofs(), _communicator);
-  _system_rhs = assembled_rhs;
+  if (_matrix_free_mode)
+  {
+    _matrix_free.initialize_dof_vector(_system_rhs);
+    _system_rhs.copy_locally_owned_data_from(assembled_rhs);
+  }
+  else
+  {
+    _system_rhs.reinit(_dof_handler->locally_owned_dofs(), _communicator);
+    _system_rhs = assembled_rhs;
+  }
 }
 } // namespace adamantine
 
@@ -14,8 +14,11 @@
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/hp/q_collection.h>
 #include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/diagonal_matrix.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
 
 #include <boost/property_tree/ptree.hpp>
 
@@ -25,6 +28,8 @@ namespace adamantine
  * This class is the operator associated with the solid mechanics equations.
  * The class is templated on the MemorySpace because it use MaterialProperty
  * which itself is templated on the MemorySpace but the operator is CPU only.
+ * The operator is either assembled in a Trilinos sparse matrix or applied
+ * using matrix-free.
  */
 template <int dim, int p_order, typename MaterialStates,
           typename MemorySpaceType>
@@ -33,18 +38,30 @@ class MechanicalOperator : public Operator<dealii::MemorySpace::Host>
 public:
   /**
    * Constructor. If the initial temperature is negative, the simulation is
-   * mechanical only. Otherwise, we solve a thermo-mechanical problem.
+   * mechanical only. Otherwise, we solve a thermo-mechanical problem. If @p
+   * matrix_free is true, the sparse matrix is not assembled and the operator
+   * is applied using matrix-free.
    */
   MechanicalOperator(MPI_Comm const &communicator,
                      MaterialProperty<dim, p_order, MaterialStates,
                                       MemorySpaceType> &material_properties,
-                     std::vector<double> const &reference_temperatures);
+                     std::vector<double> const &reference_temperatures,
+                     bool matrix_free = false);
 
+  /**
+   * Assemble the operator and the right-hand-side. @p mesh_generation
+   * identifies the active mesh and the DoFs. If it is equal to the value
+   * given during the previous call, only the right-hand-side is assembled:
+   * the operator and the map between the thermal and the mechanical cells
+   * are reused, so that preconditioners built from the matrix stay valid.
+   */
   void reinit(dealii::DoFHandler<dim> const &dof_handler,
               dealii::AffineConstraints<double> const &affine_constraints,
               dealii::hp::QCollection<dim> const &quad,
               std::vector<std::shared_ptr<BodyForce<dim>>> const &body_forces =
-                  std::vector<std::shared_ptr<BodyForce<dim>>>());
+                  std::vector<std::shared_ptr<BodyForce<dim>>>(),
+              unsigned int mesh_generation =
+                  dealii::numbers::invalid_unsigned_int);
 
   dealii::types::global_dof_index m() const override;
 
@@ -83,15 +100,74 @@ public:
 
   dealii::TrilinosWrappers::SparseMatrix const &system_matrix() const;
 
+  /**
+   * Return true if the operator is applied using matrix-free.
+   */
+  bool is_matrix_free() const;
+
+  /**
+   * Initialize a vector compatible with the matrix-free operator.
+   */
+  void initialize_dof_vector(
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+          &vector) const;
+
+  /**
+   * Return the inverse of the diagonal of the matrix-free operator. It is used
+   * as a Jacobi preconditioner.
+   */
+  dealii::DiagonalMatrix<
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>> const
+      &inverse_diagonal() const;
+
 private:
   /**
-   * Assemble the matrix and the right-hand-side.
+   * Assemble the sparse matrix.
    * @note The 2D case does not represent any physical model but it is
    * convenient for testing.
    */
-  void assemble_system(
+  void assemble_matrix();
+
+  /**
+   * Assemble the right-hand-side.
+   */
+  void assemble_rhs(
       std::vector<std::shared_ptr<BodyForce<dim>>> const &body_forces);
 
+  /**
+   * Initialize the MatrixFree object, the Lamé parameters of each cell batch,
+   * and the inverse of the diagonal.
+   */
+  void setup_matrix_free();
+
+  /**
+   * Multiply the symmetric gradient by the elasticity tensor at each
+   * quadrature point of the cell batch @p cell.
+   */
+  void apply_elasticity_tensor(
+      dealii::FEEvaluation<dim, -1, 0, dim, double> &fe_eval,
+      unsigned int cell) const;
+
+  /**
+   * Apply the operator on a range of cells.
+   */
+  void cell_local_apply(
+      dealii::MatrixFree<dim, double> const &data,
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> &dst,
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+          &src,
+      std::pair<unsigned int, unsigned int> const &cell_range) const;
+
+  /**
+   * Compute the diagonal of the operator on a range of cells.
+   */
+  void cell_local_diagonal(
+      dealii::MatrixFree<dim, double> const &data,
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> &dst,
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+          &src,
+      std::pair<unsigned int, unsigned int> const &cell_range) const;
+
   /**
    * MPI communicator.
    */
@@ -131,6 +207,41 @@ private:
    * Matrix of the mechanical problem.
    */
   dealii::TrilinosWrappers::SparseMatrix _system_matrix;
+  /**
+   * Generation of the mesh used to build the operator.
+   */
+  unsigned int _mesh_generation = dealii::numbers::invalid_unsigned_int;
+  /**
+   * Locally relevant DoFs of the mechanical DoFHandler.
+   */
+  dealii::IndexSet _locally_relevant_dofs;
+  /**
+   * Map between the active cell index of the mechanical cells and the index
+   * of the cell in _has_melted.
+   */
+  std::vector<unsigned int> _cell_indices;
+  /**
+   * Flag is true if the operator is applied using matrix-free.
+   */
+  bool _matrix_free_mode;
+  /**
+   * Underlying MatrixFree object.
+   */
+  dealii::MatrixFree<dim, double> _matrix_free;
+  /**
+   * First Lamé parameter of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _lambda;
+  /**
+   * Second Lamé parameter of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _mu;
+  /**
+   * Inverse of the diagonal of the matrix-free operator.
+   */
+  dealii::DiagonalMatrix<
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
+      _inverse_diagonal;
   /**
    * Temperature of the material.
    */
@@ -149,7 +260,7 @@ template <int dim, int p_order, typename MaterialStates,
 inline dealii::types::global_dof_index
 MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::m() const
 {
-  return _system_matrix.m();
+  return _matrix_free_mode ? _dof_handler->n_dofs() : _system_matrix.m();
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -157,7 +268,7 @@ template <int dim, int p_order, typename MaterialStates,
 inline dealii::types::global_dof_index
 MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::n() const
 {
-  return _system_matrix.n();
+  return _matrix_free_mode ? _dof_handler->n_dofs() : _system_matrix.n();
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -177,5 +288,34 @@ MechanicalOperator<dim, p_order, MaterialStates,
 {
   return _system_matrix;
 }
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+inline bool MechanicalOperator<dim, p_order, MaterialStates,
+                               MemorySpaceType>::is_matrix_free() const
+{
+  return _matrix_free_mode;
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+inline void
+MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>::
+    initialize_dof_vector(
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+            &vector) const
+{
+  _matrix_free.initialize_dof_vector(vector);
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+inline dealii::DiagonalMatrix<
+    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>> const &
+MechanicalOperator<dim, p_order, MaterialStates,
+                   MemorySpaceType>::inverse_diagonal() const
+{
+  return _inverse_diagonal;
+}
 } // namespace adamantine
 #endif
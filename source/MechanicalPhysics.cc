@@ -2,20 +2,30 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
  */
 
+#include <CellDataBuffer.hh>
 #include <MechanicalPhysics.hh>
 #include <instantiation.hh>
 
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/symmetric_tensor.h>
 #include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/fe_nothing.h>
 #include <deal.II/fe/fe_q.h>
-#include <deal.II/hp/fe_values.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/solver_cg.h>
 #include <deal.II/lac/trilinos_precondition.h>
+#include <deal.II/matrix_free/evaluation_flags.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
 #include <deal.II/numerics/vector_tools.h>
 
+#include <array>
+#include <limits>
+#include <utility>
+
 namespace adamantine
 {
 template <int dim, int p_order, typename MaterialStates,
@@ -25,13 +35,11 @@ MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
                       unsigned int const fe_degree, Geometry<dim> &geometry,
                       MaterialProperty<dim, p_order, MaterialStates,
                                        MemorySpaceType> &material_properties,
-                      std::vector<double> const &reference_temperatures)
+                      std::vector<double> const &reference_temperatures,
+                      bool matrix_free, std::string const &preconditioner)
     : _geometry(geometry), _material_properties(material_properties),
       _dof_handler(_geometry.get_triangulation()),
-      _solution_transfer(_dof_handler),
-      _cell_data_transfer(
-          dynamic_cast<const dealii::parallel::distributed::Triangulation<dim>
-                           &>(_dof_handler.get_triangulation()))
+      _solution_transfer(_dof_handler)
 {
   // Create the FECollection
   _fe_collection.push_back(
@@ -62,34 +70,49 @@ MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
     }
   }
 
+  // Choose the preconditioner
+  _preconditioner_type =
+      preconditioner.empty() ? (matrix_free ? "jacobi" : "ssor")
+                             : preconditioner;
+  if (matrix_free)
+  {
+    ASSERT_THROW((_preconditioner_type == "jacobi") ||
+                     (_preconditioner_type == "chebyshev"),
+                 "With matrix-free, the preconditioner must be jacobi or "
+                 "chebyshev.");
+  }
+  else
+  {
+    ASSERT_THROW((_preconditioner_type == "ssor") ||
+                     (_preconditioner_type == "amg"),
+                 "With a sparse matrix, the preconditioner must be ssor or "
+                 "amg.");
+  }
+
   // Create the mechanical operator
   _mechanical_operator = std::make_unique<
       MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>>(
-      communicator, _material_properties, reference_temperatures);
+      communicator, _material_properties, reference_temperatures,
+      matrix_free);
 
   // Create the data used to compute the stress tensor
   unsigned int const n_quad_pts = _q_collection.max_n_quadrature_points();
-  _plastic_internal_variable.reserve(n_active_cells);
-
+  _plasticity_state.reinit(n_active_cells, n_quad_pts);
   for (auto const &cell : _dof_handler.active_cell_iterators())
   {
     if (cell->is_locally_owned())
     {
       auto elastic_limit = _material_properties.get_mechanical_property(
           cell, StateProperty::elastic_limit);
-      _plastic_internal_variable.emplace_back(
-          std::vector<double>(n_quad_pts, elastic_limit));
+      _plasticity_state.reset_cell(cell->active_cell_index(), elastic_limit);
     }
     else
     {
-      _plastic_internal_variable.emplace_back(std::vector<double>(
-          n_quad_pts, std::numeric_limits<double>::signaling_NaN()));
+      _plasticity_state.reset_cell(
+          cell->active_cell_index(),
+          std::numeric_limits<double>::signaling_NaN());
     }
   }
-  _stress.resize(n_active_cells,
-                 std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
-  _back_stress.resize(n_active_cells,
-                      std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -97,25 +120,31 @@ template <int dim, int p_order, typename MaterialStates,
 void MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
     setup_dofs(std::vector<std::shared_ptr<BodyForce<dim>>> const &body_forces)
 {
-  _dof_handler.distribute_dofs(_fe_collection);
-  dealii::IndexSet locally_relevant_dofs;
-  dealii::DoFTools::extract_locally_relevant_dofs(_dof_handler,
-                                                  locally_relevant_dofs);
-  _affine_constraints.clear();
-  _affine_constraints.reinit(locally_relevant_dofs);
-  dealii::DoFTools::make_hanging_node_constraints(_dof_handler,
-                                                  _affine_constraints);
-  // FIXME For now this is only a Dirichlet boundary condition. It is also
-  // manually set to be what is the bottom face for a dealii hyper-rectangle. We
-  // need to decide how we want to expose BC control to the user more generally
-  // (including for user-supplied meshes).
-  dealii::VectorTools::interpolate_boundary_values(
-      _dof_handler, 4, dealii::Functions::ZeroFunction<dim>(dim),
-      _affine_constraints);
-  _affine_constraints.close();
+  // The DoFs and the constraints only depend on the mesh. If the mesh has not
+  // changed since the last call, only the right-hand-side is reassembled.
+  if (_dofs_mesh_generation != _mesh_generation)
+  {
+    _dof_handler.distribute_dofs(_fe_collection);
+    dealii::IndexSet locally_relevant_dofs;
+    dealii::DoFTools::extract_locally_relevant_dofs(_dof_handler,
+                                                    locally_relevant_dofs);
+    _affine_constraints.clear();
+    _affine_constraints.reinit(locally_relevant_dofs);
+    dealii::DoFTools::make_hanging_node_constraints(_dof_handler,
+                                                    _affine_constraints);
+    // FIXME For now this is only a Dirichlet boundary condition. It is also
+    // manually set to be what is the bottom face for a dealii hyper-rectangle.
+    // We need to decide how we want to expose BC control to the user more
+    // generally (including for user-supplied meshes).
+    dealii::VectorTools::interpolate_boundary_values(
+        _dof_handler, 4, dealii::Functions::ZeroFunction<dim>(dim),
+        _affine_constraints);
+    _affine_constraints.close();
+    _dofs_mesh_generation = _mesh_generation;
+  }
 
   _mechanical_operator->reinit(_dof_handler, _affine_constraints, _q_collection,
-                               body_forces);
+                               body_forces, _mesh_generation);
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -125,51 +154,8 @@ void MechanicalPhysics<dim, p_order, MaterialStates,
 {
   _old_displacement.update_ghost_values();
   _solution_transfer.prepare_for_coarsening_and_refinement(_old_displacement);
-
-  _data_to_transfer.clear();
-  unsigned int const n_quad_pts = _q_collection.max_n_quadrature_points();
-  unsigned int const n_doubles_per_quad_plastic = 1;
-  unsigned int const n_doubles_per_quad_stress =
-      dealii::SymmetricTensor<2, dim>::n_independent_components;
-
-  unsigned int const n_doubles_per_quad =
-      n_doubles_per_quad_plastic + n_doubles_per_quad_stress * 2;
-  std::vector<double> dummy_cell_data(n_quad_pts * n_doubles_per_quad,
-                                      std::numeric_limits<double>::infinity());
-
-  unsigned int cell_id = 0;
-  for (auto const &cell : _dof_handler.active_cell_iterators())
-  {
-    if (cell->is_locally_owned())
-    {
-      std::vector<double> cell_data(n_quad_pts * n_doubles_per_quad);
-      unsigned int const stress_offset =
-          n_quad_pts * n_doubles_per_quad_plastic;
-      unsigned int const back_stress_offset =
-          n_quad_pts * (n_doubles_per_quad_plastic + n_doubles_per_quad_stress);
-
-      std::copy(_plastic_internal_variable[cell_id].begin(),
-                _plastic_internal_variable[cell_id].end(), cell_data.begin());
-
-      for (unsigned int quad = 0; quad < n_quad_pts; ++quad)
-      {
-        for (unsigned int i = 0; i < n_doubles_per_quad_stress; ++i)
-        {
-          cell_data[stress_offset + quad * n_doubles_per_quad_stress + i] =
-              _stress[cell_id][quad].access_raw_entry(i);
-          cell_data[back_stress_offset + quad * n_doubles_per_quad_stress + i] =
-              _back_stress[cell_id][quad].access_raw_entry(i);
-        }
-      }
-      _data_to_transfer.push_back(std::move(cell_data));
-    }
-    else
-    {
-      _data_to_transfer.push_back(dummy_cell_data);
-    }
-    ++cell_id;
-  }
-  _cell_data_transfer.prepare_for_coarsening_and_refinement(_data_to_transfer);
+  _plasticity_state.prepare_for_coarsening_and_refinement(
+      _geometry.get_triangulation());
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -177,6 +163,7 @@ template <int dim, int p_order, typename MaterialStates,
 void MechanicalPhysics<dim, p_order, MaterialStates,
                        MemorySpaceType>::complete_transfer_mpi()
 {
+  ++_mesh_generation;
   _dof_handler.distribute_dofs(_fe_collection);
 
   const dealii::IndexSet locally_relevant_dofs =
@@ -185,56 +172,7 @@ void MechanicalPhysics<dim, p_order, MaterialStates,
                            locally_relevant_dofs,
                            _dof_handler.get_communicator());
   _solution_transfer.interpolate(_old_displacement);
-
-  auto n_active_cells = _dof_handler.get_triangulation().n_active_cells();
-  unsigned int const n_quad_pts = _q_collection.max_n_quadrature_points();
-
-  _plastic_internal_variable.resize(n_active_cells,
-                                    std::vector<double>(n_quad_pts));
-  _stress.resize(n_active_cells,
-                 std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
-  _back_stress.resize(n_active_cells,
-                      std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
-
-  unsigned int const n_doubles_per_quad_plastic = 1;
-  unsigned int const n_doubles_per_quad_stress =
-      dealii::SymmetricTensor<2, dim>::n_independent_components;
-
-  unsigned int const n_doubles_per_quad =
-      n_doubles_per_quad_plastic + n_doubles_per_quad_stress * 2;
-  std::vector<std::vector<double>> data_to_unpack(
-      n_active_cells, std::vector<double>(n_doubles_per_quad * n_quad_pts));
-  _cell_data_transfer.unpack(data_to_unpack);
-
-  unsigned int cell_id = 0;
-  for (auto const &cell : _dof_handler.active_cell_iterators())
-  {
-    if (cell->is_locally_owned())
-    {
-      unsigned int const stress_offset =
-          n_quad_pts * n_doubles_per_quad_plastic;
-      unsigned int const back_stress_offset =
-          n_quad_pts * (n_doubles_per_quad_plastic + n_doubles_per_quad_stress);
-
-      std::copy(data_to_unpack[cell_id].begin(),
-                data_to_unpack[cell_id].begin() + stress_offset,
-                _plastic_internal_variable[cell_id].begin());
-
-      for (unsigned int quad = 0; quad < n_quad_pts; ++quad)
-      {
-        for (unsigned int i = 0; i < n_doubles_per_quad_stress; ++i)
-        {
-          _stress[cell_id][quad].access_raw_entry(i) =
-              data_to_unpack[cell_id][stress_offset +
-                                      quad * n_doubles_per_quad_stress + i];
-          _back_stress[cell_id][quad].access_raw_entry(i) =
-              data_to_unpack[cell_id][back_stress_offset +
-                                      quad * n_doubles_per_quad_stress + i];
-        }
-      }
-    }
-    ++cell_id;
-  }
+  _plasticity_state.unpack(_geometry.get_triangulation());
 }
 
 template <int dim, int p_order, typename MaterialStates,
@@ -250,58 +188,40 @@ void MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
   _mechanical_operator->update_temperature(thermal_dof_handler, temperature,
                                            has_melted);
   // Update the active fe indices, the plastic variables, and the displacement.
-  unsigned int const n_quad_pts = _q_collection.max_n_quadrature_points();
-  unsigned int cell_id = 0;
-  std::vector<std::vector<double>> saved_old_displacement;
-  std::vector<std::vector<double>> tmp_plastic_internal_variable;
-  std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> tmp_stress;
-  std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> tmp_back_stress;
-  // The number of cells to activate/deactive should be small, so we can
-  // already reserve the memory.
+  CellDataBuffer<dim> saved_old_displacement;
   unsigned int const n_dofs_per_cell = _fe_collection.max_dofs_per_cell();
-  unsigned int const n_old_active_cells = _plastic_internal_variable.size();
   std::vector<dealii::types::global_dof_index> global_dof_indices(
       n_dofs_per_cell);
-  tmp_plastic_internal_variable.reserve(n_old_active_cells);
-  tmp_stress.reserve(n_old_active_cells);
-  tmp_back_stress.reserve(_back_stress.size());
   // First we save _old_displacement if it exists
   if (_old_displacement.size())
   {
     _old_displacement.update_ghost_values();
 
-    std::vector<double> cell_values(n_dofs_per_cell);
-    saved_old_displacement.reserve(n_old_active_cells);
-    for (auto const &cell : _dof_handler.active_cell_iterators())
+    // The cells that do not contain material or that are liquid keep a zero
+    // displacement.
+    saved_old_displacement.reinit(
+        _dof_handler.get_triangulation().n_active_cells(), n_dofs_per_cell);
+    for (auto const &cell :
+         dealii::filter_iterators(_dof_handler.active_cell_iterators(),
+                                  dealii::IteratorFilters::LocallyOwnedCell()))
     {
-      if (cell->is_locally_owned())
+      if (cell->active_fe_index() == 0)
       {
-        auto fe_index = cell->active_fe_index();
-        if (fe_index == 0)
-        {
-          // The cell contains solid material, we need to save the displacement
-          cell->get_dof_indices(global_dof_indices);
-          for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
-          {
-            cell_values[i] = _old_displacement[global_dof_indices[i]];
-          }
-        }
-        else
+        // The cell contains solid material, we need to save the displacement
+        dealii::ArrayView<double> const cell_values =
+            saved_old_displacement[cell->active_cell_index()];
+        cell->get_dof_indices(global_dof_indices);
+        for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
         {
-          // The cell does not contain material or it is liquid. The
-          // displacement is ignored.
-          cell_values.assign(n_dofs_per_cell, 0.);
+          cell_values[i] = _old_displacement[global_dof_indices[i]];
         }
-        saved_old_displacement.push_back(cell_values);
-      }
-      else
-      {
-        saved_old_displacement.push_back(std::vector<double>(n_dofs_per_cell));
       }
     }
   }
 
-  // Now we can update the fe indices and the plastic variables.
+  // Now we can update the fe indices and the plastic variables. The number of
+  // cells does not change, so the plastic variables are updated in place.
+  bool active_cells_changed = false;
   for (auto const &cell : _dof_handler.active_cell_iterators())
   {
     if (cell->is_locally_owned())
@@ -316,59 +236,53 @@ void MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
             &(_dof_handler.get_triangulation()), cell->level(), cell->index(),
             &thermal_dof_handler);
         auto updated_fe_index = thermal_cell.active_fe_index();
-        if (current_fe_index == updated_fe_index)
-        {
-          // The cells is unchanged, we just copy the plastic variables as-is.
-          tmp_plastic_internal_variable.push_back(
-              _plastic_internal_variable[cell_id]);
-          tmp_stress.push_back(_stress[cell_id]);
-          tmp_back_stress.push_back(_back_stress[cell_id]);
-        }
-        else
+        // If the cell is unchanged, the plastic variables are kept as-is.
+        if (current_fe_index != updated_fe_index)
         {
           // The cell has solidified or material has been added. The new cells
           // are initialized with default values.
           auto elastic_limit = _material_properties.get_mechanical_property(
               cell, StateProperty::elastic_limit);
-          tmp_plastic_internal_variable.push_back(
-              std::vector<double>(n_quad_pts, elastic_limit));
-          tmp_stress.push_back(
-              std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
-          tmp_back_stress.push_back(
-              std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
+          _plasticity_state.reset_cell(cell->active_cell_index(),
+                                       elastic_limit);
 
           cell->set_active_fe_index(updated_fe_index);
+          active_cells_changed = true;
         }
       }
       else
       {
         // The cell is liquid. We don't need to save the plastic variables.
+        if (current_fe_index != 1)
+          active_cells_changed = true;
         cell->set_active_fe_index(1);
-        tmp_plastic_internal_variable.push_back(std::vector<double>(
-            n_quad_pts, std::numeric_limits<double>::signaling_NaN()));
-        tmp_stress.push_back(
-            std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
-        tmp_back_stress.push_back(
-            std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
+        _plasticity_state.reset_cell(
+            cell->active_cell_index(),
+            std::numeric_limits<double>::signaling_NaN());
       }
     }
     else
     {
-      tmp_plastic_internal_variable.push_back(std::vector<double>(
-          n_quad_pts, std::numeric_limits<double>::signaling_NaN()));
-      tmp_stress.push_back(
-          std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
-      tmp_back_stress.push_back(
-          std::vector<dealii::SymmetricTensor<2, dim>>(n_quad_pts));
+      _plasticity_state.reset_cell(
+          cell->active_cell_index(),
+          std::numeric_limits<double>::signaling_NaN());
     }
-    ++cell_id;
   }
-  _plastic_internal_variable.swap(tmp_plastic_internal_variable);
-  _stress.swap(tmp_stress);
-  _back_stress.swap(tmp_back_stress);
 
+  // The set of active cells is not necessarily the same on all the
+  // processors.
+  if (dealii::Utilities::MPI::logical_or(active_cells_changed,
+                                         _dof_handler.get_communicator()))
+    ++_mesh_generation;
+
+  bool const dofs_changed = _dofs_mesh_generation != _mesh_generation;
   setup_dofs(body_forces);
 
+  // If the mesh is unchanged, the DoFs are not renumbered and _old_displacement
+  // is still valid.
+  if (!dofs_changed)
+    return;
+
   // Update _old_displacement if necessary
   const dealii::IndexSet locally_relevant_dofs =
       dealii::DoFTools::extract_locally_relevant_dofs(_dof_handler);
@@ -376,41 +290,160 @@ void MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
   _old_displacement.reinit(locally_owned_dofs, locally_relevant_dofs,
                            _dof_handler.get_communicator());
 
-  if (saved_old_displacement.size())
+  if (saved_old_displacement.n_cells())
   {
-    cell_id = 0;
-    for (auto const &cell : _dof_handler.active_cell_iterators())
+    for (auto const &cell :
+         dealii::filter_iterators(_dof_handler.active_cell_iterators(),
+                                  dealii::IteratorFilters::LocallyOwnedCell()))
     {
-      if (cell->is_locally_owned())
+      if (cell->active_fe_index() == 0)
       {
-        auto fe_index = cell->active_fe_index();
-        if (fe_index == 0)
+        dealii::ArrayView<double const> const cell_values =
+            std::as_const(saved_old_displacement)[cell->active_cell_index()];
+        cell->get_dof_indices(global_dof_indices);
+        for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
         {
-          cell->get_dof_indices(global_dof_indices);
-          for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
-          {
-            if (locally_owned_dofs.is_element(global_dof_indices[i]))
-              _old_displacement[global_dof_indices[i]] =
-                  saved_old_displacement[cell_id][i];
-          }
+          if (locally_owned_dofs.is_element(global_dof_indices[i]))
+            _old_displacement[global_dof_indices[i]] = cell_values[i];
         }
       }
-      ++cell_id;
     }
     _old_displacement.compress(dealii::VectorOperation::insert);
   }
 }
 
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MechanicalPhysics<dim, p_order, MaterialStates,
+                       MemorySpaceType>::setup_preconditioner()
+{
+  if (_preconditioner_mesh_generation == _mesh_generation)
+    return;
+
+  if (_preconditioner_type == "amg")
+  {
+    dealii::TrilinosWrappers::PreconditionAMG::AdditionalData amg_data;
+    amg_data.elliptic = true;
+    amg_data.higher_order_elements = _fe_collection[0].degree > 1;
+    amg_data.smoother_sweeps = 2;
+    amg_data.aggregation_threshold = 0.02;
+    amg_data.constant_modes_values = compute_rigid_body_modes();
+    auto amg = std::make_unique<dealii::TrilinosWrappers::PreconditionAMG>();
+    amg->initialize(_mechanical_operator->system_matrix(), amg_data);
+    _sparse_preconditioner = std::move(amg);
+  }
+  else if (_preconditioner_type == "ssor")
+  {
+    auto ssor = std::make_unique<dealii::TrilinosWrappers::PreconditionSSOR>();
+    ssor->initialize(_mechanical_operator->system_matrix());
+    _sparse_preconditioner = std::move(ssor);
+  }
+  else if (_preconditioner_type == "chebyshev")
+  {
+    typename ChebyshevPreconditioner::AdditionalData chebyshev_data;
+    chebyshev_data.preconditioner = std::make_shared<dealii::DiagonalMatrix<
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>>();
+    chebyshev_data.preconditioner->reinit(
+        _mechanical_operator->inverse_diagonal().get_vector());
+    chebyshev_data.degree = 4;
+    chebyshev_data.smoothing_range = 30.;
+    chebyshev_data.eig_cg_n_iterations = 20;
+    _chebyshev_preconditioner = std::make_unique<ChebyshevPreconditioner>();
+    _chebyshev_preconditioner->initialize(*_mechanical_operator,
+                                          chebyshev_data);
+  }
+
+  _preconditioner_mesh_generation = _mesh_generation;
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+std::vector<std::vector<double>>
+MechanicalPhysics<dim, p_order, MaterialStates,
+                  MemorySpaceType>::compute_rigid_body_modes() const
+{
+  // There are dim translations and dim*(dim-1)/2 rotations.
+  unsigned int constexpr n_modes = dim + dim * (dim - 1) / 2;
+  dealii::IndexSet const &locally_owned_dofs =
+      _dof_handler.locally_owned_dofs();
+  std::vector<std::vector<double>> modes(
+      n_modes, std::vector<double>(locally_owned_dofs.n_elements(), 0.));
+
+  auto const &fe = _fe_collection[0];
+  auto const &unit_support_points = fe.get_unit_support_points();
+  std::vector<dealii::types::global_dof_index> local_dof_indices(
+      fe.n_dofs_per_cell());
+  for (auto const &cell : _dof_handler.active_cell_iterators() |
+                              dealii::IteratorFilters::ActiveFEIndexEqualTo(
+                                  0, /* locally owned */ true))
+  {
+    cell->get_dof_indices(local_dof_indices);
+    for (unsigned int i = 0; i < fe.n_dofs_per_cell(); ++i)
+    {
+      if (!locally_owned_dofs.is_element(local_dof_indices[i]))
+        continue;
+
+      auto const index =
+          locally_owned_dofs.index_within_set(local_dof_indices[i]);
+      unsigned int const component = fe.system_to_component_index(i).first;
+      dealii::Point<dim> const point =
+          dealii::StaticMappingQ1<dim>::mapping.transform_unit_to_real_cell(
+              cell, unit_support_points[i]);
+      // Translations
+      modes[component][index] = 1.;
+      // Rotations in the (x,y), (y,z), and (z,x) planes
+      if (component == 0)
+      {
+        modes[dim][index] = -point[1];
+        if constexpr (dim == 3)
+          modes[dim + 2][index] = point[2];
+      }
+      else if (component == 1)
+      {
+        modes[dim][index] = point[0];
+        if constexpr (dim == 3)
+          modes[dim + 1][index] = -point[2];
+      }
+      else
+      {
+        if constexpr (dim == 3)
+        {
+          modes[dim + 1][index] = point[1];
+          modes[dim + 2][index] = -point[0];
+        }
+      }
+    }
+  }
+
+  return modes;
+}
+
 template <int dim, int p_order, typename MaterialStates,
           typename MemorySpaceType>
 dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
-MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::solve()
+MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::solve(
+    std::vector<Timer> *timers)
 {
+  if (timers)
+    (*timers)[mech_preconditioner].start();
+  setup_preconditioner();
+  if (timers)
+  {
+    (*timers)[mech_preconditioner].stop();
+    (*timers)[mech_solve].start();
+  }
   dealii::IndexSet locally_relevant_dofs =
       dealii::DoFTools::extract_locally_relevant_dofs(_dof_handler);
   dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
       displacement(_dof_handler.locally_owned_dofs(), locally_relevant_dofs,
                    _mechanical_operator->rhs().get_mpi_communicator());
+  // Start from the displacement of the previous solve. The value of the
+  // constrained dofs is set by distribute() after the solve.
+  if (_old_displacement.size() == displacement.size())
+  {
+    displacement.copy_locally_owned_data_from(_old_displacement);
+    _affine_constraints.set_zero(displacement);
+  }
 
   // Solve the mechanical problem assuming that the deformation is elastic
   // TODO check that we are computing only difference of the displacement
@@ -421,12 +454,33 @@ MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::solve()
   dealii::SolverCG<
       dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
       cg(solver_control);
-  // FIXME Use better preconditioner
-  dealii::TrilinosWrappers::PreconditionSSOR preconditioner;
-  preconditioner.initialize(_mechanical_operator->system_matrix());
-  cg.solve(_mechanical_operator->system_matrix(), displacement,
-           _mechanical_operator->rhs(), preconditioner);
+  if (_mechanical_operator->is_matrix_free())
+  {
+    // The vectors need to use the partitioner of the MatrixFree object.
+    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+        mf_displacement;
+    _mechanical_operator->initialize_dof_vector(mf_displacement);
+    mf_displacement.copy_locally_owned_data_from(displacement);
+    if (_chebyshev_preconditioner)
+      cg.solve(*_mechanical_operator, mf_displacement,
+               _mechanical_operator->rhs(), *_chebyshev_preconditioner);
+    else
+      cg.solve(*_mechanical_operator, mf_displacement,
+               _mechanical_operator->rhs(),
+               _mechanical_operator->inverse_diagonal());
+    displacement.copy_locally_owned_data_from(mf_displacement);
+  }
+  else
+  {
+    cg.solve(_mechanical_operator->system_matrix(), displacement,
+             _mechanical_operator->rhs(), *_sparse_preconditioner);
+  }
   _affine_constraints.distribute(displacement);
+  if (timers)
+  {
+    (*timers)[mech_solve].stop();
+    (*timers)[mech_solve].record_iterations(solver_control.last_step());
+  }
 
   // Compute the new stress assuming the deformation is elastic.
   // If the stress is under the yield criterion, the deformation is elastic and
@@ -451,90 +505,198 @@ MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::solve()
 
 template <int dim, int p_order, typename MaterialStates,
           typename MemorySpaceType>
-void MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
-    compute_stress(
-        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
-            &displacement)
+void MechanicalPhysics<dim, p_order, MaterialStates,
+                       MemorySpaceType>::setup_stress_kernel()
 {
-  dealii::hp::FEValues<dim> displacement_hp_fe_values(
-      _fe_collection, _q_collection, dealii::update_gradients);
-  unsigned int const dofs_per_cell = _fe_collection.max_dofs_per_cell();
-  std::vector<dealii::types::global_dof_index> local_dof_indices(dofs_per_cell);
-  unsigned int const n_q_points = _q_collection.max_n_quadrature_points();
-  std::vector<dealii::SymmetricTensor<2, dim>> strain_tensor(n_q_points);
-  const dealii::FEValuesExtractors::Vector displacement_extr(0);
-  unsigned int cell_id = 0;
-  for (auto const &cell : _dof_handler.active_cell_iterators())
+  // The cells are not colored because each cell batch only updates its own
+  // quadrature points.
+  typename dealii::MatrixFree<dim, double>::AdditionalData matrix_free_data;
+  matrix_free_data.tasks_parallel_scheme =
+      dealii::MatrixFree<dim, double>::AdditionalData::none;
+  matrix_free_data.mapping_update_flags = dealii::update_gradients;
+  _stress_matrix_free.reinit(dealii::StaticMappingQ1<dim>::mapping,
+                             _dof_handler, _affine_constraints, _q_collection,
+                             matrix_free_data);
+
+  unsigned int const n_batches = _stress_matrix_free.n_cell_batches();
+  _solid_cell_batches.clear();
+  for (unsigned int batch = 0; batch < n_batches; ++batch)
   {
-    if (cell->is_locally_owned() && cell->active_fe_index() == 0)
+    if (_stress_matrix_free.get_cell_active_fe_index(
+            std::make_pair(batch, batch + 1)) == 0)
+      _solid_cell_batches.push_back(batch);
+  }
+
+  // The material parameters are constant on each cell, so we evaluate them
+  // once per cell batch instead of at every solve.
+  unsigned int constexpr n_lanes = dealii::VectorizedArray<double>::size();
+  _batch_cell_indices.assign(n_batches * n_lanes, 0);
+  _lambda.resize(n_batches);
+  _mu.resize(n_batches);
+  _plastic_modulus.resize(n_batches);
+  _isotropic_hardening.resize(n_batches);
+  for (auto const batch : _solid_cell_batches)
+  {
+    unsigned int const n_active_lanes =
+        _stress_matrix_free.n_active_entries_per_cell_batch(batch);
+    for (unsigned int lane = 0; lane < n_lanes; ++lane)
     {
-      // Formulation based on the combined isotropic-kinematic hardening model
-      // for J2 plasticity in Chapter 3 of R. Borja, Plasticity: Modeling and
-      // Computation, Springer-Verlag, 2013. DOI: 10.1007/978-3-642-38547-6
-      //
-      // Compute the strain. We get the strain for all the quadrature points at
-      // once.
-      displacement_hp_fe_values.reinit(cell);
-      auto const &fe_values = displacement_hp_fe_values.get_present_fe_values();
-      cell->get_dof_indices(local_dof_indices);
-
-      fe_values[displacement_extr].get_function_symmetric_gradients(
-          displacement, strain_tensor);
-
-      double const lambda = _material_properties.get_mechanical_property(
+      // The unused lanes duplicate the first cell of the batch so that they
+      // perform valid computations. Their results are discarded.
+      auto const dof_cell = _stress_matrix_free.get_cell_iterator(
+          batch, lane < n_active_lanes ? lane : 0);
+      typename dealii::Triangulation<dim>::active_cell_iterator const cell =
+          dof_cell;
+      _batch_cell_indices[batch * n_lanes + lane] = cell->active_cell_index();
+      _lambda[batch][lane] = _material_properties.get_mechanical_property(
           cell, StateProperty::lame_first_parameter);
-      double const mu = _material_properties.get_mechanical_property(
+      _mu[batch][lane] = _material_properties.get_mechanical_property(
           cell, StateProperty::lame_second_parameter);
-      double const plastic_modulus =
+      _plastic_modulus[batch][lane] =
           _material_properties.get_mechanical_property(
               cell, StateProperty::plastic_modulus);
-      double const iso_hardening_coef =
+      _isotropic_hardening[batch][lane] =
           _material_properties.get_mechanical_property(
               cell, StateProperty::isotropic_hardening);
-      dealii::SymmetricTensor<4, dim> stiffness_tensor =
-          lambda * dealii::outer_product(dealii::unit_symmetric_tensor<dim>(),
-                                         dealii::unit_symmetric_tensor<dim>()) +
-          2 * mu * dealii::identity_tensor<dim>();
-      // Loop over the quadrature points.
-      for (auto const q : fe_values.quadrature_point_indices())
+    }
+  }
+
+  _stress_mesh_generation = _mesh_generation;
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
+    compute_stress(
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+            &displacement)
+{
+  if (_stress_mesh_generation != _mesh_generation)
+    setup_stress_kernel();
+
+  // The vector needs to use the partitioner of the MatrixFree object.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      mf_displacement;
+  _stress_matrix_free.initialize_dof_vector(mf_displacement);
+  mf_displacement.copy_locally_owned_data_from(displacement);
+  mf_displacement.update_ghost_values();
+
+  // The cell batches are independent, so they are distributed among the
+  // threads by the task scheduler.
+  dealii::parallel::apply_to_subranges(
+      0u, static_cast<unsigned int>(_solid_cell_batches.size()),
+      [&](unsigned int begin, unsigned int end)
+      { compute_stress_batches(mf_displacement, begin, end); },
+      /* grainsize */ 16);
+}
+
+template <int dim, int p_order, typename MaterialStates,
+          typename MemorySpaceType>
+void MechanicalPhysics<dim, p_order, MaterialStates, MemorySpaceType>::
+    compute_stress_batches(
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+            &displacement,
+        unsigned int begin, unsigned int end)
+{
+  using VectorizedDouble = dealii::VectorizedArray<double>;
+  unsigned int constexpr n_lanes = VectorizedDouble::size();
+  unsigned int constexpr n_tensor_components =
+      PlasticityState<dim>::n_tensor_components;
+  unsigned int const n_q_points = _plasticity_state.n_q_points();
+  double *plastic_internal_variable_data = _plasticity_state.get_component(0);
+  std::array<double *, n_tensor_components> stress_data;
+  std::array<double *, n_tensor_components> back_stress_data;
+  for (unsigned int i = 0; i < n_tensor_components; ++i)
+  {
+    stress_data[i] = _plasticity_state.get_component(1 + i);
+    back_stress_data[i] =
+        _plasticity_state.get_component(1 + n_tensor_components + i);
+  }
+
+  dealii::FEEvaluation<dim, -1, 0, dim, double> fe_eval(_stress_matrix_free);
+  std::array<unsigned int, n_lanes> offsets;
+  for (unsigned int i = begin; i < end; ++i)
+  {
+    unsigned int const batch = _solid_cell_batches[i];
+    // Formulation based on the combined isotropic-kinematic hardening model
+    // for J2 plasticity in Chapter 3 of R. Borja, Plasticity: Modeling and
+    // Computation, Springer-Verlag, 2013. DOI: 10.1007/978-3-642-38547-6
+    //
+    // The displacement has already been distributed, so we read the values
+    // without resolving the constraints.
+    fe_eval.reinit(batch);
+    fe_eval.read_dof_values_plain(displacement);
+    fe_eval.evaluate(dealii::EvaluationFlags::gradients);
+
+    VectorizedDouble const lambda = _lambda[batch];
+    VectorizedDouble const two_mu = 2. * _mu[batch];
+    VectorizedDouble const plastic_modulus = _plastic_modulus[batch];
+    VectorizedDouble const iso_hardening_coef = _isotropic_hardening[batch];
+    unsigned int const n_active_lanes =
+        _stress_matrix_free.n_active_entries_per_cell_batch(batch);
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      for (unsigned int lane = 0; lane < n_lanes; ++lane)
+        offsets[lane] = _batch_cell_indices[batch * n_lanes + lane] *
+                            n_q_points +
+                        q;
+
+      VectorizedDouble plastic_internal_variable;
+      plastic_internal_variable.gather(plastic_internal_variable_data,
+                                       offsets.data());
+      dealii::SymmetricTensor<2, dim, VectorizedDouble> stress;
+      dealii::SymmetricTensor<2, dim, VectorizedDouble> back_stress;
+      for (unsigned int i = 0; i < n_tensor_components; ++i)
       {
-        // Compute the trial elastic stress.
-        dealii::SymmetricTensor<2, dim> elastic_stress = _stress[cell_id][q];
-        elastic_stress += stiffness_tensor * strain_tensor[q];
-
-        auto stress_deviator = dealii::deviator(elastic_stress);
-        auto effective_stress = stress_deviator - _back_stress[cell_id][q];
-        double const effective_stress_norm = effective_stress.norm();
-        if (effective_stress_norm < _plastic_internal_variable[cell_id][q])
-        {
-          // The deformation is elastic. We just update the stress with the
-          // elastic stress.
-          _stress[cell_id][q] = elastic_stress;
-        }
-        else
+        stress.access_raw_entry(i).gather(stress_data[i], offsets.data());
+        back_stress.access_raw_entry(i).gather(back_stress_data[i],
+                                               offsets.data());
+      }
+
+      // Compute the trial elastic stress:
+      // sigma + lambda tr(epsilon) I + 2 mu epsilon
+      auto const strain = fe_eval.get_symmetric_gradient(q);
+      VectorizedDouble const lambda_trace = lambda * dealii::trace(strain);
+      stress += two_mu * strain;
+      for (unsigned int d = 0; d < dim; ++d)
+        stress[d][d] += lambda_trace;
+
+      // If the effective stress is under the yield criterion, the deformation
+      // is elastic and the plastic strain increment is zero. Otherwise, we
+      // update the stress, the plastic internal variable, and the back stress.
+      auto const effective_stress = dealii::deviator(stress) - back_stress;
+      VectorizedDouble const effective_stress_norm = effective_stress.norm();
+      VectorizedDouble const is_plastic = dealii::compare_and_apply_mask<
+          dealii::SIMDComparison::less_than>(
+          effective_stress_norm, plastic_internal_variable,
+          VectorizedDouble(0.), VectorizedDouble(1.));
+      VectorizedDouble const plastic_strain_increment =
+          is_plastic * (effective_stress_norm - plastic_internal_variable) /
+          (two_mu + plastic_modulus);
+      auto const plastic_flow_direction =
+          effective_stress /
+          std::max(effective_stress_norm,
+                   VectorizedDouble(std::numeric_limits<double>::min()));
+      stress -= (two_mu * plastic_strain_increment) * plastic_flow_direction;
+      plastic_internal_variable +=
+          iso_hardening_coef * plastic_modulus * plastic_strain_increment;
+      back_stress += (is_plastic * (1. - iso_hardening_coef) *
+                      plastic_modulus * plastic_modulus) *
+                     plastic_flow_direction;
+
+      // Only the lanes associated with a cell are written back.
+      for (unsigned int lane = 0; lane < n_active_lanes; ++lane)
+      {
+        plastic_internal_variable_data[offsets[lane]] =
+            plastic_internal_variable[lane];
+        for (unsigned int i = 0; i < n_tensor_components; ++i)
         {
-          // The deformation is plastic. We need to compute a new stress and
-          // update the plastic internal variable and the back stress.
-          double plastic_strain_increment =
-              (effective_stress_norm - _plastic_internal_variable[cell_id][q]) /
-              (2. * mu + plastic_modulus);
-          auto plastic_flow_direction =
-              effective_stress / effective_stress_norm;
-          // Update stress
-          _stress[cell_id][q] = elastic_stress - 2. * mu *
-                                                     plastic_strain_increment *
-                                                     plastic_flow_direction;
-          // Update plastic internal variable
-          _plastic_internal_variable[cell_id][q] +=
-              iso_hardening_coef * plastic_modulus * plastic_strain_increment;
-          // Update back stress
-          _back_stress[cell_id][q] += (1. - iso_hardening_coef) *
-                                      plastic_modulus * plastic_modulus *
-                                      plastic_flow_direction;
+          stress_data[i][offsets[lane]] = stress.access_raw_entry(i)[lane];
+          back_stress_data[i][offsets[lane]] =
+              back_stress.access_raw_entry(i)[lane];
         }
       }
     }
-    ++cell_id;
   }
 }
 
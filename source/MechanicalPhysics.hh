@@ -7,13 +7,16 @@
 
 #include <Geometry.hh>
 #include <MechanicalOperator.hh>
+#include <PlasticityState.hh>
+#include <Timer.hh>
 
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/symmetric_tensor.h>
-#include <deal.II/distributed/cell_data_transfer.templates.h>
 #include <deal.II/distributed/solution_transfer.h>
 #include <deal.II/fe/fe_system.h>
 #include <deal.II/hp/fe_collection.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/trilinos_precondition.h>
 
 namespace adamantine
 {
@@ -23,13 +26,19 @@ class MechanicalPhysics
 {
 public:
   /**
-   * Constructor.
+   * Constructor. If @p matrix_free is true, the MechanicalOperator is applied
+   * using matrix-free instead of assembling a sparse matrix. @p
+   * preconditioner is the preconditioner of the conjugate gradient: ssor or
+   * amg with the sparse matrix, jacobi or chebyshev with matrix-free. If @p
+   * preconditioner is empty, ssor or jacobi is used.
    */
   MechanicalPhysics(MPI_Comm const &communicator, unsigned int const fe_degree,
                     Geometry<dim> &geometry,
                     MaterialProperty<dim, p_order, MaterialStates,
                                      MemorySpaceType> &material_properties,
-                    std::vector<double> const &initial_temperatures);
+                    std::vector<double> const &initial_temperatures,
+                    bool matrix_free = false,
+                    std::string const &preconditioner = "");
 
   /**
    * Setup the DoFHandler, the AffineConstraints, and the
@@ -63,9 +72,14 @@ public:
   void complete_transfer_mpi();
 
   /**
-   * Solve the mechanical problem and return the displacement.
+   * Solve the mechanical problem and return the displacement. The solver
+   * starts from the displacement of the previous solve. The preconditioner is
+   * only rebuilt if the mesh or the active cells have changed since the last
+   * solve. The time spent in the solver is measured only if @p timers is not
+   * nullptr.
    */
-  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> solve();
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+  solve(std::vector<Timer> *timers = nullptr);
 
   /**
    * Return the DoFHandler.
@@ -78,12 +92,30 @@ public:
   dealii::AffineConstraints<double> &get_affine_constraints();
 
   /**
-   * Return the stress tensor associated to each quadrature point.
+   * Return the plastic internal variable, the stress, and the back stress
+   * associated to each quadrature point.
    */
-  std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> &
-  get_stress_tensor();
+  PlasticityState<dim> const &get_plasticity_state() const;
 
 private:
+  using ChebyshevPreconditioner = dealii::PreconditionChebyshev<
+      MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>,
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>,
+      dealii::DiagonalMatrix<
+          dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>>;
+
+  /**
+   * Build the preconditioner if the mesh has changed since it was last built.
+   */
+  void setup_preconditioner();
+
+  /**
+   * Compute the rigid body modes of the locally owned dofs. They are the
+   * near-null space of the elasticity operator used by the algebraic
+   * multigrid.
+   */
+  std::vector<std::vector<double>> compute_rigid_body_modes() const;
+
   // Compute the stress using linear combination of isotropic and kinematic
   // hardening in the book Plasticity Modeling & Computation from Ronaldo I.
   // Borja.
@@ -91,6 +123,23 @@ private:
       dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
           &displacement);
 
+  /**
+   * Initialize the MatrixFree object used to evaluate the strain, the
+   * material parameters of each cell batch, and the position of each cell in
+   * _plasticity_state.
+   */
+  void setup_stress_kernel();
+
+  /**
+   * Perform the radial return mapping on the solid cell batches [@p begin,
+   * @p end) of _solid_cell_batches. The stress is updated for all the cells
+   * of a batch at once using SIMD instructions.
+   */
+  void compute_stress_batches(
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> const
+          &displacement,
+      unsigned int begin, unsigned int end);
+
   /**
    * Associated Geometry.
    */
@@ -122,6 +171,33 @@ private:
   std::unique_ptr<
       MechanicalOperator<dim, p_order, MaterialStates, MemorySpaceType>>
       _mechanical_operator;
+  /**
+   * Type of preconditioner: ssor, amg, jacobi, or chebyshev.
+   */
+  std::string _preconditioner_type;
+  /**
+   * Counter incremented every time the mesh or the set of active cells
+   * changes.
+   */
+  unsigned int _mesh_generation = 0;
+  /**
+   * Value of _mesh_generation when the DoFs and the constraints were built.
+   */
+  unsigned int _dofs_mesh_generation = dealii::numbers::invalid_unsigned_int;
+  /**
+   * Value of _mesh_generation when the preconditioner was built.
+   */
+  unsigned int _preconditioner_mesh_generation =
+      dealii::numbers::invalid_unsigned_int;
+  /**
+   * Preconditioner used with the sparse matrix.
+   */
+  std::unique_ptr<dealii::TrilinosWrappers::PreconditionBase>
+      _sparse_preconditioner;
+  /**
+   * Preconditioner used with matrix-free.
+   */
+  std::unique_ptr<ChebyshevPreconditioner> _chebyshev_preconditioner;
   /**
    * Whether to include a gravitional body force in the calculation.
    */
@@ -134,19 +210,44 @@ private:
       _old_displacement;
 
   /**
-   * Plastic internal variable related to the strain
+   * Plastic internal variable, stress, and back stress at each (cell,
+   * quadrature point).
    */
-  std::vector<std::vector<double>> _plastic_internal_variable;
+  PlasticityState<dim> _plasticity_state;
 
   /**
-   * Stress tensor at each (cell, quadrature point).
+   * MatrixFree object used to evaluate the strain in compute_stress().
    */
-  std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> _stress;
-
+  dealii::MatrixFree<dim, double> _stress_matrix_free;
+  /**
+   * Value of _mesh_generation when _stress_matrix_free was built.
+   */
+  unsigned int _stress_mesh_generation = dealii::numbers::invalid_unsigned_int;
+  /**
+   * Cell batches of _stress_matrix_free associated with solid cells.
+   */
+  std::vector<unsigned int> _solid_cell_batches;
   /**
-   * Back stress tensor at each (cell, quadrature point).
+   * Active cell index of each lane of each cell batch. The unused lanes point
+   * to the first cell of the batch.
    */
-  std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> _back_stress;
+  std::vector<unsigned int> _batch_cell_indices;
+  /**
+   * First Lamé parameter of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _lambda;
+  /**
+   * Second Lamé parameter of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _mu;
+  /**
+   * Plastic modulus of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _plastic_modulus;
+  /**
+   * Isotropic hardening coefficient of each cell batch.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _isotropic_hardening;
 
   /**
    * Solution transfer object used for updating _old_displacement when the
@@ -155,20 +256,6 @@ private:
   dealii::parallel::distributed::SolutionTransfer<
       dim, dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
       _solution_transfer;
-
-  /**
-   * Cell data transfer object used for updating _plastic_internal_variable,
-   * _stress, and _back_stress when the triangulation is updated when adding
-   * material
-   */
-  dealii::parallel::distributed::CellDataTransfer<
-      dim, dim, std::vector<std::vector<double>>>
-      _cell_data_transfer;
-
-  /**
-   * Temporary storaged used by _cell_data_transfer
-   */
-  std::vector<std::vector<double>> _data_to_transfer;
 };
 
 template <int dim, int p_order, typename MaterialStates,
@@ -191,11 +278,11 @@ MechanicalPhysics<dim, p_order, MaterialStates,
 
 template <int dim, int p_order, typename MaterialStates,
           typename MemorySpaceType>
-inline std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> &
+inline PlasticityState<dim> const &
 MechanicalPhysics<dim, p_order, MaterialStates,
-                  MemorySpaceType>::get_stress_tensor()
+                  MemorySpaceType>::get_plasticity_state() const
 {
-  return _stress;
+  return _plasticity_state;
 }
 
 } // namespace adamantine
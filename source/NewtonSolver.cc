@@ -3,11 +3,41 @@
  */
 
 #include <NewtonSolver.hh>
+#include <utils.hh>
+
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+
+#include <algorithm>
+#include <cmath>
 
 namespace adamantine
 {
-NewtonSolver::NewtonSolver(unsigned int max_it, double tolerance)
-    : _max_it(max_it), _tolerance(tolerance)
+namespace
+{
+/**
+ * Wrapper used to pass a function to the deal.II solvers as a matrix or as a
+ * preconditioner.
+ */
+struct FunctionOperator
+{
+  void vmult(dealii::LA::distributed::Vector<double> &dst,
+             dealii::LA::distributed::Vector<double> const &src) const
+  {
+    function(dst, src);
+  }
+
+  std::function<void(dealii::LA::distributed::Vector<double> &,
+                     dealii::LA::distributed::Vector<double> const &)> const
+      &function;
+};
+} // namespace
+
+NewtonSolver::NewtonSolver(unsigned int max_it, double tolerance,
+                           unsigned int max_linear_it,
+                           unsigned int max_n_tmp_vectors)
+    : _max_it(max_it), _tolerance(tolerance), _max_linear_it(max_linear_it),
+      _max_n_tmp_vectors(max_n_tmp_vectors)
 {
 }
 
@@ -52,4 +82,94 @@ void NewtonSolver::solve(
     ++i;
   }
 }
+
+void NewtonSolver::solve(
+    std::function<dealii::LA::distributed::Vector<double>(
+        dealii::LA::distributed::Vector<double> const &)> const
+        &compute_residual,
+    std::function<void(dealii::LA::distributed::Vector<double> &,
+                       dealii::LA::distributed::Vector<double> const &)> const
+        &jacobian_vmult,
+    std::function<void(dealii::LA::distributed::Vector<double> const &)> const
+        &setup_preconditioner,
+    std::function<void(dealii::LA::distributed::Vector<double> &,
+                       dealii::LA::distributed::Vector<double> const &)> const
+        &apply_preconditioner,
+    dealii::LA::distributed::Vector<double> &y)
+{
+  // Parameters of the forcing terms and of the line search.
+  double constexpr eta_max = 0.9;
+  double constexpr gamma = 0.9;
+  double constexpr sufficient_decrease = 1e-4;
+  double constexpr min_step_length = 1e-6;
+
+  _n_iterations = 0;
+  _n_linear_iterations = 0;
+
+  FunctionOperator const jacobian{jacobian_vmult};
+  FunctionOperator const preconditioner{apply_preconditioner};
+  typename dealii::SolverFGMRES<
+      dealii::LA::distributed::Vector<double>>::AdditionalData
+      additional_data(_max_n_tmp_vectors);
+
+  dealii::LA::distributed::Vector<double> residual = compute_residual(y);
+  double residual_norm = residual.l2_norm();
+  dealii::LA::distributed::Vector<double> newton_step(y.get_partitioner());
+  dealii::LA::distributed::Vector<double> y_old(y.get_partitioner());
+  double eta = 0.5;
+  bool setup_needed = true;
+  while ((residual_norm >= _tolerance) && (_n_iterations < _max_it))
+  {
+    if (setup_needed)
+    {
+      setup_preconditioner(y);
+      setup_needed = false;
+    }
+
+    // Compute the Newton step inexactly. There is no need to solve the linear
+    // system more accurately than the tolerance of the Newton solver.
+    dealii::IterationNumberControl solver_control(
+        _max_linear_it, std::max(eta * residual_norm, 0.5 * _tolerance));
+    dealii::SolverFGMRES<dealii::LA::distributed::Vector<double>> solver(
+        solver_control, additional_data);
+    newton_step = 0.;
+    solver.solve(jacobian, newton_step, residual, preconditioner);
+    _n_linear_iterations += solver_control.last_step();
+
+    // Backtracking line search on the norm of the true residual.
+    y_old = y;
+    double const residual_norm_old = residual_norm;
+    double step_length = 1.;
+    while (true)
+    {
+      y = y_old;
+      y.add(-step_length, newton_step);
+      residual = compute_residual(y);
+      residual_norm = residual.l2_norm();
+      if (residual_norm <=
+          (1. - sufficient_decrease * step_length) * residual_norm_old)
+        break;
+      step_length /= 2.;
+      // Break if the line search is failing to improve the solution.
+      if (step_length < min_step_length)
+        break;
+    }
+    // The linearization used by the preconditioner is not good enough if the
+    // Newton step had to be shortened.
+    setup_needed = step_length < 1.;
+
+    // Update the forcing term. The safeguard prevents the forcing term from
+    // decreasing too quickly.
+    double const eta_old = eta;
+    eta = gamma * std::pow(residual_norm / residual_norm_old, 2);
+    if (gamma * eta_old * eta_old > 0.1)
+      eta = std::max(eta, gamma * eta_old * eta_old);
+    eta = std::min(eta, eta_max);
+
+    ++_n_iterations;
+  }
+
+  ASSERT_THROW(residual_norm < _tolerance,
+               "Error: The Newton-Krylov solver did not converge.");
+}
 } // namespace adamantine
@@ -23,9 +23,14 @@ public:
   /**
    * Constructor. \p max_it is the maximal number of Newton iteration and \p
    * tolerance
-   * is the tolerance on the solution.
+   * is the tolerance on the solution. \p max_linear_it and \p
+   * max_n_tmp_vectors are the maximal number of iterations and the maximal
+   * number of temporary vectors of the Krylov solver used by the
+   * Newton-Krylov method.
    */
-  NewtonSolver(unsigned int max_it, double tolerance);
+  NewtonSolver(unsigned int max_it, double tolerance,
+               unsigned int max_linear_it = 1000,
+               unsigned int max_n_tmp_vectors = 30);
 
   /**
    * Solve non-linear problem.
@@ -43,6 +48,50 @@ public:
                  &compute_inv_jacobian,
              dealii::LA::distributed::Vector<double> &y);
 
+  /**
+   * Solve non-linear problem using an inexact Newton-Krylov method. The
+   * Newton steps are computed with flexible GMRES and the tolerance of the
+   * linear solver is chosen using the second forcing term of Eisenstat and
+   * Walker (SIAM J. Sci. Comput. 17, 1996). The length of the Newton steps is
+   * chosen using a backtracking line search on the norm of the residual.
+   * \param[in] compute_residual: this function must return the residual for a
+   * given vector.
+   * \param[in] jacobian_vmult: this function must compute the product of the
+   * Jacobian with the second argument. The Jacobian is evaluated at the last
+   * vector passed to \p compute_residual.
+   * \param[in] setup_preconditioner: this function is called with the current
+   * solution during the first Newton iteration. The preconditioner is reused
+   * by the following iterations and it is only set up again when the line
+   * search had to shorten the Newton step.
+   * \param[in] apply_preconditioner: this function must apply the
+   * preconditioner to the second argument.
+   * \param[in] y is the initial guess and the solution of the problem.
+   */
+  void solve(std::function<dealii::LA::distributed::Vector<double>(
+                 dealii::LA::distributed::Vector<double> const &)> const
+                 &compute_residual,
+             std::function<void(dealii::LA::distributed::Vector<double> &,
+                                dealii::LA::distributed::Vector<double> const
+                                    &)> const &jacobian_vmult,
+             std::function<void(dealii::LA::distributed::Vector<double> const
+                                    &)> const &setup_preconditioner,
+             std::function<void(dealii::LA::distributed::Vector<double> &,
+                                dealii::LA::distributed::Vector<double> const
+                                    &)> const &apply_preconditioner,
+             dealii::LA::distributed::Vector<double> &y);
+
+  /**
+   * Return the number of Newton iterations performed by the last call to
+   * the Newton-Krylov solve().
+   */
+  unsigned int get_n_iterations() const;
+
+  /**
+   * Return the total number of linear iterations performed by the last call
+   * to the Newton-Krylov solve().
+   */
+  unsigned int get_n_linear_iterations() const;
+
 private:
   /**
    * Maximum number of iteration.
@@ -52,7 +101,33 @@ private:
    * Tolerance.
    */
   double _tolerance;
+  /**
+   * Maximum number of iterations of the Krylov solver.
+   */
+  unsigned int _max_linear_it;
+  /**
+   * Maximum number of temporary vectors of the Krylov solver.
+   */
+  unsigned int _max_n_tmp_vectors;
+  /**
+   * Number of Newton iterations performed by the last Newton-Krylov solve.
+   */
+  unsigned int _n_iterations = 0;
+  /**
+   * Number of linear iterations performed by the last Newton-Krylov solve.
+   */
+  unsigned int _n_linear_iterations = 0;
 };
+
+inline unsigned int NewtonSolver::get_n_iterations() const
+{
+  return _n_iterations;
+}
+
+inline unsigned int NewtonSolver::get_n_linear_iterations() const
+{
+  return _n_linear_iterations;
+}
 } // namespace adamantine
 
 #endif
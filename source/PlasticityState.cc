@@ -0,0 +1,123 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <CellDataBuffer.hh>
+#include <PlasticityState.hh>
+#include <instantiation.hh>
+#include <utils.hh>
+
+#include <algorithm>
+#include <cstring>
+
+namespace adamantine
+{
+template <int dim>
+void PlasticityState<dim>::reinit(unsigned int n_cells,
+                                  unsigned int n_q_points)
+{
+  _n_cells = n_cells;
+  _n_q_points = n_q_points;
+  _data.assign(static_cast<std::size_t>(n_components) * _n_cells * _n_q_points,
+               0.);
+}
+
+template <int dim>
+void PlasticityState<dim>::reset_cell(unsigned int cell,
+                                      double plastic_internal_variable)
+{
+  std::fill_n(_data.begin() + index(0, cell, 0), _n_q_points,
+              plastic_internal_variable);
+  for (unsigned int c = 1; c < n_components; ++c)
+    std::fill_n(_data.begin() + index(c, cell, 0), _n_q_points, 0.);
+}
+
+template <int dim>
+void PlasticityState<dim>::prepare_for_coarsening_and_refinement(
+    dealii::parallel::distributed::Triangulation<dim> &triangulation)
+{
+  ASSERT(_handle == dealii::numbers::invalid_unsigned_int,
+         "The data is already attached to the triangulation.");
+
+  auto pack =
+      [this](typename dealii::Triangulation<dim>::cell_iterator const &cell,
+             internal::CellStatus<dim> const status)
+  {
+    std::size_t const block_size = _n_q_points * sizeof(double);
+    std::vector<char> buffer(n_components * block_size);
+    if (status == internal::children_will_be_coarsened<dim>)
+    {
+      // The children are active, the parent gets their average.
+      std::vector<double> cell_data(n_components * _n_q_points, 0.);
+      double const weight = 1. / cell->n_children();
+      for (unsigned int i = 0; i < cell->n_children(); ++i)
+      {
+        unsigned int const child_index = cell->child(i)->active_cell_index();
+        for (unsigned int c = 0; c < n_components; ++c)
+          for (unsigned int q = 0; q < _n_q_points; ++q)
+            cell_data[c * _n_q_points + q] +=
+                weight * _data[index(c, child_index, q)];
+      }
+      std::memcpy(buffer.data(), cell_data.data(), buffer.size());
+    }
+    else
+    {
+      unsigned int const cell_index = cell->active_cell_index();
+      for (unsigned int c = 0; c < n_components; ++c)
+        std::memcpy(buffer.data() + c * block_size,
+                    _data.data() + index(c, cell_index, 0), block_size);
+    }
+
+    return buffer;
+  };
+
+  _handle = triangulation.register_data_attach(
+      pack, /* returns_variable_size_data */ false);
+}
+
+template <int dim>
+void PlasticityState<dim>::unpack(
+    dealii::parallel::distributed::Triangulation<dim> &triangulation)
+{
+  ASSERT(_handle != dealii::numbers::invalid_unsigned_int,
+         "No data is attached to the triangulation.");
+
+  reinit(triangulation.n_active_cells(), _n_q_points);
+
+  auto unpack =
+      [this](typename dealii::Triangulation<dim>::cell_iterator const &cell,
+             internal::CellStatus<dim> const status,
+             boost::iterator_range<std::vector<char>::const_iterator> const
+                 &data_range)
+  {
+    std::size_t const block_size = _n_q_points * sizeof(double);
+    char const *cell_data = &*data_range.begin();
+    auto copy_to = [&](unsigned int cell_index)
+    {
+      for (unsigned int c = 0; c < n_components; ++c)
+        std::memcpy(_data.data() + index(c, cell_index, 0),
+                    cell_data + c * block_size, block_size);
+    };
+
+    if (status == internal::cell_will_be_refined<dim>)
+    {
+      // The children inherit the state of the parent.
+      for (unsigned int i = 0; i < cell->n_children(); ++i)
+        copy_to(cell->child(i)->active_cell_index());
+    }
+    else
+      copy_to(cell->active_cell_index());
+  };
+
+  triangulation.notify_ready_to_unpack(_handle, unpack);
+  _handle = dealii::numbers::invalid_unsigned_int;
+}
+
+template <int dim>
+std::size_t PlasticityState<dim>::memory_consumption() const
+{
+  return sizeof(*this) + _data.capacity() * sizeof(double);
+}
+} // namespace adamantine
+
+INSTANTIATE_DIM(PlasticityState)
@@ -0,0 +1,253 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef PLASTICITY_STATE_HH
+#define PLASTICITY_STATE_HH
+
+#include <deal.II/base/symmetric_tensor.h>
+#include <deal.II/distributed/tria.h>
+
+#include <vector>
+
+namespace adamantine
+{
+/**
+ * This class stores the state of the J2 plasticity model at each quadrature
+ * point of each active cell: the plastic internal variable, the stress, and
+ * the back stress. The data is stored in a single contiguous buffer using a
+ * structure-of-arrays layout: each component of the state (the plastic
+ * internal variable and the independent components of the two tensors) is
+ * stored in its own block, inside of which the quadrature points of a cell
+ * are contiguous. The cells are indexed by their active cell index.
+ */
+template <int dim>
+class PlasticityState
+{
+public:
+  /**
+   * Number of independent components of the stress tensor.
+   */
+  static unsigned int constexpr n_tensor_components =
+      dealii::SymmetricTensor<2, dim>::n_independent_components;
+  /**
+   * Number of values stored at each quadrature point: the plastic internal
+   * variable, the stress, and the back stress.
+   */
+  static unsigned int constexpr n_components = 1 + 2 * n_tensor_components;
+
+  /**
+   * Resize the container to @p n_cells cells with @p n_q_points quadrature
+   * points each. All the values are set to zero.
+   */
+  void reinit(unsigned int n_cells, unsigned int n_q_points);
+
+  /**
+   * Return the number of cells.
+   */
+  unsigned int n_cells() const;
+
+  /**
+   * Return the number of quadrature points per cell.
+   */
+  unsigned int n_q_points() const;
+
+  /**
+   * Return the plastic internal variable at the quadrature point @p q of the
+   * cell @p cell.
+   */
+  double &plastic_internal_variable(unsigned int cell, unsigned int q);
+
+  /**
+   * Same as above but const.
+   */
+  double plastic_internal_variable(unsigned int cell, unsigned int q) const;
+
+  /**
+   * Return the stress at the quadrature point @p q of the cell @p cell.
+   */
+  dealii::SymmetricTensor<2, dim> get_stress(unsigned int cell,
+                                             unsigned int q) const;
+
+  /**
+   * Set the stress at the quadrature point @p q of the cell @p cell.
+   */
+  void set_stress(unsigned int cell, unsigned int q,
+                  dealii::SymmetricTensor<2, dim> const &stress);
+
+  /**
+   * Return the back stress at the quadrature point @p q of the cell @p cell.
+   */
+  dealii::SymmetricTensor<2, dim> get_back_stress(unsigned int cell,
+                                                  unsigned int q) const;
+
+  /**
+   * Set the back stress at the quadrature point @p q of the cell @p cell.
+   */
+  void set_back_stress(unsigned int cell, unsigned int q,
+                       dealii::SymmetricTensor<2, dim> const &back_stress);
+
+  /**
+   * Set the plastic internal variable of all the quadrature points of the cell
+   * @p cell to @p plastic_internal_variable and the stress and the back
+   * stress to zero.
+   */
+  void reset_cell(unsigned int cell, double plastic_internal_variable);
+
+  /**
+   * Return a pointer to the block of the component @p component. The value at
+   * the quadrature point @p q of the cell @p cell is at the position
+   * cell * n_q_points() + q. The component 0 is the plastic internal
+   * variable, the components [1, n_tensor_components] are the stress, and the
+   * remaining components are the back stress.
+   */
+  double *get_component(unsigned int component);
+
+  /**
+   * Same as above but const.
+   */
+  double const *get_component(unsigned int component) const;
+
+  /**
+   * Attach the state to @p triangulation before the triangulation is refined,
+   * coarsened, or repartitioned. The data of each cell is directly
+   * serialized from the buffer. When children are coarsened, the state of the
+   * parent is the average of the state of the children.
+   */
+  void prepare_for_coarsening_and_refinement(
+      dealii::parallel::distributed::Triangulation<dim> &triangulation);
+
+  /**
+   * Resize the container to the new number of active cells of @p
+   * triangulation and unpack the data attached by
+   * prepare_for_coarsening_and_refinement(). When a cell is refined, the
+   * children inherit the state of the parent.
+   */
+  void unpack(dealii::parallel::distributed::Triangulation<dim> &triangulation);
+
+  /**
+   * Return the memory used by the container in bytes.
+   */
+  std::size_t memory_consumption() const;
+
+private:
+  /**
+   * Return the position of the value at the quadrature point @p q of the cell
+   * @p cell for the component @p component.
+   */
+  std::size_t index(unsigned int component, unsigned int cell,
+                    unsigned int q) const;
+
+  /**
+   * Number of cells.
+   */
+  unsigned int _n_cells = 0;
+  /**
+   * Number of quadrature points per cell.
+   */
+  unsigned int _n_q_points = 0;
+  /**
+   * Handle returned by the triangulation when the data is attached.
+   */
+  unsigned int _handle = dealii::numbers::invalid_unsigned_int;
+  /**
+   * Values of all the components at all the quadrature points.
+   */
+  std::vector<double> _data;
+};
+
+template <int dim>
+inline unsigned int PlasticityState<dim>::n_cells() const
+{
+  return _n_cells;
+}
+
+template <int dim>
+inline unsigned int PlasticityState<dim>::n_q_points() const
+{
+  return _n_q_points;
+}
+
+template <int dim>
+inline std::size_t PlasticityState<dim>::index(unsigned int component,
+                                               unsigned int cell,
+                                               unsigned int q) const
+{
+  return (static_cast<std::size_t>(component) * _n_cells + cell) *
+             _n_q_points +
+         q;
+}
+
+template <int dim>
+inline double &
+PlasticityState<dim>::plastic_internal_variable(unsigned int cell,
+                                                unsigned int q)
+{
+  return _data[index(0, cell, q)];
+}
+
+template <int dim>
+inline double
+PlasticityState<dim>::plastic_internal_variable(unsigned int cell,
+                                                unsigned int q) const
+{
+  return _data[index(0, cell, q)];
+}
+
+template <int dim>
+inline dealii::SymmetricTensor<2, dim>
+PlasticityState<dim>::get_stress(unsigned int cell, unsigned int q) const
+{
+  dealii::SymmetricTensor<2, dim> stress;
+  for (unsigned int i = 0; i < n_tensor_components; ++i)
+    stress.access_raw_entry(i) = _data[index(1 + i, cell, q)];
+
+  return stress;
+}
+
+template <int dim>
+inline void
+PlasticityState<dim>::set_stress(unsigned int cell, unsigned int q,
+                                 dealii::SymmetricTensor<2, dim> const &stress)
+{
+  for (unsigned int i = 0; i < n_tensor_components; ++i)
+    _data[index(1 + i, cell, q)] = stress.access_raw_entry(i);
+}
+
+template <int dim>
+inline dealii::SymmetricTensor<2, dim>
+PlasticityState<dim>::get_back_stress(unsigned int cell, unsigned int q) const
+{
+  dealii::SymmetricTensor<2, dim> back_stress;
+  for (unsigned int i = 0; i < n_tensor_components; ++i)
+    back_stress.access_raw_entry(i) =
+        _data[index(1 + n_tensor_components + i, cell, q)];
+
+  return back_stress;
+}
+
+template <int dim>
+inline void PlasticityState<dim>::set_back_stress(
+    unsigned int cell, unsigned int q,
+    dealii::SymmetricTensor<2, dim> const &back_stress)
+{
+  for (unsigned int i = 0; i < n_tensor_components; ++i)
+    _data[index(1 + n_tensor_components + i, cell, q)] =
+        back_stress.access_raw_entry(i);
+}
+
+template <int dim>
+inline double *PlasticityState<dim>::get_component(unsigned int component)
+{
+  return _data.data() + index(component, 0, 0);
+}
+
+template <int dim>
+inline double const *
+PlasticityState<dim>::get_component(unsigned int component) const
+{
+  return _data.data() + index(component, 0, 0);
+}
+} // namespace adamantine
+
+#endif
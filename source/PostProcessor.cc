@@ -11,10 +11,32 @@
 #include <deal.II/numerics/data_component_interpretation.h>
 
 #include <fstream>
+#include <future>
 #include <unordered_map>
 
 namespace adamantine
 {
+namespace
+{
+dealii::DataOutBase::CompressionLevel
+read_compression_level(boost::property_tree::ptree const &database)
+{
+  // PropertyTreeInput post_processor.compression_level
+  std::string const compression_level =
+      database.get<std::string>("compression_level", "best_speed");
+  if (compression_level == "none")
+    return dealii::DataOutBase::CompressionLevel::no_compression;
+  if (compression_level == "best_compression")
+    return dealii::DataOutBase::CompressionLevel::best_compression;
+  if (compression_level == "default")
+    return dealii::DataOutBase::CompressionLevel::default_compression;
+  ASSERT_THROW(compression_level == "best_speed",
+               "Unknown compression level. The choices are none, best_speed, "
+               "best_compression, and default.");
+  return dealii::DataOutBase::CompressionLevel::best_speed;
+}
+} // namespace
+
 template <int dim>
 PostProcessor<dim>::PostProcessor(MPI_Comm const &communicator,
                                   boost::property_tree::ptree const &database,
@@ -47,6 +69,10 @@ PostProcessor<dim>::PostProcessor(MPI_Comm const &communicator,
   // PropertyTreeInput post_processor.additional_output_refinement
   _additional_output_refinement =
       database.get<unsigned int>("additional_output_refinement", 0);
+
+  // PropertyTreeInput post_processor.asynchronous_output
+  _asynchronous_output = database.get("asynchronous_output", false);
+  _compression_level = read_compression_level(database);
 }
 
 template <int dim>
@@ -74,11 +100,24 @@ PostProcessor<dim>::PostProcessor(
   // PropertyTreeInput post_processor.additional_output_refinement
   _additional_output_refinement =
       database.get<unsigned int>("additional_output_refinement", 0);
+
+  // PropertyTreeInput post_processor.asynchronous_output
+  _asynchronous_output = database.get("asynchronous_output", false);
+  _compression_level = read_compression_level(database);
 }
 
 template <int dim>
-void PostProcessor<dim>::write_pvd() const
+PostProcessor<dim>::~PostProcessor()
 {
+  // Do not throw from the destructor
+  if (_pending_output.valid())
+    _pending_output.wait();
+}
+
+template <int dim>
+void PostProcessor<dim>::write_pvd()
+{
+  wait_for_output();
   unsigned int rank = dealii::Utilities::MPI::this_mpi_process(_communicator);
   if (rank == 0)
   {
@@ -87,29 +126,33 @@ void PostProcessor<dim>::write_pvd() const
   }
 }
 
+template <int dim>
+void PostProcessor<dim>::wait_for_output()
+{
+  // get() rethrows the exceptions raised while writing the files
+  if (_pending_output.valid())
+    _pending_output.get();
+}
+
 template <int dim>
 dealii::Vector<double> PostProcessor<dim>::get_stress_norm(
-    std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> const
-        &stress_tensor)
+    PlasticityState<dim> const &plasticity_state)
 {
   dealii::Vector<double> norm(
       _mechanical_dof_handler->get_triangulation().n_active_cells());
-  unsigned int const n_quad_pts =
-      stress_tensor.size() > 0 ? stress_tensor[0].size() : 0;
-  unsigned int cell_id = 0;
+  unsigned int const n_quad_pts = plasticity_state.n_q_points();
   for (auto const &cell : _mechanical_dof_handler->active_cell_iterators() |
                               dealii::IteratorFilters::ActiveFEIndexEqualTo(
                                   0, /* locally owned */ true))
   {
+    unsigned int const cell_index = cell->active_cell_index();
     dealii::SymmetricTensor<2, dim> accumulated_stress;
     for (unsigned int q = 0; q < n_quad_pts; ++q)
     {
-      accumulated_stress += stress_tensor[cell_id][q];
+      accumulated_stress += plasticity_state.get_stress(cell_index, q);
     }
 
-    norm(cell->active_cell_index()) = (accumulated_stress / n_quad_pts).norm();
-
-    ++cell_id;
+    norm(cell_index) = (accumulated_stress / n_quad_pts).norm();
   }
 
   return norm;
@@ -127,8 +170,7 @@ template <int dim>
 void PostProcessor<dim>::mechanical_dataout(
     dealii::LA::distributed::Vector<double> const &displacement,
     StrainPostProcessor<dim> const &strain,
-    std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> const
-        &stress_tensor)
+    PlasticityState<dim> const &plasticity_state)
 {
   // Add the displacement to the output
   displacement.update_ghost_values();
@@ -145,7 +187,7 @@ void PostProcessor<dim>::mechanical_dataout(
   _data_out.add_data_vector(*_mechanical_dof_handler, displacement, strain);
 
   // Add the stress tensor
-  dealii::Vector<double> stress_norm = get_stress_norm(stress_tensor);
+  dealii::Vector<double> stress_norm = get_stress_norm(plasticity_state);
   _data_out.add_data_vector(stress_norm, "stress");
 }
 
@@ -171,19 +213,24 @@ void PostProcessor<dim>::write_pvtu(unsigned int time_step, double time)
       (_thermal_dof_handler) ? _thermal_dof_handler : _mechanical_dof_handler;
   dealii::types::subdomain_id subdomain_id =
       dof_handler->get_triangulation().locally_owned_subdomain();
+  // The patches need to be built now because the mesh and the solution may
+  // change before the files are written.
   _data_out.build_patches(_additional_output_refinement);
+  std::shared_ptr<DataOutSnapshot<dim>> snapshot = _data_out.create_snapshot();
+  _data_out.clear();
+  dealii::DataOutBase::VtkFlags flags(
+      time, dealii::numbers::invalid_unsigned_int, true, _compression_level);
+  snapshot->set_flags(flags);
   std::string local_filename = _filename_prefix + "." +
                                dealii::Utilities::to_string(time_step) + "." +
-                               dealii::Utilities::to_string(subdomain_id);
-  std::ofstream output((local_filename + ".vtu").c_str());
-  dealii::DataOutBase::VtkFlags flags(time);
-  _data_out.set_flags(flags);
-  _data_out.write_vtu(output);
+                               dealii::Utilities::to_string(subdomain_id) +
+                               ".vtu";
 
   unsigned int rank = dealii::Utilities::MPI::this_mpi_process(_communicator);
+  std::vector<std::string> filenames;
+  std::string pvtu_filename;
   if (rank == 0)
   {
-    std::vector<std::string> filenames;
     unsigned int comm_size =
         dealii::Utilities::MPI::n_mpi_processes(_communicator);
     for (unsigned int i = 0; i < comm_size; ++i)
@@ -193,16 +240,35 @@ void PostProcessor<dim>::write_pvtu(unsigned int time_step, double time)
                                dealii::Utilities::to_string(i) + ".vtu";
       filenames.push_back(local_name);
     }
-    std::string pvtu_filename = _filename_prefix + "." +
-                                dealii::Utilities::to_string(time_step) +
-                                ".pvtu";
-    std::ofstream pvtu_output(pvtu_filename.c_str());
-    _data_out.write_pvtu_record(pvtu_output, filenames);
+    pvtu_filename = _filename_prefix + "." +
+                    dealii::Utilities::to_string(time_step) + ".pvtu";
 
     // Associate the time to the time step.
     _times_filenames.push_back(
         std::pair<double, std::string>(time, pvtu_filename));
   }
+
+  // Writing the files does not require any communication, so it can be done
+  // by a background thread.
+  auto write_files = [snapshot, local_filename, filenames, pvtu_filename]()
+  {
+    std::ofstream output(local_filename);
+    snapshot->write_vtu(output);
+
+    if (!pvtu_filename.empty())
+    {
+      std::ofstream pvtu_output(pvtu_filename);
+      snapshot->write_pvtu_record(pvtu_output, filenames);
+    }
+  };
+
+  // Only one output is in flight at a time to bound the memory used by the
+  // snapshots.
+  wait_for_output();
+  if (_asynchronous_output)
+    _pending_output = std::async(std::launch::async, write_files);
+  else
+    write_files();
 }
 } // namespace adamantine
 
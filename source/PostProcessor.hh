@@ -6,6 +6,7 @@
 #define POST_PROCESSOR_HH
 
 #include <MaterialProperty.hh>
+#include <PlasticityState.hh>
 #include <types.hh>
 
 #include <deal.II/base/types.h>
@@ -15,6 +16,9 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <future>
+#include <memory>
+#include <tuple>
 #include <unordered_map>
 
 namespace adamantine
@@ -34,7 +38,54 @@ public:
 };
 
 /**
- * This class outputs the results using the vtu format.
+ * Copy of the patches built by a DataOut. The copy does not reference the
+ * DoFHandler or the data vectors, so it can be written while the simulation
+ * keeps modifying them.
+ */
+template <int dim>
+class DataOutSnapshot : public dealii::DataOutInterface<dim, dim>
+{
+public:
+  using NonscalarDataRanges = std::vector<
+      std::tuple<unsigned int, unsigned int, std::string,
+                 dealii::DataComponentInterpretation::
+                     DataComponentInterpretation>>;
+
+  DataOutSnapshot(
+      std::vector<dealii::DataOutBase::Patch<dim, dim>> const &patches,
+      std::vector<std::string> const &dataset_names,
+      NonscalarDataRanges const &nonscalar_data_ranges);
+
+protected:
+  std::vector<dealii::DataOutBase::Patch<dim, dim>> const &
+  get_patches() const override;
+
+  std::vector<std::string> get_dataset_names() const override;
+
+  NonscalarDataRanges get_nonscalar_data_ranges() const override;
+
+private:
+  std::vector<dealii::DataOutBase::Patch<dim, dim>> _patches;
+  std::vector<std::string> _dataset_names;
+  NonscalarDataRanges _nonscalar_data_ranges;
+};
+
+/**
+ * DataOut that can copy the patches it has built into a DataOutSnapshot.
+ */
+template <int dim>
+class SnapshotDataOut : public dealii::DataOut<dim>
+{
+public:
+  /**
+   * Copy the patches built by the last call to build_patches().
+   */
+  std::shared_ptr<DataOutSnapshot<dim>> create_snapshot() const;
+};
+
+/**
+ * This class outputs the results using the vtu format. The vtu files can be
+ * written by a background thread while the simulation continues.
  */
 template <int dim>
 class PostProcessor
@@ -62,6 +113,11 @@ public:
                 dealii::DoFHandler<dim> &mechanical_dof_handler,
                 int ensemble_member_index = -1);
 
+  /**
+   * Destructor. Wait for the files that are being written.
+   */
+  ~PostProcessor();
+
   /**
    * Write the different vtu and pvtu files for a thermal problem.
    */
@@ -81,8 +137,7 @@ public:
   void write_mechanical_output(
       unsigned int time_step, double time,
       dealii::LA::distributed::Vector<double> const &displacement,
-      std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> const
-          &stress_tensor,
+      PlasticityState<dim> const &plasticity_state,
       Kokkos::View<double **, LayoutType, kokkos_host> state,
       std::unordered_map<dealii::types::global_dof_index, unsigned int> const
           &dofs_map,
@@ -96,25 +151,29 @@ public:
   write_output(unsigned int time_step, double time,
                dealii::LA::distributed::Vector<double> const &temperature,
                dealii::LA::distributed::Vector<double> const &displacement,
-               std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> const
-                   &stress_tensor,
+               PlasticityState<dim> const &plasticity_state,
                Kokkos::View<double **, LayoutType, kokkos_host> state,
                std::unordered_map<dealii::types::global_dof_index,
                                   unsigned int> const &dofs_map,
                dealii::DoFHandler<dim> const &material_dof_handler);
 
   /**
-   * Write the pvd file for Paraview.
+   * Write the pvd file for Paraview. This function waits for the files that
+   * are being written.
+   */
+  void write_pvd();
+
+  /**
+   * Wait until the files of the last output have been written.
    */
-  void write_pvd() const;
+  void wait_for_output();
 
 private:
   /**
    * Compute the norm of the stress.
    */
   dealii::Vector<double> get_stress_norm(
-      std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> const
-          &stress_tensor);
+      PlasticityState<dim> const &plasticity_state);
   /**
    * Fill _data_out with thermal data.
    */
@@ -126,8 +185,7 @@ private:
   void mechanical_dataout(
       dealii::LA::distributed::Vector<double> const &displacement,
       StrainPostProcessor<dim> const &strain,
-      std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> const
-          &stress_tensor);
+      PlasticityState<dim> const &plasticity_state);
   /**
    * Fill _data_out with material data.
    */
@@ -141,7 +199,8 @@ private:
    */
   void subdomain_dataout();
   /**
-   * Write pvtu file.
+   * Write vtu and pvtu files. The patches are built immediately but the files
+   * are written by a background thread if _asynchronous_output is true.
    */
   void write_pvtu(unsigned int time_step, double time);
 
@@ -168,7 +227,7 @@ private:
   /**
    * DataOut associated with the post-processing.
    */
-  dealii::DataOut<dim> _data_out;
+  SnapshotDataOut<dim> _data_out;
   /**
    * DoFHandler associated with the thermal simulation.
    */
@@ -181,8 +240,60 @@ private:
    * Additional levels of refinement for the output.
    */
   unsigned int _additional_output_refinement;
+  /**
+   * Flag is true if the files are written by a background thread.
+   */
+  bool _asynchronous_output = false;
+  /**
+   * Compression level of the vtu files.
+   */
+  dealii::DataOutBase::CompressionLevel _compression_level =
+      dealii::DataOutBase::CompressionLevel::best_speed;
+  /**
+   * Files of the last output that are being written in the background.
+   */
+  std::future<void> _pending_output;
 };
 
+template <int dim>
+DataOutSnapshot<dim>::DataOutSnapshot(
+    std::vector<dealii::DataOutBase::Patch<dim, dim>> const &patches,
+    std::vector<std::string> const &dataset_names,
+    NonscalarDataRanges const &nonscalar_data_ranges)
+    : _patches(patches), _dataset_names(dataset_names),
+      _nonscalar_data_ranges(nonscalar_data_ranges)
+{
+}
+
+template <int dim>
+std::vector<dealii::DataOutBase::Patch<dim, dim>> const &
+DataOutSnapshot<dim>::get_patches() const
+{
+  return _patches;
+}
+
+template <int dim>
+std::vector<std::string> DataOutSnapshot<dim>::get_dataset_names() const
+{
+  return _dataset_names;
+}
+
+template <int dim>
+typename DataOutSnapshot<dim>::NonscalarDataRanges
+DataOutSnapshot<dim>::get_nonscalar_data_ranges() const
+{
+  return _nonscalar_data_ranges;
+}
+
+template <int dim>
+std::shared_ptr<DataOutSnapshot<dim>>
+SnapshotDataOut<dim>::create_snapshot() const
+{
+  return std::make_shared<DataOutSnapshot<dim>>(
+      this->get_patches(), this->get_dataset_names(),
+      this->get_nonscalar_data_ranges());
+}
+
 template <int dim>
 StrainPostProcessor<dim>::StrainPostProcessor()
     : dealii::DataPostprocessorTensor<dim>("strain", dealii::update_gradients)
@@ -234,8 +345,7 @@ template <typename LayoutType>
 void PostProcessor<dim>::write_mechanical_output(
     unsigned int time_step, double time,
     dealii::LA::distributed::Vector<double> const &displacement,
-    std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> const
-        &stress_tensor,
+    PlasticityState<dim> const &plasticity_state,
     Kokkos::View<double **, LayoutType, kokkos_host> state,
     std::unordered_map<dealii::types::global_dof_index, unsigned int> const
         &dofs_map,
@@ -245,7 +355,7 @@ void PostProcessor<dim>::write_mechanical_output(
   _data_out.clear();
   // We need the StrainPostProcessor to live until write_pvtu is done
   StrainPostProcessor<dim> strain;
-  mechanical_dataout(displacement, strain, stress_tensor);
+  mechanical_dataout(displacement, strain, plasticity_state);
   material_dataout(state, dofs_map, material_dof_handler);
   subdomain_dataout();
   write_pvtu(time_step, time);
@@ -257,8 +367,7 @@ void PostProcessor<dim>::write_output(
     unsigned int time_step, double time,
     dealii::LA::distributed::Vector<double> const &temperature,
     dealii::LA::distributed::Vector<double> const &displacement,
-    std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> const
-        &stress_tensor,
+    PlasticityState<dim> const &plasticity_state,
     Kokkos::View<double **, LayoutType, kokkos_host> state,
     std::unordered_map<dealii::types::global_dof_index, unsigned int> const
         &dofs_map,
@@ -270,7 +379,7 @@ void PostProcessor<dim>::write_output(
   thermal_dataout(temperature);
   // We need the StrainPostProcessor to live until write_pvtu is done
   StrainPostProcessor<dim> strain;
-  mechanical_dataout(displacement, strain, stress_tensor);
+  mechanical_dataout(displacement, strain, plasticity_state);
   material_dataout(state, dofs_map, material_dof_handler);
   subdomain_dataout();
   write_pvtu(time_step, time);
@@ -0,0 +1,167 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <RungeKuttaLegendre.hh>
+#include <utils.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace adamantine
+{
+template <typename MemorySpaceType>
+RungeKuttaLegendre<MemorySpaceType>::RungeKuttaLegendre(
+    unsigned int n_power_iterations, double safety_factor,
+    unsigned int update_interval)
+    : _n_power_iterations(n_power_iterations), _safety_factor(safety_factor),
+      _update_interval(update_interval)
+{
+  ASSERT_THROW(_n_power_iterations > 0,
+               "Error: The number of power iterations must be positive.");
+  ASSERT_THROW(_safety_factor >= 1.,
+               "Error: The safety factor of the spectral radius must be "
+               "greater or equal to one.");
+}
+
+template <typename MemorySpaceType>
+void RungeKuttaLegendre<MemorySpaceType>::initialize(
+    dealii::TimeStepping::runge_kutta_method /*method*/)
+{
+  ASSERT_THROW(false, "Error: RKL2 cannot be initialized with a "
+                      "runge_kutta_method. The coefficients are computed "
+                      "at each time step from the number of stages.");
+}
+
+template <typename MemorySpaceType>
+unsigned int
+RungeKuttaLegendre<MemorySpaceType>::compute_n_stages(double delta_t,
+                                                      double spectral_radius)
+{
+  // RKL2 is stable if delta_t * spectral_radius <= (s^2 + s - 2) / 2. The
+  // method requires at least two stages.
+  double const n_stages =
+      std::ceil(0.5 * (-1. + std::sqrt(9. + 8. * delta_t * spectral_radius)));
+
+  return std::max(2u, static_cast<unsigned int>(n_stages));
+}
+
+template <typename MemorySpaceType>
+double RungeKuttaLegendre<MemorySpaceType>::evolve_one_time_step(
+    std::function<VectorType(double const, VectorType const &)> const &f,
+    std::function<VectorType(double const, double const,
+                             VectorType const &)> const & /*id_minus_tau_J*/,
+    double t, double delta_t, VectorType &y)
+{
+  if ((_spectral_radius < 0.) ||
+      ((_update_interval > 0) && (_n_steps_since_estimate >= _update_interval)))
+  {
+    _spectral_radius = _safety_factor * estimate_spectral_radius(f, t, y);
+    _n_steps_since_estimate = 0;
+  }
+  ++_n_steps_since_estimate;
+
+  unsigned int const s = compute_n_stages(delta_t, _spectral_radius);
+  _status.n_stages = s;
+  _status.spectral_radius = _spectral_radius;
+
+  // The coefficients b_j are defined for j >= 2 and b_0 = b_1 = b_2.
+  auto b = [](unsigned int j)
+  {
+    j = std::max(j, 2u);
+    return (j * j + j - 2.) / (2. * j * (j + 1.));
+  };
+  double const w_1 = 4. / (s * s + s - 2.);
+
+  // First stage
+  VectorType const &y_0 = y;
+  VectorType const f_0 = f(t, y_0);
+  double const mu_tilde_1 = b(1) * w_1;
+  VectorType y_prev_prev(y_0);
+  VectorType y_prev(y_0);
+  y_prev.add(mu_tilde_1 * delta_t, f_0);
+  // Position of the stages in the time step.
+  double c_prev_prev = 0.;
+  double c_prev = mu_tilde_1;
+
+  // Remaining stages
+  VectorType y_j(y_0.get_partitioner());
+  for (unsigned int j = 2; j <= s; ++j)
+  {
+    double const mu = (2. * j - 1.) / j * b(j) / b(j - 1);
+    double const nu = -(j - 1.) / j * b(j) / b(j - 2);
+    double const mu_tilde = mu * w_1;
+    double const gamma_tilde = -(1. - b(j - 1)) * mu_tilde;
+
+    VectorType const f_prev = f(t + c_prev * delta_t, y_prev);
+    // y_j = mu y_{j-1} + nu y_{j-2} + (1 - mu - nu) y_0
+    //       + mu_tilde dt f(y_{j-1}) + gamma_tilde dt f(y_0)
+    y_j.equ(mu, y_prev);
+    y_j.add(nu, y_prev_prev, 1. - mu - nu, y_0);
+    y_j.add(mu_tilde * delta_t, f_prev, gamma_tilde * delta_t, f_0);
+
+    double const c_j = mu * c_prev + nu * c_prev_prev + mu_tilde + gamma_tilde;
+    c_prev_prev = c_prev;
+    c_prev = c_j;
+    y_prev_prev.swap(y_prev);
+    y_prev.swap(y_j);
+  }
+  y.swap(y_prev);
+
+  return t + delta_t;
+}
+
+template <typename MemorySpaceType>
+double RungeKuttaLegendre<MemorySpaceType>::estimate_spectral_radius(
+    std::function<VectorType(double const, VectorType const &)> const &f,
+    double t, VectorType const &y) const
+{
+  // Start from a vector that is rich in high frequencies. The values only
+  // depend on the global index of the degrees of freedom, so the estimate does
+  // not depend on the number of processors.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> v_host(
+      y.get_partitioner());
+  dealii::IndexSet const locally_owned = y.locally_owned_elements();
+  for (unsigned int i = 0; i < v_host.locally_owned_size(); ++i)
+  {
+    auto const global_index = locally_owned.nth_index_in_set(i);
+    v_host.local_element(i) = (global_index % 2 == 0) ? 1. : -1.;
+    v_host.local_element(i) += 0.1 * std::sin(1. + global_index);
+  }
+  VectorType v(y.get_partitioner());
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+    v = v_host;
+  else
+    v.import_elements(v_host, dealii::VectorOperation::insert);
+  v /= v.l2_norm();
+
+  // The Jacobian-vector products are approximated by finite differences like
+  // in the Jacobian-free Newton-Krylov method.
+  double const epsilon = std::sqrt(std::numeric_limits<double>::epsilon()) *
+                         (1. + y.linfty_norm());
+  VectorType const f_y = f(t, y);
+  VectorType y_perturbed(y.get_partitioner());
+  double spectral_radius = 0.;
+  for (unsigned int k = 0; k < _n_power_iterations; ++k)
+  {
+    double const delta = epsilon / v.linfty_norm();
+    y_perturbed = y;
+    y_perturbed.add(delta, v);
+    v = f(t, y_perturbed);
+    v -= f_y;
+    v /= delta;
+    spectral_radius = v.l2_norm();
+    if (spectral_radius == 0.)
+      break;
+    v /= spectral_radius;
+  }
+
+  return spectral_radius;
+}
+
+// Instantiation
+template class RungeKuttaLegendre<dealii::MemorySpace::Host>;
+template class RungeKuttaLegendre<dealii::MemorySpace::Default>;
+} // namespace adamantine
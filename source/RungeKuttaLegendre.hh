@@ -0,0 +1,156 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef RUNGE_KUTTA_LEGENDRE_HH
+#define RUNGE_KUTTA_LEGENDRE_HH
+
+#include <deal.II/base/time_stepping.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+#include <functional>
+
+namespace adamantine
+{
+/**
+ * This class implements the second order Runge-Kutta-Legendre method (RKL2)
+ * of Meyer, Balsara, and Aslam (J. Comput. Phys. 257, 2014). RKL2 is a
+ * stabilized explicit method (super time stepping): the number of stages s is
+ * chosen such that the stability region covers the spectrum of the Jacobian of
+ * the right-hand side. The stable time step grows like s^2 while the cost of a
+ * time step grows like s, which makes the method much cheaper than the
+ * classical explicit methods when the time step is limited by diffusion.
+ *
+ * The spectral radius of the Jacobian is estimated using a few iterations of
+ * the power method. The Jacobian-vector products are approximated by finite
+ * differences of the right-hand side. The estimate is computed during the
+ * first time step, after each call to reset_spectral_radius(), and
+ * periodically after a given number of time steps because the material
+ * properties depend on the temperature.
+ */
+template <typename MemorySpaceType>
+class RungeKuttaLegendre
+    : public dealii::TimeStepping::RungeKutta<
+          dealii::LA::distributed::Vector<double, MemorySpaceType>>
+{
+public:
+  using VectorType = dealii::LA::distributed::Vector<double, MemorySpaceType>;
+
+  /**
+   * Status of the last time step.
+   */
+  struct Status : public dealii::TimeStepping::TimeStepping<VectorType>::Status
+  {
+    /**
+     * Number of stages used during the last time step.
+     */
+    unsigned int n_stages = 0;
+    /**
+     * Estimate of the spectral radius, including the safety factor, used
+     * during the last time step.
+     */
+    double spectral_radius = 0.;
+  };
+
+  /**
+   * Constructor. The spectral radius is estimated using @p n_power_iterations
+   * iterations of the power method and it is multiplied by @p safety_factor.
+   * The estimate is recomputed every @p update_interval time steps. If @p
+   * update_interval is zero, the estimate is only recomputed after a call to
+   * reset_spectral_radius().
+   */
+  RungeKuttaLegendre(unsigned int n_power_iterations, double safety_factor,
+                     unsigned int update_interval);
+
+  using dealii::TimeStepping::RungeKutta<VectorType>::evolve_one_time_step;
+
+  /**
+   * Throw an exception. The coefficients of the method depend on the number of
+   * stages which is chosen at each time step, so the method cannot be
+   * configured through a runge_kutta_method.
+   */
+  void initialize(dealii::TimeStepping::runge_kutta_method method) override;
+
+  /**
+   * Evolve @p y from @p t to @p t + @p delta_t. @p f computes the right-hand
+   * side of the ODE. @p id_minus_tau_J_inverse is not used since the method is
+   * explicit.
+   */
+  double evolve_one_time_step(
+      std::function<VectorType(double const, VectorType const &)> const &f,
+      std::function<VectorType(double const, double const,
+                               VectorType const &)> const
+          &id_minus_tau_J_inverse,
+      double t, double delta_t, VectorType &y) override;
+
+  /**
+   * Return the status of the last time step.
+   */
+  Status const &get_status() const override;
+
+  /**
+   * Force the estimate of the spectral radius to be recomputed during the next
+   * time step. This function needs to be called when the mesh or the operator
+   * has changed.
+   */
+  void reset_spectral_radius();
+
+  /**
+   * Return the smallest number of stages for which RKL2 is stable when the
+   * time step is @p delta_t and the spectral radius of the Jacobian is @p
+   * spectral_radius.
+   */
+  static unsigned int compute_n_stages(double delta_t, double spectral_radius);
+
+private:
+  /**
+   * Estimate the largest eigenvalue (in magnitude) of the Jacobian of @p f at
+   * (@p t, @p y).
+   */
+  double estimate_spectral_radius(
+      std::function<VectorType(double const, VectorType const &)> const &f,
+      double t, VectorType const &y) const;
+
+  /**
+   * Number of iterations of the power method.
+   */
+  unsigned int _n_power_iterations;
+  /**
+   * Factor used to multiply the estimate of the spectral radius. The power
+   * method underestimates the spectral radius.
+   */
+  double _safety_factor;
+  /**
+   * Number of time steps between two estimates of the spectral radius.
+   */
+  unsigned int _update_interval;
+  /**
+   * Number of time steps since the last estimate of the spectral radius.
+   */
+  unsigned int _n_steps_since_estimate = 0;
+  /**
+   * Estimate of the spectral radius. A negative value means that the estimate
+   * needs to be computed.
+   */
+  double _spectral_radius = -1.;
+  /**
+   * Status of the last time step.
+   */
+  Status _status;
+};
+
+template <typename MemorySpaceType>
+inline void RungeKuttaLegendre<MemorySpaceType>::reset_spectral_radius()
+{
+  _spectral_radius = -1.;
+}
+
+template <typename MemorySpaceType>
+inline typename RungeKuttaLegendre<MemorySpaceType>::Status const &
+RungeKuttaLegendre<MemorySpaceType>::get_status() const
+{
+  return _status;
+}
+} // namespace adamantine
+
+#endif
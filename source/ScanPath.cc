@@ -8,6 +8,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 namespace adamantine
@@ -249,6 +250,31 @@ double ScanPath::get_power_modifier(double const &time) const
   return _segment_list[_current_segment].power_modifier;
 }
 
+double ScanPath::get_path_length(double const start_time,
+                                 double end_time) const
+{
+  // The scan path does not move after the last segment.
+  end_time = std::min(end_time, _segment_list.back().end_time);
+  if (end_time <= start_time)
+    return 0.;
+
+  // Sum the length of the straight lines between the positions at
+  // start_time, at the end of the segments traversed, and at end_time.
+  double length = 0.;
+  dealii::Point<3> previous_point = value(start_time);
+  for (auto const &segment : _segment_list)
+  {
+    if ((segment.end_time > start_time) && (segment.end_time < end_time))
+    {
+      length += segment.end_point.distance(previous_point);
+      previous_point = segment.end_point;
+    }
+  }
+  length += value(end_time).distance(previous_point);
+
+  return length;
+}
+
 std::vector<ScanPathSegment> ScanPath::get_segment_list() const
 {
   return _segment_list;
@@ -86,6 +86,12 @@ public:
    */
   double get_power_modifier(double const &time) const;
 
+  /**
+   * Return the length of the path followed by the heat source between @p
+   * start_time and @p end_time.
+   */
+  double get_path_length(double const start_time, double end_time) const;
+
   /**
    * Return the scan path's list of segments
    */
@@ -11,7 +11,9 @@
 #include <ThermalOperatorBase.hh>
 
 #include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/symmetric_tensor.h>
 #include <deal.II/base/vectorization.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
 #include <deal.II/matrix_free/matrix_free.h>
 
 namespace adamantine
@@ -51,6 +53,15 @@ public:
    */
   void clear() override;
 
+  /**
+   * Use the MatrixFree object, the map between the cells and the cell
+   * batches, and the inverse of the mass matrix of @p thermal_operator. This
+   * operator only rebuilds the data that depends on the material and on the
+   * heat sources. @p thermal_operator needs to be of the same type.
+   */
+  void share_discretization(
+      ThermalOperatorBase<dim, MemorySpaceType> &thermal_operator) override;
+
   dealii::types::global_dof_index m() const override;
 
   dealii::types::global_dof_index n() const override;
@@ -97,7 +108,9 @@ public:
 
   /**
    * Set the deposition cosine and sine angles and convert the data from
-   * std::vector to dealii::Table<2, dealii::VectorizedArray>
+   * std::vector to dealii::Table<2, dealii::VectorizedArray>. The products of
+   * the cosine and the sine used by the rotation of the thermal conductivity
+   * are precomputed.
    */
   void set_material_deposition_orientation(
       std::vector<double> const &deposition_cos,
@@ -105,7 +118,159 @@ public:
 
   void set_time_and_source_height(double t, double height) override;
 
+  /**
+   * Set the scaling of the coefficients of the quiet cells. The operator uses
+   * \f$ \frac{1}{\rho C_p} \f$ and the thermal conductivity at the quadrature
+   * points, so the fluxes of the quiet cells are multiplied by the ratio of
+   * @p conductivity_scaling and @p capacity_scaling. The quiet cells are not
+   * heated by the heat sources and the boundary conditions are not applied on
+   * their faces. This function needs to be called after reinit().
+   */
+  void set_quiet_cells(std::vector<bool> const &quiet_cells,
+                       double conductivity_scaling,
+                       double capacity_scaling) override;
+
+  /**
+   * Flag the cell and face batches that contain at least one of the @p
+   * evaluated_cells. The other batches are skipped when the operator is
+   * applied. This function needs to be called after reinit().
+   */
+  void
+  set_evaluated_cells(std::vector<bool> const &evaluated_cells) override;
+
+  /**
+   * Apply the operators @p member_operators of the ensemble members to the
+   * vectors @p src and add the results to @p dst in a single sweep over the
+   * cell batches of this operator. The mapping data of a cell batch is loaded
+   * once and reused by all the members while the material state, the material
+   * properties, and the heat sources of each member are used. All the
+   * operators must be of this type and use the same mesh and the same
+   * numbering of the degrees of freedom as this operator.
+   */
+  void vmult_add_ensemble(
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &dst,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType>
+                      const *> const &src,
+      std::vector<ThermalOperatorBase<dim, MemorySpaceType> const *> const
+          &member_operators) const override;
+
+  /**
+   * Apply the operator in single precision. The material properties are
+   * evaluated in double precision and the result is added to the double
+   * precision destination vector. If @p validation is true, the operator is
+   * also applied in double precision and the largest relative difference
+   * between the two results is recorded. This function needs to be called
+   * before reinit().
+   *
+   * The single precision operator uses the batches of the double precision
+   * one, i.e., it only fills VectorizedArray<double>::size() lanes. The gain
+   * therefore comes from the smaller memory traffic of the vectors, not from
+   * the SIMD width. If the two MatrixFree objects end up with different
+   * batches, the operator is applied in double precision.
+   */
+  void set_mixed_precision(bool mixed_precision, bool validation);
+
+  double get_mixed_precision_difference() const override;
+
 private:
+  /**
+   * Flag is true if the material properties do not depend on the temperature.
+   * In this case, the coefficients of the solid material are constant and they
+   * can be precomputed.
+   */
+  static bool constexpr temperature_independent = (p_order == 0) && !use_table;
+
+  /**
+   * Number of lanes of the cell batches. The single precision MatrixFree
+   * object uses the same number of lanes as the double precision one so that
+   * the cell batches are identical and the tables indexed by cell batch can be
+   * shared. This leaves half of the single precision SIMD width unused.
+   */
+  static unsigned int constexpr n_lanes =
+      dealii::VectorizedArray<double>::size();
+
+  /**
+   * Shorthand for the VectorizedArray with n_lanes lanes.
+   */
+  template <typename Number>
+  using VectorizedNumber = dealii::VectorizedArray<Number, n_lanes>;
+
+  /**
+   * Shorthand for the MatrixFree object with n_lanes lanes.
+   */
+  template <typename Number>
+  using MatrixFreeType =
+      dealii::MatrixFree<dim, Number, VectorizedNumber<Number>>;
+
+  /**
+   * Shorthand for the FEEvaluation used by cell_local_apply.
+   */
+  template <typename Number>
+  using CellEvaluation =
+      dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, Number,
+                           VectorizedNumber<Number>>;
+
+  /**
+   * Shorthand for the FEFaceEvaluation used by face_local_apply.
+   */
+  template <typename Number>
+  using FaceEvaluation =
+      dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, Number,
+                               VectorizedNumber<Number>>;
+
+  /**
+   * Apply the operator using @p matrix_free and add the result to @p dst.
+   */
+  template <typename Number>
+  void
+  apply(MatrixFreeType<Number> const &matrix_free,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src)
+      const;
+
+  /**
+   * Apply the operator in single precision and add the result to @p dst.
+   */
+  void vmult_add_mixed_precision(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+      const;
+
+  /**
+   * Precompute \f$ \frac{1}{\rho C_p} \f$ and the rotated thermal
+   * conductivity of the solid material at every quadrature point and flag the
+   * cell batches that do not contain powder. These batches use the
+   * precomputed coefficients as long as their temperature stays below the
+   * solidus.
+   */
+  void update_constant_coefficients() const;
+
+  /**
+   * Return true if the precomputed coefficients can be used for the cell
+   * batch @p cell. @p fe_eval needs to be evaluated on the cell batch.
+   */
+  template <typename Number>
+  bool has_constant_coefficients(unsigned int cell,
+                                 CellEvaluation<Number> const &fe_eval) const;
+
+  /**
+   * Apply the operator on the cell batch @p cell using the precomputed
+   * coefficients.
+   */
+  template <typename Number>
+  void apply_constant_coefficients(unsigned int cell,
+                                   CellEvaluation<Number> &fe_eval) const;
+
+  /**
+   * Return the sum of the heat sources at the quadrature points @p q_point of
+   * the cell batch @p cell.
+   */
+  dealii::VectorizedArray<double> get_heat_source(
+      unsigned int cell,
+      dealii::Point<dim, dealii::VectorizedArray<double>> const &q_point)
+      const;
+
   /**
    * Update the ratios of the material state.
    * @note The input variables are not used when the only valid state is solid.
@@ -127,7 +292,8 @@ private:
                  MaterialStates::n_material_states> &state_ratios) const;
   /**
    * Return the value of \f$ \frac{1}{\rho C_p} \f$ for a given matrix-free
-   * cell/face and quadrature point.
+   * cell/face and quadrature point. @p latent_heat_coefficient is the value
+   * returned by get_latent_heat_coefficient().
    */
   dealii::VectorizedArray<double> get_inv_rho_cp(
       std::array<dealii::types::material_id,
@@ -136,26 +302,75 @@ private:
                  MaterialStates::n_material_states> const &state_ratios,
       dealii::VectorizedArray<double> const &temperature,
       dealii::AlignedVector<dealii::VectorizedArray<double>> const
-          &temperature_powers) const;
+          &temperature_powers,
+      dealii::VectorizedArray<double> const &latent_heat_coefficient) const;
+
+  /**
+   * Return the contribution of the latent heat to the specific heat of the
+   * mushy material, \f$ \frac{L}{T_l - T_s} \f$, for the materials @p
+   * material_id.
+   */
+  dealii::VectorizedArray<double> get_latent_heat_coefficient(
+      std::array<dealii::types::material_id, n_lanes> const &material_id)
+      const;
 
   /**
    * Apply the operator on a given set of quadrature points inside each cell.
+   * The material properties are always evaluated in double precision.
    */
+  template <typename Number>
   void cell_local_apply(
-      dealii::MatrixFree<dim, double> const &data,
-      dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
-      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
+      MatrixFreeType<Number> const &data,
+      dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+      dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src,
       std::pair<unsigned int, unsigned int> const &cell_range) const;
 
+  /**
+   * Apply the operator on the cell batch @p cell and add the result to @p
+   * dst. @p fe_eval needs to be initialized on the cell batch and
+   * @p temperature_powers is used as scratch data.
+   */
+  template <typename Number>
+  void apply_on_cell_batch(
+      unsigned int cell, CellEvaluation<Number> &fe_eval,
+      dealii::AlignedVector<dealii::VectorizedArray<double>>
+          &temperature_powers,
+      dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+      dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src)
+      const;
+
+  /**
+   * Return true if the faces whose adjacent cells use the FE indices @p
+   * adjacent_cells_fe_index are on the boundary of the activated domain.
+   */
+  static bool is_activated_domain_boundary(
+      std::pair<unsigned int, unsigned int> const &adjacent_cells_fe_index);
+
   /**
    * Apply the operator on a given set of quadrature points on each face.
+   * The material properties are always evaluated in double precision.
    */
+  template <typename Number>
   void face_local_apply(
-      dealii::MatrixFree<dim, double> const &data,
-      dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
-      dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
+      MatrixFreeType<Number> const &data,
+      dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+      dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src,
       std::pair<unsigned int, unsigned int> const &face_range) const;
 
+  /**
+   * Apply the boundary conditions on the face batch @p face and add the
+   * result to @p dst. @p fe_face_eval needs to be initialized on the face
+   * batch and @p temperature_powers is used as scratch data.
+   */
+  template <typename Number>
+  void apply_on_face_batch(
+      unsigned int face, FaceEvaluation<Number> &fe_face_eval,
+      dealii::AlignedVector<dealii::VectorizedArray<double>>
+          &temperature_powers,
+      dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+      dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src)
+      const;
+
   /**
    * Apply the mass operator on a given set of quadrature points.
    */
@@ -195,9 +410,46 @@ private:
    */
   std::vector<std::shared_ptr<HeatSource<dim>>> _heat_sources;
   /**
-   * Underlying MatrixFree object.
+   * Underlying MatrixFree object. It is shared with the operators of the
+   * other ensemble members that use the same mesh.
+   */
+  std::shared_ptr<dealii::MatrixFree<dim, double>> _matrix_free;
+  /**
+   * Flag is true if _matrix_free, _cell_it_to_mf_cell_map, and
+   * _inverse_mass_matrix are owned by another operator.
+   */
+  bool _shared_discretization = false;
+  /**
+   * Flag is true if the operator is applied in single precision.
+   */
+  bool _mixed_precision = false;
+  /**
+   * Flag is true if the single precision application of the operator is
+   * compared to the double precision one.
+   */
+  bool _mixed_precision_validation = false;
+  /**
+   * Flag is true if _matrix_free_float uses the same cell and face batches as
+   * _matrix_free. Otherwise, the operator is applied in double precision.
+   */
+  bool _single_precision_batches = false;
+  /**
+   * Largest relative difference between the single precision and the double
+   * precision applications of the operator.
+   */
+  mutable double _mixed_precision_difference = 0.;
+  /**
+   * Single precision MatrixFree object used when _mixed_precision is true.
+   */
+  MatrixFreeType<float> _matrix_free_float;
+  /**
+   * Single precision copy of the source vector.
+   */
+  mutable dealii::LA::distributed::Vector<float, MemorySpaceType> _src_float;
+  /**
+   * Single precision destination vector.
    */
-  dealii::MatrixFree<dim, double> _matrix_free;
+  mutable dealii::LA::distributed::Vector<float, MemorySpaceType> _dst_float;
   /**
    * Non-owning pointer to the AffineConstraints from ThermalPhysics.
    */
@@ -212,8 +464,8 @@ private:
   /**
    * Map between the cell iterator and the position in _inv_rho_cp table.
    */
-  std::map<typename dealii::DoFHandler<dim>::cell_iterator,
-           std::pair<unsigned int, unsigned int>>
+  std::shared_ptr<std::map<typename dealii::DoFHandler<dim>::cell_iterator,
+                           std::pair<unsigned int, unsigned int>>>
       _cell_it_to_mf_cell_map;
   /**
    * Table of the powder fraction inside cells; mutable so that it can be
@@ -245,13 +497,80 @@ private:
                                       dealii::VectorizedArray<double>::size()>>
       _face_material_id;
   /**
-   * Table of the material deposition cosine angles.
+   * Table of the square of the cosine of the material deposition angles.
+   */
+  dealii::Table<2, dealii::VectorizedArray<double>> _deposition_cos_cos;
+  /**
+   * Table of the square of the sine of the material deposition angles.
+   */
+  dealii::Table<2, dealii::VectorizedArray<double>> _deposition_sin_sin;
+  /**
+   * Table of the product of the sine and the cosine of the material
+   * deposition angles.
+   */
+  dealii::Table<2, dealii::VectorizedArray<double>> _deposition_sin_cos;
+  /**
+   * Solidus of each lane of the cell batches.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _cell_solidus;
+  /**
+   * Liquidus of each lane of the cell batches.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _cell_liquidus;
+  /**
+   * Contribution of the latent heat to the specific heat of the mushy
+   * material for each lane of the cell batches.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>>
+      _cell_latent_heat_coefficient;
+  /**
+   * Scaling of the fluxes of each lane of the cell batches. The scaling is one
+   * for the deposited material and it is smaller than one for the quiet
+   * cells. The vector is empty if there are no locally owned quiet cells.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _cell_quiet_scaling;
+  /**
+   * One for the lanes of the cell batches that contain deposited material and
+   * zero for the quiet cells. The vector is empty if there are no locally
+   * owned quiet cells.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _cell_deposited;
+  /**
+   * Same as _cell_deposited for the face batches.
+   */
+  dealii::AlignedVector<dealii::VectorizedArray<double>> _face_deposited;
+  /**
+   * Flag for each cell batch that is evaluated when the operator is applied.
+   * The vector is empty if all the cell batches are evaluated.
+   */
+  std::vector<bool> _evaluated_cell_batches;
+  /**
+   * Same as _evaluated_cell_batches for the face batches.
+   */
+  std::vector<bool> _evaluated_face_batches;
+  /**
+   * Flag is true if the precomputed coefficients need to be updated before
+   * the next application of the operator.
+   */
+  mutable bool _constant_coefficients_outdated = true;
+  /**
+   * Flag for each cell batch that can use the precomputed coefficients when
+   * its temperature is below the solidus.
+   */
+  mutable std::vector<bool> _constant_coefficient_batches;
+  /**
+   * Table of the precomputed \f$ \frac{1}{\rho C_p} \f$ of the solid
+   * material.
    */
-  dealii::Table<2, dealii::VectorizedArray<double>> _deposition_cos;
+  mutable dealii::Table<2, dealii::VectorizedArray<double>>
+      _constant_inv_rho_cp;
   /**
-   * Table of the material deposition cosine angles.
+   * Table of the precomputed thermal conductivity of the solid material
+   * including the rotation due to the deposition angle.
    */
-  dealii::Table<2, dealii::VectorizedArray<double>> _deposition_sin;
+  mutable dealii::Table<
+      2, dealii::SymmetricTensor<2, dim, dealii::VectorizedArray<double>>>
+      _constant_thermal_conductivity;
 };
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -260,7 +579,7 @@ inline dealii::types::global_dof_index
 ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                 MemorySpaceType>::m() const
 {
-  return _matrix_free.get_vector_partitioner()->size();
+  return _matrix_free->get_vector_partitioner()->size();
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -269,7 +588,7 @@ inline dealii::types::global_dof_index
 ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                 MemorySpaceType>::n() const
 {
-  return _matrix_free.get_vector_partitioner()->size();
+  return _matrix_free->get_vector_partitioner()->size();
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -287,7 +606,7 @@ inline dealii::MatrixFree<dim, double> const &
 ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                 MemorySpaceType>::get_matrix_free() const
 {
-  return _matrix_free;
+  return *_matrix_free;
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -309,7 +628,7 @@ inline void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
     initialize_dof_vector(
         dealii::LA::distributed::Vector<double, MemorySpaceType> &vector) const
 {
-  _matrix_free.initialize_dof_vector(vector);
+  _matrix_free->initialize_dof_vector(vector);
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -323,6 +642,26 @@ ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
   for (auto &beam : _heat_sources)
     beam->update_time(t);
 }
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+inline void
+ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                MemorySpaceType>::set_mixed_precision(bool mixed_precision,
+                                                      bool validation)
+{
+  _mixed_precision = mixed_precision;
+  _mixed_precision_validation = mixed_precision && validation;
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+inline double
+ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                MemorySpaceType>::get_mixed_precision_difference() const
+{
+  return _mixed_precision_difference;
+}
 } // namespace adamantine
 
 #endif
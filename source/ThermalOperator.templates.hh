@@ -10,6 +10,7 @@
 
 #include <deal.II/base/aligned_vector.h>
 #include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/types.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/dofs/dof_tools.h>
@@ -18,10 +19,82 @@
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 
+#include <algorithm>
+#include <cmath>
 #include <type_traits>
 
 namespace adamantine
 {
+namespace internal
+{
+/**
+ * Convert a VectorizedArray to a VectorizedArray of type Number with the same
+ * number of lanes. The value is returned unchanged if the types are the same.
+ */
+template <typename Number, typename OtherNumber, std::size_t width>
+inline dealii::VectorizedArray<Number, width>
+convert(dealii::VectorizedArray<OtherNumber, width> const &value)
+{
+  if constexpr (std::is_same_v<Number, OtherNumber>)
+  {
+    return value;
+  }
+  else
+  {
+    dealii::VectorizedArray<Number, width> converted_value;
+    for (unsigned int n = 0; n < width; ++n)
+      converted_value[n] = static_cast<Number>(value[n]);
+
+    return converted_value;
+  }
+}
+
+/**
+ * Same as above for a Tensor.
+ */
+template <typename Number, int dim, typename OtherNumber, std::size_t width>
+inline dealii::Tensor<1, dim, dealii::VectorizedArray<Number, width>> convert(
+    dealii::Tensor<1, dim, dealii::VectorizedArray<OtherNumber, width>> const
+        &value)
+{
+  dealii::Tensor<1, dim, dealii::VectorizedArray<Number, width>>
+      converted_value;
+  for (unsigned int d = 0; d < dim; ++d)
+    converted_value[d] = convert<Number>(value[d]);
+
+  return converted_value;
+}
+
+/**
+ * Same as above for a Point.
+ */
+template <typename Number, int dim, typename OtherNumber, std::size_t width>
+inline dealii::Point<dim, dealii::VectorizedArray<Number, width>>
+convert(dealii::Point<dim, dealii::VectorizedArray<OtherNumber, width>> const
+            &value)
+{
+  dealii::Point<dim, dealii::VectorizedArray<Number, width>> converted_value;
+  for (unsigned int d = 0; d < dim; ++d)
+    converted_value[d] = convert<Number>(value[d]);
+
+  return converted_value;
+}
+
+/**
+ * Compute the powers of @p temperature from zero to
+ * temperature_powers.size() - 1. The powers are computed once per quadrature
+ * point and shared by all the material properties. Successive
+ * multiplications are much cheaper than calling std::pow for each power.
+ */
+inline void compute_temperature_powers(
+    dealii::VectorizedArray<double> const &temperature,
+    dealii::AlignedVector<dealii::VectorizedArray<double>> &temperature_powers)
+{
+  temperature_powers[0] = 1.;
+  for (unsigned int i = 1; i < temperature_powers.size(); ++i)
+    temperature_powers[i] = temperature_powers[i - 1] * temperature;
+}
+} // namespace internal
 
 template <int dim, bool use_table, int p_order, int fe_degree,
           typename MaterialStates, typename MemorySpaceType>
@@ -34,8 +107,13 @@ ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
         std::vector<std::shared_ptr<HeatSource<dim>>> const &heat_sources)
     : _communicator(communicator), _boundary_type(boundary_type),
       _material_properties(material_properties), _heat_sources(heat_sources),
+      _matrix_free(std::make_shared<dealii::MatrixFree<dim, double>>()),
       _inverse_mass_matrix(
-          new dealii::LA::distributed::Vector<double, MemorySpaceType>())
+          new dealii::LA::distributed::Vector<double, MemorySpaceType>()),
+      _cell_it_to_mf_cell_map(
+          std::make_shared<
+              std::map<typename dealii::DoFHandler<dim>::cell_iterator,
+                       std::pair<unsigned int, unsigned int>>>())
 {
   _matrix_free_data.tasks_parallel_scheme =
       dealii::MatrixFree<dim, double>::AdditionalData::partition_color;
@@ -56,21 +134,98 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
            dealii::AffineConstraints<double> const &affine_constraints,
            dealii::hp::QCollection<1> const &q_collection)
 {
-  _matrix_free.reinit(dealii::StaticMappingQ1<dim>::mapping, dof_handler,
-                      affine_constraints, q_collection, _matrix_free_data);
-  _affine_constraints = &affine_constraints;
+  // The MatrixFree object and the map between the cells and the cell batches
+  // are only rebuilt by the operator that owns them.
+  if (!_shared_discretization)
+  {
+    _matrix_free->reinit(dealii::StaticMappingQ1<dim>::mapping, dof_handler,
+                         affine_constraints, q_collection, _matrix_free_data);
 
-  // Compute mapping between DoFHandler cells and the MatrixFree cells
-  _cell_it_to_mf_cell_map.clear();
-  unsigned int const n_cells = _matrix_free.n_cell_batches();
-  for (unsigned int cell = 0; cell < n_cells; ++cell)
-    for (unsigned int i = 0;
-         i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+    // Compute mapping between DoFHandler cells and the MatrixFree cells
+    _cell_it_to_mf_cell_map->clear();
+    for (unsigned int cell = 0; cell < _matrix_free->n_cell_batches(); ++cell)
+      for (unsigned int i = 0;
+           i < _matrix_free->n_active_entries_per_cell_batch(cell); ++i)
+      {
+        typename dealii::DoFHandler<dim>::cell_iterator cell_it =
+            _matrix_free->get_cell_iterator(cell, i);
+        (*_cell_it_to_mf_cell_map)[cell_it] = std::make_pair(cell, i);
+      }
+  }
+  _affine_constraints = &affine_constraints;
+  _constant_coefficients_outdated = true;
+  // The quiet cells need to be set again on the new mesh.
+  _cell_quiet_scaling.clear();
+  _cell_deposited.clear();
+  _face_deposited.clear();
+  _evaluated_cell_batches.clear();
+  _evaluated_face_batches.clear();
+
+  if (_mixed_precision)
+  {
+    unsigned int const n_cells = _matrix_free->n_cell_batches();
+    typename MatrixFreeType<float>::AdditionalData matrix_free_data_float;
+    matrix_free_data_float.tasks_parallel_scheme =
+        MatrixFreeType<float>::AdditionalData::partition_color;
+    matrix_free_data_float.mapping_update_flags =
+        _matrix_free_data.mapping_update_flags;
+    matrix_free_data_float.mapping_update_flags_inner_faces =
+        _matrix_free_data.mapping_update_flags_inner_faces;
+    matrix_free_data_float.mapping_update_flags_boundary_faces =
+        _matrix_free_data.mapping_update_flags_boundary_faces;
+    _matrix_free_float.reinit(dealii::StaticMappingQ1<dim>::mapping,
+                              dof_handler, affine_constraints, q_collection,
+                              matrix_free_data_float);
+    _matrix_free_float.initialize_dof_vector(_src_float);
+    _matrix_free_float.initialize_dof_vector(_dst_float);
+
+    // The tables indexed by cell and face batches are shared by the two
+    // MatrixFree objects. Since they use the same number of lanes, the
+    // batches should be identical but we check it anyway.
+    bool same_batches =
+        (_matrix_free_float.n_cell_batches() == n_cells) &&
+        (_matrix_free_float.n_inner_face_batches() ==
+         _matrix_free->n_inner_face_batches()) &&
+        (_matrix_free_float.n_boundary_face_batches() ==
+         _matrix_free->n_boundary_face_batches());
+    for (unsigned int cell = 0; same_batches && (cell < n_cells); ++cell)
+    {
+      unsigned int const n_active_entries =
+          _matrix_free->n_active_entries_per_cell_batch(cell);
+      same_batches =
+          _matrix_free_float.n_active_entries_per_cell_batch(cell) ==
+          n_active_entries;
+      for (unsigned int i = 0; same_batches && (i < n_active_entries); ++i)
+        same_batches = _matrix_free_float.get_cell_iterator(cell, i) ==
+                       _matrix_free->get_cell_iterator(cell, i);
+    }
+    unsigned int const n_faces = _matrix_free->n_inner_face_batches() +
+                                 _matrix_free->n_boundary_face_batches();
+    for (unsigned int face = 0; same_batches && (face < n_faces); ++face)
+    {
+      unsigned int const n_active_entries =
+          _matrix_free->n_active_entries_per_face_batch(face);
+      same_batches =
+          _matrix_free_float.n_active_entries_per_face_batch(face) ==
+          n_active_entries;
+      for (unsigned int i = 0; same_batches && (i < n_active_entries); ++i)
+        same_batches = _matrix_free_float.get_face_iterator(face, i, true) ==
+                       _matrix_free->get_face_iterator(face, i, true);
+    }
+    // If the batches differ, the tables cannot be shared and the operator
+    // falls back to double precision.
+    _single_precision_batches = same_batches;
+    if (!same_batches)
     {
-      typename dealii::DoFHandler<dim>::cell_iterator cell_it =
-          _matrix_free.get_cell_iterator(cell, i);
-      _cell_it_to_mf_cell_map[cell_it] = std::make_pair(cell, i);
+      _matrix_free_float.clear();
+      _src_float.reinit(0);
+      _dst_float.reinit(0);
     }
+  }
+  else
+  {
+    _single_precision_batches = false;
+  }
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -118,6 +273,11 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
         dealii::DoFHandler<dim> const &dof_handler,
         dealii::AffineConstraints<double> const &affine_constraints)
 {
+  // The mass matrix does not depend on the material, the operator that owns
+  // the inverse of the mass matrix computes it.
+  if (_shared_discretization)
+    return;
+
   // Compute the inverse of the mass matrix
   dealii::hp::QCollection<dim> mass_q_collection;
   mass_q_collection.push_back(dealii::QGaussLobatto<dim>(fe_degree + 1));
@@ -163,9 +323,42 @@ template <int dim, bool use_table, int p_order, int fe_degree,
 void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                      MemorySpaceType>::clear()
 {
-  _cell_it_to_mf_cell_map.clear();
-  _matrix_free.clear();
-  _inverse_mass_matrix->reinit(0);
+  if (!_shared_discretization)
+  {
+    _cell_it_to_mf_cell_map->clear();
+    _matrix_free->clear();
+    _inverse_mass_matrix->reinit(0);
+  }
+  _matrix_free_float.clear();
+  _src_float.reinit(0);
+  _dst_float.reinit(0);
+  _constant_coefficient_batches.clear();
+  _constant_coefficients_outdated = true;
+  _cell_quiet_scaling.clear();
+  _cell_deposited.clear();
+  _face_deposited.clear();
+  _evaluated_cell_batches.clear();
+  _evaluated_face_batches.clear();
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    share_discretization(
+        ThermalOperatorBase<dim, MemorySpaceType> &thermal_operator)
+{
+  auto *owner = dynamic_cast<ThermalOperator *>(&thermal_operator);
+  ASSERT_THROW(owner != nullptr,
+               "Error: The operators sharing the discretization need to be of "
+               "the same type.");
+  ASSERT_THROW(owner != this,
+               "Error: The operator cannot share its own discretization.");
+
+  _matrix_free = owner->_matrix_free;
+  _cell_it_to_mf_cell_map = owner->_cell_it_to_mf_cell_map;
+  _inverse_mass_matrix = owner->_inverse_mass_matrix;
+  _shared_discretization = true;
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -200,13 +393,48 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
               dealii::LA::distributed::Vector<double, MemorySpaceType> const
                   &src) const
 {
+  // Update the precomputed coefficients if the mesh or the material state
+  // changed since the last application of the operator.
+  if constexpr (temperature_independent)
+  {
+    if (_constant_coefficients_outdated)
+      update_constant_coefficients();
+  }
+
   // Execute the matrix-free matrix-vector multiplication
+  if (_mixed_precision && _single_precision_batches)
+    vmult_add_mixed_precision(dst, src);
+  else
+    apply(*_matrix_free, dst, src);
+
+  // Because cell_loop resolves the constraints, the constrained dofs are not
+  // called they stay at zero. Thus, we need to force the value on the
+  // constrained dofs by hand. The variable scaling is used so that we get the
+  // right order of magnitude.
+  // TODO: for now the value of scaling is set to 1
+  double const scaling = 1.;
+  std::vector<unsigned int> const &constrained_dofs =
+      _matrix_free->get_constrained_dofs();
+  for (auto &dof : constrained_dofs)
+    dst.local_element(dof) += scaling * src.local_element(dof);
+}
 
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+template <typename Number>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    apply(MatrixFreeType<Number> const &matrix_free,
+          dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+          dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src)
+        const
+{
   // If we use adiabatic boundary condition, we have nothing to do on the faces
   // of the cell
   if (_boundary_type & BoundaryType::adiabatic)
   {
-    _matrix_free.cell_loop(&ThermalOperator::cell_local_apply, this, dst, src);
+    matrix_free.cell_loop(&ThermalOperator::template cell_local_apply<Number>,
+                          this, dst, src);
   }
   else
   {
@@ -214,21 +442,184 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
     // internal faces and boundary faces. Here, we use the same function for
     // both cases and apply the face condition only at the boundary of the
     // activated domain.
-    _matrix_free.loop(&ThermalOperator::cell_local_apply,
-                      &ThermalOperator::face_local_apply,
-                      &ThermalOperator::face_local_apply, this, dst, src);
+    matrix_free.loop(&ThermalOperator::template cell_local_apply<Number>,
+                     &ThermalOperator::template face_local_apply<Number>,
+                     &ThermalOperator::template face_local_apply<Number>, this,
+                     dst, src);
   }
+}
 
-  // Because cell_loop resolves the constraints, the constrained dofs are not
-  // called they stay at zero. Thus, we need to force the value on the
-  // constrained dofs by hand. The variable scaling is used so that we get the
-  // right order of magnitude.
-  // TODO: for now the value of scaling is set to 1
-  double const scaling = 1.;
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    vmult_add_ensemble(
+        std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+            const &dst,
+        std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType>
+                        const *> const &src,
+        std::vector<ThermalOperatorBase<dim, MemorySpaceType> const *> const
+            &member_operators) const
+{
+  using VectorType = dealii::LA::distributed::Vector<double, MemorySpaceType>;
+
+  unsigned int const n_members = member_operators.size();
+  ASSERT_THROW((dst.size() == n_members) && (src.size() == n_members),
+               "Error: The number of vectors does not match the number of "
+               "ensemble members.");
+  ASSERT_THROW(!_mixed_precision, "Error: Mixed precision is not supported "
+                                  "by the ensemble operator.");
+  if (n_members == 0)
+    return;
+
+  std::vector<ThermalOperator const *> members(n_members);
+  for (unsigned int k = 0; k < n_members; ++k)
+  {
+    members[k] = dynamic_cast<ThermalOperator const *>(member_operators[k]);
+    ASSERT_THROW(members[k] != nullptr,
+                 "Error: The ensemble members must use the same type of "
+                 "thermal operator.");
+    ASSERT_THROW(members[k]->_matrix_free->n_cell_batches() ==
+                     _matrix_free->n_cell_batches(),
+                 "Error: The ensemble members must use the same mesh.");
+    if constexpr (temperature_independent)
+    {
+      if (members[k]->_constant_coefficients_outdated)
+        members[k]->update_constant_coefficients();
+    }
+  }
+
+  // MatrixFree takes care of the communication of the vectors of the first
+  // member. The ghost values of the other members are exchanged here.
+  std::vector<bool> src_has_ghosts(n_members, true);
+  for (unsigned int k = 1; k < n_members; ++k)
+  {
+    src_has_ghosts[k] = src[k]->has_ghost_elements();
+    if (!src_has_ghosts[k])
+      src[k]->update_ghost_values();
+    dst[k]->zero_out_ghost_values();
+  }
+
+  // The mapping data of each cell and face batch is loaded once and it is
+  // used by all the members. Each member evaluates its own material state and
+  // heat sources so the parameters of the members can differ.
+  auto cell_apply = [&](MatrixFreeType<double> const &data, VectorType &,
+                        VectorType const &,
+                        std::pair<unsigned int, unsigned int> const &cell_range)
+  {
+    std::pair<unsigned int, unsigned int> cell_subrange =
+        data.create_cell_subrange_hp_by_index(cell_range, 0);
+    CellEvaluation<double> fe_eval(data);
+    dealii::AlignedVector<dealii::VectorizedArray<double>> temperature_powers(
+        p_order + 1);
+    for (unsigned int cell = cell_subrange.first; cell < cell_subrange.second;
+         ++cell)
+    {
+      if (!_evaluated_cell_batches.empty() && !_evaluated_cell_batches[cell])
+        continue;
+      fe_eval.reinit(cell);
+      for (unsigned int k = 0; k < n_members; ++k)
+        members[k]->apply_on_cell_batch(cell, fe_eval, temperature_powers,
+                                        *dst[k], *src[k]);
+    }
+  };
+  auto face_apply = [&](MatrixFreeType<double> const &data, VectorType &,
+                        VectorType const &,
+                        std::pair<unsigned int, unsigned int> const &face_range)
+  {
+    auto const adjacent_cells_fe_index =
+        data.get_face_range_category(face_range);
+    if (!is_activated_domain_boundary(adjacent_cells_fe_index))
+      return;
+    FaceEvaluation<double> fe_face_eval(data,
+                                        adjacent_cells_fe_index.first == 0);
+    dealii::AlignedVector<dealii::VectorizedArray<double>> temperature_powers(
+        p_order + 1);
+    for (unsigned int face = face_range.first; face < face_range.second;
+         ++face)
+    {
+      if (!_evaluated_face_batches.empty() && !_evaluated_face_batches[face])
+        continue;
+      fe_face_eval.reinit(face);
+      for (unsigned int k = 0; k < n_members; ++k)
+        members[k]->apply_on_face_batch(face, fe_face_eval, temperature_powers,
+                                        *dst[k], *src[k]);
+    }
+  };
+
+  if (_boundary_type & BoundaryType::adiabatic)
+  {
+    _matrix_free->template cell_loop<VectorType, VectorType>(
+        cell_apply, *dst[0], *src[0]);
+  }
+  else
+  {
+    _matrix_free->template loop<VectorType, VectorType>(
+        cell_apply, face_apply, face_apply, *dst[0], *src[0]);
+  }
+
+  for (unsigned int k = 1; k < n_members; ++k)
+  {
+    dst[k]->compress(dealii::VectorOperation::add);
+    if (!src_has_ghosts[k])
+      src[k]->zero_out_ghost_values();
+  }
+
+  // Same as in vmult_add, the constrained degrees of freedom are set by hand.
   std::vector<unsigned int> const &constrained_dofs =
-      _matrix_free.get_constrained_dofs();
-  for (auto &dof : constrained_dofs)
-    dst.local_element(dof) += scaling * src.local_element(dof);
+      _matrix_free->get_constrained_dofs();
+  for (unsigned int k = 0; k < n_members; ++k)
+    for (auto &dof : constrained_dofs)
+      dst[k]->local_element(dof) += src[k]->local_element(dof);
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    vmult_add_mixed_precision(
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> const &src)
+        const
+{
+  // In validation mode, the operator is first applied in double precision to
+  // get the reference result. The material state is then updated again by the
+  // single precision application.
+  dealii::LA::distributed::Vector<double, MemorySpaceType> dst_reference;
+  if (_mixed_precision_validation)
+  {
+    _matrix_free->initialize_dof_vector(dst_reference);
+    apply(*_matrix_free, dst_reference, src);
+  }
+
+  _src_float.copy_locally_owned_data_from(src);
+  _dst_float = 0.f;
+  apply(_matrix_free_float, _dst_float, _src_float);
+
+  // The result is accumulated in double precision
+  unsigned int const local_size = dst.locally_owned_size();
+  for (unsigned int i = 0; i < local_size; ++i)
+    dst.local_element(i) += _dst_float.local_element(i);
+
+  if (_mixed_precision_validation)
+  {
+    double difference = 0.;
+    double norm = 0.;
+    for (unsigned int i = 0; i < local_size; ++i)
+    {
+      double const reference = dst_reference.local_element(i);
+      difference = std::max(
+          difference, std::abs(_dst_float.local_element(i) - reference));
+      norm = std::max(norm, std::abs(reference));
+    }
+    difference = dealii::Utilities::MPI::max(difference, _communicator);
+    norm = dealii::Utilities::MPI::max(norm, _communicator);
+    if (norm > 0.)
+    {
+      _mixed_precision_difference =
+          std::max(_mixed_precision_difference, difference / norm);
+    }
+  }
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -259,79 +650,40 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
   {
     state_ratios[solid] = 1.;
   }
-  else if constexpr (std::is_same_v<MaterialStates, SolidLiquid>)
+  else
   {
     unsigned int constexpr liquid =
         static_cast<unsigned int>(MaterialStates::State::liquid);
-    // Loop over the vectorized arrays
-    for (unsigned int n = 0; n < temperature.size(); ++n)
-    {
-      // Get the material id at this point
-      dealii::types::material_id const material_id = _material_id(cell, q)[n];
-
-      // Get the material thermodynamic properties
-      double const solidus =
-          _material_properties.get(material_id, Property::solidus);
-      double const liquidus =
-          _material_properties.get(material_id, Property::liquidus);
 
-      // Update the state ratios
-      if (temperature[n] < solidus)
-        state_ratios[liquid][n] = 0.;
-      else if (temperature[n] > liquidus)
-        state_ratios[liquid][n] = 1.;
-      else
-      {
-        state_ratios[liquid][n] =
-            (temperature[n] - solidus) / (liquidus - solidus);
-      }
-      state_ratios[solid][n] = 1. - state_ratios[liquid][n];
+    // The ratio of liquid is zero below the solidus, one above the liquidus,
+    // and it increases linearly in between. The solidus and the liquidus of
+    // the cell batch are cached so the ratio can be computed on all the lanes
+    // at once.
+    auto const &solidus = _cell_solidus[cell];
+    auto const &liquidus = _cell_liquidus[cell];
+    state_ratios[liquid] =
+        std::min(std::max((temperature - solidus) / (liquidus - solidus),
+                          dealii::VectorizedArray<double>(0.)),
+                 dealii::make_vectorized_array<double>(1.));
+
+    if constexpr (std::is_same_v<MaterialStates, SolidLiquid>)
+    {
+      state_ratios[solid] = 1. - state_ratios[liquid];
     }
-
-    _liquid_ratio(cell, q) = state_ratios[liquid];
-  }
-  else if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
-  {
-    unsigned int constexpr liquid =
-        static_cast<unsigned int>(MaterialStates::State::liquid);
-    unsigned int constexpr powder =
-        static_cast<unsigned int>(MaterialStates::State::powder);
-
-    // Loop over the vectorized arrays
-    for (unsigned int n = 0; n < temperature.size(); ++n)
+    else
     {
-      // Get the material id at this point
-      dealii::types::material_id const material_id = _material_id(cell, q)[n];
-
-      // Get the material thermodynamic properties
-      double const solidus =
-          _material_properties.get(material_id, Property::solidus);
-      double const liquidus =
-          _material_properties.get(material_id, Property::liquidus);
-
-      // Update the state ratios
-      state_ratios[powder] = _powder_ratio(cell, q);
-
-      if (temperature[n] < solidus)
-        state_ratios[liquid][n] = 0.;
-      else if (temperature[n] > liquidus)
-        state_ratios[liquid][n] = 1.;
-      else
-      {
-        state_ratios[liquid][n] =
-            (temperature[n] - solidus) / (liquidus - solidus);
-      }
+      unsigned int constexpr powder =
+          static_cast<unsigned int>(MaterialStates::State::powder);
       // Because the powder can only become liquid, the solid can only
       // become liquid, and the liquid can only become solid, the ratio of
       // powder can only decrease.
-      state_ratios[powder][n] =
-          std::min(1. - state_ratios[liquid][n], state_ratios[powder][n]);
-      state_ratios[solid][n] =
-          1. - state_ratios[liquid][n] - state_ratios[powder][n];
+      state_ratios[powder] =
+          std::min(1. - state_ratios[liquid], _powder_ratio(cell, q));
+      state_ratios[solid] = 1. - state_ratios[liquid] - state_ratios[powder];
+      _powder_ratio(cell, q) = state_ratios[powder];
     }
 
     _liquid_ratio(cell, q) = state_ratios[liquid];
-    _powder_ratio(cell, q) = state_ratios[powder];
   }
 }
 
@@ -443,7 +795,9 @@ ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                    MaterialStates::n_material_states> const &state_ratios,
         dealii::VectorizedArray<double> const &temperature,
         dealii::AlignedVector<dealii::VectorizedArray<double>> const
-            &temperature_powers) const
+            &temperature_powers,
+        [[maybe_unused]] dealii::VectorizedArray<double> const
+            &latent_heat_coefficient) const
 {
   // Here we need the specific heat (including the latent heat contribution)
   // and the density
@@ -462,17 +816,6 @@ ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
   // Add in the latent heat contribution
   if constexpr (!std::is_same_v<MaterialStates, Solid>)
   {
-    // Get the state-independent material properties
-    dealii::VectorizedArray<double> solidus, liquidus, latent_heat;
-    for (unsigned int n = 0; n < solidus.size(); ++n)
-    {
-      solidus[n] = _material_properties.get(material_id[n], Property::solidus);
-      liquidus[n] =
-          _material_properties.get(material_id[n], Property::liquidus);
-      latent_heat[n] =
-          _material_properties.get(material_id[n], Property::latent_heat);
-    }
-
     unsigned int constexpr solid =
         static_cast<unsigned int>(MaterialStates::State::solid);
     unsigned int constexpr liquid =
@@ -483,35 +826,58 @@ ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
     // that is very slow. Instead, we create a new variable is_mushy that is
     // non-zero when there is both solid and liquid.
     auto is_mushy = state_ratios[liquid] * state_ratios[solid];
-    for (unsigned int n = 0; n < specific_heat.size(); ++n)
+    dealii::VectorizedArray<double> const zero = 0.;
+    specific_heat +=
+        dealii::compare_and_apply_mask<dealii::SIMDComparison::greater_than>(
+            is_mushy, zero, latent_heat_coefficient, zero);
+  }
+
+  return 1.0 / (density * specific_heat);
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+dealii::VectorizedArray<double>
+ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                MemorySpaceType>::
+    get_latent_heat_coefficient(
+        [[maybe_unused]] std::array<dealii::types::material_id,
+                                    n_lanes> const &material_id) const
+{
+  dealii::VectorizedArray<double> latent_heat_coefficient = 0.;
+  if constexpr (!std::is_same_v<MaterialStates, Solid>)
+  {
+    for (unsigned int n = 0; n < latent_heat_coefficient.size(); ++n)
     {
-      if (is_mushy[n] > 0.0)
-      {
-        specific_heat[n] += latent_heat[n] / (liquidus[n] - solidus[n]);
-      }
+      double const solidus =
+          _material_properties.get(material_id[n], Property::solidus);
+      double const liquidus =
+          _material_properties.get(material_id[n], Property::liquidus);
+      double const latent_heat =
+          _material_properties.get(material_id[n], Property::latent_heat);
+      latent_heat_coefficient[n] = latent_heat / (liquidus - solidus);
     }
   }
 
-  return 1.0 / (density * specific_heat);
+  return latent_heat_coefficient;
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
           typename MaterialStates, typename MemorySpaceType>
+template <typename Number>
 void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                      MemorySpaceType>::
     cell_local_apply(
-        dealii::MatrixFree<dim, double> const &data,
-        dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
-        dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
+        MatrixFreeType<Number> const &data,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src,
         std::pair<unsigned int, unsigned int> const &cell_range) const
 {
   // Get the subrange of cells associated with the fe index 0
   std::pair<unsigned int, unsigned int> cell_subrange =
       data.create_cell_subrange_hp_by_index(cell_range, 0);
 
-  dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, double> fe_eval(data);
-  std::array<dealii::VectorizedArray<double>, MaterialStates::n_material_states>
-      state_ratios;
+  CellEvaluation<Number> fe_eval(data);
 
   // We need powers of temperature to compute the material properties. We
   // could compute it in MaterialProperty but because it's in a hot loop.
@@ -525,129 +891,369 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
   for (unsigned int cell = cell_subrange.first; cell < cell_subrange.second;
        ++cell)
   {
+    if (!_evaluated_cell_batches.empty() && !_evaluated_cell_batches[cell])
+      continue;
     // Reinit fe_eval on the current cell
     fe_eval.reinit(cell);
-    // Store in a local vector the local values of src
-    fe_eval.read_dof_values(src);
-    // Evaluate the function and its gradient on the reference cell
-    fe_eval.evaluate(dealii::EvaluationFlags::values |
-                     dealii::EvaluationFlags::gradients);
-    // Apply the Jacobian of the transformation, multiply by the variable
-    // coefficients and the quadrature points
-    for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+    apply_on_cell_batch(cell, fe_eval, temperature_powers, dst, src);
+  }
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+template <typename Number>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    apply_on_cell_batch(
+        unsigned int cell, CellEvaluation<Number> &fe_eval,
+        dealii::AlignedVector<dealii::VectorizedArray<double>>
+            &temperature_powers,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src)
+        const
+{
+  std::array<dealii::VectorizedArray<double>, MaterialStates::n_material_states>
+      state_ratios;
+
+  // Store in a local vector the local values of src
+  fe_eval.read_dof_values(src);
+  // Evaluate the function and its gradient on the reference cell
+  fe_eval.evaluate(dealii::EvaluationFlags::values |
+                   dealii::EvaluationFlags::gradients);
+  // Most of the domain is cold solid whose material properties do not
+  // change. These cell batches use the precomputed coefficients and only
+  // the other cell batches evaluate the material properties.
+  if (has_constant_coefficients(cell, fe_eval))
+  {
+    apply_constant_coefficients(cell, fe_eval);
+    fe_eval.integrate(dealii::EvaluationFlags::values |
+                      dealii::EvaluationFlags::gradients);
+    fe_eval.distribute_local_to_global(dst);
+    return;
+  }
+  // Apply the Jacobian of the transformation, multiply by the variable
+  // coefficients and the quadrature points
+  for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+  {
+    // The material properties are evaluated in double precision
+    auto temperature = internal::convert<double>(fe_eval.get_value(q));
+    // Precompute the powers of temperature.
+    internal::compute_temperature_powers(temperature, temperature_powers);
+
+    // Calculate the local material properties
+    update_state_ratios(cell, q, temperature, state_ratios);
+    auto const &material_id = _material_id(cell, q);
+    auto inv_rho_cp = get_inv_rho_cp(material_id, state_ratios, temperature,
+                                     temperature_powers,
+                                     _cell_latent_heat_coefficient[cell]);
+    auto th_conductivity_grad =
+        internal::convert<double>(fe_eval.get_gradient(q));
+
+    // In 2D we only use x and z, and there are no deposition angle
+    if constexpr (dim == 2)
+    {
+      th_conductivity_grad[axis<dim>::x] *=
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::thermal_conductivity_x, material_id.data(),
+              state_ratios.data(), temperature, temperature_powers);
+      th_conductivity_grad[axis<dim>::z] *=
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::thermal_conductivity_z, material_id.data(),
+              state_ratios.data(), temperature, temperature_powers);
+    }
+
+    if constexpr (dim == 3)
+    {
+      auto const th_conductivity_grad_x = th_conductivity_grad[axis<dim>::x];
+      auto const th_conductivity_grad_y = th_conductivity_grad[axis<dim>::y];
+      auto const thermal_conductivity_x =
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::thermal_conductivity_x, material_id.data(),
+              state_ratios.data(), temperature, temperature_powers);
+      auto const thermal_conductivity_y =
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::thermal_conductivity_y, material_id.data(),
+              state_ratios.data(), temperature, temperature_powers);
+
+      // The products of the cosine and the sine of the deposition angle
+      // only depend on the cell and they are precomputed.
+      auto const &cos_cos = _deposition_cos_cos(cell, q);
+      auto const &sin_sin = _deposition_sin_sin(cell, q);
+      auto const &sin_cos = _deposition_sin_cos(cell, q);
+
+      // The rotation is performed using the following formula
+      //
+      // (cos  -sin) (x  0) ( cos  sin)
+      // (sin   cos) (0  y) (-sin  cos)
+      // =
+      // ((x*cos^2 + y*sin^2)  ((x-y) * (sin*cos)))
+      // (((x-y) * (sin*cos))  (x*sin^2 + y*cos^2))
+
+      auto const thermal_conductivity_xy =
+          (thermal_conductivity_x - thermal_conductivity_y) * sin_cos;
+      th_conductivity_grad[axis<dim>::x] =
+          (thermal_conductivity_x * cos_cos +
+           thermal_conductivity_y * sin_sin) *
+              th_conductivity_grad_x +
+          thermal_conductivity_xy * th_conductivity_grad_y;
+      th_conductivity_grad[axis<dim>::y] =
+          thermal_conductivity_xy * th_conductivity_grad_x +
+          (thermal_conductivity_x * sin_sin +
+           thermal_conductivity_y * cos_cos) *
+              th_conductivity_grad_y;
+
+      // There is no deposition angle for the z axis
+      th_conductivity_grad[axis<dim>::z] *=
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::thermal_conductivity_z, material_id.data(),
+              state_ratios.data(), temperature, temperature_powers);
+    }
+
+    // The heat flows much more slowly through the quiet cells and they are
+    // not heated by the heat sources.
+    if (!_cell_quiet_scaling.empty())
+      th_conductivity_grad *= _cell_quiet_scaling[cell];
+
+    fe_eval.submit_gradient(
+        internal::convert<Number>(-inv_rho_cp * th_conductivity_grad), q);
+
+    // Compute source term
+    dealii::VectorizedArray<double> quad_pt_source = get_heat_source(
+        cell, internal::convert<double>(fe_eval.quadrature_point(q)));
+    quad_pt_source *= inv_rho_cp;
+    if (!_cell_deposited.empty())
+      quad_pt_source *= _cell_deposited[cell];
+
+    fe_eval.submit_value(internal::convert<Number>(quad_pt_source), q);
+  }
+  // Sum over the quadrature points.
+  fe_eval.integrate(dealii::EvaluationFlags::values |
+                    dealii::EvaluationFlags::gradients);
+  fe_eval.distribute_local_to_global(dst);
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+dealii::VectorizedArray<double>
+ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                MemorySpaceType>::
+    get_heat_source(
+        unsigned int cell,
+        dealii::Point<dim, dealii::VectorizedArray<double>> const &q_point)
+        const
+{
+  dealii::VectorizedArray<double> quad_pt_source = 0.0;
+  for (unsigned int i = 0;
+       i < _matrix_free->n_active_entries_per_cell_batch(cell); ++i)
+  {
+    dealii::Point<dim> q_point_loc;
+    for (unsigned int d = 0; d < dim; ++d)
+      q_point_loc(d) = q_point(d)[i];
+
+    for (auto &beam : _heat_sources)
+      quad_pt_source[i] += beam->value(q_point_loc, _current_source_height);
+  }
+
+  return quad_pt_source;
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::update_constant_coefficients() const
+{
+  unsigned int const n_cells = _matrix_free->n_cell_batches();
+  unsigned int const n_q_points = _material_id.size(1);
+  _constant_coefficient_batches.assign(n_cells, false);
+  _constant_inv_rho_cp.reinit(n_cells, n_q_points);
+  _constant_thermal_conductivity.reinit(n_cells, n_q_points);
+  _constant_coefficients_outdated = false;
+
+  // The material state is not known yet.
+  if (_material_id.size(0) != n_cells)
+    return;
+  // In 3D, the conductivity depends on the deposition angle.
+  if ((dim == 3) && (_deposition_cos_cos.size(0) != n_cells))
+    return;
+
+  // The coefficients are the ones of the solid material.
+  unsigned int constexpr solid =
+      static_cast<unsigned int>(MaterialStates::State::solid);
+  std::array<dealii::VectorizedArray<double>, MaterialStates::n_material_states>
+      state_ratios;
+  for (auto &ratio : state_ratios)
+    ratio = 0.;
+  state_ratios[solid] = 1.;
+  dealii::VectorizedArray<double> const temperature = 0.;
+  dealii::AlignedVector<dealii::VectorizedArray<double>> temperature_powers(
+      p_order + 1);
+  temperature_powers[0] = 1.;
+
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+  {
+    // Only the cells with FE_Q are used by cell_local_apply
+    if (_matrix_free->get_cell_active_fe_index({cell, cell + 1}) != 0)
+      continue;
+
+    unsigned int const n_active_entries =
+        _matrix_free->n_active_entries_per_cell_batch(cell);
+    bool constant_coefficients = true;
+    for (unsigned int q = 0; q < n_q_points; ++q)
     {
-      auto temperature = fe_eval.get_value(q);
-      // Precompute the powers of temperature.
-      for (unsigned int i = 0; i <= p_order; ++i)
+      auto const &material_id = _material_id(cell, q);
+      // The powder ratio only changes when the powder melts. The cell
+      // batches that contain powder always evaluate the material properties.
+      if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
       {
-        // FIXME Need to cast i to double due to a limitation in deal.II 9.5
-        temperature_powers[i] = std::pow(temperature, static_cast<double>(i));
+        for (unsigned int n = 0; n < n_active_entries; ++n)
+          if (_powder_ratio(cell, q)[n] != 0.)
+            constant_coefficients = false;
       }
 
-      // Calculate the local material properties
-      update_state_ratios(cell, q, temperature, state_ratios);
-      auto material_id = _material_id(cell, q);
-      auto inv_rho_cp = get_inv_rho_cp(material_id, state_ratios, temperature,
-                                       temperature_powers);
-      auto th_conductivity_grad = fe_eval.get_gradient(q);
-
-      // In 2D we only use x and z, and there are no deposition angle
+      _constant_inv_rho_cp(cell, q) = get_inv_rho_cp(
+          material_id, state_ratios, temperature, temperature_powers,
+          _cell_latent_heat_coefficient[cell]);
+
+      auto &thermal_conductivity = _constant_thermal_conductivity(cell, q);
+      auto const thermal_conductivity_x =
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::thermal_conductivity_x, material_id.data(),
+              state_ratios.data(), temperature, temperature_powers);
+      auto const thermal_conductivity_z =
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::thermal_conductivity_z, material_id.data(),
+              state_ratios.data(), temperature, temperature_powers);
       if constexpr (dim == 2)
       {
-        th_conductivity_grad[axis<dim>::x] *=
-            _material_properties.template compute_material_property<use_table>(
-                StateProperty::thermal_conductivity_x, material_id.data(),
-                state_ratios.data(), temperature, temperature_powers);
-        th_conductivity_grad[axis<dim>::z] *=
-            _material_properties.template compute_material_property<use_table>(
-                StateProperty::thermal_conductivity_z, material_id.data(),
-                state_ratios.data(), temperature, temperature_powers);
+        thermal_conductivity[axis<dim>::x][axis<dim>::x] =
+            thermal_conductivity_x;
+        thermal_conductivity[axis<dim>::z][axis<dim>::z] =
+            thermal_conductivity_z;
       }
-
-      if constexpr (dim == 3)
+      else
       {
-        auto const th_conductivity_grad_x = th_conductivity_grad[axis<dim>::x];
-        auto const th_conductivity_grad_y = th_conductivity_grad[axis<dim>::y];
-        auto const thermal_conductivity_x =
-            _material_properties.template compute_material_property<use_table>(
-                StateProperty::thermal_conductivity_x, material_id.data(),
-                state_ratios.data(), temperature, temperature_powers);
         auto const thermal_conductivity_y =
             _material_properties.template compute_material_property<use_table>(
                 StateProperty::thermal_conductivity_y, material_id.data(),
                 state_ratios.data(), temperature, temperature_powers);
-
-        auto cos = _deposition_cos(cell, q);
-        auto sin = _deposition_sin(cell, q);
-
-        // The rotation is performed using the following formula
-        //
-        // (cos  -sin) (x  0) ( cos  sin)
-        // (sin   cos) (0  y) (-sin  cos)
-        // =
-        // ((x*cos^2 + y*sin^2)  ((x-y) * (sin*cos)))
-        // (((x-y) * (sin*cos))  (x*sin^2 + y*cos^2))
-
-        th_conductivity_grad[axis<dim>::x] =
-            (thermal_conductivity_x * cos * cos +
-             thermal_conductivity_y * sin * sin) *
-                th_conductivity_grad_x +
-            ((thermal_conductivity_x - thermal_conductivity_y) * sin * cos) *
-                th_conductivity_grad_y;
-        th_conductivity_grad[axis<dim>::y] =
-            ((thermal_conductivity_x - thermal_conductivity_y) * sin * cos) *
-                th_conductivity_grad_x +
-            (thermal_conductivity_x * sin * sin +
-             thermal_conductivity_y * cos * cos) *
-                th_conductivity_grad_y;
-
-        // There is no deposition angle for the z axis
-        th_conductivity_grad[axis<dim>::z] *=
-            _material_properties.template compute_material_property<use_table>(
-                StateProperty::thermal_conductivity_z, material_id.data(),
-                state_ratios.data(), temperature, temperature_powers);
+        auto const &cos_cos = _deposition_cos_cos(cell, q);
+        auto const &sin_sin = _deposition_sin_sin(cell, q);
+        auto const &sin_cos = _deposition_sin_cos(cell, q);
+        // See cell_local_apply for the rotation
+        thermal_conductivity[axis<dim>::x][axis<dim>::x] =
+            thermal_conductivity_x * cos_cos + thermal_conductivity_y * sin_sin;
+        thermal_conductivity[axis<dim>::x][axis<dim>::y] =
+            (thermal_conductivity_x - thermal_conductivity_y) * sin_cos;
+        thermal_conductivity[axis<dim>::y][axis<dim>::y] =
+            thermal_conductivity_x * sin_sin + thermal_conductivity_y * cos_cos;
+        thermal_conductivity[axis<dim>::z][axis<dim>::z] =
+            thermal_conductivity_z;
       }
+      if (!_cell_quiet_scaling.empty())
+        thermal_conductivity *= _cell_quiet_scaling[cell];
+    }
 
-      fe_eval.submit_gradient(-inv_rho_cp * th_conductivity_grad, q);
+    _constant_coefficient_batches[cell] = constant_coefficients;
+  }
+}
 
-      // Compute source term
-      dealii::Point<dim, dealii::VectorizedArray<double>> const &q_point =
-          fe_eval.quadrature_point(q);
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+template <typename Number>
+bool ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    has_constant_coefficients(
+        [[maybe_unused]] unsigned int cell,
+        [[maybe_unused]] CellEvaluation<Number> const &fe_eval) const
+{
+  if constexpr (!temperature_independent)
+  {
+    return false;
+  }
+  else
+  {
+    if (!_constant_coefficient_batches[cell])
+      return false;
 
-      dealii::VectorizedArray<double> quad_pt_source = 0.0;
-      for (unsigned int i = 0;
-           i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+    // If the temperature reaches the solidus, the latent heat and the
+    // properties of the liquid need to be taken into account.
+    if constexpr (!std::is_same_v<MaterialStates, Solid>)
+    {
+      unsigned int const n_active_entries =
+          _matrix_free->n_active_entries_per_cell_batch(cell);
+      auto const &solidus = _cell_solidus[cell];
+      for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
       {
-        dealii::Point<dim> q_point_loc;
-        for (unsigned int d = 0; d < dim; ++d)
-          q_point_loc(d) = q_point(d)[i];
-
-        for (auto &beam : _heat_sources)
-          quad_pt_source[i] += beam->value(q_point_loc, _current_source_height);
+        auto const temperature = fe_eval.get_value(q);
+        for (unsigned int n = 0; n < n_active_entries; ++n)
+          if (!(temperature[n] < solidus[n]))
+            return false;
       }
-      quad_pt_source *= inv_rho_cp;
-
-      fe_eval.submit_value(quad_pt_source, q);
     }
-    // Sum over the quadrature points.
-    fe_eval.integrate(dealii::EvaluationFlags::values |
-                      dealii::EvaluationFlags::gradients);
-    fe_eval.distribute_local_to_global(dst);
+
+    return true;
   }
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
           typename MaterialStates, typename MemorySpaceType>
+template <typename Number>
 void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                      MemorySpaceType>::
-    face_local_apply(
-        dealii::MatrixFree<dim, double> const &data,
-        dealii::LA::distributed::Vector<double, MemorySpaceType> &dst,
-        dealii::LA::distributed::Vector<double, MemorySpaceType> const &src,
-        std::pair<unsigned int, unsigned int> const &face_range) const
+    apply_constant_coefficients(unsigned int cell,
+                                CellEvaluation<Number> &fe_eval) const
+{
+  for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+  {
+    auto const &inv_rho_cp = _constant_inv_rho_cp(cell, q);
+    auto const &thermal_conductivity = _constant_thermal_conductivity(cell, q);
+    auto const grad = internal::convert<double>(fe_eval.get_gradient(q));
+    auto th_conductivity_grad = grad;
+    if constexpr (dim == 2)
+    {
+      th_conductivity_grad[axis<dim>::x] *=
+          thermal_conductivity[axis<dim>::x][axis<dim>::x];
+      th_conductivity_grad[axis<dim>::z] *=
+          thermal_conductivity[axis<dim>::z][axis<dim>::z];
+    }
+    else
+    {
+      th_conductivity_grad[axis<dim>::x] =
+          thermal_conductivity[axis<dim>::x][axis<dim>::x] *
+              grad[axis<dim>::x] +
+          thermal_conductivity[axis<dim>::x][axis<dim>::y] *
+              grad[axis<dim>::y];
+      th_conductivity_grad[axis<dim>::y] =
+          thermal_conductivity[axis<dim>::x][axis<dim>::y] *
+              grad[axis<dim>::x] +
+          thermal_conductivity[axis<dim>::y][axis<dim>::y] *
+              grad[axis<dim>::y];
+      th_conductivity_grad[axis<dim>::z] *=
+          thermal_conductivity[axis<dim>::z][axis<dim>::z];
+    }
+    fe_eval.submit_gradient(
+        internal::convert<Number>(-inv_rho_cp * th_conductivity_grad), q);
+
+    // The whole cell batch is below the solidus
+    if constexpr (!std::is_same_v<MaterialStates, Solid>)
+      _liquid_ratio(cell, q) = 0.;
+
+    dealii::VectorizedArray<double> quad_pt_source = get_heat_source(
+        cell, internal::convert<double>(fe_eval.quadrature_point(q)));
+    quad_pt_source *= inv_rho_cp;
+    if (!_cell_deposited.empty())
+      quad_pt_source *= _cell_deposited[cell];
+    fe_eval.submit_value(internal::convert<Number>(quad_pt_source), q);
+  }
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+bool ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    is_activated_domain_boundary(
+        std::pair<unsigned int, unsigned int> const &adjacent_cells_fe_index)
 {
-  // Get the fe_indices of the cells that share faces in face_range;
-  auto const adjacent_cells_fe_index = data.get_face_range_category(face_range);
   // We now have four cases:
   //  - cell_1 = cell_2 = FE_Q: internal face of the activated domain
   //  - cell_1/2 = FE_Q and cell_2/1 = FE_Nothing/does not exit: boundary of
@@ -662,27 +1268,32 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
   // domain, we need to check that cell_1 is different than cell_2 and that at
   // one of the two cells is using FE_Q
   if (adjacent_cells_fe_index.first == adjacent_cells_fe_index.second)
-  {
-    return;
-  }
-  if ((adjacent_cells_fe_index.first != 0 &&
-       adjacent_cells_fe_index.second != 0))
-  {
+    return false;
+
+  return (adjacent_cells_fe_index.first == 0) ||
+         (adjacent_cells_fe_index.second == 0);
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+template <typename Number>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    face_local_apply(
+        MatrixFreeType<Number> const &data,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src,
+        std::pair<unsigned int, unsigned int> const &face_range) const
+{
+  // Get the fe_indices of the cells that share faces in face_range;
+  auto const adjacent_cells_fe_index = data.get_face_range_category(face_range);
+  if (!is_activated_domain_boundary(adjacent_cells_fe_index))
     return;
-  }
 
   // Create the FEFaceEvaluation object. The boolean in the constructor is
   // used to decided which cell the face should be exterior to.
-  dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, double>
-      fe_face_eval(data, adjacent_cells_fe_index.first == 0);
-  std::array<dealii::VectorizedArray<double>, MaterialStates::n_material_states>
-      face_state_ratios;
-
-  // Create variables used to compute boundary conditions.
-  auto conv_temperature_infty = dealii::make_vectorized_array<double>(0.);
-  auto conv_heat_transfer_coef = dealii::make_vectorized_array<double>(0.);
-  auto rad_temperature_infty = dealii::make_vectorized_array<double>(0.);
-  auto rad_heat_transfer_coef = dealii::make_vectorized_array<double>(0.);
+  FaceEvaluation<Number> fe_face_eval(data,
+                                      adjacent_cells_fe_index.first == 0);
 
   // We need powers of temperature to compute the material properties. We
   // could compute it in MaterialProperty but because it's in a hot loop.
@@ -694,73 +1305,101 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
   // Loop over the faces
   for (unsigned int face = face_range.first; face < face_range.second; ++face)
   {
+    if (!_evaluated_face_batches.empty() && !_evaluated_face_batches[face])
+      continue;
     // Reinit fe_face_eval on the current face
     fe_face_eval.reinit(face);
-    // Store in a local vector the local values of src
-    fe_face_eval.read_dof_values(src);
-    // Evalue the function on the reference cell
-    fe_face_eval.evaluate(dealii::EvaluationFlags::values);
-    // Apply the Jacobian of the transformation, mutliply by the variable
-    // coefficients and the quadrature points
-    for (unsigned int q = 0; q < fe_face_eval.n_q_points; ++q)
-    {
-      auto temperature = fe_face_eval.get_value(q);
-      // Precompute the powers of temperature.
-      for (unsigned int i = 0; i <= p_order; ++i)
-      {
-        // FIXME Need to cast i to double due to a limitation in deal.II 9.5
-        temperature_powers[i] = std::pow(temperature, static_cast<double>(i));
-      }
+    apply_on_face_batch(face, fe_face_eval, temperature_powers, dst, src);
+  }
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+template <typename Number>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    apply_on_face_batch(
+        unsigned int face, FaceEvaluation<Number> &fe_face_eval,
+        dealii::AlignedVector<dealii::VectorizedArray<double>>
+            &temperature_powers,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> &dst,
+        dealii::LA::distributed::Vector<Number, MemorySpaceType> const &src)
+        const
+{
+  std::array<dealii::VectorizedArray<double>, MaterialStates::n_material_states>
+      face_state_ratios;
+
+  // Create variables used to compute boundary conditions.
+  auto conv_temperature_infty = dealii::make_vectorized_array<double>(0.);
+  auto conv_heat_transfer_coef = dealii::make_vectorized_array<double>(0.);
+  auto rad_temperature_infty = dealii::make_vectorized_array<double>(0.);
+  auto rad_heat_transfer_coef = dealii::make_vectorized_array<double>(0.);
 
-      // Compute the local_properties
-      auto material_id = _face_material_id(face, q);
-      update_face_state_ratios(face, q, temperature, face_state_ratios);
-      auto const inv_rho_cp = get_inv_rho_cp(material_id, face_state_ratios,
-                                             temperature, temperature_powers);
-      if (_boundary_type & BoundaryType::convective)
+  // Store in a local vector the local values of src
+  fe_face_eval.read_dof_values(src);
+  // Evalue the function on the reference cell
+  fe_face_eval.evaluate(dealii::EvaluationFlags::values);
+  // Apply the Jacobian of the transformation, mutliply by the variable
+  // coefficients and the quadrature points
+  for (unsigned int q = 0; q < fe_face_eval.n_q_points; ++q)
+  {
+    // The material properties are evaluated in double precision
+    auto temperature = internal::convert<double>(fe_face_eval.get_value(q));
+    // Precompute the powers of temperature.
+    internal::compute_temperature_powers(temperature, temperature_powers);
+
+    // Compute the local_properties
+    auto const &material_id = _face_material_id(face, q);
+    update_face_state_ratios(face, q, temperature, face_state_ratios);
+    auto const inv_rho_cp = get_inv_rho_cp(
+        material_id, face_state_ratios, temperature, temperature_powers,
+        get_latent_heat_coefficient(material_id));
+    if (_boundary_type & BoundaryType::convective)
+    {
+      for (unsigned int n = 0; n < conv_temperature_infty.size(); ++n)
       {
-        for (unsigned int n = 0; n < conv_temperature_infty.size(); ++n)
-        {
-          conv_temperature_infty[n] = _material_properties.get(
-              material_id[n], Property::convection_temperature_infty);
-        }
-        conv_heat_transfer_coef =
-            _material_properties.template compute_material_property<use_table>(
-                StateProperty::convection_heat_transfer_coef,
-                material_id.data(), face_state_ratios.data(), temperature,
-                temperature_powers);
+        conv_temperature_infty[n] = _material_properties.get(
+            material_id[n], Property::convection_temperature_infty);
       }
-      if (_boundary_type & BoundaryType::radiative)
+      conv_heat_transfer_coef =
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::convection_heat_transfer_coef,
+              material_id.data(), face_state_ratios.data(), temperature,
+              temperature_powers);
+    }
+    if (_boundary_type & BoundaryType::radiative)
+    {
+      for (unsigned int n = 0; n < rad_temperature_infty.size(); ++n)
       {
-        for (unsigned int n = 0; n < rad_temperature_infty.size(); ++n)
-        {
-          rad_temperature_infty[n] = _material_properties.get(
-              material_id[n], Property::radiation_temperature_infty);
-        }
-
-        // We need the radiation heat transfer coefficient but it is not a
-        // real material property but it is derived from other material
-        // properties: h_rad = emissitivity * stefan-boltzmann constant * (T
-        // + T_infty) (T^2 + T^2_infty).
-        rad_heat_transfer_coef =
-            _material_properties.template compute_material_property<use_table>(
-                StateProperty::emissivity, material_id.data(),
-                face_state_ratios.data(), temperature, temperature_powers) *
-            Constant::stefan_boltzmann * (temperature + rad_temperature_infty) *
-            (temperature * temperature +
-             rad_temperature_infty * rad_temperature_infty);
+        rad_temperature_infty[n] = _material_properties.get(
+            material_id[n], Property::radiation_temperature_infty);
       }
 
-      auto const boundary_val =
-          -inv_rho_cp *
-          (conv_heat_transfer_coef * (temperature - conv_temperature_infty) +
-           rad_heat_transfer_coef * (temperature - rad_temperature_infty));
-      fe_face_eval.submit_value(boundary_val * fe_face_eval.get_value(q), q);
+      // We need the radiation heat transfer coefficient but it is not a
+      // real material property but it is derived from other material
+      // properties: h_rad = emissitivity * stefan-boltzmann constant * (T
+      // + T_infty) (T^2 + T^2_infty).
+      rad_heat_transfer_coef =
+          _material_properties.template compute_material_property<use_table>(
+              StateProperty::emissivity, material_id.data(),
+              face_state_ratios.data(), temperature, temperature_powers) *
+          Constant::stefan_boltzmann * (temperature + rad_temperature_infty) *
+          (temperature * temperature +
+           rad_temperature_infty * rad_temperature_infty);
     }
-    // Sum over the quadrature points
-    fe_face_eval.integrate(dealii::EvaluationFlags::values);
-    fe_face_eval.distribute_local_to_global(dst);
+
+    auto boundary_val =
+        -inv_rho_cp *
+        (conv_heat_transfer_coef * (temperature - conv_temperature_infty) +
+         rad_heat_transfer_coef * (temperature - rad_temperature_infty));
+    if (!_face_deposited.empty())
+      boundary_val *= _face_deposited[face];
+    fe_face_eval.submit_value(
+        internal::convert<Number>(boundary_val * temperature), q);
   }
+  // Sum over the quadrature points
+  fe_face_eval.integrate(dealii::EvaluationFlags::values);
+  fe_face_eval.distribute_local_to_global(dst);
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -768,9 +1407,9 @@ template <int dim, bool use_table, int p_order, int fe_degree,
 void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                      MemorySpaceType>::get_state_from_material_properties()
 {
-  unsigned int const n_cells = _matrix_free.n_cell_batches();
+  unsigned int const n_cells = _matrix_free->n_cell_batches();
   dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, double> fe_eval(
-      _matrix_free);
+      *_matrix_free);
 
   if constexpr (!std::is_same_v<MaterialStates, Solid>)
   {
@@ -783,14 +1422,15 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
   }
 
   _material_id.reinit(n_cells, fe_eval.n_q_points);
+  _constant_coefficients_outdated = true;
 
   for (unsigned int cell = 0; cell < n_cells; ++cell)
     for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
       for (unsigned int i = 0;
-           i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+           i < _matrix_free->n_active_entries_per_cell_batch(cell); ++i)
       {
         typename dealii::DoFHandler<dim>::cell_iterator cell_it =
-            _matrix_free.get_cell_iterator(cell, i);
+            _matrix_free->get_cell_iterator(cell, i);
         // Cast to Triangulation<dim>::cell_iterator to access the material_id
         typename dealii::Triangulation<dim>::active_cell_iterator cell_tria(
             cell_it);
@@ -810,16 +1450,36 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
         _material_id(cell, q)[i] = cell_tria->material_id();
       }
 
+  // The state-independent material properties only depend on the material of
+  // the cells. They are cached for each cell batch instead of being read at
+  // every quadrature point and every stage of the time stepping scheme.
+  _cell_solidus.resize(n_cells);
+  _cell_liquidus.resize(n_cells);
+  _cell_latent_heat_coefficient.resize(n_cells);
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+  {
+    auto const &material_id = _material_id(cell, 0);
+    for (unsigned int n = 0; n < n_lanes; ++n)
+    {
+      _cell_solidus[cell][n] =
+          _material_properties.get(material_id[n], Property::solidus);
+      _cell_liquidus[cell][n] =
+          _material_properties.get(material_id[n], Property::liquidus);
+    }
+    _cell_latent_heat_coefficient[cell] =
+        get_latent_heat_coefficient(material_id);
+  }
+
   // If we are using boundary conditions other than adiabatic, we also need to
   // update the face variables
   if (!(_boundary_type & BoundaryType::adiabatic))
   {
-    unsigned int const n_inner_faces = _matrix_free.n_inner_face_batches();
+    unsigned int const n_inner_faces = _matrix_free->n_inner_face_batches();
     unsigned int const n_boundary_faces =
-        _matrix_free.n_boundary_face_batches();
+        _matrix_free->n_boundary_face_batches();
     unsigned int const n_faces = n_inner_faces + n_boundary_faces;
     dealii::FEFaceEvaluation<dim, fe_degree, fe_degree + 1, 1, double>
-        fe_face_eval(_matrix_free, true);
+        fe_face_eval(*_matrix_free, true);
 
     if constexpr (std::is_same_v<MaterialStates, SolidLiquidPowder>)
     {
@@ -831,12 +1491,13 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
     for (unsigned int face = 0; face < n_inner_faces; ++face)
       for (unsigned int q = 0; q < fe_face_eval.n_q_points; ++q)
         for (unsigned int i = 0;
-             i < _matrix_free.n_active_entries_per_face_batch(face); ++i)
+             i < _matrix_free->n_active_entries_per_face_batch(face); ++i)
         {
           // We get the two cells associated with the face
-          auto [cell_1, face_1] = _matrix_free.get_face_iterator(face, i, true);
+          auto [cell_1, face_1] =
+              _matrix_free->get_face_iterator(face, i, true);
           auto [cell_2, face_2] =
-              _matrix_free.get_face_iterator(face, i, false);
+              _matrix_free->get_face_iterator(face, i, false);
           // We only care for cells that are at the boundary between activated
           // and deactivated domains
           unsigned int const active_fe_index_1 = cell_1->active_fe_index();
@@ -866,10 +1527,10 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
     for (unsigned int face = n_inner_faces; face < n_faces; ++face)
       for (unsigned int q = 0; q < fe_face_eval.n_q_points; ++q)
         for (unsigned int i = 0;
-             i < _matrix_free.n_active_entries_per_face_batch(face); ++i)
+             i < _matrix_free->n_active_entries_per_face_batch(face); ++i)
         {
           // We get one cell associated with the face
-          auto [cell, face_] = _matrix_free.get_face_iterator(face, i, true);
+          auto [cell, face_] = _matrix_free->get_face_iterator(face, i, true);
           unsigned int const active_fe_index = cell->active_fe_index();
           if (active_fe_index == 1)
           {
@@ -901,8 +1562,8 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
                      MemorySpaceType>::set_state_to_material_properties()
 {
   _material_properties.set_state(_liquid_ratio, _powder_ratio,
-                                 _cell_it_to_mf_cell_map,
-                                 _matrix_free.get_dof_handler());
+                                 *_cell_it_to_mf_cell_map,
+                                 _matrix_free->get_dof_handler());
 }
 
 template <int dim, bool use_table, int p_order, int fe_degree,
@@ -913,18 +1574,20 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
         std::vector<double> const &deposition_cos,
         std::vector<double> const &deposition_sin)
 {
-  unsigned int const n_cells = _matrix_free.n_cell_batches();
+  unsigned int const n_cells = _matrix_free->n_cell_batches();
   dealii::FEEvaluation<dim, fe_degree, fe_degree + 1, 1, double> fe_eval(
-      _matrix_free);
+      *_matrix_free);
 
-  _deposition_cos.reinit(n_cells, fe_eval.n_q_points);
-  _deposition_sin.reinit(n_cells, fe_eval.n_q_points);
+  _deposition_cos_cos.reinit(n_cells, fe_eval.n_q_points);
+  _deposition_sin_sin.reinit(n_cells, fe_eval.n_q_points);
+  _deposition_sin_cos.reinit(n_cells, fe_eval.n_q_points);
+  _constant_coefficients_outdated = true;
 
   using dof_cell_iterator = typename dealii::DoFHandler<dim>::cell_iterator;
   std::map<dof_cell_iterator, unsigned int> cell_mapping;
   unsigned int pos = 0;
   for (auto const &cell : dealii::filter_iterators(
-           _matrix_free.get_dof_handler().active_cell_iterators(),
+           _matrix_free->get_dof_handler().active_cell_iterators(),
            dealii::IteratorFilters::LocallyOwnedCell(),
            dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
   {
@@ -937,19 +1600,149 @@ void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
   for (unsigned int cell = 0; cell < n_cells; ++cell)
     for (unsigned int q = 0; q < fe_eval.n_q_points; ++q)
       for (unsigned int i = 0;
-           i < _matrix_free.n_active_entries_per_cell_batch(cell); ++i)
+           i < _matrix_free->n_active_entries_per_cell_batch(cell); ++i)
       {
-        dof_cell_iterator cell_it = _matrix_free.get_cell_iterator(cell, i);
+        dof_cell_iterator cell_it = _matrix_free->get_cell_iterator(cell, i);
 
         if (cell_it->active_fe_index() == 0)
         {
           unsigned int const j = cell_mapping[cell_it];
-          _deposition_cos(cell, q)[i] = deposition_cos[j];
-          _deposition_sin(cell, q)[i] = deposition_sin[j];
+          double const cos = deposition_cos[j];
+          double const sin = deposition_sin[j];
+          _deposition_cos_cos(cell, q)[i] = cos * cos;
+          _deposition_sin_sin(cell, q)[i] = sin * sin;
+          _deposition_sin_cos(cell, q)[i] = sin * cos;
         }
       }
 }
 
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    set_quiet_cells(std::vector<bool> const &quiet_cells,
+                    double conductivity_scaling, double capacity_scaling)
+{
+  _cell_quiet_scaling.clear();
+  _cell_deposited.clear();
+  _face_deposited.clear();
+  _constant_coefficients_outdated = true;
+
+  // Nothing to do if all the locally owned cells contain material.
+  if (std::find(quiet_cells.begin(), quiet_cells.end(), true) ==
+      quiet_cells.end())
+    return;
+
+  // Flag the quiet cells using the active cell index.
+  auto const &dof_handler = _matrix_free->get_dof_handler();
+  std::vector<bool> is_quiet(dof_handler.get_triangulation().n_active_cells(),
+                             false);
+  unsigned int pos = 0;
+  for (auto const &cell : dealii::filter_iterators(
+           dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    is_quiet[cell->active_cell_index()] = quiet_cells[pos];
+    ++pos;
+  }
+  ASSERT(pos == quiet_cells.size(), "Wrong number of cells.");
+
+  double const quiet_scaling = conductivity_scaling / capacity_scaling;
+  auto const one = dealii::make_vectorized_array<double>(1.);
+  unsigned int const n_cells = _matrix_free->n_cell_batches();
+  _cell_quiet_scaling.resize(n_cells, one);
+  _cell_deposited.resize(n_cells, one);
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+    for (unsigned int i = 0;
+         i < _matrix_free->n_active_entries_per_cell_batch(cell); ++i)
+      if (is_quiet[_matrix_free->get_cell_iterator(cell, i)
+                       ->active_cell_index()])
+      {
+        _cell_quiet_scaling[cell][i] = quiet_scaling;
+        _cell_deposited[cell][i] = 0.;
+      }
+
+  if (!(_boundary_type & BoundaryType::adiabatic))
+  {
+    unsigned int const n_inner_faces = _matrix_free->n_inner_face_batches();
+    unsigned int const n_faces =
+        n_inner_faces + _matrix_free->n_boundary_face_batches();
+    _face_deposited.resize(n_faces, one);
+    for (unsigned int face = 0; face < n_faces; ++face)
+      for (unsigned int i = 0;
+           i < _matrix_free->n_active_entries_per_face_batch(face); ++i)
+      {
+        // Same as in get_state_from_material_properties, we need the cell
+        // that has FE_Q.
+        auto cell = _matrix_free->get_face_iterator(face, i, true).first;
+        if ((face < n_inner_faces) && (cell->active_fe_index() != 0))
+          cell = _matrix_free->get_face_iterator(face, i, false).first;
+        if (cell->is_locally_owned() && is_quiet[cell->active_cell_index()])
+          _face_deposited[face][i] = 0.;
+      }
+  }
+}
+
+template <int dim, bool use_table, int p_order, int fe_degree,
+          typename MaterialStates, typename MemorySpaceType>
+void ThermalOperator<dim, use_table, p_order, fe_degree, MaterialStates,
+                     MemorySpaceType>::
+    set_evaluated_cells(std::vector<bool> const &evaluated_cells)
+{
+  _evaluated_cell_batches.clear();
+  _evaluated_face_batches.clear();
+
+  if (evaluated_cells.empty())
+    return;
+
+  // Flag the evaluated cells using the active cell index.
+  auto const &dof_handler = _matrix_free->get_dof_handler();
+  std::vector<bool> is_evaluated(
+      dof_handler.get_triangulation().n_active_cells(), false);
+  unsigned int pos = 0;
+  for (auto const &cell : dealii::filter_iterators(
+           dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    is_evaluated[cell->active_cell_index()] = evaluated_cells[pos];
+    ++pos;
+  }
+  ASSERT(pos == evaluated_cells.size(), "Wrong number of cells.");
+
+  // A batch is evaluated as soon as one of its lanes is evaluated.
+  unsigned int const n_cells = _matrix_free->n_cell_batches();
+  _evaluated_cell_batches.resize(n_cells, false);
+  for (unsigned int cell = 0; cell < n_cells; ++cell)
+    for (unsigned int i = 0;
+         i < _matrix_free->n_active_entries_per_cell_batch(cell); ++i)
+      if (is_evaluated[_matrix_free->get_cell_iterator(cell, i)
+                           ->active_cell_index()])
+        _evaluated_cell_batches[cell] = true;
+
+  if (!(_boundary_type & BoundaryType::adiabatic))
+  {
+    unsigned int const n_inner_faces = _matrix_free->n_inner_face_batches();
+    unsigned int const n_faces =
+        n_inner_faces + _matrix_free->n_boundary_face_batches();
+    _evaluated_face_batches.resize(n_faces, false);
+    for (unsigned int face = 0; face < n_faces; ++face)
+      for (unsigned int i = 0;
+           i < _matrix_free->n_active_entries_per_face_batch(face); ++i)
+      {
+        // Same as in set_quiet_cells, we need the cell that has FE_Q. We do
+        // not know if a ghost cell is evaluated so its faces always are.
+        auto cell = _matrix_free->get_face_iterator(face, i, true).first;
+        if ((face < n_inner_faces) && (cell->active_fe_index() != 0))
+          cell = _matrix_free->get_face_iterator(face, i, false).first;
+        if (!cell->is_locally_owned() ||
+            is_evaluated[cell->active_cell_index()])
+          _evaluated_face_batches[face] = true;
+      }
+  }
+}
+
 } // namespace adamantine
 
 #endif
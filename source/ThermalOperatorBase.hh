@@ -40,6 +40,15 @@ public:
 
   virtual void clear() = 0;
 
+  /**
+   * Use the data that only depends on the mesh, e.g., the MatrixFree object
+   * and the inverse of the mass matrix, of @p thermal_operator instead of
+   * building new data. The shared data is only rebuilt by @p thermal_operator,
+   * which needs to be reinitialized before this operator.
+   */
+  virtual void share_discretization(
+      ThermalOperatorBase<dim, MemorySpaceType> &thermal_operator) = 0;
+
   virtual void get_state_from_material_properties() = 0;
 
   virtual void set_state_to_material_properties() = 0;
@@ -49,6 +58,47 @@ public:
       std::vector<double> const &deposition_sin) = 0;
 
   virtual void set_time_and_source_height(double, double) = 0;
+
+  /**
+   * Flag the cells that are meshed but that do not contain deposited material
+   * yet. @p quiet_cells uses the same ordering as the deposition angles. The
+   * conductivity and the heat capacity of the quiet cells are multiplied by
+   * @p conductivity_scaling and @p capacity_scaling respectively.
+   */
+  virtual void set_quiet_cells(std::vector<bool> const &quiet_cells,
+                               double conductivity_scaling,
+                               double capacity_scaling) = 0;
+
+  /**
+   * Restrict the application of the operator to the cell batches that contain
+   * at least one of the @p evaluated_cells. @p evaluated_cells uses the same
+   * ordering as the deposition angles. If @p evaluated_cells is empty, the
+   * operator is applied on all the cells. The restriction is removed by
+   * reinit().
+   */
+  virtual void
+  set_evaluated_cells(std::vector<bool> const &evaluated_cells) = 0;
+
+  /**
+   * Apply the operators @p member_operators of the ensemble members to the
+   * vectors @p src and add the results to @p dst in a single sweep over the
+   * mesh. The operators must use the same mesh as this operator.
+   */
+  virtual void vmult_add_ensemble(
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &dst,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType>
+                      const *> const &src,
+      std::vector<ThermalOperatorBase<dim, MemorySpaceType> const *> const
+          &member_operators) const = 0;
+
+  /**
+   * Return the largest relative difference between the single precision and
+   * the double precision applications of the operator. The difference is only
+   * measured when the validation of the mixed precision is enabled, otherwise
+   * zero is returned.
+   */
+  virtual double get_mixed_precision_difference() const = 0;
 };
 } // namespace adamantine
 #endif
@@ -34,6 +34,15 @@ public:
 
   void clear() override;
 
+  /**
+   * The operator on the device keeps its own MatrixFree object and its own
+   * inverse of the mass matrix, only the DoFHandler is shared.
+   */
+  void
+  share_discretization(ThermalOperatorBase<dim, MemorySpaceType> &) override
+  {
+  }
+
   dealii::types::global_dof_index m() const override;
 
   dealii::types::global_dof_index n() const override;
@@ -88,6 +97,43 @@ public:
     // TODO
   }
 
+  /**
+   * Mixed precision is not supported on the device.
+   */
+  double get_mixed_precision_difference() const override { return 0.; }
+
+  /**
+   * Quiet cells are not supported on the device.
+   */
+  void set_quiet_cells(std::vector<bool> const &, double, double) override
+  {
+    ASSERT_THROW(false, "Error: Quiet cells are not supported on the device.");
+  }
+
+  /**
+   * Multirate time stepping is not supported on the device.
+   */
+  void set_evaluated_cells(std::vector<bool> const &) override
+  {
+    ASSERT_THROW(false, "Error: Multirate time stepping is not supported on "
+                        "the device.");
+  }
+
+  /**
+   * The ensemble operator is not supported on the device.
+   */
+  void vmult_add_ensemble(
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType>
+                      const *> const &,
+      std::vector<ThermalOperatorBase<dim, MemorySpaceType> const *> const &)
+      const override
+  {
+    ASSERT_THROW(false, "Error: The ensemble operator is not supported on the "
+                        "device.");
+  }
+
   /**
    * Update \f$ \frac{1}{\rho C_p} \f$ on the cells using the values computed at
    * the quadrature points.
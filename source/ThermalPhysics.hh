@@ -5,16 +5,19 @@
 #ifndef THERMAL_PHYSICS_HH
 #define THERMAL_PHYSICS_HH
 
+#include <CellDataBuffer.hh>
 #include <Geometry.hh>
 #include <HeatSource.hh>
 #include <ImplicitOperator.hh>
+#include <NewtonSolver.hh>
 #include <ThermalOperatorBase.hh>
 #include <ThermalPhysicsInterface.hh>
 
+#include <deal.II/base/bounding_box.h>
 #include <deal.II/base/time_stepping.h>
 #include <deal.II/base/time_stepping.templates.h>
-#include <deal.II/distributed/cell_data_transfer.templates.h>
 #include <deal.II/distributed/cell_weights.h>
+#include <deal.II/distributed/solution_transfer.h>
 #include <deal.II/hp/fe_collection.h>
 
 #include <boost/property_tree/ptree.hpp>
@@ -45,6 +48,9 @@ public:
 
   void setup_dofs() override;
 
+  void share_discretization(
+      ThermalPhysicsInterface<dim, MemorySpaceType> &owner) override;
+
   void compute_inverse_mass_matrix() override;
 
   void add_material_start(
@@ -62,6 +68,43 @@ public:
                         dealii::LA::distributed::Vector<double, MemorySpaceType>
                             &solution) override;
 
+  void mesh_change_start(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
+      override;
+
+  void mesh_change_activate(
+      std::vector<std::vector<
+          typename dealii::DoFHandler<dim>::active_cell_iterator>> const
+          &elements_to_activate,
+      std::vector<double> const &new_deposition_cos,
+      std::vector<double> const &new_deposition_sin,
+      std::vector<bool> &new_has_melted, unsigned int const activation_start,
+      unsigned int const activation_end) override;
+
+  void mesh_change_prepare_pass() override;
+
+  void mesh_change_complete_pass() override;
+
+  void mesh_change_end(double const new_material_temperature,
+                       dealii::LA::distributed::Vector<double, MemorySpaceType>
+                           &solution) override;
+
+  bool use_quiet_elements() const override;
+
+  std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>
+  get_quiet_cell_iterators() const override;
+
+  void activate_quiet_cells(
+      std::vector<std::vector<
+          typename dealii::DoFHandler<dim>::active_cell_iterator>> const
+          &elements_to_activate,
+      std::vector<double> const &new_deposition_cos,
+      std::vector<double> const &new_deposition_sin,
+      unsigned int const activation_start, unsigned int const activation_end,
+      double const new_material_temperature,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
+      override;
+
   /**
    * For ThermalPhysics, update_physics_parameters is used to modify the heat
    * sources in the middle of a simulation, e.g. for data assimilation with an
@@ -75,6 +118,14 @@ public:
       dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
       std::vector<Timer> &timers) override;
 
+  double evolve_ensemble_one_time_step(
+      double t, double delta_t,
+      std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+          &members,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &solutions,
+      std::vector<Timer> &timers) override;
+
   void
   initialize_dof_vector(double const value,
                         dealii::LA::distributed::Vector<double, MemorySpaceType>
@@ -92,6 +143,20 @@ public:
                        dealii::LA::distributed::Vector<double, MemorySpaceType>
                            &temperature) override;
 
+  void load_ensemble_checkpoint(
+      std::string const &filename,
+      std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+          &members,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &temperatures) override;
+
+  void save_ensemble_checkpoint(
+      std::string const &filename,
+      std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+          &members,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &temperatures) override;
+
   void set_material_deposition_orientation(
       std::vector<double> const &deposition_cos,
       std::vector<double> const &deposition_sin) override;
@@ -110,6 +175,10 @@ public:
 
   bool get_has_melted(unsigned int const i) const override;
 
+  bool get_quiet_cell(unsigned int const i) const override;
+
+  void set_quiet_cells_vector(std::vector<bool> const &quiet_cells) override;
+
   dealii::DoFHandler<dim> &get_dof_handler() override;
 
   dealii::AffineConstraints<double> &get_affine_constraints() override;
@@ -118,6 +187,10 @@ public:
 
   unsigned int get_fe_degree() const override;
 
+  double get_locally_owned_weight() const override;
+
+  double get_mixed_precision_difference() const override;
+
   /**
    * Return the current height of the heat source.
    */
@@ -126,6 +199,8 @@ public:
 private:
   using LA_Vector =
       typename dealii::LA::distributed::Vector<double, MemorySpaceType>;
+  using SolutionTransfer = dealii::parallel::distributed::SolutionTransfer<
+      dim, dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>;
 
   /**
    * Update the depostion cosine and sine from the Physics object to the
@@ -133,6 +208,26 @@ private:
    */
   void update_material_deposition_orientation();
 
+  /**
+   * Update the quiet cells from the Physics object to the operator object.
+   */
+  void update_quiet_cells();
+
+  /**
+   * Reset the spectral radius estimated by RKL2. This needs to be called every
+   * time the coefficients of the operator change.
+   */
+  void reset_spectral_radius();
+
+  /**
+   * Compute the load balancing weight of a cell given the finite element that
+   * the cell will use after the mesh has been updated.
+   */
+  unsigned int
+  compute_cell_weight(typename dealii::DoFHandler<dim>::cell_iterator const
+                          &cell,
+                      dealii::FiniteElement<dim> const &future_fe) const;
+
   /**
    * Compute the right-hand side and apply the TermalOperator.
    */
@@ -146,10 +241,199 @@ private:
                                    LA_Vector const &y,
                                    std::vector<Timer> &timers) const;
 
+  /**
+   * Update the height of the heat sources and the time window swept by the
+   * time averaged heat sources for the time step [@p t, @p t + @p delta_t].
+   */
+  void update_heat_sources(double t, double delta_t);
+
+  /**
+   * Attach the material state, the deposition angles, the FE indices, and
+   * @p temperature to the Triangulation before it is saved. The objects
+   * passed to this function need to be alive until the Triangulation is
+   * saved.
+   */
+  void prepare_checkpoint(
+      LA_Vector const &temperature, CellDataBuffer<dim> &data_to_serialize,
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+          &ghosted_temperature,
+      SolutionTransfer &solution_transfer);
+
+  /**
+   * Retrieve the data attached by prepare_checkpoint() after the
+   * Triangulation has been loaded and rebuild the degrees of freedom and the
+   * operators.
+   */
+  void restore_checkpoint(LA_Vector &temperature);
+
+  /**
+   * Check that @p members are ThermalPhysics objects that share the
+   * discretization of this object, which needs to be the first member, and
+   * that there is one temperature per member.
+   */
+  std::vector<ThermalPhysics *> get_ensemble_physics(
+      std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+          &members,
+      std::vector<LA_Vector *> const &temperatures);
+
+  /**
+   * Split the degrees of freedom between the fast region, which is sub-cycled
+   * during a multirate time step, and the slow region. This function needs to
+   * be called after every change of the mesh.
+   */
+  void update_multirate_partition();
+
+  /**
+   * Evolve @p solution using the multirate forward Euler method. The slow
+   * degrees of freedom take one step of size @p delta_t while the fast
+   * degrees of freedom take _multirate_n_substeps substeps. During the
+   * substeps, the slow degrees of freedom are interpolated linearly in time so
+   * that the fluxes at the interface between the two regions are interpolated
+   * too. Only the cell batches coupled to the fast degrees of freedom are
+   * evaluated during the substeps.
+   */
+  double evolve_one_time_step_multirate(double t, double delta_t,
+                                        LA_Vector &solution,
+                                        std::vector<Timer> &timers);
+
+  /**
+   * Flag the locally owned degrees of freedom of the cells flagged in @p
+   * cells, and the masters of their constrained degrees of freedom, in @p
+   * dofs. The cells that are coupled to the flagged degrees of freedom are
+   * flagged in @p coupled_cells. If @p interface_dofs is not null, the
+   * flagged degrees of freedom shared with cells that are not flagged are
+   * flagged in @p interface_dofs. The cells are the locally owned cells with
+   * material and their ordering is the same as the deposition angles.
+   */
+  void flag_coupled_dofs(std::vector<bool> const &cells,
+                         std::vector<bool> &dofs,
+                         std::vector<bool> &coupled_cells,
+                         std::vector<bool> *interface_dofs = nullptr) const;
+
+  /**
+   * Evolve @p solution while skipping the evaluation of the operator on the
+   * dormant cells. The dormant cells are the cells that have reached
+   * thermal equilibrium: the temperature rate and the temperature gradient
+   * are small and the cells are far from the heat sources. The degrees of
+   * freedom that are only shared by dormant cells are advanced using their
+   * rate computed during the last full evaluation. The dormant region is
+   * updated with a full evaluation every _dormant_update_interval time
+   * steps, when the rate on the interface with the dormant region rises, or
+   * when a heat source gets close to the dormant region.
+   */
+  double evolve_one_time_step_dormant(double t, double delta_t,
+                                      LA_Vector &solution,
+                                      std::vector<Timer> &timers);
+
+  /**
+   * Compute the dormant region using the temperature @p solution and the
+   * temperature rate _dormant_rates at time @p t.
+   */
+  void update_dormant_region(double t, LA_Vector const &solution);
+
+  /**
+   * Evolve @p solution using backward Euler. The non-linear system is solved
+   * with the Jacobian-free Newton-Krylov method: the Jacobian-vector products
+   * are finite differences of the right-hand side so the changes of the
+   * material properties and of the latent heat are taken into account. The
+   * linear systems are preconditioned by a Chebyshev polynomial of the
+   * Jacobian.
+   */
+  double evolve_one_time_step_newton_krylov(double t, double delta_t,
+                                            LA_Vector &solution,
+                                            std::vector<Timer> &timers);
+
   /**
    * This flag is true if the time stepping method is implicit.
    */
   bool _implicit_method = false;
+  /**
+   * This flag is true if the operator can be applied together with the
+   * operators of other ensemble members, i.e., if the time stepping method is
+   * forward Euler and the operator is applied on the whole mesh in double
+   * precision.
+   */
+  bool _batched_ensemble = false;
+  /**
+   * Degree of the Chebyshev polynomial used to precondition the Newton-Krylov
+   * method. No preconditioner is used if the degree is zero.
+   */
+  unsigned int _chebyshev_degree = 4;
+  /**
+   * Newton solver used by the Newton-Krylov method. The pointer is null if
+   * the method is not used.
+   */
+  std::unique_ptr<NewtonSolver> _newton_solver;
+  /**
+   * Number of substeps of the fast region during a multirate time step.
+   * Multirate time stepping is disabled if the value is one.
+   */
+  unsigned int _multirate_n_substeps = 1;
+  /**
+   * The cells whose level is greater or equal to _multirate_min_level form the
+   * fast region. If the value is negative, the fast region is made of the
+   * cells on the finest level of the mesh.
+   */
+  int _multirate_min_level = -1;
+  /**
+   * Flag for each locally owned degree of freedom in the fast region.
+   */
+  std::vector<bool> _multirate_fast_dofs;
+  /**
+   * Flag for each locally owned cell with material that is coupled to the
+   * fast region. The ordering is the same as the deposition angles.
+   */
+  std::vector<bool> _multirate_evaluated_cells;
+  /**
+   * Number of time steps between two full evaluations of the operator used
+   * to update the dormant region. The dormant region is not used if the
+   * value is zero.
+   */
+  unsigned int _dormant_update_interval = 0;
+  /**
+   * Number of time steps since the last update of the dormant region.
+   */
+  unsigned int _n_steps_since_dormant_update = 0;
+  /**
+   * A cell can become dormant if the absolute value of the temperature rate
+   * of all its degrees of freedom is less than this threshold.
+   */
+  double _dormant_rate_threshold = 0.;
+  /**
+   * A cell can become dormant if the variation of the temperature on the
+   * cell divided by its diameter is less than this threshold.
+   */
+  double _dormant_gradient_threshold = 0.;
+  /**
+   * A cell can become dormant if it is farther than this distance from the
+   * bounding boxes of all the heat sources.
+   */
+  double _dormant_distance = 0.;
+  /**
+   * Flag for each locally owned degree of freedom that is only shared by
+   * dormant cells.
+   */
+  std::vector<bool> _dormant_dofs;
+  /**
+   * Flag for each locally owned degree of freedom that is shared by a
+   * dormant cell and a cell that is not dormant.
+   */
+  std::vector<bool> _dormant_interface_dofs;
+  /**
+   * Flag for each locally owned cell with material that needs to be
+   * evaluated while the dormant region is used. The ordering is the same as
+   * the deposition angles.
+   */
+  std::vector<bool> _dormant_evaluated_cells;
+  /**
+   * Bounding boxes of the locally owned dormant cells.
+   */
+  std::vector<dealii::BoundingBox<dim>> _dormant_cell_bounding_boxes;
+  /**
+   * Temperature rate computed during the last full evaluation of the
+   * operator.
+   */
+  LA_Vector _dormant_rates;
   /**
    * This flag is true if right preconditioning is used to invert the
    * ImplicitOperator.
@@ -163,6 +447,25 @@ private:
    * Maximum number of temporary vectors when inverting the ImplicitOperator.
    */
   unsigned int _max_n_tmp_vectors;
+  /**
+   * This flag is true if the symmetric form of the ImplicitOperator is
+   * inverted using the conjugate gradient method instead of GMRES.
+   */
+  bool _use_cg = false;
+  /**
+   * This flag is true if the initial guess used to invert the
+   * ImplicitOperator is extrapolated from the previous time steps.
+   */
+  bool _extrapolate_initial_guess = false;
+  /**
+   * Time of the stages solved during the current time step.
+   */
+  mutable std::vector<double> _stage_times;
+  /**
+   * Solutions of the first inversion of the ImplicitOperator of each stage
+   * during the last two time steps. The most recent solution comes first.
+   */
+  mutable std::vector<std::vector<LA_Vector>> _previous_stage_solutions;
   /**
    * Tolerance to inverte the ImplicitOperator.
    */
@@ -184,22 +487,38 @@ private:
    */
   dealii::hp::FECollection<dim> _fe_collection;
   /**
-   * Associated DoFHandler.
+   * Associated DoFHandler. It is shared with the ensemble members that use the
+   * same mesh.
    */
-  dealii::DoFHandler<dim> _dof_handler;
+  std::shared_ptr<dealii::DoFHandler<dim>> _dof_handler;
   /**
-   * Associated AffineConstraints<double>.
+   * Associated AffineConstraints<double>. It is shared with the ensemble
+   * members that use the same mesh.
    */
-  dealii::AffineConstraints<double> _affine_constraints;
+  std::shared_ptr<dealii::AffineConstraints<double>> _affine_constraints;
+  /**
+   * Flag is true if _dof_handler and _affine_constraints are owned by another
+   * ThermalPhysics.
+   */
+  bool _shared_discretization = false;
   /**
    * Associated quadature, either Gauss or Gauss-Lobatto.
    */
   dealii::hp::QCollection<1> _q_collection;
+  /**
+   * Load balancing weight of a cell without material (FE_Nothing).
+   */
+  unsigned int _inactive_cell_weight = 0;
+  /**
+   * Additional load balancing weight of a cell per level of refinement.
+   */
+  unsigned int _refinement_level_weight = 0;
   /**
    * Object used to attach to each cell, a weight (used for load balancing)
-   * equal to the number of degrees of freedom associated with the cell.
+   * computed by compute_cell_weight(). The weights are only attached by the
+   * owner of the DoFHandler.
    */
-  dealii::parallel::CellWeights<dim> _cell_weights;
+  std::unique_ptr<dealii::parallel::CellWeights<dim>> _cell_weights;
   /**
    * Cosine of the material deposition angles.
    */
@@ -214,6 +533,24 @@ private:
    * that has melted.
    */
   std::vector<bool> _has_melted;
+  /**
+   * This flag is true if the cells without material use FE_Q and are kept
+   * quiet instead of using FE_Nothing.
+   */
+  bool _use_quiet_elements = false;
+  /**
+   * Scaling of the thermal conductivity of the quiet cells.
+   */
+  double _quiet_conductivity_scaling = 1e-6;
+  /**
+   * Scaling of the heat capacity of the quiet cells.
+   */
+  double _quiet_capacity_scaling = 1e-2;
+  /**
+   * Indicator variable for whether a cell is a quiet cell. The vector is only
+   * used when _use_quiet_elements is true.
+   */
+  std::vector<bool> _quiet_cells;
   /**
    * Associated material properties.
    */
@@ -237,23 +574,20 @@ private:
   std::unique_ptr<dealii::TimeStepping::RungeKutta<LA_Vector>> _time_stepping;
 
   /**
-   * Cell data transfer object used for updating _solution, _has_melted,
-   * _deposition_cos, _deposition_sin, and state of _material_properties when
-   * the triangulation is updated when adding material
-   */
-  std::unique_ptr<dealii::parallel::distributed::CellDataTransfer<
-      dim, dim, std::vector<std::vector<double>>>>
-      _cell_data_trans;
-
-  /**
-   * Temporary data used in _cell_data_trans for _solution
+   * Temporary data used to copy the temperature of a cell.
    */
   dealii::Vector<double> _cell_solution;
 
   /**
-   * Temporary data used in _cell_data_trans for transfer
+   * Data attached to each active cell during a mesh change. The data of a cell
+   * is stored in the following order: temperature at the degrees of freedom,
+   * direction of deposition (cosine and sine), prior melting indicator, quiet
+   * cell indicator, and state ratios. The temperature of the cells without
+   * material is set to infinity. The buffer is used to update _solution,
+   * _has_melted, _quiet_cells, _deposition_cos, _deposition_sin, and the state
+   * of _material_properties.
    */
-  std::vector<std::vector<double>> _data_to_transfer;
+  CellDataBuffer<dim> _data_to_transfer;
 };
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
@@ -266,6 +600,41 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
                                                          _deposition_sin);
 }
 
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+inline void
+ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+               QuadratureType>::update_quiet_cells()
+{
+  if (_use_quiet_elements)
+  {
+    _thermal_operator->set_quiet_cells(_quiet_cells,
+                                       _quiet_conductivity_scaling,
+                                       _quiet_capacity_scaling);
+    // Activating quiet cells increases their conductivity and thus the
+    // spectral radius of the operator.
+    reset_spectral_radius();
+  }
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+inline unsigned int
+ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+               QuadratureType>::
+    compute_cell_weight(
+        typename dealii::DoFHandler<dim>::cell_iterator const &cell,
+        dealii::FiniteElement<dim> const &future_fe) const
+{
+  // Cells without material are not seen by the ThermalOperator. The cost of
+  // the other cells is proportional to their number of degrees of freedom.
+  // Cells on finer levels are more likely to have hanging nodes.
+  if (future_fe.n_dofs_per_cell() == 0)
+    return _inactive_cell_weight;
+
+  return future_fe.n_dofs_per_cell() + _refinement_level_weight * cell->level();
+}
+
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
           typename MemorySpaceType, typename QuadratureType>
 inline void ThermalPhysics<dim, p_order, fe_degree, MaterialStates,
@@ -325,13 +694,45 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
   return _has_melted[i];
 }
 
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+inline bool
+ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+               QuadratureType>::get_quiet_cell(unsigned int const i) const
+{
+  return _use_quiet_elements && _quiet_cells[i];
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+inline void
+ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+               QuadratureType>::set_quiet_cells_vector(std::vector<bool> const
+                                                           &quiet_cells)
+{
+  if (_use_quiet_elements)
+  {
+    _quiet_cells = quiet_cells;
+    update_quiet_cells();
+  }
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+inline bool
+ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+               QuadratureType>::use_quiet_elements() const
+{
+  return _use_quiet_elements;
+}
+
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
           typename MemorySpaceType, typename QuadratureType>
 inline dealii::DoFHandler<dim> &
 ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
                QuadratureType>::get_dof_handler()
 {
-  return _dof_handler;
+  return *_dof_handler;
 }
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
@@ -340,7 +741,7 @@ inline dealii::AffineConstraints<double> &
 ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
                QuadratureType>::get_affine_constraints()
 {
-  return _affine_constraints;
+  return *_affine_constraints;
 }
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
@@ -8,6 +8,7 @@
 #include <CubeHeatSource.hh>
 #include <ElectronBeamHeatSource.hh>
 #include <GoldakHeatSource.hh>
+#include <RungeKuttaLegendre.hh>
 #include <ThermalOperator.hh>
 #include <ThermalOperatorDevice.hh>
 #include <ThermalPhysics.hh>
@@ -15,8 +16,8 @@
 
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/index_set.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/quadrature_lib.h>
-#include <deal.II/distributed/cell_data_transfer.templates.h>
 #include <deal.II/distributed/solution_transfer.h>
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/fe_nothing.h>
@@ -24,9 +25,12 @@
 #include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/hp/q_collection.h>
+#include <deal.II/lac/diagonal_matrix.h>
 #include <deal.II/lac/precondition.h>
 #include <deal.II/lac/read_write_vector.h>
+#include <deal.II/lac/solver_cg.h>
 #include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/vector.h>
 #include <deal.II/lac/vector_operation.h>
 
 #ifdef ADAMANTINE_WITH_CALIPER
@@ -34,7 +38,11 @@
 #endif
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <utility>
 
 namespace adamantine
 {
@@ -269,12 +277,31 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
                    MaterialProperty<dim, p_order, MaterialStates,
                                     MemorySpaceType> &material_properties)
     : _boundary_type(BoundaryType::invalid), _geometry(geometry),
-      _dof_handler(_geometry.get_triangulation()),
-      _cell_weights(
-          _dof_handler,
-          dealii::parallel::CellWeights<dim>::ndofs_weighting({1, 1})),
+      _dof_handler(std::make_shared<dealii::DoFHandler<dim>>(
+          _geometry.get_triangulation())),
+      _affine_constraints(
+          std::make_shared<dealii::AffineConstraints<double>>()),
+      _cell_weights(std::make_unique<dealii::parallel::CellWeights<dim>>(
+          *_dof_handler,
+          [this](typename dealii::DoFHandler<dim>::cell_iterator const &cell,
+                 dealii::FiniteElement<dim> const &future_fe)
+          { return compute_cell_weight(cell, future_fe); })),
       _material_properties(material_properties)
 {
+  // Get the load balancing parameters
+  boost::optional<boost::property_tree::ptree const &>
+      load_balancing_optional_database =
+          database.get_child_optional("load_balancing");
+  if (load_balancing_optional_database)
+  {
+    // PropertyTreeInput load_balancing.inactive_cell_weight
+    _inactive_cell_weight =
+        load_balancing_optional_database->get("inactive_cell_weight", 0u);
+    // PropertyTreeInput load_balancing.refinement_level_weight
+    _refinement_level_weight =
+        load_balancing_optional_database->get("refinement_level_weight", 0u);
+  }
+
   // Create the FECollection
   _fe_collection.push_back(dealii::FE_Q<dim>(fe_degree));
   _fe_collection.push_back(dealii::FE_Nothing<dim>());
@@ -359,28 +386,43 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
   }
   parse_boundary_type(boundary_type_str);
 
+  // PropertyTreeInput discretization.thermal.mixed_precision
+  bool const mixed_precision =
+      database.get("discretization.thermal.mixed_precision", false);
+  // PropertyTreeInput discretization.thermal.mixed_precision_validation
+  bool const mixed_precision_validation =
+      database.get("discretization.thermal.mixed_precision_validation", false);
+
   // Create the thermal operator
   if (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value)
   {
     if (_material_properties.properties_use_table())
     {
-      _thermal_operator =
+      auto thermal_operator =
           std::make_shared<ThermalOperator<dim, true, p_order, fe_degree,
                                            MaterialStates, MemorySpaceType>>(
               communicator, _boundary_type, _material_properties,
               _heat_sources);
+      thermal_operator->set_mixed_precision(mixed_precision,
+                                            mixed_precision_validation);
+      _thermal_operator = thermal_operator;
     }
     else
     {
-      _thermal_operator =
+      auto thermal_operator =
           std::make_shared<ThermalOperator<dim, false, p_order, fe_degree,
                                            MaterialStates, MemorySpaceType>>(
               communicator, _boundary_type, _material_properties,
               _heat_sources);
+      thermal_operator->set_mixed_precision(mixed_precision,
+                                            mixed_precision_validation);
+      _thermal_operator = thermal_operator;
     }
   }
   else
   {
+    ASSERT_THROW(!mixed_precision,
+                 "Error: Mixed precision is not supported on the device.");
     if (_material_properties.properties_use_table())
     {
       _thermal_operator = std::make_shared<ThermalOperatorDevice<
@@ -414,6 +456,20 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
     _time_stepping =
         std::make_unique<dealii::TimeStepping::ExplicitRungeKutta<LA_Vector>>(
             dealii::TimeStepping::RK_CLASSIC_FOURTH_ORDER);
+  else if (method.compare("rkl2") == 0)
+  {
+    // PropertyTreeInput time_stepping.n_power_iterations
+    unsigned int const n_power_iterations =
+        time_stepping_database.get("n_power_iterations", 10);
+    // PropertyTreeInput time_stepping.spectral_radius_safety_factor
+    double const safety_factor =
+        time_stepping_database.get("spectral_radius_safety_factor", 1.5);
+    // PropertyTreeInput time_stepping.spectral_radius_update_interval
+    unsigned int const update_interval =
+        time_stepping_database.get("spectral_radius_update_interval", 50);
+    _time_stepping = std::make_unique<RungeKuttaLegendre<MemorySpaceType>>(
+        n_power_iterations, safety_factor, update_interval);
+  }
   else if (method.compare("backward_euler") == 0)
   {
     _time_stepping =
@@ -443,6 +499,58 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
     _implicit_method = true;
   }
 
+  // PropertyTreeInput time_stepping.multirate_substeps
+  _multirate_n_substeps =
+      time_stepping_database.get<unsigned int>("multirate_substeps", 1);
+  ASSERT_THROW(_multirate_n_substeps > 0,
+               "Error: The number of multirate substeps must be positive.");
+  if (_multirate_n_substeps > 1)
+  {
+    ASSERT_THROW(
+        (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value),
+        "Error: Multirate time stepping is not supported on the device.");
+    ASSERT_THROW(method.compare("forward_euler") == 0,
+                 "Error: Multirate time stepping requires forward_euler.");
+    ASSERT_THROW(!mixed_precision, "Error: Mixed precision is not supported "
+                                   "with multirate time stepping.");
+    // PropertyTreeInput time_stepping.multirate_min_level
+    _multirate_min_level =
+        time_stepping_database.get("multirate_min_level", -1);
+  }
+
+  _batched_ensemble =
+      std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host> &&
+      (method.compare("forward_euler") == 0) && !mixed_precision &&
+      (_multirate_n_substeps == 1);
+
+  // PropertyTreeInput time_stepping.dormant_update_interval
+  _dormant_update_interval =
+      time_stepping_database.get<unsigned int>("dormant_update_interval", 0);
+  if (_dormant_update_interval > 0)
+  {
+    ASSERT_THROW(
+        (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value),
+        "Error: The dormant region is not supported on the device.");
+    ASSERT_THROW(!_implicit_method, "Error: The dormant region requires an "
+                                    "explicit time stepping method.");
+    ASSERT_THROW(_multirate_n_substeps == 1,
+                 "Error: The dormant region cannot be used with multirate "
+                 "time stepping.");
+    ASSERT_THROW(!mixed_precision, "Error: Mixed precision is not supported "
+                                   "with the dormant region.");
+    // PropertyTreeInput time_stepping.dormant_rate_threshold
+    _dormant_rate_threshold =
+        time_stepping_database.get<double>("dormant_rate_threshold");
+    // PropertyTreeInput time_stepping.dormant_gradient_threshold
+    _dormant_gradient_threshold =
+        time_stepping_database.get<double>("dormant_gradient_threshold");
+    // PropertyTreeInput time_stepping.dormant_distance
+    _dormant_distance = time_stepping_database.get<double>("dormant_distance");
+    // The dormant region is computed during the first time step.
+    _n_steps_since_dormant_update = _dormant_update_interval;
+    _batched_ensemble = false;
+  }
+
   // If the time stepping scheme is implicit, set the parameters for the solver
   // and create the implicit operator.
   if (_implicit_method == true)
@@ -468,22 +576,77 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
     implicit_rk->set_newton_solver_parameters(newton_max_iter,
                                               newton_tolerance);
 
+    // PropertyTreeInput time_stepping.newton_krylov
+    if (time_stepping_database.get("newton_krylov", false))
+    {
+      ASSERT_THROW(
+          (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value),
+          "Error: The Newton-Krylov method is not supported on the device.");
+      ASSERT_THROW(method.compare("backward_euler") == 0,
+                   "Error: The Newton-Krylov method requires backward_euler.");
+      // PropertyTreeInput time_stepping.chebyshev_degree
+      _chebyshev_degree = time_stepping_database.get("chebyshev_degree",
+                                                     _chebyshev_degree);
+      _newton_solver = std::make_unique<NewtonSolver>(
+          newton_max_iter, newton_tolerance, _max_iter, _max_n_tmp_vectors);
+    }
+
+    ASSERT_THROW(!mixed_precision, "Error: Mixed precision is only supported "
+                                   "with explicit time stepping.");
+
+    // PropertyTreeInput time_stepping.linear_solver
+    std::string linear_solver =
+        time_stepping_database.get<std::string>("linear_solver", "gmres");
+    std::transform(linear_solver.begin(), linear_solver.end(),
+                   linear_solver.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    ASSERT_THROW((linear_solver == "gmres") || (linear_solver == "cg"),
+                 "Error: Unknown linear solver " + linear_solver + ".");
+    _use_cg = (linear_solver == "cg");
+    // PropertyTreeInput time_stepping.extrapolate_initial_guess
+    _extrapolate_initial_guess =
+        time_stepping_database.get("extrapolate_initial_guess", _use_cg);
+
     // PropertyTreeInput time_stepping.jfnk
     bool jfnk = time_stepping_database.get("jfnk", false);
     _implicit_operator = std::make_unique<ImplicitOperator<MemorySpaceType>>(
-        _thermal_operator, jfnk);
+        _thermal_operator, jfnk, _use_cg);
   }
 
   // Set material on part of the domain
   // PropertyTreeInput geometry.material_height
   double const material_height = database.get("geometry.material_height", 1e9);
+  // PropertyTreeInput geometry.quiet_elements
+  _use_quiet_elements = database.get("geometry.quiet_elements", false);
+  if (_use_quiet_elements)
+  {
+    ASSERT_THROW(
+        (std::is_same<MemorySpaceType, dealii::MemorySpace::Host>::value),
+        "Error: Quiet elements are not supported on the device.");
+    // PropertyTreeInput geometry.quiet_element_conductivity_scaling
+    _quiet_conductivity_scaling = database.get(
+        "geometry.quiet_element_conductivity_scaling",
+        _quiet_conductivity_scaling);
+    // PropertyTreeInput geometry.quiet_element_capacity_scaling
+    _quiet_capacity_scaling = database.get(
+        "geometry.quiet_element_capacity_scaling", _quiet_capacity_scaling);
+    ASSERT_THROW((_quiet_conductivity_scaling > 0.) &&
+                     (_quiet_capacity_scaling > 0.),
+                 "Error: The scalings of the quiet elements need to be "
+                 "positive.");
+    ASSERT_THROW(_quiet_conductivity_scaling <= _quiet_capacity_scaling,
+                 "Error: The heat cannot diffuse faster in the quiet elements "
+                 "than in the deposited material.");
+  }
   for (auto const &cell :
-       dealii::filter_iterators(_dof_handler.active_cell_iterators(),
+       dealii::filter_iterators(_dof_handler->active_cell_iterators(),
                                 dealii::IteratorFilters::LocallyOwnedCell()))
   {
     // If the center of the cell is below material_height, it contains material
-    // otherwise it does not.
-    if (cell->center()[axis<dim>::z] < material_height)
+    // otherwise it does not. With quiet elements, the cells without material
+    // are meshed too.
+    bool const has_material = cell->center()[axis<dim>::z] < material_height;
+    if (has_material || _use_quiet_elements)
     {
       cell->set_active_fe_index(0);
       // Set material deposition cos and sin. We arbitrarily choose cos = 1 and
@@ -492,6 +655,8 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
       _deposition_sin.push_back(0.);
       // Set the initial material as non-melted
       _has_melted.push_back(false);
+      if (_use_quiet_elements)
+        _quiet_cells.push_back(!has_material);
     }
     else
       cell->set_active_fe_index(1);
@@ -515,6 +680,7 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
 {
   setup_dofs();
   update_material_deposition_orientation();
+  update_quiet_cells();
   compute_inverse_mass_matrix();
   get_state_from_material_properties();
 }
@@ -524,17 +690,59 @@ template <int dim, int p_order, int fe_degree, typename MaterialStates,
 void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
                     QuadratureType>::setup_dofs()
 {
-  _dof_handler.distribute_dofs(_fe_collection);
-  dealii::IndexSet locally_relevant_dofs;
-  dealii::DoFTools::extract_locally_relevant_dofs(_dof_handler,
-                                                  locally_relevant_dofs);
-  _affine_constraints.clear();
-  _affine_constraints.reinit(locally_relevant_dofs);
-  dealii::DoFTools::make_hanging_node_constraints(_dof_handler,
-                                                  _affine_constraints);
-  _affine_constraints.close();
+  // The degrees of freedom and the constraints are only rebuilt by the owner
+  // of the DoFHandler.
+  if (!_shared_discretization)
+  {
+    _dof_handler->distribute_dofs(_fe_collection);
+    dealii::IndexSet locally_relevant_dofs;
+    dealii::DoFTools::extract_locally_relevant_dofs(*_dof_handler,
+                                                    locally_relevant_dofs);
+    _affine_constraints->clear();
+    _affine_constraints->reinit(locally_relevant_dofs);
+    dealii::DoFTools::make_hanging_node_constraints(*_dof_handler,
+                                                    *_affine_constraints);
+    _affine_constraints->close();
+  }
+
+  _thermal_operator->reinit(*_dof_handler, *_affine_constraints, _q_collection);
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    share_discretization(ThermalPhysicsInterface<dim, MemorySpaceType> &owner)
+{
+  auto *physics = dynamic_cast<ThermalPhysics *>(&owner);
+  ASSERT_THROW(physics != nullptr,
+               "Error: The physics sharing the discretization need to be of "
+               "the same type.");
+  ASSERT_THROW(physics != this,
+               "Error: The physics cannot share its own discretization.");
+  ASSERT_THROW(&physics->_geometry.get_triangulation() ==
+                   &_geometry.get_triangulation(),
+               "Error: The physics sharing the discretization need to use the "
+               "same mesh.");
+
+  // The weights used for load balancing are attached by the owner of the
+  // DoFHandler. The weights need to be detached before the DoFHandler of this
+  // object is destroyed.
+  _cell_weights.reset();
+  _dof_handler = physics->_dof_handler;
+  _affine_constraints = physics->_affine_constraints;
+  _thermal_operator->share_discretization(*physics->_thermal_operator);
+  _shared_discretization = true;
+}
 
-  _thermal_operator->reinit(_dof_handler, _affine_constraints, _q_collection);
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::reset_spectral_radius()
+{
+  if (auto rkl2 = dynamic_cast<RungeKuttaLegendre<MemorySpaceType> *>(
+          _time_stepping.get()))
+    rkl2->reset_spectral_radius();
 }
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
@@ -542,11 +750,135 @@ template <int dim, int p_order, int fe_degree, typename MaterialStates,
 void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
                     QuadratureType>::compute_inverse_mass_matrix()
 {
-  _thermal_operator->compute_inverse_mass_matrix(_dof_handler,
-                                                 _affine_constraints);
+  _thermal_operator->compute_inverse_mass_matrix(*_dof_handler,
+                                                 *_affine_constraints);
   if (_implicit_method == true)
+  {
     _implicit_operator->set_inverse_mass_matrix(
         _thermal_operator->get_inverse_mass_matrix());
+    // The previous solutions cannot be extrapolated on the new mesh.
+    _previous_stage_solutions.clear();
+  }
+  // The spectral radius used by RKL2 depends on the mesh.
+  reset_spectral_radius();
+  // The multirate partition depends on the mesh too.
+  update_multirate_partition();
+  // The dormant region needs to be recomputed on the new mesh.
+  _n_steps_since_dormant_update = _dormant_update_interval;
+  _dormant_dofs.clear();
+  _dormant_interface_dofs.clear();
+  _dormant_evaluated_cells.clear();
+  _dormant_cell_bounding_boxes.clear();
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::update_multirate_partition()
+{
+  _multirate_fast_dofs.clear();
+  _multirate_evaluated_cells.clear();
+  if (_multirate_n_substeps == 1)
+    return;
+
+  int min_level = _multirate_min_level;
+  if (min_level < 0)
+    min_level = _dof_handler->get_triangulation().n_global_levels() - 1;
+
+  std::vector<bool> fast_cells;
+  for (auto const &cell : dealii::filter_iterators(
+           _dof_handler->active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+    fast_cells.push_back(cell->level() >= min_level);
+
+  flag_coupled_dofs(fast_cells, _multirate_fast_dofs,
+                    _multirate_evaluated_cells);
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    flag_coupled_dofs(std::vector<bool> const &cells, std::vector<bool> &dofs,
+                      std::vector<bool> &coupled_cells,
+                      std::vector<bool> *interface_dofs) const
+{
+  // Flag the degrees of freedom of the flagged cells. The masters of the
+  // constrained degrees of freedom are flagged too since they determine the
+  // value of the constrained degrees of freedom. The ghost values are
+  // necessary to find the cells that are coupled to the flagged degrees of
+  // freedom.
+  dealii::IndexSet locally_relevant_dofs;
+  dealii::DoFTools::extract_locally_relevant_dofs(*_dof_handler,
+                                                  locally_relevant_dofs);
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      flagged_dofs(_dof_handler->locally_owned_dofs(), locally_relevant_dofs,
+                   _dof_handler->get_communicator());
+  std::vector<dealii::types::global_dof_index> dof_indices;
+  unsigned int cell_id = 0;
+  for (auto const &cell : dealii::filter_iterators(
+           _dof_handler->active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    if (!cells[cell_id++])
+      continue;
+    dof_indices.resize(cell->get_fe().n_dofs_per_cell());
+    cell->get_dof_indices(dof_indices);
+    for (auto const dof : dof_indices)
+    {
+      flagged_dofs(dof) = 1.;
+      if (_affine_constraints->is_constrained(dof))
+        for (auto const &entry :
+             *_affine_constraints->get_constraint_entries(dof))
+          flagged_dofs(entry.first) = 1.;
+    }
+  }
+  flagged_dofs.compress(dealii::VectorOperation::add);
+  flagged_dofs.update_ghost_values();
+
+  unsigned int const local_size = flagged_dofs.locally_owned_size();
+  dofs.resize(local_size);
+  for (unsigned int i = 0; i < local_size; ++i)
+    dofs[i] = flagged_dofs.local_element(i) > 0.;
+
+  // A cell is coupled to the flagged degrees of freedom if one of its degrees
+  // of freedom, or one of their masters, is flagged. The flagged degrees of
+  // freedom of the cells that are not flagged form the interface.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      interface(flagged_dofs.get_partitioner());
+  coupled_cells.clear();
+  cell_id = 0;
+  for (auto const &cell : dealii::filter_iterators(
+           _dof_handler->active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    bool const flagged = cells[cell_id++];
+    dof_indices.resize(cell->get_fe().n_dofs_per_cell());
+    cell->get_dof_indices(dof_indices);
+    bool coupled = false;
+    for (auto const dof : dof_indices)
+    {
+      coupled = coupled || (flagged_dofs(dof) > 0.);
+      if (!flagged && (flagged_dofs(dof) > 0.))
+        interface(dof) = 1.;
+      if (_affine_constraints->is_constrained(dof))
+        for (auto const &entry :
+             *_affine_constraints->get_constraint_entries(dof))
+          coupled = coupled || (flagged_dofs(entry.first) > 0.);
+    }
+    coupled_cells.push_back(coupled);
+  }
+
+  if (interface_dofs)
+  {
+    interface.compress(dealii::VectorOperation::add);
+    interface_dofs->resize(local_size);
+    for (unsigned int i = 0; i < local_size; ++i)
+      (*interface_dofs)[i] = interface.local_element(i) > 0.;
+  }
 }
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
@@ -558,17 +890,17 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &temperature)
 {
   temperature.update_ghost_values();
-  auto dofs_per_cell = _dof_handler.get_fe().dofs_per_cell;
+  auto dofs_per_cell = _dof_handler->get_fe().dofs_per_cell;
 
   dealii::hp::FEValues<dim> hp_fe_values(
-      _dof_handler.get_fe_collection(), _q_collection,
+      _dof_handler->get_fe_collection(), _q_collection,
       dealii::UpdateFlags::update_values |
           dealii::UpdateFlags::update_JxW_values);
 
   unsigned int const n_q_points = _q_collection.max_n_quadrature_points();
   unsigned int cell_id = 0;
   for (auto const &cell : dealii::filter_iterators(
-           _dof_handler.active_cell_iterators(),
+           _dof_handler->active_cell_iterators(),
            dealii::IteratorFilters::LocallyOwnedCell(),
            dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
   {
@@ -619,90 +951,114 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
         std::vector<bool> &new_has_melted, unsigned int const activation_start,
         unsigned int const activation_end,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
+{
+  mesh_change_start(solution);
+  mesh_change_activate(elements_to_activate, new_deposition_cos,
+                       new_deposition_sin, new_has_melted, activation_start,
+                       activation_end);
+  mesh_change_prepare_pass();
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    add_material_end(
+        double const new_material_temperature,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
+{
+  mesh_change_complete_pass();
+  mesh_change_end(new_material_temperature, solution);
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    mesh_change_start(
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
 {
   // Update the material state from the ThermalOperator to MaterialProperty
   // because, for now, we need to use state from MaterialProperty to perform the
-  // transfer to the refined mesh.
+  // transfer to the new mesh.
   set_state_to_material_properties();
 
   _thermal_operator->clear();
-  // The data on each cell is stored in the following order: solution, direction
-  // of deposition (cosine and sine), prior melting indictor, and state ratio.
-  _data_to_transfer.clear();
-  unsigned int const n_dofs_per_cell = _dof_handler.get_fe().n_dofs_per_cell();
+  unsigned int const n_dofs_per_cell = _dof_handler->get_fe().n_dofs_per_cell();
   unsigned int const direction_data_size = 2;
   unsigned int const phase_history_data_size = 1;
+  unsigned int const quiet_data_size = 1;
   unsigned int constexpr n_material_states = MaterialStates::n_material_states;
-  unsigned int const data_size_per_cell =
-      n_dofs_per_cell + direction_data_size + phase_history_data_size +
-      n_material_states;
+  unsigned int const quiet_data_index =
+      n_dofs_per_cell + direction_data_size + phase_history_data_size;
+  unsigned int const state_data_index = quiet_data_index + quiet_data_size;
+  unsigned int const data_size_per_cell = state_data_index + n_material_states;
   _cell_solution.reinit(n_dofs_per_cell);
-  std::vector<double> dummy_cell_data(data_size_per_cell,
-                                      std::numeric_limits<double>::infinity());
-
-  solution.update_ghost_values();
+  _data_to_transfer.reinit(_dof_handler->get_triangulation().n_active_cells(),
+                           data_size_per_cell,
+                           std::numeric_limits<double>::infinity());
 
-  // We need to move the solution on the host because we cannot use
-  // CellDataTransfer on the device.
-  dealii::IndexSet rw_index_set = solution.locally_owned_elements();
-  rw_index_set.add_indices(solution.get_partitioner()->ghost_indices());
-  dealii::LA::ReadWriteVector<double> rw_solution(rw_index_set);
-  rw_solution.import(solution, dealii::VectorOperation::insert);
+  // We need to move the solution on the host because the cell data is packed
+  // on the host. The constraints are applied so that the
+  // values at the hanging nodes are correct.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      solution_host(solution.get_partitioner());
+  solution_host.import(solution, dealii::VectorOperation::insert);
+  _affine_constraints->distribute(solution_host);
+  solution_host.update_ghost_values();
 
   auto state_host = Kokkos::create_mirror_view_and_copy(
       Kokkos::HostSpace{}, _material_properties.get_state());
   unsigned int locally_owned_cell_id = 0;
   unsigned int activated_cell_id = 0;
-  unsigned int cell_id = 0;
-  std::map<typename dealii::DoFHandler<dim>::active_cell_iterator, int>
-      cell_to_id;
-  for (auto const &cell : _dof_handler.active_cell_iterators())
+  for (auto const &cell :
+       dealii::filter_iterators(_dof_handler->active_cell_iterators(),
+                                dealii::IteratorFilters::LocallyOwnedCell()))
   {
-    if (cell->is_locally_owned())
-    {
-      if (cell->active_fe_index() == 0)
-      {
-        std::vector<double> cell_data(
-            direction_data_size + phase_history_data_size + n_material_states);
-        cell->get_dof_values(rw_solution, _cell_solution);
-        cell_data.insert(cell_data.begin(), _cell_solution.begin(),
-                         _cell_solution.end());
-        cell_data[n_dofs_per_cell] = _deposition_cos[activated_cell_id];
-        cell_data[n_dofs_per_cell + 1] = _deposition_sin[activated_cell_id];
-
-        if (_has_melted[activated_cell_id])
-          cell_data[n_dofs_per_cell + direction_data_size] = 1.0;
-        else
-          cell_data[n_dofs_per_cell + direction_data_size] = 0.0;
-
-        for (unsigned int i = 0; i < n_material_states; ++i)
-          cell_data[n_dofs_per_cell + direction_data_size +
-                    phase_history_data_size + i] =
-              state_host(i, locally_owned_cell_id);
-        _data_to_transfer.push_back(cell_data);
-
-        ++activated_cell_id;
-      }
-      else
-      {
-        std::vector<double> cell_data = dummy_cell_data;
-        for (unsigned int i = 0; i < n_material_states; ++i)
-          cell_data[n_dofs_per_cell + direction_data_size +
-                    phase_history_data_size + i] =
-              state_host(i, locally_owned_cell_id);
-        _data_to_transfer.push_back(cell_data);
-      }
-      ++locally_owned_cell_id;
-    }
-    else
+    dealii::ArrayView<double> const cell_data =
+        _data_to_transfer[cell->active_cell_index()];
+    if (cell->active_fe_index() == 0)
     {
-      _data_to_transfer.push_back(dummy_cell_data);
+      cell->get_dof_values(solution_host, _cell_solution);
+      std::copy(_cell_solution.begin(), _cell_solution.end(),
+                cell_data.begin());
+      cell_data[n_dofs_per_cell] = _deposition_cos[activated_cell_id];
+      cell_data[n_dofs_per_cell + 1] = _deposition_sin[activated_cell_id];
+      cell_data[n_dofs_per_cell + direction_data_size] =
+          _has_melted[activated_cell_id] ? 1. : 0.;
+      cell_data[quiet_data_index] =
+          get_quiet_cell(activated_cell_id) ? 1. : 0.;
+
+      ++activated_cell_id;
     }
-    cell_to_id[cell] = cell_id;
-    ++cell_id;
+
+    for (unsigned int i = 0; i < n_material_states; ++i)
+      cell_data[state_data_index + i] = state_host(i, locally_owned_cell_id);
+    ++locally_owned_cell_id;
   }
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    mesh_change_activate(
+        std::vector<std::vector<
+            typename dealii::DoFHandler<dim>::active_cell_iterator>> const
+            &elements_to_activate,
+        std::vector<double> const &new_deposition_cos,
+        std::vector<double> const &new_deposition_sin,
+        std::vector<bool> &new_has_melted, unsigned int const activation_start,
+        unsigned int const activation_end)
+{
+  unsigned int const n_dofs_per_cell = _dof_handler->get_fe().n_dofs_per_cell();
+  unsigned int const direction_data_size = 2;
+  unsigned int const phase_history_data_size = 1;
+  unsigned int const quiet_data_index =
+      n_dofs_per_cell + direction_data_size + phase_history_data_size;
 
-  // Activate elements by updating the fe_index
+  // Activate elements by updating the fe_index. The temperature of the
+  // activated cells is left to infinity, it is set by mesh_change_end().
   for (unsigned int i = activation_start; i < activation_end; ++i)
   {
     for (auto const &cell : elements_to_activate[i])
@@ -710,37 +1066,158 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
       if (cell->active_fe_index() != 0)
       {
         cell->set_future_fe_index(0);
-        _data_to_transfer[cell_to_id[cell]][n_dofs_per_cell] =
-            new_deposition_cos[i];
-        _data_to_transfer[cell_to_id[cell]][n_dofs_per_cell + 1] =
-            new_deposition_sin[i];
-
-        if (_data_to_transfer[cell_to_id[cell]]
-                             [n_dofs_per_cell + direction_data_size] > 0.5)
-          new_has_melted[i] = true;
-        else
-          new_has_melted[i] = false;
+        dealii::ArrayView<double> const cell_data =
+            _data_to_transfer[cell->active_cell_index()];
+        cell_data[n_dofs_per_cell] = new_deposition_cos[i];
+        cell_data[n_dofs_per_cell + 1] = new_deposition_sin[i];
+        cell_data[quiet_data_index] = 0.;
+
+        new_has_melted[i] =
+            cell_data[n_dofs_per_cell + direction_data_size] > 0.5;
       }
     }
   }
+}
 
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::mesh_change_prepare_pass()
+{
   dealii::parallel::distributed::Triangulation<dim> &triangulation =
       dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
           const_cast<dealii::Triangulation<dim> &>(
-              _dof_handler.get_triangulation()));
+              _dof_handler->get_triangulation()));
+  dealii::FiniteElement<dim> const &fe = _dof_handler->get_fe();
+  unsigned int const n_dofs_per_cell = fe.n_dofs_per_cell();
+  unsigned int const direction_data_size = 2;
+  unsigned int const phase_history_data_size = 1;
+  unsigned int const quiet_data_size = 1;
+  unsigned int constexpr n_material_states = MaterialStates::n_material_states;
+  unsigned int const phase_history_data_index =
+      n_dofs_per_cell + direction_data_size;
+  unsigned int const quiet_data_index =
+      phase_history_data_index + phase_history_data_size;
+  unsigned int const state_data_index = quiet_data_index + quiet_data_size;
+
+  // Do not coarsen across the deposition front: the children of a coarsened
+  // cell need to be all with material, all without material, or all quiet.
+  for (auto const &cell :
+       dealii::filter_iterators(_dof_handler->active_cell_iterators(),
+                                dealii::IteratorFilters::LocallyOwnedCell()))
+  {
+    if (cell->coarsen_flag_set() && (cell->level() > 0))
+    {
+      double const quiet = _data_to_transfer[cell->active_cell_index()]
+                                            [quiet_data_index];
+      auto const parent = cell->parent();
+      for (unsigned int c = 0; c < parent->n_children(); ++c)
+      {
+        auto const child = parent->child(c);
+        if (!child->is_active() || !child->is_locally_owned() ||
+            (child->future_fe_index() != cell->future_fe_index()) ||
+            (_data_to_transfer[child->active_cell_index()][quiet_data_index] !=
+             quiet))
+        {
+          cell->clear_coarsen_flag();
+          break;
+        }
+      }
+    }
+  }
   triangulation.prepare_coarsening_and_refinement();
-  _cell_data_trans =
-      std::make_unique<dealii::parallel::distributed::CellDataTransfer<
-          dim, dim, std::vector<std::vector<double>>>>(triangulation);
 
-  _cell_data_trans->prepare_for_coarsening_and_refinement(_data_to_transfer);
+  // The temperature is prolongated and restricted using the matrices of the
+  // finite element like SolutionTransfer does. The other data is copied to the
+  // children. When cells are coarsened, the parent uses the direction of
+  // deposition of the first child, it has melted if one of the children has
+  // melted, and its state is the average of the states of the children.
+  auto refinement_strategy =
+      [&fe, n_dofs_per_cell,
+       parent_dofs = dealii::Vector<double>(n_dofs_per_cell),
+       child_dofs = dealii::Vector<double>(n_dofs_per_cell)](
+          typename dealii::Triangulation<dim>::cell_iterator const &,
+          unsigned int const child,
+          dealii::ArrayView<double const> const &parent_values,
+          dealii::ArrayView<double> const &child_values) mutable
+  {
+    std::copy(parent_values.begin(), parent_values.end(),
+              child_values.begin());
+    if (parent_values[0] != std::numeric_limits<double>::infinity())
+    {
+      std::copy(parent_values.begin(), parent_values.begin() + n_dofs_per_cell,
+                parent_dofs.begin());
+      fe.get_prolongation_matrix(child).vmult(child_dofs, parent_dofs);
+      std::copy(child_dofs.begin(), child_dofs.end(), child_values.begin());
+    }
+  };
+
+  auto coarsening_strategy =
+      [&fe, n_dofs_per_cell, phase_history_data_index, state_data_index,
+       parent_dofs = dealii::Vector<double>(n_dofs_per_cell),
+       child_dofs = dealii::Vector<double>(n_dofs_per_cell),
+       restricted_dofs = dealii::Vector<double>(n_dofs_per_cell)](
+          typename dealii::Triangulation<dim>::cell_iterator const &,
+          std::vector<dealii::ArrayView<double const>> const &children_values,
+          dealii::ArrayView<double> const &parent_values) mutable
+  {
+    std::copy(children_values[0].begin(), children_values[0].end(),
+              parent_values.begin());
+    unsigned int const n_children = children_values.size();
+    if (parent_values[0] != std::numeric_limits<double>::infinity())
+    {
+      parent_dofs = 0.;
+      for (unsigned int c = 0; c < n_children; ++c)
+      {
+        std::copy(children_values[c].begin(),
+                  children_values[c].begin() + n_dofs_per_cell,
+                  child_dofs.begin());
+        fe.get_restriction_matrix(c).vmult(restricted_dofs, child_dofs);
+        for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
+        {
+          if (fe.restriction_is_additive(i))
+            parent_dofs(i) += restricted_dofs(i);
+          else if (restricted_dofs(i) != 0.)
+            parent_dofs(i) = restricted_dofs(i);
+        }
+      }
+      std::copy(parent_dofs.begin(), parent_dofs.end(), parent_values.begin());
+    }
+
+    for (unsigned int c = 1; c < n_children; ++c)
+    {
+      parent_values[phase_history_data_index] =
+          std::max(parent_values[phase_history_data_index],
+                   children_values[c][phase_history_data_index]);
+      for (unsigned int i = 0; i < n_material_states; ++i)
+        parent_values[state_data_index + i] +=
+            children_values[c][state_data_index + i];
+    }
+    for (unsigned int i = 0; i < n_material_states; ++i)
+      parent_values[state_data_index + i] /= n_children;
+  };
+
+  _data_to_transfer.prepare_for_coarsening_and_refinement(
+      triangulation, refinement_strategy, coarsening_strategy);
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::mesh_change_complete_pass()
+{
+  dealii::parallel::distributed::Triangulation<dim> &triangulation =
+      dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
+          const_cast<dealii::Triangulation<dim> &>(
+              _dof_handler->get_triangulation()));
+  _data_to_transfer.unpack(triangulation);
 }
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
           typename MemorySpaceType, typename QuadratureType>
 void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
                     QuadratureType>::
-    add_material_end(
+    mesh_change_end(
         double const new_material_temperature,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
 {
@@ -758,77 +1235,70 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
   for (auto val : solution.locally_owned_elements())
     rw_solution[val] = new_material_temperature;
 
-  dealii::parallel::distributed::Triangulation<dim> &triangulation =
-      dynamic_cast<dealii::parallel::distributed::Triangulation<dim> &>(
-          const_cast<dealii::Triangulation<dim> &>(
-              _dof_handler.get_triangulation()));
-
   // Unpack the material state and repopulate the material state
-  unsigned int constexpr n_material_states = MaterialStates::n_material_states;
-  unsigned int const n_dofs_per_cell = _dof_handler.get_fe().n_dofs_per_cell();
+  unsigned int const n_dofs_per_cell = _dof_handler->get_fe().n_dofs_per_cell();
   unsigned int const direction_data_size = 2;
   unsigned int const phase_history_data_size = 1;
-  unsigned int const data_size_per_cell =
-      n_dofs_per_cell + direction_data_size + phase_history_data_size +
-      n_material_states;
+  unsigned int const quiet_data_size = 1;
+  unsigned int constexpr n_material_states = MaterialStates::n_material_states;
+  unsigned int const quiet_data_index =
+      n_dofs_per_cell + direction_data_size + phase_history_data_size;
+  unsigned int const state_data_index = quiet_data_index + quiet_data_size;
 
-  std::vector<std::vector<double>> transferred_data(
-      triangulation.n_active_cells(), std::vector<double>(data_size_per_cell));
-  _cell_data_trans->unpack(transferred_data);
   auto state = _material_properties.get_state();
   auto state_host = Kokkos::create_mirror_view(state);
   _deposition_cos.clear();
   _deposition_sin.clear();
   _has_melted.clear();
-  unsigned int cell_id = 0;
+  _quiet_cells.clear();
   unsigned int locally_owned_cell_id = 0;
   std::vector<dealii::types::global_dof_index> local_dof_indices(
       n_dofs_per_cell);
-  for (auto const &cell : _dof_handler.active_cell_iterators())
+  for (auto const &cell :
+       dealii::filter_iterators(_dof_handler->active_cell_iterators(),
+                                dealii::IteratorFilters::LocallyOwnedCell()))
   {
-    if (cell->is_locally_owned())
+    dealii::ArrayView<double const> const cell_data =
+        std::as_const(_data_to_transfer)[cell->active_cell_index()];
+    if (cell_data[0] != std::numeric_limits<double>::infinity())
     {
-      if (transferred_data[cell_id][0] !=
-          std::numeric_limits<double>::infinity())
+      cell->get_dof_indices(local_dof_indices);
+      for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
       {
-        std::copy(transferred_data[cell_id].begin(),
-                  transferred_data[cell_id].begin() + n_dofs_per_cell,
-                  _cell_solution.begin());
-        cell->get_dof_indices(local_dof_indices);
-        for (unsigned int i = 0; i < n_dofs_per_cell; ++i)
+        if (rw_index_set.is_element(local_dof_indices[i]))
         {
-          if (rw_index_set.is_element(local_dof_indices[i]))
-          {
-            rw_solution[local_dof_indices[i]] = _cell_solution(i);
-          }
+          rw_solution[local_dof_indices[i]] = cell_data[i];
         }
       }
+    }
 
-      if (cell->active_fe_index() == 0)
-      {
-        _deposition_cos.push_back(transferred_data[cell_id][n_dofs_per_cell]);
-        _deposition_sin.push_back(
-            transferred_data[cell_id][n_dofs_per_cell + 1]);
-        if (transferred_data[cell_id][n_dofs_per_cell + direction_data_size] >
-            0.5)
-          _has_melted.push_back(true);
-        else
-          _has_melted.push_back(false);
-      }
-      for (unsigned int i = 0; i < n_material_states; ++i)
-      {
-        state_host(i, locally_owned_cell_id) =
-            transferred_data[cell_id][n_dofs_per_cell + direction_data_size +
-                                      phase_history_data_size + i];
-      }
-      ++locally_owned_cell_id;
+    if (cell->active_fe_index() == 0)
+    {
+      _deposition_cos.push_back(cell_data[n_dofs_per_cell]);
+      _deposition_sin.push_back(cell_data[n_dofs_per_cell + 1]);
+      _has_melted.push_back(cell_data[n_dofs_per_cell + direction_data_size] >
+                            0.5);
+      if (_use_quiet_elements)
+        _quiet_cells.push_back(cell_data[quiet_data_index] > 0.5);
     }
-    ++cell_id;
+    for (unsigned int i = 0; i < n_material_states; ++i)
+    {
+      state_host(i, locally_owned_cell_id) = cell_data[state_data_index + i];
+    }
+#ifdef ADAMANTINE_DEBUG
+    // Check that we are not losing material
+    double const material_ratio =
+        std::accumulate(cell_data.begin() + state_data_index, cell_data.end(),
+                        0.);
+    ASSERT(std::abs(material_ratio - 1.) < 1e-14, "Material is lost.");
+#endif
+    ++locally_owned_cell_id;
   }
+  _data_to_transfer.clear();
   Kokkos::deep_copy(state, state_host);
   get_state_from_material_properties();
-  _thermal_operator->set_material_deposition_orientation(_deposition_cos,
-                                                         _deposition_sin);
+  update_material_deposition_orientation();
+  update_quiet_cells();
 
   // Communicate the results.
   solution.zero_out_ghost_values();
@@ -838,48 +1308,158 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
           typename MemorySpaceType, typename QuadratureType>
-void ThermalPhysics<
-    dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
-    QuadratureType>::update_physics_parameters(boost::property_tree::ptree const
-                                                   &heat_source_database)
+std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>
+ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+               QuadratureType>::get_quiet_cell_iterators() const
 {
-  // Update the heat source from heat_source_database to reflect changes during
-  // the simulation (i.e. due to data assimilation)
-  unsigned int source_index = 0;
-  for (auto const &source : _heat_sources)
-  {
-    // PropertyTreeInput sources.beam_X
-    boost::property_tree::ptree const &beam_database =
-        heat_source_database.get_child("beam_" + std::to_string(source_index));
-
-    // PropertyTreeInput sources.beam_X.type
-    std::string type = beam_database.get<std::string>("type");
-
-    if (type == "goldak" || type == "electron_beam")
-      source->set_beam_properties(beam_database);
+  std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>
+      quiet_cell_iterators;
+  if (!_use_quiet_elements)
+    return quiet_cell_iterators;
 
-    source_index++;
+  unsigned int cell_id = 0;
+  for (auto const &cell :
+       dealii::filter_iterators(_dof_handler->active_cell_iterators(),
+                                dealii::IteratorFilters::LocallyOwnedCell()))
+  {
+    if (_quiet_cells[cell_id])
+      quiet_cell_iterators.push_back(cell);
+    ++cell_id;
   }
+
+  return quiet_cell_iterators;
 }
 
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
           typename MemorySpaceType, typename QuadratureType>
-double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
-                      QuadratureType>::
-    evolve_one_time_step(
-        double t, double delta_t,
-        dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
-        std::vector<Timer> &timers)
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    activate_quiet_cells(
+        std::vector<std::vector<
+            typename dealii::DoFHandler<dim>::active_cell_iterator>> const
+            &elements_to_activate,
+        std::vector<double> const &new_deposition_cos,
+        std::vector<double> const &new_deposition_sin,
+        unsigned int const activation_start, unsigned int const activation_end,
+        double const new_material_temperature,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &solution)
 {
-  // Update the height of the heat source. Right now this is just the
-  // maximum heat source height, which can lead to unexpected behavior for
-  // different sources with different heights.
-  double temp_height = std::numeric_limits<double>::lowest();
-  for (auto const &source : _heat_sources)
+  ASSERT(_use_quiet_elements, "Quiet elements are not used.");
+
+  // With quiet elements, every locally owned cell uses FE_Q. We store the
+  // position of the cells in the per-cell vectors using their active cell
+  // index.
+  std::vector<unsigned int> cell_ids(
+      _dof_handler->get_triangulation().n_active_cells(),
+      dealii::numbers::invalid_unsigned_int);
+
+  // Flag the degrees of freedom of the material already deposited with two and
+  // the ones of the activated cells with one. The degrees of freedom can be
+  // shared with cells owned by other processors, so we keep the largest flag.
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dof_flags(
+      solution.get_partitioner());
+  std::vector<dealii::types::global_dof_index> local_dof_indices(
+      _dof_handler->get_fe().n_dofs_per_cell());
+  auto flag_dofs = [&](auto const &cell, double const flag)
   {
-    temp_height = std::max(temp_height, source->get_current_height(t));
+    cell->get_dof_indices(local_dof_indices);
+    for (auto const dof : local_dof_indices)
+      dof_flags(dof) = std::max(dof_flags(dof), flag);
+  };
+
+  unsigned int cell_id = 0;
+  for (auto const &cell :
+       dealii::filter_iterators(_dof_handler->active_cell_iterators(),
+                                dealii::IteratorFilters::LocallyOwnedCell()))
+  {
+    cell_ids[cell->active_cell_index()] = cell_id;
+    if (!_quiet_cells[cell_id])
+      flag_dofs(cell, 2.);
+    ++cell_id;
   }
-  _current_source_height = temp_height;
+
+  // Activate the cells by updating their deposition angles and their
+  // coefficients.
+  for (unsigned int i = activation_start; i < activation_end; ++i)
+  {
+    for (auto const &cell : elements_to_activate[i])
+    {
+      unsigned int const j = cell_ids[cell->active_cell_index()];
+      if (_quiet_cells[j])
+      {
+        _quiet_cells[j] = false;
+        _deposition_cos[j] = new_deposition_cos[i];
+        _deposition_sin[j] = new_deposition_sin[i];
+        flag_dofs(cell, 1.);
+      }
+    }
+  }
+  dof_flags.compress(dealii::VectorOperation::max);
+
+  update_material_deposition_orientation();
+  update_quiet_cells();
+
+  // Set the temperature of the new material.
+  dealii::IndexSet rw_index_set = solution.locally_owned_elements();
+  dealii::LA::ReadWriteVector<double> rw_solution(rw_index_set);
+  rw_solution.import(solution, dealii::VectorOperation::insert);
+  for (auto val : rw_index_set)
+    if (dof_flags(val) == 1.)
+      rw_solution[val] = new_material_temperature;
+
+  // Communicate the results.
+  solution.zero_out_ghost_values();
+  solution.import(rw_solution, dealii::VectorOperation::insert);
+  solution.update_ghost_values();
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<
+    dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+    QuadratureType>::update_physics_parameters(boost::property_tree::ptree const
+                                                   &heat_source_database)
+{
+  // Update the heat source from heat_source_database to reflect changes during
+  // the simulation (i.e. due to data assimilation)
+  unsigned int source_index = 0;
+  for (auto const &source : _heat_sources)
+  {
+    // PropertyTreeInput sources.beam_X
+    boost::property_tree::ptree const &beam_database =
+        heat_source_database.get_child("beam_" + std::to_string(source_index));
+
+    // PropertyTreeInput sources.beam_X.type
+    std::string type = beam_database.get<std::string>("type");
+
+    if (type == "goldak" || type == "electron_beam")
+      source->set_beam_properties(beam_database);
+
+    source_index++;
+  }
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                      QuadratureType>::
+    evolve_one_time_step(
+        double t, double delta_t,
+        dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
+        std::vector<Timer> &timers)
+{
+  update_heat_sources(t, delta_t);
+
+  if (_multirate_n_substeps > 1)
+    return evolve_one_time_step_multirate(t, delta_t, solution, timers);
+
+  if (_dormant_update_interval > 0)
+    return evolve_one_time_step_dormant(t, delta_t, solution, timers);
+
+  if (_newton_solver)
+    return evolve_one_time_step_newton_krylov(t, delta_t, solution, timers);
+
+  _stage_times.clear();
 
   auto eval = [&](double const t, LA_Vector const &y)
   { return evaluate_thermal_physics(t, y, timers); };
@@ -893,6 +1473,432 @@ double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
   return time;
 }
 
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::update_heat_sources(double t,
+                                                         double delta_t)
+{
+  // Update the height of the heat source. Right now this is just the
+  // maximum heat source height, which can lead to unexpected behavior for
+  // different sources with different heights.
+  double temp_height = std::numeric_limits<double>::lowest();
+  for (auto const &source : _heat_sources)
+  {
+    temp_height = std::max(temp_height, source->get_current_height(t));
+    // Time averaged sources are swept over the time step.
+    source->set_sweep_window(t, delta_t);
+  }
+  _current_source_height = temp_height;
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                      QuadratureType>::
+    evolve_ensemble_one_time_step(
+        double t, double delta_t,
+        std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+            &members,
+        std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+            const &solutions,
+        std::vector<Timer> &timers)
+{
+  unsigned int const n_members = members.size();
+  ASSERT_THROW(solutions.size() == n_members,
+               "Error: The number of solutions does not match the number of "
+               "ensemble members.");
+
+  // The operators can only be applied together if all the members can use
+  // the batched operator and have the same mesh. The decision needs to be
+  // the same on all the processors because the vectors of the members are
+  // communicated in the same order.
+  std::vector<ThermalPhysics *> physics(n_members);
+  bool batched = true;
+  for (unsigned int k = 0; k < n_members; ++k)
+  {
+    physics[k] = dynamic_cast<ThermalPhysics *>(members[k]);
+    batched = batched && (physics[k] != nullptr) &&
+              physics[k]->_batched_ensemble &&
+              (solutions[k]->locally_owned_size() ==
+               _dof_handler->n_locally_owned_dofs());
+  }
+  batched = dealii::Utilities::MPI::min(static_cast<int>(batched),
+                                        _dof_handler->get_communicator());
+  if (!batched)
+  {
+    double time = t;
+    for (unsigned int k = 0; k < n_members; ++k)
+      time = members[k]->evolve_one_time_step(t, delta_t, *solutions[k],
+                                              timers);
+    return time;
+  }
+
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    std::vector<LA_Vector> values(n_members);
+    std::vector<LA_Vector *> dst(n_members);
+    std::vector<LA_Vector const *> src(n_members);
+    std::vector<ThermalOperatorBase<dim, MemorySpaceType> const *> operators(
+        n_members);
+    for (unsigned int k = 0; k < n_members; ++k)
+    {
+      physics[k]->update_heat_sources(t, delta_t);
+      physics[k]->_thermal_operator->set_time_and_source_height(
+          t, physics[k]->_current_source_height);
+      values[k].reinit(solutions[k]->get_partitioner());
+      dst[k] = &values[k];
+      src[k] = solutions[k];
+      operators[k] = physics[k]->_thermal_operator.get();
+    }
+
+    timers[evol_time_eval_th_ph].start();
+    _thermal_operator->vmult_add_ensemble(dst, src, operators);
+    timers[evol_time_eval_th_ph].stop();
+
+    // Forward Euler step of each member
+    for (unsigned int k = 0; k < n_members; ++k)
+    {
+      auto const &thermal_operator = physics[k]->_thermal_operator;
+      values[k].scale(*thermal_operator->get_inverse_mass_matrix());
+      solutions[k]->add(delta_t, values[k]);
+    }
+  }
+  else
+  {
+    ASSERT_THROW(false, "Error: The ensemble operator is not supported on the "
+                        "device.");
+  }
+
+  return t + delta_t;
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                      QuadratureType>::
+    evolve_one_time_step_multirate(double t, double delta_t,
+                                   LA_Vector &solution,
+                                   std::vector<Timer> &timers)
+{
+  // The right-hand side of the slow degrees of freedom is computed once on
+  // the whole domain. The slow degrees of freedom are then advanced by
+  // substep * rhs during each substep, which interpolates them linearly
+  // between the beginning and the end of the time step.
+  LA_Vector const rhs = evaluate_thermal_physics(t, solution, timers);
+
+  double const substep = delta_t / _multirate_n_substeps;
+  _thermal_operator->set_evaluated_cells(_multirate_evaluated_cells);
+  unsigned int const local_size = solution.locally_owned_size();
+  for (unsigned int k = 0; k < _multirate_n_substeps; ++k)
+  {
+    // The fast region sees the source swept over the substep.
+    for (auto &source : _heat_sources)
+      source->set_sweep_window(t + k * substep, substep);
+    // Only the cell batches coupled to the fast region are evaluated, the
+    // slow entries of fast_rhs are meaningless.
+    LA_Vector const fast_rhs =
+        evaluate_thermal_physics(t + k * substep, solution, timers);
+    for (unsigned int i = 0; i < local_size; ++i)
+      solution.local_element(i) +=
+          substep * (_multirate_fast_dofs[i] ? fast_rhs.local_element(i)
+                                             : rhs.local_element(i));
+    if (solution.has_ghost_elements())
+      solution.update_ghost_values();
+  }
+  _thermal_operator->set_evaluated_cells(std::vector<bool>());
+
+  return t + delta_t;
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                      QuadratureType>::
+    evolve_one_time_step_dormant(double t, double delta_t,
+                                 LA_Vector &solution,
+                                 std::vector<Timer> &timers)
+{
+  // Check if a heat source got close to the dormant region. The decision
+  // needs to be the same on all the processors because the update of the
+  // dormant region requires communication.
+  bool update_needed =
+      _n_steps_since_dormant_update >= _dormant_update_interval;
+  if (!update_needed)
+  {
+    for (auto &source : _heat_sources)
+    {
+      source->update_time(t);
+      auto source_bounding_box = source->get_bounding_box(1.);
+      source_bounding_box.extend(_dormant_distance);
+      for (auto const &cell_bounding_box : _dormant_cell_bounding_boxes)
+        if (source_bounding_box.get_neighbor_type(cell_bounding_box) !=
+            dealii::NeighborType::not_neighbors)
+        {
+          update_needed = true;
+          break;
+        }
+    }
+  }
+  update_needed = dealii::Utilities::MPI::max(
+      static_cast<int>(update_needed), _dof_handler->get_communicator());
+
+  unsigned int const local_size = solution.locally_owned_size();
+  bool first_evaluation = true;
+  bool interface_is_active = false;
+  auto eval = [&](double const t, LA_Vector const &y)
+  {
+    LA_Vector value = evaluate_thermal_physics(t, y, timers);
+    if (update_needed)
+    {
+      // The first stage of the explicit methods is evaluated at the
+      // beginning of the time step.
+      if (first_evaluation)
+        _dormant_rates = value;
+    }
+    else
+    {
+      for (unsigned int i = 0; i < local_size; ++i)
+      {
+        if (_dormant_dofs[i])
+          value.local_element(i) = _dormant_rates.local_element(i);
+        else if (first_evaluation && _dormant_interface_dofs[i] &&
+                 (std::abs(value.local_element(i)) > _dormant_rate_threshold))
+          interface_is_active = true;
+      }
+    }
+    first_evaluation = false;
+
+    return value;
+  };
+  auto id_m_Jinv = [&](double const t, double const tau, LA_Vector const &y)
+  { return id_minus_tau_J_inverse(t, tau, y, timers); };
+
+  if (update_needed)
+    _thermal_operator->set_evaluated_cells(std::vector<bool>());
+  else
+    _thermal_operator->set_evaluated_cells(_dormant_evaluated_cells);
+  double const time = _time_stepping->evolve_one_time_step(
+      eval, id_m_Jinv, t, delta_t, solution);
+  _thermal_operator->set_evaluated_cells(std::vector<bool>());
+
+  if (update_needed)
+  {
+    update_dormant_region(time, solution);
+    _n_steps_since_dormant_update = 0;
+  }
+  ++_n_steps_since_dormant_update;
+  // The heat flux going through the interface rises, the dormant region is
+  // woken up during the next time step.
+  if (interface_is_active)
+    _n_steps_since_dormant_update = _dormant_update_interval;
+
+  return time;
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::update_dormant_region(double t,
+                                                          LA_Vector const
+                                                              &solution)
+{
+  std::vector<dealii::BoundingBox<dim>> source_bounding_boxes;
+  for (auto &source : _heat_sources)
+  {
+    source->update_time(t);
+    source_bounding_boxes.push_back(source->get_bounding_box(1.));
+    source_bounding_boxes.back().extend(_dormant_distance);
+  }
+
+  // The temperature and the rate of the ghost degrees of freedom are
+  // necessary to check the cells.
+  dealii::IndexSet locally_relevant_dofs;
+  dealii::DoFTools::extract_locally_relevant_dofs(*_dof_handler,
+                                                  locally_relevant_dofs);
+  LA_Vector temperature(_dof_handler->locally_owned_dofs(),
+                        locally_relevant_dofs,
+                        _dof_handler->get_communicator());
+  LA_Vector rates(temperature.get_partitioner());
+  temperature.copy_locally_owned_data_from(solution);
+  rates.copy_locally_owned_data_from(_dormant_rates);
+  temperature.update_ghost_values();
+  rates.update_ghost_values();
+
+  std::vector<bool> active_cells;
+  _dormant_cell_bounding_boxes.clear();
+  dealii::Vector<double> cell_temperature;
+  dealii::Vector<double> cell_rates;
+  for (auto const &cell : dealii::filter_iterators(
+           _dof_handler->active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    cell_temperature.reinit(cell->get_fe().n_dofs_per_cell());
+    cell_rates.reinit(cell->get_fe().n_dofs_per_cell());
+    cell->get_dof_values(temperature, cell_temperature);
+    cell->get_dof_values(rates, cell_rates);
+    double const temperature_variation =
+        *std::max_element(cell_temperature.begin(), cell_temperature.end()) -
+        *std::min_element(cell_temperature.begin(), cell_temperature.end());
+    bool dormant =
+        (cell_rates.linfty_norm() < _dormant_rate_threshold) &&
+        (temperature_variation <
+         _dormant_gradient_threshold * cell->diameter());
+    auto const cell_bounding_box = cell->bounding_box();
+    for (auto const &source_bounding_box : source_bounding_boxes)
+      dormant = dormant && (source_bounding_box.get_neighbor_type(
+                                cell_bounding_box) ==
+                            dealii::NeighborType::not_neighbors);
+    if (dormant)
+      _dormant_cell_bounding_boxes.push_back(cell_bounding_box);
+    active_cells.push_back(!dormant);
+  }
+
+  // The degrees of freedom that are not coupled to an active cell are
+  // dormant. Only the cells coupled to the active degrees of freedom need to
+  // be evaluated.
+  flag_coupled_dofs(active_cells, _dormant_dofs, _dormant_evaluated_cells,
+                    &_dormant_interface_dofs);
+  _dormant_dofs.flip();
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                      QuadratureType>::
+    evolve_one_time_step_newton_krylov(double t, double delta_t,
+                                       LA_Vector &solution,
+                                       std::vector<Timer> &timers)
+{
+  if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
+  {
+    double const new_time = t + delta_t;
+    LA_Vector const old_solution(solution);
+
+    // The evaluations of the right-hand side are timed by
+    // evaluate_thermal_physics. The J_inv timer is paused during the
+    // evaluations so that it only measures the rest of the Newton-Krylov
+    // solve and the time is not counted twice.
+    auto evaluate = [&](LA_Vector const &y)
+    {
+      timers[evol_time_J_inv].stop();
+      LA_Vector value = evaluate_thermal_physics(new_time, y, timers);
+      timers[evol_time_J_inv].start();
+      return value;
+    };
+
+    // The residual of backward Euler is y - y_old - delta_t f(new_time, y).
+    // The last point where the residual is evaluated and the right-hand side
+    // at this point are kept to compute the Jacobian-vector products.
+    LA_Vector current_y(solution.get_partitioner());
+    LA_Vector current_f(solution.get_partitioner());
+    auto compute_residual = [&](LA_Vector const &y)
+    {
+      current_y = y;
+      current_f = evaluate(y);
+      LA_Vector residual(y);
+      residual -= old_solution;
+      residual.add(-delta_t, current_f);
+      return residual;
+    };
+
+    // J src = src - delta_t (f(y + epsilon src) - f(y)) / epsilon
+    LA_Vector y_perturbed(solution.get_partitioner());
+    auto jacobian_vmult = [&](LA_Vector &dst, LA_Vector const &src)
+    {
+      double const src_norm = src.linfty_norm();
+      if (src_norm == 0.)
+      {
+        dst = 0.;
+        return;
+      }
+      double const epsilon = std::sqrt(std::numeric_limits<double>::epsilon()) *
+                             (1. + current_y.linfty_norm()) / src_norm;
+      y_perturbed = current_y;
+      y_perturbed.add(epsilon, src);
+      dst = evaluate(y_perturbed);
+      dst -= current_f;
+      dst *= -delta_t / epsilon;
+      dst += src;
+    };
+
+    // The eigenvalues of the Jacobian are in [1, lambda_max] when the
+    // material properties do not change too quickly. lambda_max is estimated
+    // using the power method and the estimate is reused by the following
+    // Newton iterations.
+    double lambda_max = 1.;
+    auto setup_preconditioner = [&](LA_Vector const &)
+    {
+      if (_chebyshev_degree == 0)
+        return;
+      LA_Vector v(solution.get_partitioner());
+      LA_Vector w(solution.get_partitioner());
+      dealii::IndexSet const locally_owned = v.locally_owned_elements();
+      for (unsigned int i = 0; i < v.locally_owned_size(); ++i)
+      {
+        auto const global_index = locally_owned.nth_index_in_set(i);
+        v.local_element(i) = (global_index % 2 == 0) ? 1. : -1.;
+        v.local_element(i) += 0.1 * std::sin(1. + global_index);
+      }
+      v /= v.l2_norm();
+      double eigenvalue = 1.;
+      for (unsigned int k = 0; k < 10; ++k)
+      {
+        jacobian_vmult(w, v);
+        eigenvalue = w.l2_norm();
+        if (eigenvalue == 0.)
+          break;
+        v.equ(1. / eigenvalue, w);
+      }
+      // The power method underestimates the largest eigenvalue.
+      lambda_max = std::max(1.2 * eigenvalue, 1.);
+    };
+
+    // Chebyshev iteration on [1, lambda_max] starting from zero.
+    LA_Vector residual(solution.get_partitioner());
+    LA_Vector direction(solution.get_partitioner());
+    LA_Vector jacobian_direction(solution.get_partitioner());
+    auto apply_preconditioner = [&](LA_Vector &dst, LA_Vector const &src)
+    {
+      if ((_chebyshev_degree == 0) || (lambda_max <= 1.))
+      {
+        dst = src;
+        return;
+      }
+      double const theta = 0.5 * (lambda_max + 1.);
+      double const delta = 0.5 * (lambda_max - 1.);
+      double const sigma = theta / delta;
+      double rho = 1. / sigma;
+      residual = src;
+      direction.equ(1. / theta, src);
+      dst = direction;
+      for (unsigned int k = 1; k < _chebyshev_degree; ++k)
+      {
+        jacobian_vmult(jacobian_direction, direction);
+        residual -= jacobian_direction;
+        double const rho_new = 1. / (2. * sigma - rho);
+        direction.sadd(rho_new * rho, 2. * rho_new / delta, residual);
+        dst += direction;
+        rho = rho_new;
+      }
+    };
+
+    timers[evol_time_J_inv].start();
+    _newton_solver->solve(compute_residual, jacobian_vmult,
+                          setup_preconditioner, apply_preconditioner,
+                          solution);
+    timers[evol_time_J_inv].stop();
+  }
+  else
+  {
+    ASSERT_THROW(false, "Error: The Newton-Krylov method is not supported on "
+                        "the device.");
+  }
+
+  return t + delta_t;
+}
+
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
           typename MemorySpaceType, typename QuadratureType>
 void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
@@ -926,6 +1932,29 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
   _thermal_operator->set_state_to_material_properties();
 }
 
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                      QuadratureType>::get_locally_owned_weight() const
+{
+  double weight = 0.;
+  for (auto const &cell : _dof_handler->active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    weight += compute_cell_weight(cell, cell->get_fe());
+  }
+
+  return weight;
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+double ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                      QuadratureType>::get_mixed_precision_difference() const
+{
+  return _thermal_operator->get_mixed_precision_difference();
+}
+
 template <int dim, int p_order, int fe_degree, typename MaterialStates,
           typename MemorySpaceType, typename QuadratureType>
 dealii::LA::distributed::Vector<double, MemorySpaceType>
@@ -950,17 +1979,17 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
     {
       return evaluate_thermal_physics_impl<dim, true, p_order, fe_degree,
                                            MaterialStates, MemorySpaceType>(
-          _thermal_operator, _fe_collection, t, _dof_handler, _heat_sources,
+          _thermal_operator, _fe_collection, t, *_dof_handler, _heat_sources,
           _current_source_height, _boundary_type, _material_properties,
-          _affine_constraints, y, timers);
+          *_affine_constraints, y, timers);
     }
     else
     {
       return evaluate_thermal_physics_impl<dim, false, p_order, fe_degree,
                                            MaterialStates, MemorySpaceType>(
-          _thermal_operator, _fe_collection, t, _dof_handler, _heat_sources,
+          _thermal_operator, _fe_collection, t, *_dof_handler, _heat_sources,
           _current_source_height, _boundary_type, _material_properties,
-          _affine_constraints, y, timers);
+          *_affine_constraints, y, timers);
     }
   }
 
@@ -974,7 +2003,7 @@ dealii::LA::distributed::Vector<double, MemorySpaceType>
 ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
                QuadratureType>::
     id_minus_tau_J_inverse(
-        double const /*t*/, double const tau,
+        double const t, double const tau,
         dealii::LA::distributed::Vector<double, MemorySpaceType> const &y,
         std::vector<Timer> &timers) const
 {
@@ -983,18 +2012,77 @@ ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
   dealii::LA::distributed::Vector<double, MemorySpaceType> solution(
       y.get_partitioner());
 
-  // TODO Add a geometric multigrid preconditioner.
-  dealii::PreconditionIdentity preconditioner;
+  // The first inversion of a stage computes the whole update of the stage.
+  // The following Newton iterations only compute small corrections, so only
+  // the first inversion uses and updates the extrapolation.
+  unsigned int stage = _stage_times.size();
+  for (unsigned int i = 0; i < _stage_times.size(); ++i)
+    if (std::abs(_stage_times[i] - t) <= 1e-12 * (1. + std::abs(t)))
+      stage = i;
+  bool const first_inversion = (stage == _stage_times.size());
+  if (first_inversion)
+    _stage_times.push_back(t);
+
+  // The symmetric form of the operator is multiplied by the mass matrix.
+  dealii::LA::distributed::Vector<double, MemorySpaceType> rhs(y);
+  if (_use_cg)
+    rhs.scale(*_implicit_operator->get_mass_matrix());
+
+  if (_extrapolate_initial_guess && first_inversion &&
+      (stage < _previous_stage_solutions.size()))
+  {
+    auto const &previous_solutions = _previous_stage_solutions[stage];
+    solution = previous_solutions[0];
+    if (previous_solutions.size() == 2)
+      solution.sadd(2., -1., previous_solutions[1]);
+    // The extrapolation is discarded if it is worse than the zero vector,
+    // e.g., after a sudden change of the heat sources.
+    dealii::LA::distributed::Vector<double, MemorySpaceType> residual(
+        y.get_partitioner());
+    _implicit_operator->vmult(residual, solution);
+    residual -= rhs;
+    if (residual.l2_norm() >= rhs.l2_norm())
+      solution = 0.;
+  }
 
-  dealii::SolverControl solver_control(_max_iter, _tolerance * y.l2_norm());
-  // We need to inverse (I - tau M^{-1} J). While M^{-1} and J are SPD,
-  // (I - tau M^{-1} J) is symmetric indefinite in the general case.
-  typename dealii::SolverGMRES<
-      dealii::LA::distributed::Vector<double, MemorySpaceType>>::AdditionalData
-      additional_data(_max_n_tmp_vectors, _right_preconditioning);
-  dealii::SolverGMRES<dealii::LA::distributed::Vector<double, MemorySpaceType>>
-      solver(solver_control, additional_data);
-  solver.solve(*_implicit_operator, solution, y, preconditioner);
+  dealii::SolverControl solver_control(_max_iter, _tolerance * rhs.l2_norm());
+  if (_use_cg)
+  {
+    // (M - tau J) is symmetric positive definite when the coefficients are
+    // lagged. The inverse of the diagonal mass matrix is used as
+    // preconditioner.
+    dealii::DiagonalMatrix<
+        dealii::LA::distributed::Vector<double, MemorySpaceType>>
+        preconditioner(*_thermal_operator->get_inverse_mass_matrix());
+    dealii::SolverCG<dealii::LA::distributed::Vector<double, MemorySpaceType>>
+        solver(solver_control);
+    solver.solve(*_implicit_operator, solution, rhs, preconditioner);
+  }
+  else
+  {
+    // TODO Add a geometric multigrid preconditioner.
+    dealii::PreconditionIdentity preconditioner;
+
+    // We need to inverse (I - tau M^{-1} J). While M^{-1} and J are SPD,
+    // (I - tau M^{-1} J) is symmetric indefinite in the general case.
+    typename dealii::SolverGMRES<dealii::LA::distributed::Vector<
+        double, MemorySpaceType>>::AdditionalData
+        additional_data(_max_n_tmp_vectors, _right_preconditioning);
+    dealii::SolverGMRES<
+        dealii::LA::distributed::Vector<double, MemorySpaceType>>
+        solver(solver_control, additional_data);
+    solver.solve(*_implicit_operator, solution, rhs, preconditioner);
+  }
+
+  if (_extrapolate_initial_guess && first_inversion)
+  {
+    if (stage >= _previous_stage_solutions.size())
+      _previous_stage_solutions.resize(stage + 1);
+    auto &previous_solutions = _previous_stage_solutions[stage];
+    if (previous_solutions.size() == 2)
+      previous_solutions.pop_back();
+    previous_solutions.insert(previous_solutions.begin(), solution);
+  }
 
   timers[evol_time_J_inv].stop();
 
@@ -1010,63 +2098,88 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &temperature)
 {
   // Deserialize the mesh
+  _geometry.get_triangulation().load(filename);
+  restore_checkpoint(temperature);
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    load_ensemble_checkpoint(
+        std::string const &filename,
+        std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+            &members,
+        std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+            const &temperatures)
+{
+  auto const physics = get_ensemble_physics(members, temperatures);
+
+  // Deserialize the mesh once. The data of the members is retrieved in the
+  // order used by save_ensemble_checkpoint(). This object owns the
+  // DoFHandler and it rebuilds the degrees of freedom first.
+  _geometry.get_triangulation().load(filename);
+  for (unsigned int k = 0; k < physics.size(); ++k)
+    physics[k]->restore_checkpoint(*temperatures[k]);
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::restore_checkpoint(LA_Vector &temperature)
+{
   auto &triangulation = _geometry.get_triangulation();
-  triangulation.load(filename);
 
   // Deserialize the states, the direction, and the fe indices.
   unsigned int constexpr n_material_states = MaterialStates::n_material_states;
   unsigned int constexpr direction_data_size = 2;
   unsigned int constexpr data_size_per_cell =
       n_material_states + direction_data_size + 1;
-  std::vector<std::vector<double>> data_to_deserialize(
-      triangulation.n_active_cells(), std::vector<double>(data_size_per_cell));
-  dealii::parallel::distributed::CellDataTransfer<
-      dim, dim, std::vector<std::vector<double>>>
-      cell_data_trans(triangulation);
-  cell_data_trans.deserialize(data_to_deserialize);
+  CellDataBuffer<dim> data_to_deserialize;
+  data_to_deserialize.reinit(triangulation.n_active_cells(),
+                             data_size_per_cell);
+  data_to_deserialize.deserialize(triangulation);
   _deposition_cos.clear();
   _deposition_sin.clear();
+  _quiet_cells.clear();
 
-  unsigned int cell_id = 0;
   std::vector<std::array<double, n_material_states>> cell_state;
-
-  for (auto const &cell : _dof_handler.active_cell_iterators())
+  std::array<double, n_material_states> state;
+  for (auto const &cell :
+       dealii::filter_iterators(_dof_handler->active_cell_iterators(),
+                                dealii::IteratorFilters::LocallyOwnedCell()))
   {
-    if (cell->is_locally_owned())
-    {
-      // Get the state
-      if constexpr (n_material_states == 1)
-      {
-        cell_state.push_back({{data_to_deserialize[cell_id][0]}});
-      }
-      else if constexpr (n_material_states == 2)
-      {
-        cell_state.push_back({{data_to_deserialize[cell_id][0],
-                               data_to_deserialize[cell_id][1]}});
-      }
-      else if constexpr (n_material_states == 3)
-      {
-        cell_state.push_back(
-            {{data_to_deserialize[cell_id][0], data_to_deserialize[cell_id][1],
-              data_to_deserialize[cell_id][2]}});
-      }
-
-      // Set the fe index
-      auto fe_index = static_cast<unsigned int>(
-          data_to_deserialize[cell_id]
-                             [n_material_states + direction_data_size]);
+    dealii::ArrayView<double const> const cell_data =
+        std::as_const(data_to_deserialize)[cell->active_cell_index()];
+
+    // Get the state
+    std::copy_n(cell_data.begin(), n_material_states, state.begin());
+    cell_state.push_back(state);
+
+    // Set the fe index. The quiet cells use FE_Q but they are stored with an
+    // index of 2.
+    auto fe_index = static_cast<unsigned int>(
+        cell_data[n_material_states + direction_data_size]);
+    bool const quiet = fe_index == 2;
+    ASSERT_THROW(_use_quiet_elements || !quiet,
+                 "Error: The checkpoint was written using quiet elements.");
+    ASSERT_THROW(!_use_quiet_elements || (fe_index != 1),
+                 "Error: The checkpoint was not written using quiet "
+                 "elements.");
+    if (quiet)
+      fe_index = 0;
+    // The FE indices are stored in the shared DoFHandler by its owner.
+    if (!_shared_discretization)
       cell->set_active_fe_index(fe_index);
 
-      // Get the direction
-      if (fe_index == 0)
-      {
-        _deposition_cos.push_back(
-            data_to_deserialize[cell_id][n_material_states]);
-        _deposition_sin.push_back(
-            data_to_deserialize[cell_id][n_material_states + 1]);
-      }
+    // Get the direction
+    if (fe_index == 0)
+    {
+      _deposition_cos.push_back(cell_data[n_material_states]);
+      _deposition_sin.push_back(cell_data[n_material_states + 1]);
+      if (_use_quiet_elements)
+        _quiet_cells.push_back(quiet);
     }
-    ++cell_id;
   }
 
   setup_dofs();
@@ -1078,13 +2191,12 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
   // Finish the setup
   _thermal_operator->set_material_deposition_orientation(_deposition_cos,
                                                          _deposition_sin);
+  update_quiet_cells();
   compute_inverse_mass_matrix();
   get_state_from_material_properties();
 
   // Deserialize the temperature
-  dealii::parallel::distributed::SolutionTransfer<
-      dim, dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
-      solution_transfer(_dof_handler);
+  SolutionTransfer solution_transfer(*_dof_handler);
   initialize_dof_vector(0., temperature);
   if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
   {
@@ -1107,6 +2219,93 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
     save_checkpoint(
         std::string const &filename,
         dealii::LA::distributed::Vector<double, MemorySpaceType> &temperature)
+{
+  CellDataBuffer<dim> data_to_serialize;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      ghosted_temperature;
+  SolutionTransfer solution_transfer(*_dof_handler);
+  prepare_checkpoint(temperature, data_to_serialize, ghosted_temperature,
+                     solution_transfer);
+
+  // Serialize the mesh and the rest of the data.
+  _geometry.get_triangulation().save(filename);
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    save_ensemble_checkpoint(
+        std::string const &filename,
+        std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+            &members,
+        std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+            const &temperatures)
+{
+  auto const physics = get_ensemble_physics(members, temperatures);
+
+  // The data of all the members is attached to the shared Triangulation, in
+  // the order of the members, and the mesh is saved once. The objects used
+  // for the serialization need to be alive until the mesh is saved.
+  unsigned int const n_members = physics.size();
+  std::vector<CellDataBuffer<dim>> data_to_serialize(n_members);
+  std::vector<
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
+      ghosted_temperatures(n_members);
+  std::vector<std::unique_ptr<SolutionTransfer>> solution_transfers(n_members);
+  for (unsigned int k = 0; k < n_members; ++k)
+  {
+    solution_transfers[k] =
+        std::make_unique<SolutionTransfer>(*physics[k]->_dof_handler);
+    physics[k]->prepare_checkpoint(*temperatures[k], data_to_serialize[k],
+                                   ghosted_temperatures[k],
+                                   *solution_transfers[k]);
+  }
+
+  _geometry.get_triangulation().save(filename);
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+std::vector<ThermalPhysics<dim, p_order, fe_degree, MaterialStates,
+                           MemorySpaceType, QuadratureType> *>
+ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+               QuadratureType>::
+    get_ensemble_physics(
+        std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+            &members,
+        std::vector<LA_Vector *> const &temperatures)
+{
+  unsigned int const n_members = members.size();
+  ASSERT_THROW(temperatures.size() == n_members,
+               "Error: The number of temperatures does not match the number "
+               "of ensemble members.");
+  ASSERT_THROW((n_members > 0) && (members[0] == this),
+               "Error: The first ensemble member needs to own the "
+               "discretization.");
+
+  std::vector<ThermalPhysics *> physics(n_members);
+  for (unsigned int k = 0; k < n_members; ++k)
+  {
+    physics[k] = dynamic_cast<ThermalPhysics *>(members[k]);
+    ASSERT_THROW((physics[k] != nullptr) &&
+                     (physics[k]->_dof_handler == _dof_handler),
+                 "Error: The ensemble members need to share the "
+                 "discretization.");
+  }
+
+  return physics;
+}
+
+template <int dim, int p_order, int fe_degree, typename MaterialStates,
+          typename MemorySpaceType, typename QuadratureType>
+void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
+                    QuadratureType>::
+    prepare_checkpoint(
+        LA_Vector const &temperature, CellDataBuffer<dim> &data_to_serialize,
+        dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+            &ghosted_temperature,
+        SolutionTransfer &solution_transfer)
 {
   // Prepare the states and the fe indices for serialization.
   unsigned int constexpr n_material_states = MaterialStates::n_material_states;
@@ -1115,61 +2314,55 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
       n_material_states + direction_data_size + 1;
   unsigned int locally_owned_cell_id = 0;
   unsigned int activated_cell_id = 0;
-  unsigned int cell_id = 0;
   auto &triangulation = _geometry.get_triangulation();
-  std::vector<std::vector<double>> data_to_serialize(
-      triangulation.n_active_cells(), std::vector<double>(data_size_per_cell));
-  std::vector<double> element_data(data_size_per_cell, 0.);
+  data_to_serialize.reinit(triangulation.n_active_cells(), data_size_per_cell);
   auto state_host = Kokkos::create_mirror_view_and_copy(
       Kokkos::HostSpace{}, _material_properties.get_state());
-  for (auto const &cell : _dof_handler.active_cell_iterators())
+  for (auto const &cell :
+       dealii::filter_iterators(_dof_handler->active_cell_iterators(),
+                                dealii::IteratorFilters::LocallyOwnedCell()))
   {
-    if (cell->is_locally_owned())
+    dealii::ArrayView<double> const cell_data =
+        data_to_serialize[cell->active_cell_index()];
+
+    // Store the state
+    for (unsigned int i = 0; i < n_material_states; ++i)
     {
-      // Store the state
-      for (unsigned int i = 0; i < n_material_states; ++i)
-      {
-        data_to_serialize[cell_id][i] = state_host(i, locally_owned_cell_id);
-      }
+      cell_data[i] = state_host(i, locally_owned_cell_id);
+    }
 
-      auto fe_index = cell->active_fe_index();
-      // Store the direction
-      if (fe_index == 0)
-      {
-        data_to_serialize[cell_id][n_material_states] =
-            _deposition_cos[activated_cell_id];
-        data_to_serialize[cell_id][n_material_states + 1] =
-            _deposition_sin[activated_cell_id];
-        ++activated_cell_id;
-      }
-      else
-      {
-        // If there is no material, there is no deposition direction -> use an
-        // obviously wrong value.
-        data_to_serialize[cell_id][n_material_states] = 10.;
-        data_to_serialize[cell_id][n_material_states + 1] = 10.;
-      }
+    auto fe_index = cell->active_fe_index();
+    // Store the direction
+    if (fe_index == 0)
+    {
+      cell_data[n_material_states] = _deposition_cos[activated_cell_id];
+      cell_data[n_material_states + 1] = _deposition_sin[activated_cell_id];
+      // The quiet cells are stored with an FE index of 2
+      if (_use_quiet_elements && _quiet_cells[activated_cell_id])
+        fe_index = 2;
+      ++activated_cell_id;
+    }
+    else
+    {
+      // If there is no material, there is no deposition direction -> use an
+      // obviously wrong value.
+      cell_data[n_material_states] = 10.;
+      cell_data[n_material_states + 1] = 10.;
+    }
 
-      // Store the FE index
-      data_to_serialize[cell_id][n_material_states + direction_data_size] =
-          fe_index;
+    // Store the FE index
+    cell_data[n_material_states + direction_data_size] = fe_index;
 
-      ++locally_owned_cell_id;
-    }
-    ++cell_id;
+    ++locally_owned_cell_id;
   }
-  dealii::parallel::distributed::CellDataTransfer<
-      dim, dim, std::vector<std::vector<double>>>
-      cell_data_trans(triangulation);
-  cell_data_trans.prepare_for_serialization(data_to_serialize);
+  data_to_serialize.prepare_for_serialization(triangulation);
 
   // Prepare the temperature for serialization. We need to use a ghosted
   // vector.
-  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
-      ghosted_temperature(
-          temperature.locally_owned_elements(),
-          dealii::DoFTools::extract_locally_relevant_dofs(_dof_handler),
-          temperature.get_mpi_communicator());
+  ghosted_temperature.reinit(
+      temperature.locally_owned_elements(),
+      dealii::DoFTools::extract_locally_relevant_dofs(*_dof_handler),
+      temperature.get_mpi_communicator());
   if constexpr (std::is_same_v<MemorySpaceType, dealii::MemorySpace::Host>)
   {
     ghosted_temperature = temperature;
@@ -1183,13 +2376,7 @@ void ThermalPhysics<dim, p_order, fe_degree, MaterialStates, MemorySpaceType,
     ghosted_temperature = temperature_host;
   }
   ghosted_temperature.update_ghost_values();
-  dealii::parallel::distributed::SolutionTransfer<
-      dim, dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
-      solution_transfer(_dof_handler);
   solution_transfer.prepare_for_serialization(ghosted_temperature);
-
-  // Serialize the mesh and the rest of the data.
-  triangulation.save(filename);
 }
 } // namespace adamantine
 
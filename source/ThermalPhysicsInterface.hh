@@ -43,6 +43,19 @@ public:
    */
   virtual void setup_dofs() = 0;
 
+  /**
+   * Use the DoFHandler, the AffineConstraints<double>, and the MatrixFree
+   * objects of @p owner instead of building new ones. Both physics need to be
+   * of the same type and to be built on the same Geometry. This function needs
+   * to be called before setup(). The shared objects are only rebuilt by
+   * @p owner, so @p owner needs to go through setup() and through each step of
+   * a mesh change before the physics that share its objects. The only
+   * exception is mesh_change_start(): it clears the shared objects, so
+   * @p owner needs to call it after the physics that share its objects.
+   */
+  virtual void share_discretization(
+      ThermalPhysicsInterface<dim, MemorySpaceType> &owner) = 0;
+
   /**
    * Compute the inverse of the mass matrix associated to the Physics.
    */
@@ -70,6 +83,81 @@ public:
       double const new_material_temperature,
       dealii::LA::distributed::Vector<double, MemorySpaceType> &solution) = 0;
 
+  /**
+   * Start a mesh change. The temperature at the degrees of freedom and the data
+   * associated to each cell are saved so that the mesh can go through several
+   * passes of refinement, coarsening, and material activation before the
+   * degrees of freedom are rebuilt by mesh_change_end().
+   */
+  virtual void mesh_change_start(
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &solution) = 0;
+
+  /**
+   * Activate the cells of @p elements_to_activate between @p activation_start
+   * and @p activation_end during the next pass of the mesh change.
+   */
+  virtual void mesh_change_activate(
+      std::vector<std::vector<
+          typename dealii::DoFHandler<dim>::active_cell_iterator>> const
+          &elements_to_activate,
+      std::vector<double> const &new_deposition_cos,
+      std::vector<double> const &new_deposition_sin,
+      std::vector<bool> &new_has_melted, unsigned int const activation_start,
+      unsigned int const activation_end) = 0;
+
+  /**
+   * Attach the saved data to the Triangulation. The refinement and coarsening
+   * flags must be set before calling this function. The pass is executed by
+   * calling execute_coarsening_and_refinement() on the Triangulation followed
+   * by mesh_change_complete_pass().
+   */
+  virtual void mesh_change_prepare_pass() = 0;
+
+  /**
+   * Retrieve the saved data on the new mesh. The degrees of freedom are not
+   * rebuilt.
+   */
+  virtual void mesh_change_complete_pass() = 0;
+
+  /**
+   * Finalize the mesh change: rebuild the degrees of freedom and the operators
+   * once and fill @p solution. The degrees of freedom that only belong to
+   * activated cells are set to @p new_material_temperature.
+   */
+  virtual void mesh_change_end(
+      double const new_material_temperature,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &solution) = 0;
+
+  /**
+   * Return true if the cells without material are meshed from the start and
+   * kept quiet until they are activated instead of using FE_Nothing.
+   */
+  virtual bool use_quiet_elements() const = 0;
+
+  /**
+   * Return the locally owned quiet cells, i.e., the cells that are meshed but
+   * that do not contain material yet.
+   */
+  virtual std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>
+  get_quiet_cell_iterators() const = 0;
+
+  /**
+   * Activate quiet cells. Unlike add_material_start() and add_material_end(),
+   * the mesh and the degrees of freedom are unchanged and only the
+   * coefficients of the operator are updated. The degrees of freedom that are
+   * not shared with the material already deposited are set to @p
+   * new_material_temperature.
+   */
+  virtual void activate_quiet_cells(
+      std::vector<std::vector<
+          typename dealii::DoFHandler<dim>::active_cell_iterator>> const
+          &elements_to_activate,
+      std::vector<double> const &new_deposition_cos,
+      std::vector<double> const &new_deposition_sin,
+      unsigned int const activation_start, unsigned int const activation_end,
+      double const new_material_temperature,
+      dealii::LA::distributed::Vector<double, MemorySpaceType> &solution) = 0;
+
   /**
    * Public interface for modifying the private state of the Physics object. One
    * use of this is to modify nominally constant parameters in the middle of a
@@ -88,6 +176,21 @@ public:
       dealii::LA::distributed::Vector<double, MemorySpaceType> &solution,
       std::vector<Timer> &timers) = 0;
 
+  /**
+   * Evolve the ensemble members @p members from time t to time t+delta_t.
+   * @p solutions contains the fields of the members. If all the members use
+   * forward Euler on the same mesh, the operators of the members are applied
+   * in a single sweep over the mesh of this object. Otherwise, the members
+   * are evolved one after the other.
+   */
+  virtual double evolve_ensemble_one_time_step(
+      double t, double delta_t,
+      std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+          &members,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &solutions,
+      std::vector<Timer> &timers) = 0;
+
   /**
    * Initialize the given vector with the given value.
    */
@@ -124,6 +227,29 @@ public:
                   dealii::LA::distributed::Vector<double, MemorySpaceType>
                       &temperature) = 0;
 
+  /**
+   * Load the state of the ensemble members @p members, which share their mesh
+   * with this object, from a single file. This object needs to be the first
+   * member.
+   */
+  virtual void load_ensemble_checkpoint(
+      std::string const &filename,
+      std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+          &members,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &temperatures) = 0;
+
+  /**
+   * Write the state of the ensemble members @p members, which share their mesh
+   * with this object, in a single file. The mesh is only written once.
+   */
+  virtual void save_ensemble_checkpoint(
+      std::string const &filename,
+      std::vector<ThermalPhysicsInterface<dim, MemorySpaceType> *> const
+          &members,
+      std::vector<dealii::LA::distributed::Vector<double, MemorySpaceType> *>
+          const &temperatures) = 0;
+
   /**
    * Set the deposition cosine and sine and call
    * update_material_deposition_orientation.
@@ -167,6 +293,17 @@ public:
    */
   virtual bool get_has_melted(const unsigned int) const = 0;
 
+  /**
+   * Returns true if the cell @p i is a quiet cell.
+   */
+  virtual bool get_quiet_cell(unsigned int const i) const = 0;
+
+  /**
+   * Sets the quiet cells and update the operator. This function does nothing
+   * if quiet elements are not used.
+   */
+  virtual void set_quiet_cells_vector(std::vector<bool> const &quiet_cells) = 0;
+
   /**
    * Return the DoFHandler.
    */
@@ -186,6 +323,18 @@ public:
    * Return the degree of the finite element.
    */
   virtual unsigned int get_fe_degree() const = 0;
+
+  /**
+   * Return the sum of the load balancing weights of the locally owned cells.
+   */
+  virtual double get_locally_owned_weight() const = 0;
+
+  /**
+   * Return the largest relative difference between the single precision and
+   * the double precision applications of the thermal operator. The difference
+   * is only measured when the validation of the mixed precision is enabled.
+   */
+  virtual double get_mixed_precision_difference() const = 0;
 };
 } // namespace adamantine
 #endif
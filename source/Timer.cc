@@ -4,22 +4,68 @@
 
 #include <Timer.hh>
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 
 namespace adamantine
 {
-Timer::Timer(MPI_Comm communicator, std::string const &section)
-    : _communicator(communicator), _section(section), _clock(), _t_start(),
-      _elapsed_time(boost::chrono::milliseconds(0))
+namespace
 {
+unsigned int get_depth(std::vector<Timer> const &timers, unsigned int i)
+{
+  unsigned int depth = 0;
+  int parent = timers[i].get_parent();
+  while (parent >= 0)
+  {
+    ++depth;
+    parent = timers[parent].get_parent();
+  }
+
+  return depth;
 }
 
-void Timer::start() { _t_start = _clock.now(); }
+std::string get_path(std::vector<Timer> const &timers, unsigned int i)
+{
+  std::string path = timers[i].get_section();
+  int parent = timers[i].get_parent();
+  while (parent >= 0)
+  {
+    path = timers[parent].get_section() + "/" + path;
+    parent = timers[parent].get_parent();
+  }
+
+  return path;
+}
+} // namespace
 
-void Timer::stop() { _elapsed_time += _clock.now() - _t_start; }
+Timer::Timer(MPI_Comm communicator, std::string const &section, int parent)
+    : _communicator(communicator), _section(section), _parent(parent),
+      _t_start(), _elapsed_time(boost::chrono::milliseconds(0))
+{
+}
 
 void Timer::reset() { _elapsed_time = boost::chrono::milliseconds(0); }
 
+void Timer::record_load(double local_load)
+{
+  if (!_enabled)
+    return;
+
+  int n_procs = 1;
+  MPI_Comm_size(_communicator, &n_procs);
+  double total_load = 0.;
+  MPI_Allreduce(&local_load, &_min_load, 1, MPI_DOUBLE, MPI_MIN, _communicator);
+  MPI_Allreduce(&local_load, &_max_load, 1, MPI_DOUBLE, MPI_MAX, _communicator);
+  MPI_Allreduce(&local_load, &total_load, 1, MPI_DOUBLE, MPI_SUM,
+                _communicator);
+  _mean_load = total_load / n_procs;
+  if (_mean_load > 0.)
+    _max_imbalance = std::max(_max_imbalance, _max_load / _mean_load);
+  ++_n_load_records;
+}
+
 void Timer::print()
 {
   int rank = -1;
@@ -30,11 +76,123 @@ void Timer::print()
         boost::chrono::duration_cast<boost::chrono::milliseconds>(
             _elapsed_time);
     std::cout << "Time elapsed in " + _section + ": " << ms << std::endl;
+    print_records(std::cout, "");
   }
 }
 
-boost::chrono::process_real_cpu_clock::duration Timer::get_elapsed_time()
+void Timer::print_records(std::ostream &out, std::string const &indent) const
+{
+  if (_n_load_records > 0)
+  {
+    double const imbalance = _mean_load > 0. ? _max_load / _mean_load : 1.;
+    out << indent << "Load in " + _section + ": min " << _min_load << " max "
+        << _max_load << " mean " << _mean_load << " imbalance " << imbalance
+        << " (largest imbalance " << _max_imbalance << " over "
+        << _n_load_records << " records)" << std::endl;
+  }
+  if (_n_solves > 0)
+  {
+    out << indent << "Iterations in " + _section + ": " << _n_iterations
+        << " over " << _n_solves << " solves ("
+        << static_cast<double>(_n_iterations) / _n_solves << " per solve)"
+        << std::endl;
+  }
+}
+
+boost::chrono::steady_clock::duration Timer::get_elapsed_time()
 {
   return _elapsed_time;
 }
+
+TimerStatistics Timer::compute_statistics() const
+{
+  double const local_time =
+      boost::chrono::duration<double>(_elapsed_time).count();
+  int n_procs = 1;
+  MPI_Comm_size(_communicator, &n_procs);
+  TimerStatistics statistics;
+  double total_time = 0.;
+  MPI_Allreduce(&local_time, &statistics.min, 1, MPI_DOUBLE, MPI_MIN,
+                _communicator);
+  MPI_Allreduce(&local_time, &statistics.max, 1, MPI_DOUBLE, MPI_MAX,
+                _communicator);
+  MPI_Allreduce(&local_time, &total_time, 1, MPI_DOUBLE, MPI_SUM,
+                _communicator);
+  statistics.mean = total_time / n_procs;
+  statistics.imbalance =
+      statistics.mean > 0. ? statistics.max / statistics.mean : 1.;
+
+  return statistics;
+}
+
+void print_timers(std::vector<Timer> const &timers)
+{
+  if (timers.empty())
+    return;
+
+  std::vector<TimerStatistics> statistics;
+  for (auto const &timer : timers)
+    statistics.push_back(timer.compute_statistics());
+
+  int rank = -1;
+  MPI_Comm_rank(timers[0].get_communicator(), &rank);
+  if (rank == 0)
+  {
+    std::cout << "Wall-clock time in seconds (min / mean / max, imbalance):"
+              << std::endl;
+    for (unsigned int i = 0; i < timers.size(); ++i)
+    {
+      std::string const indent(2 * get_depth(timers, i), ' ');
+      std::cout << indent << timers[i].get_section() << ": "
+                << statistics[i].min << " / " << statistics[i].mean << " / "
+                << statistics[i].max << ", " << statistics[i].imbalance
+                << std::endl;
+      // The loads and the iterations are printed below their section.
+      timers[i].print_records(std::cout, indent + "  ");
+    }
+  }
+}
+
+void write_timers(std::vector<Timer> const &timers,
+                  std::string const &filename)
+{
+  if (timers.empty())
+    return;
+
+  std::vector<TimerStatistics> statistics;
+  for (auto const &timer : timers)
+    statistics.push_back(timer.compute_statistics());
+
+  int rank = -1;
+  MPI_Comm_rank(timers[0].get_communicator(), &rank);
+  if (rank != 0)
+    return;
+
+  std::ofstream file(filename);
+  bool const json = std::filesystem::path(filename).extension() == ".json";
+  if (json)
+  {
+    file << "[\n";
+    for (unsigned int i = 0; i < timers.size(); ++i)
+    {
+      file << "  {\"section\": \"" << get_path(timers, i)
+           << "\", \"min\": " << statistics[i].min
+           << ", \"mean\": " << statistics[i].mean
+           << ", \"max\": " << statistics[i].max
+           << ", \"imbalance\": " << statistics[i].imbalance << "}"
+           << (i + 1 < timers.size() ? ",\n" : "\n");
+    }
+    file << "]\n";
+  }
+  else
+  {
+    file << "section,min,mean,max,imbalance\n";
+    for (unsigned int i = 0; i < timers.size(); ++i)
+    {
+      file << "\"" << get_path(timers, i) << "\"," << statistics[i].min << ","
+           << statistics[i].mean << "," << statistics[i].max << ","
+           << statistics[i].imbalance << "\n";
+    }
+  }
+}
 } // namespace adamantine
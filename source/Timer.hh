@@ -7,16 +7,34 @@
 
 #include <boost/chrono/include.hpp>
 
+#include <ostream>
 #include <string>
+#include <vector>
 
 #include <mpi.h>
 
 namespace adamantine
 {
 /**
- * This class measures the time spend in a given section by the rank 0 process.
- * This class does not use any MPI_Barrier to synchronize the timer among all
- * the processors.
+ * Statistics of a Timer across all the processors. The times are in seconds.
+ */
+struct TimerStatistics
+{
+  double min = 0.;
+  double max = 0.;
+  double mean = 0.;
+  /**
+   * Ratio between the maximum and the average time.
+   */
+  double imbalance = 1.;
+};
+
+/**
+ * This class measures the wall-clock time spent in a given section using a
+ * monotonic clock. This class does not use any MPI_Barrier to synchronize the
+ * timer among all the processors. Sections can be nested by giving the index
+ * of the parent section in the vector of timers. When the Timer is disabled,
+ * start() and stop() do not query the clock.
  */
 class Timer
 {
@@ -27,9 +45,11 @@ public:
   Timer() = default;
 
   /**
-   * Constructor. The string @p section is used when the timing is output.
+   * Constructor. The string @p section is used when the timing is output. @p
+   * parent is the index of the enclosing section in the vector of timers, -1
+   * if the section is not nested.
    */
-  Timer(MPI_Comm communicator, std::string const &section);
+  Timer(MPI_Comm communicator, std::string const &section, int parent = -1);
 
   /**
    * Start the clock.
@@ -48,24 +68,153 @@ public:
   void reset();
 
   /**
-   * Print the name of the section and the elapsed time.
+   * Enable or disable the Timer.
+   */
+  void set_enabled(bool enabled);
+
+  /**
+   * Record the work load owned by the current processor, e.g. the sum of the
+   * load balancing weights of the locally owned cells. This function needs to
+   * be called by all the processors. The minimum, maximum, and average load
+   * across the processors are output by print() and print_timers().
+   */
+  void record_load(double local_load);
+
+  /**
+   * Record the number of iterations of a linear solve performed in the
+   * section. The total and the average number of iterations are output by
+   * print() and print_timers().
+   */
+  void record_iterations(unsigned int n_iterations);
+
+  /**
+   * Print the name of the section and the elapsed time. If loads have been
+   * recorded, the load imbalance is also printed. If iterations have been
+   * recorded, the number of iterations is also printed.
    */
   void print();
 
+  /**
+   * Print the loads and the iterations recorded in the section, if any, to
+   * @p out. Each line starts with @p indent. Unlike print(), this function
+   * prints on every processor that calls it.
+   */
+  void print_records(std::ostream &out, std::string const &indent) const;
+
   /**
    * Return the current elapsed time.
    */
-  boost::chrono::process_real_cpu_clock::duration get_elapsed_time();
+  boost::chrono::steady_clock::duration get_elapsed_time();
+
+  /**
+   * Compute the minimum, maximum, and average elapsed time across the
+   * processors. This function needs to be called by all the processors.
+   */
+  TimerStatistics compute_statistics() const;
+
+  /**
+   * Return the name of the section.
+   */
+  std::string const &get_section() const;
+
+  /**
+   * Return the index of the parent section, -1 if there is none.
+   */
+  int get_parent() const;
+
+  /**
+   * Return the MPI communicator.
+   */
+  MPI_Comm get_communicator() const;
 
 private:
   MPI_Comm _communicator;
   std::string _section;
-  boost::chrono::process_cpu_clock _clock;
-  boost::chrono::process_cpu_clock::time_point _t_start;
   /**
-   * Store the elapsed time in milliseconds nds
+   * Index of the parent section in the vector of timers.
+   */
+  int _parent = -1;
+  /**
+   * Flag is true if the Timer measures time.
    */
-  boost::chrono::process_cpu_clock::duration _elapsed_time;
+  bool _enabled = true;
+  boost::chrono::steady_clock::time_point _t_start;
+  /**
+   * Store the elapsed time.
+   */
+  boost::chrono::steady_clock::duration _elapsed_time;
+  /**
+   * Number of times the load has been recorded.
+   */
+  unsigned int _n_load_records = 0;
+  /**
+   * Minimum load across the processors during the last record.
+   */
+  double _min_load = 0.;
+  /**
+   * Maximum load across the processors during the last record.
+   */
+  double _max_load = 0.;
+  /**
+   * Average load across the processors during the last record.
+   */
+  double _mean_load = 0.;
+  /**
+   * Largest ratio between the maximum and the average load over all the
+   * records.
+   */
+  double _max_imbalance = 1.;
+  /**
+   * Number of linear solves recorded.
+   */
+  unsigned int _n_solves = 0;
+  /**
+   * Total number of iterations of the linear solves.
+   */
+  unsigned int _n_iterations = 0;
 };
+
+/**
+ * Print the statistics across the processors of all the @p timers, nested
+ * sections are indented below their parent. The loads and the iterations
+ * recorded by a Timer are printed below its section. This function needs to be
+ * called by all the processors.
+ */
+void print_timers(std::vector<Timer> const &timers);
+
+/**
+ * Write the statistics across the processors of all the @p timers to @p
+ * filename. The file uses the json format if the extension of @p filename is
+ * .json and the csv format otherwise. This function needs to be called by all
+ * the processors.
+ */
+void write_timers(std::vector<Timer> const &timers,
+                  std::string const &filename);
+
+inline void Timer::start()
+{
+  if (_enabled)
+    _t_start = boost::chrono::steady_clock::now();
+}
+
+inline void Timer::stop()
+{
+  if (_enabled)
+    _elapsed_time += boost::chrono::steady_clock::now() - _t_start;
+}
+
+inline void Timer::set_enabled(bool enabled) { _enabled = enabled; }
+
+inline void Timer::record_iterations(unsigned int n_iterations)
+{
+  _n_iterations += n_iterations;
+  ++_n_solves;
+}
+
+inline std::string const &Timer::get_section() const { return _section; }
+
+inline int Timer::get_parent() const { return _parent; }
+
+inline MPI_Comm Timer::get_communicator() const { return _communicator; }
 } // namespace adamantine
 #endif
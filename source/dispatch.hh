@@ -0,0 +1,183 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef DISPATCH_HH
+#define DISPATCH_HH
+
+#include <MaterialStates.hh>
+#include <instantiation_list.hh>
+
+#include <deal.II/base/memory_space.h>
+
+#include <boost/preprocessor/seq/enum.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace adamantine
+{
+/**
+ * Wrapper used to pass a type to a generic lambda.
+ */
+template <typename T>
+struct TypeTag
+{
+  using type = T;
+};
+
+namespace internal
+{
+template <int... values>
+std::string not_instantiated_message(std::string const &name, int const value,
+                                     std::string const &option)
+{
+  std::string instantiated_values;
+  ((instantiated_values += " " + std::to_string(values)), ...);
+
+  return name + " = " + std::to_string(value) +
+         " has not been instantiated. The instantiated values are:" +
+         instantiated_values + ". Add the value to the CMake option " +
+         option + " and recompile adamantine.";
+}
+
+template <int value, int... values, typename Functor, typename ErrorMessage>
+decltype(auto) dispatch_int(int const n, Functor &&functor,
+                            ErrorMessage const &error_message)
+{
+  if (n == value)
+    return functor(std::integral_constant<int, value>{});
+
+  if constexpr (sizeof...(values) > 0)
+    return dispatch_int<values...>(n, std::forward<Functor>(functor),
+                                   error_message);
+  else
+    throw std::runtime_error(error_message());
+}
+
+template <int... values, typename Functor>
+decltype(auto) dispatch_int(std::string const &name, std::string const &option,
+                            int const n, Functor &&functor)
+{
+  return dispatch_int<values...>(
+      n, std::forward<Functor>(functor), [&]()
+      { return not_instantiated_message<values...>(name, n, option); });
+}
+
+template <typename MaterialStates, typename... OtherMaterialStates,
+          typename Functor, typename ErrorMessage>
+decltype(auto) dispatch_material_states(int const n_material_states,
+                                        Functor &&functor,
+                                        ErrorMessage const &error_message)
+{
+  if (n_material_states == MaterialStates::n_material_states)
+    return functor(TypeTag<MaterialStates>{});
+
+  if constexpr (sizeof...(OtherMaterialStates) > 0)
+    return dispatch_material_states<OtherMaterialStates...>(
+        n_material_states, std::forward<Functor>(functor), error_message);
+  else
+    throw std::runtime_error(error_message());
+}
+
+template <typename... MaterialStates, typename Functor>
+decltype(auto) dispatch_material_states(int const n_material_states,
+                                        Functor &&functor)
+{
+  return dispatch_material_states<MaterialStates...>(
+      n_material_states, std::forward<Functor>(functor),
+      [&]()
+      {
+        return not_instantiated_message<MaterialStates::n_material_states...>(
+            "Number of material states", n_material_states,
+            "ADAMANTINE_MATERIAL_STATES");
+      });
+}
+} // namespace internal
+
+/**
+ * Call @p functor with std::integral_constant<int, dim>. An exception is thrown
+ * if the classes have not been instantiated for @p dim. The instantiated
+ * dimensions are set using the CMake option ADAMANTINE_DIMS.
+ */
+template <typename Functor>
+decltype(auto) dispatch_dim(int const dim, Functor &&functor)
+{
+  return internal::dispatch_int<BOOST_PP_SEQ_ENUM(ADAMANTINE_DIM_SEQ)>(
+      "dim", "ADAMANTINE_DIMS", dim, std::forward<Functor>(functor));
+}
+
+/**
+ * Call @p functor with std::integral_constant<int, p_order>. An exception is
+ * thrown if the classes have not been instantiated for @p p_order. The
+ * instantiated polynomial orders are set using the CMake option
+ * ADAMANTINE_P_ORDERS.
+ */
+template <typename Functor>
+decltype(auto) dispatch_p_order(int const p_order, Functor &&functor)
+{
+  return internal::dispatch_int<BOOST_PP_SEQ_ENUM(ADAMANTINE_P_ORDER_SEQ)>(
+      "p_order", "ADAMANTINE_P_ORDERS", p_order,
+      std::forward<Functor>(functor));
+}
+
+/**
+ * Call @p functor with std::integral_constant<int, fe_degree>. An exception is
+ * thrown if the classes have not been instantiated for @p fe_degree. The
+ * instantiated degrees are set using the CMake option ADAMANTINE_FE_DEGREES.
+ */
+template <typename Functor>
+decltype(auto) dispatch_fe_degree(int const fe_degree, Functor &&functor)
+{
+  return internal::dispatch_int<BOOST_PP_SEQ_ENUM(ADAMANTINE_FE_DEGREE_SEQ)>(
+      "fe_degree", "ADAMANTINE_FE_DEGREES", fe_degree,
+      std::forward<Functor>(functor));
+}
+
+/**
+ * Call @p functor with TypeTag<MaterialStates> where MaterialStates is the
+ * struct with @p n_material_states states. An exception is thrown if the
+ * classes have not been instantiated for these material states. The
+ * instantiated material states are set using the CMake option
+ * ADAMANTINE_MATERIAL_STATES.
+ */
+template <typename Functor>
+decltype(auto) dispatch_material_states(int const n_material_states,
+                                        Functor &&functor)
+{
+  return internal::dispatch_material_states<BOOST_PP_SEQ_ENUM(
+      ADAMANTINE_MATERIAL_STATE_SEQ)>(n_material_states,
+                                      std::forward<Functor>(functor));
+}
+
+/**
+ * Call @p functor with TypeTag<dealii::MemorySpace::Default> if @p
+ * memory_space is "device" and with TypeTag<dealii::MemorySpace::Host>
+ * otherwise. An exception is thrown if the classes have not been instantiated
+ * for this memory space. The instantiated memory spaces are set using the
+ * CMake option ADAMANTINE_MEMORY_SPACES.
+ */
+template <typename Functor>
+decltype(auto) dispatch_memory_space(std::string const &memory_space,
+                                     Functor &&functor)
+{
+  bool const device = memory_space == "device";
+#if ADAMANTINE_INSTANTIATE_DEVICE
+  if (device)
+    return functor(TypeTag<dealii::MemorySpace::Default>{});
+#endif
+#if ADAMANTINE_INSTANTIATE_HOST
+  if (!device)
+    return functor(TypeTag<dealii::MemorySpace::Host>{});
+#endif
+
+  throw std::runtime_error(
+      "memory_space = " + std::string(device ? "device" : "host") +
+      " has not been instantiated. Add the memory space to the CMake option "
+      "ADAMANTINE_MEMORY_SPACES and recompile adamantine.");
+}
+} // namespace adamantine
+
+#endif
@@ -312,9 +312,8 @@ get_elements_to_activate(
     return std::vector<
         std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>>();
 
-  // We activate the cells that intersect a box. To do that we use ArborX.
-  // First, we create the bounding boxes of all the non-activated cells.
-  std::vector<dealii::BoundingBox<dim>> bounding_boxes;
+  // We activate the cells that intersect a box. The candidates are all the
+  // non-activated cells.
   std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>
       cell_iterators;
   for (auto const &cell : dealii::filter_iterators(
@@ -322,10 +321,31 @@ get_elements_to_activate(
            dealii::IteratorFilters::LocallyOwnedCell(),
            dealii::IteratorFilters::ActiveFEIndexEqualTo(1)))
   {
-    bounding_boxes.push_back(cell->bounding_box());
     cell_iterators.push_back(cell);
   }
 
+  return get_elements_to_activate(cell_iterators, material_deposition_boxes);
+}
+
+template <int dim>
+std::vector<std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>>
+get_elements_to_activate(
+    std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator> const
+        &cell_iterators,
+    std::vector<dealii::BoundingBox<dim>> const &material_deposition_boxes)
+{
+  // Exit early if we can
+  if (material_deposition_boxes.size() == 0)
+    return std::vector<
+        std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>>();
+
+  // We activate the cells that intersect a box. To do that we use ArborX.
+  // First, we create the bounding boxes of all the candidate cells.
+  std::vector<dealii::BoundingBox<dim>> bounding_boxes;
+  bounding_boxes.reserve(cell_iterators.size());
+  for (auto const &cell : cell_iterators)
+    bounding_boxes.push_back(cell->bounding_box());
+
   // Perform the search
   dealii::ArborXWrappers::BVH bvh(bounding_boxes);
   dealii::ArborXWrappers::BoundingBoxIntersectPredicate bb_intersect(
@@ -379,6 +399,18 @@ template std::vector<
 get_elements_to_activate(
     dealii::DoFHandler<3> const &dof_handler,
     std::vector<dealii::BoundingBox<3>> const &material_deposition_boxes);
+template std::vector<
+    std::vector<typename dealii::DoFHandler<2>::active_cell_iterator>>
+get_elements_to_activate(
+    std::vector<typename dealii::DoFHandler<2>::active_cell_iterator> const
+        &cell_iterators,
+    std::vector<dealii::BoundingBox<2>> const &material_deposition_boxes);
+template std::vector<
+    std::vector<typename dealii::DoFHandler<3>::active_cell_iterator>>
+get_elements_to_activate(
+    std::vector<typename dealii::DoFHandler<3>::active_cell_iterator> const
+        &cell_iterators,
+    std::vector<dealii::BoundingBox<3>> const &material_deposition_boxes);
 
 template std::tuple<std::vector<dealii::BoundingBox<2, double>>,
                     std::vector<double>, std::vector<double>,
@@ -62,6 +62,17 @@ std::vector<std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>>
 get_elements_to_activate(
     dealii::DoFHandler<dim> const &dof_handler,
     std::vector<dealii::BoundingBox<dim>> const &material_deposition_boxes);
+
+/**
+ * Same as above but the cells to activate are searched among @p
+ * cell_iterators instead of among the locally owned cells without material.
+ */
+template <int dim>
+std::vector<std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator>>
+get_elements_to_activate(
+    std::vector<typename dealii::DoFHandler<dim>::active_cell_iterator> const
+        &cell_iterators,
+    std::vector<dealii::BoundingBox<dim>> const &material_deposition_boxes);
 } // namespace adamantine
 
 #endif
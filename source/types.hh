@@ -133,6 +133,7 @@ enum Timing
 {
   main,
   refine,
+  refine_add_material_search,
   add_material_search,
   add_material_activate,
   da_experimental_data,
@@ -144,6 +145,8 @@ enum Timing
   evol_time_eval_th_ph,
   evol_time_J_inv,
   evol_time_update_bound_mat_prop,
+  mech_preconditioner,
+  mech_solve,
   output,
   n_timers
 };
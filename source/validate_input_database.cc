@@ -353,14 +353,16 @@ void validate_input_database(boost::property_tree::ptree &database)
   ASSERT_THROW(boost::iequals(time_stepping_method, "forward_euler") ||
                    boost::iequals(time_stepping_method, "rk_third_order") ||
                    boost::iequals(time_stepping_method, "rk_fourth_order") ||
+                   boost::iequals(time_stepping_method, "rkl2") ||
                    boost::iequals(time_stepping_method, "backward_euler") ||
                    boost::iequals(time_stepping_method, "implicit_midpoint") ||
                    boost::iequals(time_stepping_method, "crank_nicolson") ||
                    boost::iequals(time_stepping_method, "sdirk2"),
                "Error: Time stepping method, '" + time_stepping_method +
                    "', is not recognized. Valid options are: 'forward_euler', "
-                   "'rk_third_order', 'rk_fourth_order', 'backward_euler', "
-                   "'implicit_midpoint', 'crank_nicolson', and 'sdirk2'.");
+                   "'rk_third_order', 'rk_fourth_order', 'rkl2', "
+                   "'backward_euler', 'implicit_midpoint', 'crank_nicolson', "
+                   "and 'sdirk2'.");
 
   if (database.get("time.scan_path_for_duration", false))
   {
@@ -371,6 +373,43 @@ void validate_input_database(boost::property_tree::ptree &database)
   ASSERT_THROW(database.get<double>("time_stepping.time_step") >= 0.0,
                "Error: Time step must be non-negative.");
 
+  std::string const linear_solver =
+      database.get<std::string>("time_stepping.linear_solver", "gmres");
+  ASSERT_THROW(boost::iequals(linear_solver, "gmres") ||
+                   boost::iequals(linear_solver, "cg"),
+               "Error: Linear solver, '" + linear_solver +
+                   "', is not recognized. Valid options are: 'gmres' and "
+                   "'cg'.");
+
+  if (database.get<unsigned int>("time_stepping.multirate_substeps", 1) > 1)
+  {
+    ASSERT_THROW(boost::iequals(time_stepping_method, "forward_euler"),
+                 "Error: Multirate time stepping requires forward_euler.");
+  }
+
+  if (database.get<unsigned int>("time_stepping.dormant_update_interval", 0) >
+      0)
+  {
+    ASSERT_THROW(
+        database.get<unsigned int>("time_stepping.multirate_substeps", 1) == 1,
+        "Error: The dormant region cannot be used with multirate time "
+        "stepping.");
+    ASSERT_THROW(
+        database.get<double>("time_stepping.dormant_rate_threshold") >= 0.,
+        "Error: The dormant rate threshold must be non-negative.");
+    ASSERT_THROW(
+        database.get<double>("time_stepping.dormant_gradient_threshold") >= 0.,
+        "Error: The dormant gradient threshold must be non-negative.");
+    ASSERT_THROW(database.get<double>("time_stepping.dormant_distance") >= 0.,
+                 "Error: The dormant distance must be non-negative.");
+  }
+
+  if (database.get("time_stepping.newton_krylov", false))
+  {
+    ASSERT_THROW(boost::iequals(time_stepping_method, "backward_euler"),
+                 "Error: The Newton-Krylov method requires backward_euler.");
+  }
+
   // Tree: experiment
   // I'm not checking for the existence of the experimental files here, that's
   // still done in `adamantine::read_experimental_data_point_cloud` and
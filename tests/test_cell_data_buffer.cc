@@ -0,0 +1,210 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#define BOOST_TEST_MODULE CellDataBuffer
+
+#include <CellDataBuffer.hh>
+#include <Geometry.hh>
+
+#include <deal.II/grid/filtered_iterator.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "main.cc"
+
+namespace
+{
+template <int dim>
+std::unique_ptr<adamantine::Geometry<dim>> make_geometry(MPI_Comm communicator)
+{
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 4);
+  geometry_database.put("length_divisions", 2);
+  geometry_database.put("height", 4);
+  geometry_database.put("height_divisions", 2);
+  if constexpr (dim == 3)
+  {
+    geometry_database.put("width", 4);
+    geometry_database.put("width_divisions", 2);
+  }
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  return std::make_unique<adamantine::Geometry<dim>>(
+      communicator, geometry_database, units_optional_database);
+}
+
+template <typename CellIterator>
+double cell_value(CellIterator const &cell)
+{
+  return cell->center()[0] + 10. * cell->center()[1];
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(access)
+{
+  unsigned int const n_cells = 5;
+  unsigned int const stride = 3;
+  adamantine::CellDataBuffer<2> buffer;
+  buffer.reinit(n_cells, stride, -1.);
+  BOOST_TEST(buffer.n_cells() == n_cells);
+  BOOST_TEST(buffer.stride() == stride);
+
+  for (unsigned int c = 0; c < n_cells; ++c)
+  {
+    BOOST_TEST(buffer[c].size() == stride);
+    BOOST_TEST(buffer[c][0] == -1.);
+    for (unsigned int i = 0; i < stride; ++i)
+      buffer[c][i] = 10. * c + i;
+  }
+
+  // The values of consecutive cells are contiguous.
+  for (unsigned int c = 0; c < n_cells; ++c)
+  {
+    BOOST_TEST(std::as_const(buffer)[c].data() ==
+               std::as_const(buffer)[0].data() + c * stride);
+    for (unsigned int i = 0; i < stride; ++i)
+      BOOST_TEST(std::as_const(buffer)[c][i] == 10. * c + i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(transfer)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  int constexpr dim = 2;
+  auto geometry = make_geometry<dim>(communicator);
+  auto &triangulation = geometry->get_triangulation();
+
+  // The first value depends on the position of the cell and the second value
+  // is a counter.
+  unsigned int const stride = 2;
+  adamantine::CellDataBuffer<dim> buffer;
+  buffer.reinit(triangulation.n_active_cells(), stride);
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    buffer[cell->active_cell_index()][0] = cell_value(cell);
+    buffer[cell->active_cell_index()][1] = 1.;
+  }
+
+  // Refine the cells using the default strategy and check that the children
+  // inherit the values of the parent.
+  std::map<dealii::CellId, double> parent_values;
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    parent_values[cell->id()] = cell_value(cell);
+    cell->set_refine_flag();
+  }
+  buffer.prepare_for_coarsening_and_refinement(triangulation);
+  triangulation.execute_coarsening_and_refinement();
+  buffer.unpack(triangulation);
+  BOOST_TEST(buffer.n_cells() == triangulation.n_active_cells());
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    BOOST_TEST(buffer[cell->active_cell_index()][0] ==
+               parent_values[cell->parent()->id()]);
+    BOOST_TEST(buffer[cell->active_cell_index()][1] == 1.);
+  }
+
+  // Coarsen the cells. The parent gets the average of the first value and
+  // the sum of the second value of its children.
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    buffer[cell->active_cell_index()][0] = cell_value(cell);
+    cell->set_coarsen_flag();
+  }
+  auto coarsening_strategy =
+      [](adamantine::CellDataBuffer<dim>::cell_iterator const &,
+         std::vector<dealii::ArrayView<double const>> const &children_values,
+         dealii::ArrayView<double> const &parent_values)
+  {
+    parent_values[0] = 0.;
+    parent_values[1] = 0.;
+    for (auto const &child_values : children_values)
+    {
+      parent_values[0] += child_values[0] / children_values.size();
+      parent_values[1] += child_values[1];
+    }
+  };
+  buffer.prepare_for_coarsening_and_refinement(
+      triangulation, adamantine::CellDataBuffer<dim>::RefinementStrategy(),
+      coarsening_strategy);
+  triangulation.execute_coarsening_and_refinement();
+  buffer.unpack(triangulation);
+  BOOST_TEST(buffer.n_cells() == triangulation.n_active_cells());
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    BOOST_TEST(buffer[cell->active_cell_index()][0] == cell_value(cell),
+               boost::test_tools::tolerance(1e-12));
+    BOOST_TEST(buffer[cell->active_cell_index()][1] == 4.);
+  }
+
+  // Refine the cells again. The value of each child is the index of the
+  // child.
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+    cell->set_refine_flag();
+  auto refinement_strategy =
+      [](adamantine::CellDataBuffer<dim>::cell_iterator const &,
+         unsigned int const child, dealii::ArrayView<double const> const &,
+         dealii::ArrayView<double> const &child_values)
+  {
+    child_values[0] = child;
+    child_values[1] = 0.;
+  };
+  buffer.prepare_for_coarsening_and_refinement(triangulation,
+                                               refinement_strategy);
+  triangulation.execute_coarsening_and_refinement();
+  buffer.unpack(triangulation);
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    BOOST_TEST(buffer[cell->active_cell_index()][0] ==
+               cell->parent()->child_iterator_to_index(cell));
+    BOOST_TEST(buffer[cell->active_cell_index()][1] == 0.);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(serialization)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  int constexpr dim = 2;
+  std::string const filename = "cell_data_buffer_checkpoint";
+  unsigned int const stride = 3;
+
+  {
+    auto geometry = make_geometry<dim>(communicator);
+    auto &triangulation = geometry->get_triangulation();
+    triangulation.refine_global(1);
+    adamantine::CellDataBuffer<dim> buffer;
+    buffer.reinit(triangulation.n_active_cells(), stride);
+    for (auto const &cell : triangulation.active_cell_iterators() |
+                                dealii::IteratorFilters::LocallyOwnedCell())
+      for (unsigned int i = 0; i < stride; ++i)
+        buffer[cell->active_cell_index()][i] = cell_value(cell) + i;
+    buffer.prepare_for_serialization(triangulation);
+    triangulation.save(filename);
+  }
+
+  auto geometry = make_geometry<dim>(communicator);
+  auto &triangulation = geometry->get_triangulation();
+  triangulation.load(filename);
+  adamantine::CellDataBuffer<dim> buffer;
+  buffer.reinit(triangulation.n_active_cells(), stride,
+                std::numeric_limits<double>::infinity());
+  buffer.deserialize(triangulation);
+  BOOST_TEST(buffer.n_cells() == triangulation.n_active_cells());
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+    for (unsigned int i = 0; i < stride; ++i)
+      BOOST_TEST(buffer[cell->active_cell_index()][i] == cell_value(cell) + i);
+}
@@ -206,4 +206,82 @@ BOOST_AUTO_TEST_CASE(heat_source_height, *utf::tolerance(1e-12))
   BOOST_TEST(eb_height == 0.001);
 }
 
+BOOST_AUTO_TEST_CASE(heat_source_time_averaged, *utf::tolerance(1e-12))
+{
+  boost::property_tree::ptree database;
+
+  database.put("depth", 0.1);
+  database.put("absorption_efficiency", 0.1);
+  database.put("diameter", 2.0e-4);
+  database.put("max_power", 10.);
+  database.put("scan_path_file", "scan_path.txt");
+  database.put("scan_path_file_format", "segment");
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  GoldakHeatSource<2> goldak_heat_source(database, units_optional_database);
+  ElectronBeamHeatSource<2> eb_heat_source(database, units_optional_database);
+  database.put("time_averaged", true);
+  GoldakHeatSource<2> averaged_goldak_heat_source(database,
+                                                  units_optional_database);
+  ElectronBeamHeatSource<2> averaged_eb_heat_source(database,
+                                                    units_optional_database);
+  BOOST_TEST(!goldak_heat_source.is_time_averaged());
+  BOOST_TEST(averaged_goldak_heat_source.is_time_averaged());
+
+  double const time = 0.001001;
+  double const duration = 4.5e-4;
+  double const start_time = time - 0.5 * duration;
+  dealii::Point<2> point(8.2e-4, 0.19);
+
+  // Without a sweep duration, the source is evaluated at a single time.
+  goldak_heat_source.update_time(time);
+  averaged_goldak_heat_source.update_time(time);
+  BOOST_TEST(averaged_goldak_heat_source.value(point, 0.2) ==
+             goldak_heat_source.value(point, 0.2));
+
+  // The beam moves by 3.6e-4 during the window and the centers are at most
+  // half a radius apart, so the window is divided in 8 intervals.
+  BOOST_TEST(averaged_goldak_heat_source.get_scan_path().get_path_length(
+                 start_time, start_time + duration) == 3.6e-4);
+  unsigned int const n_intervals = 8;
+  averaged_goldak_heat_source.set_sweep_window(start_time, duration);
+  averaged_eb_heat_source.set_sweep_window(start_time, duration);
+  averaged_goldak_heat_source.update_time(time);
+  averaged_eb_heat_source.update_time(time);
+  double g_value = 0.;
+  double eb_value = 0.;
+  for (unsigned int i = 0; i < n_intervals; ++i)
+  {
+    double const t = start_time + (i + 0.5) * duration / n_intervals;
+    goldak_heat_source.update_time(t);
+    g_value += goldak_heat_source.value(point, 0.2) / n_intervals;
+    eb_heat_source.update_time(t);
+    eb_value += eb_heat_source.value(point, 0.2) / n_intervals;
+  }
+  BOOST_TEST(averaged_goldak_heat_source.value(point, 0.2) == g_value);
+  BOOST_TEST(averaged_eb_heat_source.value(point, 0.2) == eb_value);
+
+  // The window does not depend on the time of the stage.
+  averaged_goldak_heat_source.update_time(start_time + duration);
+  BOOST_TEST(averaged_goldak_heat_source.value(point, 0.2) == g_value);
+  averaged_goldak_heat_source.update_time(start_time);
+  BOOST_TEST(averaged_goldak_heat_source.value(point, 0.2) == g_value);
+
+  // The bounding box covers the path swept by the beam.
+  double const scaling_factor = 2.;
+  auto const averaged_box =
+      averaged_goldak_heat_source.get_bounding_box(scaling_factor);
+  goldak_heat_source.update_time(start_time + 0.5 * duration / n_intervals);
+  auto const first_box = goldak_heat_source.get_bounding_box(scaling_factor);
+  goldak_heat_source.update_time(start_time + duration -
+                                 0.5 * duration / n_intervals);
+  auto const last_box = goldak_heat_source.get_bounding_box(scaling_factor);
+  for (unsigned int d = 0; d < 2; ++d)
+  {
+    BOOST_TEST(averaged_box.get_boundary_points().first[d] ==
+               first_box.get_boundary_points().first[d]);
+    BOOST_TEST(averaged_box.get_boundary_points().second[d] ==
+               last_box.get_boundary_points().second[d]);
+  }
+}
+
 } // namespace adamantine
@@ -21,6 +21,8 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <cmath>
+
 #include "main.cc"
 
 namespace tt = boost::test_tools;
@@ -150,4 +152,45 @@ BOOST_AUTO_TEST_CASE(implicit_operator)
 
   double const tolerance = 1e-7;
   BOOST_TEST(dst.l2_norm() == dst_jfnk.l2_norm(), tt::tolerance(tolerance));
+
+  // Check that the symmetric form is the operator multiplied by the mass
+  // matrix and that it is symmetric.
+  adamantine::ImplicitOperator<dealii::MemorySpace::Host>
+      symmetric_implicit_operator(thermal_operator, false, true);
+  std::shared_ptr<
+      dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>>
+      scaled_inverse_mass_matrix(
+          new dealii::LA::distributed::Vector<double,
+                                              dealii::MemorySpace::Host>(size));
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    source[i] = std::sin(i + 1.);
+    (*scaled_inverse_mass_matrix)[i] = 1. + 0.5 * std::cos(i + 1.);
+  }
+  implicit_operator.set_inverse_mass_matrix(scaled_inverse_mass_matrix);
+  symmetric_implicit_operator.set_tau(1.);
+  symmetric_implicit_operator.set_inverse_mass_matrix(
+      scaled_inverse_mass_matrix);
+  auto const mass_matrix = symmetric_implicit_operator.get_mass_matrix();
+  for (unsigned int i = 0; i < size; ++i)
+    BOOST_TEST((*mass_matrix)[i] * (*scaled_inverse_mass_matrix)[i] == 1.,
+               tt::tolerance(1e-14));
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      dst_symmetric(size);
+  implicit_operator.vmult(dst, source);
+  symmetric_implicit_operator.vmult(dst_symmetric, source);
+  for (unsigned int i = 0; i < size; ++i)
+    BOOST_TEST(dst_symmetric[i] == (*mass_matrix)[i] * dst[i],
+               tt::tolerance(1e-12));
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> other(
+      size);
+  for (unsigned int i = 0; i < size; ++i)
+    other[i] = std::cos(2. * i);
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      dst_other(size);
+  symmetric_implicit_operator.vmult(dst_other, other);
+  BOOST_TEST(other * dst_symmetric == source * dst_other, tt::tolerance(1e-12));
+  BOOST_TEST(source * dst_symmetric > 0.);
 }
@@ -7,8 +7,11 @@
 
 #include "../application/adamantine.hh"
 
+#include <deal.II/fe/mapping_q1.h>
+
 #include <boost/property_tree/info_parser.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
@@ -101,3 +104,260 @@ BOOST_AUTO_TEST_CASE(integration_2D_units, *utf::tolerance(0.1))
     BOOST_TEST(temperature.local_element(i) == gold_value);
   }
 }
+
+BOOST_AUTO_TEST_CASE(integration_2D_ensemble_mesh_change)
+{
+  int constexpr dim = 2;
+  int constexpr p_order = 1;
+  using MaterialStates = adamantine::SolidLiquidPowder;
+  using MemorySpaceType = dealii::MemorySpace::Host;
+  using MaterialPropertyType =
+      adamantine::MaterialProperty<dim, p_order, MaterialStates,
+                                   MemorySpaceType>;
+  using ThermalPhysicsType =
+      adamantine::ThermalPhysics<dim, p_order, 2, MaterialStates,
+                                 MemorySpaceType, dealii::QGauss<1>>;
+  using VectorType = dealii::LA::distributed::Vector<double, MemorySpaceType>;
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  std::vector<adamantine::Timer> timers;
+  initialize_timers(communicator, timers);
+
+  boost::property_tree::ptree database;
+  // Geometry database. The top of the material is made of powder.
+  database.put("geometry.import_mesh", false);
+  database.put("geometry.length", 8);
+  database.put("geometry.length_divisions", 8);
+  database.put("geometry.height", 8);
+  database.put("geometry.height_divisions", 8);
+  database.put("geometry.material_height", 4.);
+  database.put("geometry.use_powder", true);
+  database.put("geometry.powder_layer", 2.);
+  // MaterialProperty database
+  database.put("materials.property_format", "polynomial");
+  database.put("materials.n_materials", 1);
+  for (std::string state : {"solid", "powder", "liquid"})
+  {
+    database.put("materials.material_0." + state + ".density", 1.);
+    database.put("materials.material_0." + state + ".specific_heat", 1.);
+    database.put("materials.material_0." + state + ".thermal_conductivity_x",
+                 1.);
+    database.put("materials.material_0." + state + ".thermal_conductivity_z",
+                 1.);
+  }
+  // Source database
+  database.put("sources.n_beams", 0);
+  // Time-stepping database
+  database.put("time_stepping.method", "forward_euler");
+  // Boundary database
+  database.put("boundary.type", "adiabatic");
+  boost::property_tree::ptree geometry_database =
+      database.get_child("geometry");
+  boost::property_tree::ptree material_property_database =
+      database.get_child("materials");
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+
+  // The first two members share the mesh and the discretization like the
+  // members of an ensemble on a processor. The last two members have their
+  // own mesh and they go through the same mesh change one after the other.
+  unsigned int const n_members = 4;
+  std::vector<std::unique_ptr<adamantine::Geometry<dim>>> geometries;
+  std::vector<std::unique_ptr<MaterialPropertyType>> material_properties;
+  std::vector<std::unique_ptr<
+      adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>>
+      physics;
+  std::vector<VectorType> solutions(n_members);
+  for (unsigned int i = 0; i < n_members; ++i)
+  {
+    if (i != 1)
+      geometries.push_back(std::make_unique<adamantine::Geometry<dim>>(
+          communicator, geometry_database, units_optional_database));
+    material_properties.push_back(std::make_unique<MaterialPropertyType>(
+        communicator, geometries.back()->get_triangulation(),
+        material_property_database));
+    physics.push_back(std::make_unique<ThermalPhysicsType>(
+        communicator, database, *geometries.back(),
+        *material_properties.back()));
+    if (i == 1)
+      physics[1]->share_discretization(*physics[0]);
+    physics.back()->setup();
+    physics.back()->initialize_dof_vector(300. + 100. * (i % 2),
+                                          solutions[i]);
+  }
+
+  // Activate a layer of cells on top of the material.
+  std::vector<dealii::BoundingBox<dim>> material_deposition_boxes;
+  material_deposition_boxes.emplace_back(std::make_pair(
+      dealii::Point<dim>(0.1, 4.1), dealii::Point<dim>(7.9, 4.9)));
+  std::vector<double> deposition_cos(1, 1.);
+  std::vector<double> deposition_sin(1, 0.);
+  std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> heat_sources;
+  boost::property_tree::ptree refinement_database;
+  std::unique_ptr<adamantine::MechanicalPhysics<dim, p_order, MaterialStates,
+                                                MemorySpaceType>>
+      mechanical_physics;
+  MaterialActivation<dim> const ensemble_activation{
+      material_deposition_boxes, deposition_cos, deposition_sin, 0, 1,
+      {500., 600.}};
+  refine_mesh({physics[0].get(), physics[1].get()}, mechanical_physics,
+              {&solutions[0], &solutions[1]}, heat_sources, 0., 1., 10,
+              refinement_database, false, ensemble_activation, timers);
+  for (unsigned int i = 2; i < n_members; ++i)
+  {
+    MaterialActivation<dim> const activation{
+        material_deposition_boxes, deposition_cos, deposition_sin, 0, 1,
+        {500. + 100. * (i % 2)}};
+    refine_mesh(physics[i], mechanical_physics, solutions[i], heat_sources, 0.,
+                1., 10, refinement_database, false, activation, timers);
+  }
+
+  // 32 cells below the material height and 8 activated cells.
+  unsigned int n_cells = 0;
+  for (auto const &cell : dealii::filter_iterators(
+           physics[1]->get_dof_handler().active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+    ++n_cells;
+  BOOST_TEST(dealii::Utilities::MPI::sum(n_cells, communicator) == 40);
+
+  // The members sharing the mesh keep their own temperature and their own
+  // material state through the mesh change.
+  unsigned int constexpr powder =
+      static_cast<unsigned int>(MaterialStates::State::powder);
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    BOOST_TEST(solutions[i].l2_norm() > 0.);
+    VectorType difference(solutions[i]);
+    difference -= solutions[i + 2];
+    BOOST_TEST(difference.l2_norm() <= 1e-12 * solutions[i + 2].l2_norm());
+
+    double powder_ratio[2] = {0., 0.};
+    for (unsigned int j = 0; j < 2; ++j)
+    {
+      auto state = Kokkos::create_mirror_view_and_copy(
+          Kokkos::HostSpace{}, material_properties[i + 2 * j]->get_state());
+      for (unsigned int k = 0; k < state.extent(1); ++k)
+        powder_ratio[j] += state(powder, k);
+      powder_ratio[j] =
+          dealii::Utilities::MPI::sum(powder_ratio[j], communicator);
+    }
+    BOOST_TEST(powder_ratio[0] > 0.);
+    BOOST_TEST(powder_ratio[0] == powder_ratio[1],
+               boost::test_tools::tolerance(1e-12));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(integration_2D_max_n_active_cells)
+{
+  int constexpr dim = 2;
+  int constexpr p_order = 1;
+  using MaterialStates = adamantine::SolidLiquidPowder;
+  using MemorySpaceType = dealii::MemorySpace::Host;
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  std::vector<adamantine::Timer> timers;
+  initialize_timers(communicator, timers);
+
+  boost::property_tree::ptree database;
+  database.put("geometry.import_mesh", false);
+  database.put("geometry.length", 8);
+  database.put("geometry.length_divisions", 8);
+  database.put("geometry.height", 8);
+  database.put("geometry.height_divisions", 8);
+  database.put("materials.property_format", "polynomial");
+  database.put("materials.n_materials", 1);
+  for (std::string state : {"solid", "liquid"})
+  {
+    database.put("materials.material_0." + state + ".density", 1.);
+    database.put("materials.material_0." + state + ".specific_heat", 1.);
+    database.put("materials.material_0." + state + ".thermal_conductivity_x",
+                 1.);
+    database.put("materials.material_0." + state + ".thermal_conductivity_z",
+                 1.);
+  }
+  database.put("sources.n_beams", 0);
+  database.put("time_stepping.method", "forward_euler");
+  database.put("boundary.type", "adiabatic");
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<dim> geometry(communicator,
+                                     database.get_child("geometry"),
+                                     units_optional_database);
+  auto &triangulation = geometry.get_triangulation();
+  adamantine::MaterialProperty<dim, p_order, MaterialStates, MemorySpaceType>
+      material_properties(communicator, triangulation,
+                          database.get_child("materials"));
+  std::unique_ptr<adamantine::ThermalPhysicsInterface<dim, MemorySpaceType>>
+      thermal_physics = std::make_unique<adamantine::ThermalPhysics<
+          dim, p_order, 1, MaterialStates, MemorySpaceType,
+          dealii::QGauss<1>>>(communicator, database, geometry,
+                              material_properties);
+  thermal_physics->setup();
+  dealii::LA::distributed::Vector<double, MemorySpaceType> solution;
+  thermal_physics->initialize_dof_vector(300., solution);
+
+  // Refine all the cells once.
+  thermal_physics->mesh_change_start(solution);
+  for (auto const &cell : dealii::filter_iterators(
+           triangulation.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell()))
+    cell->set_refine_flag();
+  thermal_physics->mesh_change_prepare_pass();
+  triangulation.execute_coarsening_and_refinement();
+  thermal_physics->mesh_change_complete_pass();
+  thermal_physics->mesh_change_end(300., solution);
+  unsigned int const n_fine_cells = 256;
+  BOOST_TEST(triangulation.n_global_active_cells() == n_fine_cells);
+
+  // The left part of the domain is hot and the temperature is constant. The
+  // temperature decreases linearly between x = 3 and x = 5.
+  auto temperature = [](dealii::Point<dim> const &point)
+  { return 300. + 1700. * std::clamp((5. - point[0]) / 2., 0., 1.); };
+  auto &dof_handler = thermal_physics->get_dof_handler();
+  dealii::MappingQ1<dim> mapping;
+  std::vector<dealii::Point<dim>> const &unit_support_points =
+      dof_handler.get_fe(0).get_unit_support_points();
+  std::vector<dealii::types::global_dof_index> dof_indices(
+      unit_support_points.size());
+  for (auto const &cell : dealii::filter_iterators(
+           dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell()))
+  {
+    cell->get_dof_indices(dof_indices);
+    for (unsigned int i = 0; i < dof_indices.size(); ++i)
+      if (solution.in_local_range(dof_indices[i]))
+        solution(dof_indices[i]) = temperature(
+            mapping.transform_unit_to_real_cell(cell, unit_support_points[i]));
+  }
+  solution.update_ghost_values();
+
+  // The target size of the mesh is smaller than the number of cold cells that
+  // can be coarsened.
+  double const coarsening_temperature = 1000.;
+  boost::property_tree::ptree refinement_database;
+  refinement_database.put("n_refinements", 1);
+  refinement_database.put("coarsen_after_beam", true);
+  refinement_database.put("coarsening_temperature", coarsening_temperature);
+  refinement_database.put("max_n_active_cells", 100);
+  std::vector<dealii::BoundingBox<dim>> material_deposition_boxes;
+  std::vector<double> deposition_cos;
+  std::vector<double> deposition_sin;
+  std::vector<std::shared_ptr<adamantine::HeatSource<dim>>> heat_sources;
+  std::unique_ptr<adamantine::MechanicalPhysics<dim, p_order, MaterialStates,
+                                                MemorySpaceType>>
+      mechanical_physics;
+  MaterialActivation<dim> const activation{
+      material_deposition_boxes, deposition_cos, deposition_sin, 0, 0, {300.}};
+  refine_mesh(thermal_physics, mechanical_physics, solution, heat_sources, 0.,
+              1., 10, refinement_database, true, activation, timers);
+
+  // The cold cells are coarsened but the cells with a part hotter than the
+  // coarsening temperature are kept although their temperature is smooth.
+  BOOST_TEST(triangulation.n_global_active_cells() < n_fine_cells);
+  for (auto const &cell : dealii::filter_iterators(
+           triangulation.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell()))
+  {
+    if (cell->level() == 0)
+      BOOST_TEST(cell->center()[0] > 5.);
+  }
+}
@@ -93,6 +93,48 @@ BOOST_AUTO_TEST_CASE(integration_3D, *utf::tolerance(0.1))
   }
 }
 
+BOOST_AUTO_TEST_CASE(integration_3D_mixed_precision, *utf::tolerance(0.1))
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  std::vector<adamantine::Timer> timers;
+  initialize_timers(communicator, timers);
+
+  // Read the input.
+  std::string const filename = "demo_316_short_anisotropic.info";
+  adamantine::ASSERT_THROW(std::filesystem::exists(filename) == true,
+                           "The file " + filename + " does not exist.");
+  boost::property_tree::ptree database;
+  boost::property_tree::info_parser::read_info(filename, database);
+  database.put("discretization.thermal.mixed_precision", true);
+  database.put("discretization.thermal.mixed_precision_validation", true);
+
+  auto [temperature, displacement] =
+      run<3, 4, adamantine::SolidLiquidPowder, dealii::MemorySpace::Host>(
+          communicator, database, timers);
+
+  // The single precision operator should give the same result as the double
+  // precision one.
+  double max_expected = 500.0;
+  double min_expected = 285.0;
+  for (unsigned int i = 0; i < temperature.locally_owned_size(); ++i)
+  {
+    BOOST_CHECK(temperature.local_element(i) > min_expected);
+    BOOST_CHECK(temperature.local_element(i) < max_expected);
+  }
+
+  if (dealii::Utilities::MPI::n_mpi_processes(communicator) == 1)
+  {
+    std::ifstream gold_file("integration_3d_gold.txt");
+    for (unsigned int i = 0; i < temperature.locally_owned_size(); ++i)
+    {
+      double gold_value = -1.;
+      gold_file >> gold_value;
+      BOOST_TEST(temperature.local_element(i) == gold_value);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(integration_3D_checkpoint_restart)
 {
   MPI_Comm communicator = MPI_COMM_WORLD;
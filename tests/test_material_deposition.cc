@@ -15,6 +15,7 @@
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/fe/fe_nothing.h>
 #include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q1.h>
 
 #include "main.cc"
 
@@ -364,6 +365,143 @@ BOOST_AUTO_TEST_CASE(material_deposition)
   }
 }
 
+BOOST_AUTO_TEST_CASE(mesh_change, *utf::tolerance(1e-10))
+{
+  int constexpr dim = 2;
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  double const new_material_temperature = 100.;
+
+  boost::property_tree::ptree database;
+  // Geometry database
+  database.put("geometry.import_mesh", false);
+  database.put("geometry.length", 8);
+  database.put("geometry.length_divisions", 8);
+  database.put("geometry.height", 8);
+  database.put("geometry.height_divisions", 8);
+  database.put("geometry.material_height", 4.);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  // Build Geometry
+  boost::property_tree::ptree geometry_database =
+      database.get_child("geometry");
+  adamantine::Geometry<dim> geometry(communicator, geometry_database,
+                                     units_optional_database);
+  auto &triangulation = geometry.get_triangulation();
+
+  // MaterialProperty database
+  database.put("materials.property_format", "polynomial");
+  database.put("materials.n_materials", 1);
+  database.put("materials.material_0.solid.density", 1.);
+  database.put("materials.material_0.liquid.density", 1.);
+  database.put("materials.material_0.solid.specific_heat", 1.);
+  database.put("materials.material_0.liquid.specific_heat", 1.);
+  database.put("materials.material_0.solid.thermal_conductivity_x", 1.);
+  database.put("materials.material_0.solid.thermal_conductivity_z", 1.);
+  database.put("materials.material_0.liquid.thermal_conductivity_x", 1.);
+  database.put("materials.material_0.liquid.thermal_conductivity_z", 1.);
+  // Build MaterialProperty
+  boost::property_tree::ptree material_property_database =
+      database.get_child("materials");
+  adamantine::MaterialProperty<dim, 1, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      material_properties(communicator, triangulation,
+                          material_property_database);
+
+  // Source database
+  database.put("sources.n_beams", 0);
+  // Time-stepping database
+  database.put("time_stepping.method", "forward_euler");
+  // Boundary database
+  database.put("boundary.type", "adiabatic");
+
+  // Build ThermalPhysics
+  adamantine::ThermalPhysics<dim, 1, 2, adamantine::SolidLiquidPowder,
+                             dealii::MemorySpace::Host, dealii::QGauss<1>>
+      thermal_physics(communicator, database, geometry, material_properties);
+  thermal_physics.setup();
+  auto &dof_handler = thermal_physics.get_dof_handler();
+
+  // The temperature is linear, so it is preserved exactly by the refinement.
+  auto temperature = [](dealii::Point<dim> const &point)
+  { return 300. + point[0] + 2. * point[1]; };
+  dealii::MappingQ1<dim> mapping;
+  std::vector<dealii::Point<dim>> const &unit_support_points =
+      dof_handler.get_fe().get_unit_support_points();
+  std::vector<dealii::types::global_dof_index> dof_indices(
+      unit_support_points.size());
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> solution;
+  thermal_physics.initialize_dof_vector(0., solution);
+  for (auto const &cell : dealii::filter_iterators(
+           dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    cell->get_dof_indices(dof_indices);
+    for (unsigned int i = 0; i < dof_indices.size(); ++i)
+      if (solution.in_local_range(dof_indices[i]))
+        solution(dof_indices[i]) = temperature(
+            mapping.transform_unit_to_real_cell(cell, unit_support_points[i]));
+  }
+  solution.update_ghost_values();
+
+  // Refine the left half of the domain, then refine the left quarter of the
+  // domain and activate a layer of cells on top of the material in the same
+  // mesh change.
+  auto execute_pass = [&]()
+  {
+    thermal_physics.mesh_change_prepare_pass();
+    triangulation.execute_coarsening_and_refinement();
+    thermal_physics.mesh_change_complete_pass();
+  };
+  thermal_physics.mesh_change_start(solution);
+  for (auto const &cell : dealii::filter_iterators(
+           triangulation.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell()))
+    if (cell->center()[0] < 4.)
+      cell->set_refine_flag();
+  execute_pass();
+
+  for (auto const &cell : dealii::filter_iterators(
+           triangulation.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell()))
+    if (cell->center()[0] < 2.)
+      cell->set_refine_flag();
+  std::vector<dealii::BoundingBox<dim>> material_deposition_boxes;
+  material_deposition_boxes.emplace_back(std::make_pair(
+      dealii::Point<dim>(0.1, 4.1), dealii::Point<dim>(7.9, 4.9)));
+  auto elements_to_activate = adamantine::get_elements_to_activate(
+      dof_handler, material_deposition_boxes);
+  std::vector<double> deposition_cos(1, 1.);
+  std::vector<double> deposition_sin(1, 0.);
+  std::vector<bool> has_melted(1, false);
+  thermal_physics.mesh_change_activate(elements_to_activate, deposition_cos,
+                                       deposition_sin, has_melted, 0, 1);
+  execute_pass();
+  thermal_physics.mesh_change_end(new_material_temperature, solution);
+
+  // Check the number of cells with material: 176 cells below the material
+  // height and 44 activated cells.
+  unsigned int n_cells = 0;
+  for (auto const &cell : dealii::filter_iterators(
+           dof_handler.active_cell_iterators(),
+           dealii::IteratorFilters::LocallyOwnedCell(),
+           dealii::IteratorFilters::ActiveFEIndexEqualTo(0)))
+  {
+    ++n_cells;
+    cell->get_dof_indices(dof_indices);
+    for (unsigned int i = 0; i < dof_indices.size(); ++i)
+    {
+      dealii::Point<dim> const point =
+          mapping.transform_unit_to_real_cell(cell, unit_support_points[i]);
+      if (point[1] < 4. - 1e-6)
+        BOOST_TEST(solution(dof_indices[i]) == temperature(point));
+      else if (point[1] > 4. + 1e-6)
+        BOOST_TEST(solution(dof_indices[i]) == new_material_temperature);
+    }
+  }
+  BOOST_TEST(dealii::Utilities::MPI::sum(n_cells, communicator) == 220);
+}
+
 BOOST_AUTO_TEST_CASE(deposition_from_scan_path_2d, *utf::tolerance(1e-13))
 {
   boost::optional<boost::property_tree::ptree const &> units_optional_database;
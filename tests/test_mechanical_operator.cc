@@ -19,6 +19,8 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include <cmath>
+
 #include "main.cc"
 
 namespace utf = boost::unit_test;
@@ -322,3 +324,91 @@ BOOST_AUTO_TEST_CASE(thermoelastic, *utf::tolerance(1e-12))
 
   // TODO Need to check the result
 }
+
+BOOST_AUTO_TEST_CASE(matrix_free, *utf::tolerance(1e-10))
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  int constexpr dim = 3;
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 6);
+  geometry_database.put("length_divisions", 3);
+  geometry_database.put("height", 6);
+  geometry_database.put("height_divisions", 3);
+  geometry_database.put("width", 6);
+  geometry_database.put("width_divisions", 3);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<dim> geometry(communicator, geometry_database,
+                                     units_optional_database);
+  auto const &triangulation = geometry.get_triangulation();
+  for (auto cell : triangulation.cell_iterators())
+  {
+    cell->set_material_id(0);
+    cell->set_user_index(
+        static_cast<int>(adamantine::SolidLiquidPowder::State::solid));
+  }
+  // Create the MaterialProperty
+  boost::property_tree::ptree material_database;
+  material_database.put("property_format", "polynomial");
+  material_database.put("n_materials", 1);
+  material_database.put("material_0.solid.lame_first_parameter", 2.);
+  material_database.put("material_0.solid.lame_second_parameter", 3.);
+  adamantine::MaterialProperty<dim, 4, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      material_properties(communicator, triangulation, material_database);
+  // Create the DoFHandler
+  dealii::hp::FECollection<dim> fe_collection;
+  fe_collection.push_back(dealii::FESystem<dim>(dealii::FE_Q<dim>(2) ^ dim));
+  fe_collection.push_back(
+      dealii::FESystem<dim>(dealii::FE_Nothing<dim>() ^ dim));
+  dealii::DoFHandler<dim> dof_handler(geometry.get_triangulation());
+  dof_handler.distribute_dofs(fe_collection);
+  dealii::AffineConstraints<double> affine_constraints;
+  dealii::DoFTools::make_hanging_node_constraints(dof_handler,
+                                                  affine_constraints);
+  dealii::VectorTools::interpolate_boundary_values(
+      dof_handler, 0, dealii::Functions::ZeroFunction<dim>(dim),
+      affine_constraints);
+  affine_constraints.close();
+  dealii::hp::QCollection<dim> q_collection;
+  q_collection.push_back(dealii::QGauss<dim>(3));
+  q_collection.push_back(dealii::QGauss<dim>(1));
+
+  // Create the sparse and the matrix-free operators
+  std::vector<double> empty_vector;
+  adamantine::MechanicalOperator<dim, 4, adamantine::SolidLiquidPowder,
+                                 dealii::MemorySpace::Host>
+      sparse_operator(communicator, material_properties, empty_vector);
+  sparse_operator.reinit(dof_handler, affine_constraints, q_collection);
+  adamantine::MechanicalOperator<dim, 4, adamantine::SolidLiquidPowder,
+                                 dealii::MemorySpace::Host>
+      matrix_free_operator(communicator, material_properties, empty_vector,
+                           true);
+  matrix_free_operator.reinit(dof_handler, affine_constraints, q_collection);
+  BOOST_TEST(matrix_free_operator.is_matrix_free());
+  BOOST_TEST(matrix_free_operator.m() == sparse_operator.m());
+
+  // Compare the results on the unconstrained dofs
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> src;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_1;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_2;
+  matrix_free_operator.initialize_dof_vector(src);
+  matrix_free_operator.initialize_dof_vector(dst_1);
+  dst_2.reinit(dof_handler.locally_owned_dofs(), communicator);
+  for (auto const i : dof_handler.locally_owned_dofs())
+    src[i] = affine_constraints.is_constrained(i) ? 0. : std::sin(0.1 * i);
+  matrix_free_operator.vmult(dst_1, src);
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>
+      sparse_src(dof_handler.locally_owned_dofs(), communicator);
+  sparse_src.copy_locally_owned_data_from(src);
+  sparse_operator.vmult(dst_2, sparse_src);
+  for (auto const i : dof_handler.locally_owned_dofs())
+    if (!affine_constraints.is_constrained(i))
+      BOOST_TEST(dst_1[i] == dst_2[i]);
+
+  // The right-hand-side does not depend on the operator mode
+  BOOST_TEST(matrix_free_operator.rhs().l2_norm() ==
+             sparse_operator.rhs().l2_norm());
+}
@@ -20,6 +20,7 @@
 #include <deal.II/fe/fe_system.h>
 #include <deal.II/fe/fe_values.h>
 #include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/filtered_iterator.h>
 #include <deal.II/grid/grid_refinement.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/lac/affine_constraints.h>
@@ -258,6 +259,81 @@ BOOST_AUTO_TEST_CASE(elastostatic)
     BOOST_CHECK_SMALL(solution[i] - reference_solution[i], tolerance);
 }
 
+BOOST_AUTO_TEST_CASE(elastostatic_preconditioners)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  // Geometry database
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 12);
+  geometry_database.put("length_divisions", 6);
+  geometry_database.put("height", 6);
+  geometry_database.put("height_divisions", 3);
+  geometry_database.put("width", 6);
+  geometry_database.put("width_divisions", 3);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  // Build Geometry
+  adamantine::Geometry<3> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  auto const &triangulation = geometry.get_triangulation();
+  for (auto cell : triangulation.cell_iterators())
+  {
+    cell->set_material_id(0);
+    cell->set_user_index(
+        static_cast<int>(adamantine::SolidLiquidPowder::State::solid));
+  }
+  // Create the MaterialProperty
+  boost::property_tree::ptree material_database;
+  material_database.put("property_format", "polynomial");
+  material_database.put("n_materials", 1);
+  material_database.put("material_0.solid.density", 1.);
+  material_database.put("material_0.solid.lame_first_parameter", 2.);
+  material_database.put("material_0.solid.lame_second_parameter", 3.);
+  adamantine::MaterialProperty<3, 4, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      material_properties(communicator, triangulation, material_database);
+
+  // Reference computation
+  ElastoStaticity elasto_staticity;
+  elasto_staticity.setup_system();
+  elasto_staticity.assemble_system();
+  auto reference_solution = elasto_staticity.solve();
+
+  std::vector<std::pair<bool, std::string>> const configurations = {
+      {false, "amg"}, {true, "jacobi"}, {true, "chebyshev"}};
+  for (auto const &[matrix_free, preconditioner] : configurations)
+  {
+    // Build MechanicalPhysics
+    unsigned int const fe_degree = 1;
+    std::vector<double> empty_vector;
+    adamantine::MechanicalPhysics<3, 4, adamantine::SolidLiquidPowder,
+                                  dealii::MemorySpace::Host>
+        mechanical_physics(communicator, fe_degree, geometry,
+                           material_properties, empty_vector, matrix_free,
+                           preconditioner);
+    std::vector<std::shared_ptr<adamantine::BodyForce<3>>> body_forces;
+    auto gravity_force = std::make_shared<adamantine::GravityForce<
+        3, 4, adamantine::SolidLiquidPowder, dealii::MemorySpace::Host>>(
+        material_properties);
+    body_forces.push_back(gravity_force);
+    mechanical_physics.setup_dofs(body_forces);
+    auto solution = mechanical_physics.solve();
+
+    double const tolerance = 1e-8;
+    BOOST_TEST(solution.size() == reference_solution.size());
+    for (unsigned int i = 0; i < reference_solution.size(); ++i)
+      BOOST_CHECK_SMALL(solution[i] - reference_solution[i], tolerance);
+
+    // The mesh is unchanged, so the preconditioner is reused and the solver
+    // starts from the previous solution.
+    mechanical_physics.setup_dofs(body_forces);
+    auto second_solution = mechanical_physics.solve();
+    for (unsigned int i = 0; i < reference_solution.size(); ++i)
+      BOOST_CHECK_SMALL(second_solution[i] - reference_solution[i], tolerance);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(fe_nothing)
 {
   MPI_Comm communicator = MPI_COMM_WORLD;
@@ -489,6 +565,19 @@ run_eshelby(std::vector<dealii::Point<dim>> pts, unsigned int refinement_cycles)
 
   auto solution = mechanical_physics.solve();
 
+  // The mesh is unchanged, so only the right-hand-side is reassembled and the
+  // solution stays the same.
+  auto const n_dofs = mechanical_physics.get_dof_handler().n_dofs();
+  mechanical_physics.setup_dofs(thermal_physics.get_dof_handler(), temperature,
+                                has_melted);
+  BOOST_TEST(mechanical_physics.get_dof_handler().n_dofs() == n_dofs);
+  auto second_solution = mechanical_physics.solve();
+  double const tolerance = 1e-6 * solution.linfty_norm();
+  for (unsigned int i = 0; i < solution.locally_owned_size(); ++i)
+    BOOST_CHECK_SMALL(
+        second_solution.local_element(i) - solution.local_element(i),
+        tolerance);
+
   // Output (for debugging)
   /*
   mechanical_physics.get_affine_constraints().distribute(solution);
@@ -589,9 +678,66 @@ BOOST_AUTO_TEST_CASE(elastoplastic)
       material_properties);
   body_forces.push_back(gravity_force);
   mechanical_physics.setup_dofs(body_forces);
-  mechanical_physics.solve();
-  [[maybe_unused]] auto stress_tensor = mechanical_physics.get_stress_tensor();
-  // TODO check stress tensor
+  auto displacement = mechanical_physics.solve();
+  auto const &plasticity_state = mechanical_physics.get_plasticity_state();
+
+  // Compute the reference stress one quadrature point at a time. Before the
+  // first solve, the stress and the back stress are zero and the plastic
+  // internal variable is equal to the elastic limit.
+  double const lambda = 2.;
+  double const mu = 3.;
+  double const plastic_modulus = 1.5;
+  double const iso_hardening_coef = 0.5;
+  double const elastic_limit = 0.1;
+  auto const &dof_handler = mechanical_physics.get_dof_handler();
+  dealii::FEValues<3> fe_values(dof_handler.get_fe_collection()[0],
+                                dealii::QGauss<3>(fe_degree + 1),
+                                dealii::update_gradients);
+  std::vector<dealii::SymmetricTensor<2, 3>> strain(
+      fe_values.n_quadrature_points);
+  dealii::FEValuesExtractors::Vector const displacement_extractor(0);
+  displacement.update_ghost_values();
+  unsigned int n_plastic_points = 0;
+  for (auto const &cell : dof_handler.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    fe_values.reinit(cell);
+    fe_values[displacement_extractor].get_function_symmetric_gradients(
+        displacement, strain);
+    for (unsigned int q = 0; q < fe_values.n_quadrature_points; ++q)
+    {
+      dealii::SymmetricTensor<2, 3> stress =
+          lambda * dealii::trace(strain[q]) *
+              dealii::unit_symmetric_tensor<3>() +
+          2. * mu * strain[q];
+      double plastic_internal_variable = elastic_limit;
+      auto const effective_stress = dealii::deviator(stress);
+      double const effective_stress_norm = effective_stress.norm();
+      if (effective_stress_norm >= elastic_limit)
+      {
+        double const plastic_strain_increment =
+            (effective_stress_norm - elastic_limit) /
+            (2. * mu + plastic_modulus);
+        stress -= 2. * mu * plastic_strain_increment * effective_stress /
+                  effective_stress_norm;
+        plastic_internal_variable +=
+            iso_hardening_coef * plastic_modulus * plastic_strain_increment;
+        ++n_plastic_points;
+      }
+
+      unsigned int const cell_index = cell->active_cell_index();
+      double const tolerance = 1e-10 * (1. + stress.norm());
+      BOOST_CHECK_SMALL(
+          (plasticity_state.get_stress(cell_index, q) - stress).norm(),
+          tolerance);
+      BOOST_CHECK_SMALL(
+          plasticity_state.plastic_internal_variable(cell_index, q) -
+              plastic_internal_variable,
+          tolerance);
+    }
+  }
+  BOOST_TEST_MESSAGE("Number of plastic quadrature points: "
+                     << n_plastic_points);
 }
 
 // TODO thermo-elasto-plastic problem
@@ -6,6 +6,8 @@
 
 #include <NewtonSolver.hh>
 
+#include <cmath>
+
 #include "main.cc"
 
 namespace utf = boost::unit_test;
@@ -42,3 +44,45 @@ BOOST_AUTO_TEST_CASE(newton_solver, *utf::tolerance(1e-5))
   BOOST_TEST(1. == src[0]);
   BOOST_TEST(1. == src[1]);
 }
+
+BOOST_AUTO_TEST_CASE(newton_krylov_solver, *utf::tolerance(1e-5))
+{
+  dealii::LA::distributed::Vector<double> y(2);
+  y[0] = 2.;
+  y[1] = 2.;
+
+  // The Jacobian is evaluated at the last point where the residual was
+  // computed.
+  dealii::LA::distributed::Vector<double> current_x(2);
+  auto residual = [&](dealii::LA::distributed::Vector<double> const &x)
+  {
+    current_x = x;
+    return compute_residual(x);
+  };
+  auto jacobian_vmult = [&](dealii::LA::distributed::Vector<double> &dst,
+                            dealii::LA::distributed::Vector<double> const &src)
+  {
+    dst[0] = 4. * std::pow(current_x[0], 3) * src[0];
+    dst[1] = 6. * std::pow(current_x[1], 5) * src[1];
+  };
+  unsigned int n_setups = 0;
+  auto setup_preconditioner =
+      [&](dealii::LA::distributed::Vector<double> const &) { ++n_setups; };
+  auto apply_preconditioner =
+      [](dealii::LA::distributed::Vector<double> &dst,
+         dealii::LA::distributed::Vector<double> const &src) { dst = src; };
+
+  adamantine::NewtonSolver newton_solver(20, 1e-10, 10, 10);
+  newton_solver.solve(residual, jacobian_vmult, setup_preconditioner,
+                      apply_preconditioner, y);
+
+  BOOST_TEST(1. == y[0]);
+  BOOST_TEST(1. == y[1]);
+  BOOST_TEST(newton_solver.get_n_iterations() > 0u);
+  BOOST_TEST(newton_solver.get_n_iterations() <= 20u);
+  // The preconditioner is not set up at every Newton iteration.
+  BOOST_TEST(n_setups >= 1u);
+  BOOST_TEST(n_setups <= newton_solver.get_n_iterations());
+  BOOST_TEST(newton_solver.get_n_linear_iterations() >=
+             newton_solver.get_n_iterations());
+}
@@ -0,0 +1,168 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#define BOOST_TEST_MODULE PlasticityState
+
+#include <Geometry.hh>
+#include <PlasticityState.hh>
+
+#include <deal.II/base/symmetric_tensor.h>
+#include <deal.II/grid/filtered_iterator.h>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <map>
+
+#include "main.cc"
+
+namespace
+{
+template <int dim>
+dealii::SymmetricTensor<2, dim> make_tensor(double value)
+{
+  dealii::SymmetricTensor<2, dim> tensor;
+  for (unsigned int i = 0; i < tensor.n_independent_components; ++i)
+    tensor.access_raw_entry(i) = value + i;
+
+  return tensor;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(access)
+{
+  int constexpr dim = 3;
+  unsigned int const n_cells = 5;
+  unsigned int const n_q_points = 8;
+  adamantine::PlasticityState<dim> state;
+  state.reinit(n_cells, n_q_points);
+  BOOST_TEST(state.n_cells() == n_cells);
+  BOOST_TEST(state.n_q_points() == n_q_points);
+
+  for (unsigned int c = 0; c < n_cells; ++c)
+  {
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      state.plastic_internal_variable(c, q) = c + 0.1 * q;
+      state.set_stress(c, q, make_tensor<dim>(10. * c + q));
+      state.set_back_stress(c, q, make_tensor<dim>(-10. * c - q));
+    }
+  }
+  state.reset_cell(2, 7.);
+
+  for (unsigned int c = 0; c < n_cells; ++c)
+  {
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      if (c == 2)
+      {
+        BOOST_TEST(state.plastic_internal_variable(c, q) == 7.);
+        BOOST_TEST(state.get_stress(c, q).norm() == 0.);
+        BOOST_TEST(state.get_back_stress(c, q).norm() == 0.);
+      }
+      else
+      {
+        BOOST_TEST(state.plastic_internal_variable(c, q) == c + 0.1 * q);
+        BOOST_TEST(state.get_stress(c, q) == make_tensor<dim>(10. * c + q));
+        BOOST_TEST(state.get_back_stress(c, q) ==
+                   make_tensor<dim>(-10. * c - q));
+        // The components are stored in contiguous blocks.
+        BOOST_TEST(state.get_component(0)[c * n_q_points + q] ==
+                   state.plastic_internal_variable(c, q));
+        BOOST_TEST(state.get_component(2)[c * n_q_points + q] ==
+                   state.get_stress(c, q).access_raw_entry(1));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(transfer)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  int constexpr dim = 3;
+
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 4);
+  geometry_database.put("length_divisions", 2);
+  geometry_database.put("height", 4);
+  geometry_database.put("height_divisions", 2);
+  geometry_database.put("width", 4);
+  geometry_database.put("width_divisions", 2);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<dim> geometry(communicator, geometry_database,
+                                     units_optional_database);
+  auto &triangulation = geometry.get_triangulation();
+
+  // The state of each cell depends on the position of the cell.
+  unsigned int const n_q_points = 4;
+  adamantine::PlasticityState<dim> state;
+  state.reinit(triangulation.n_active_cells(), n_q_points);
+  auto cell_value = [](auto const &cell)
+  { return cell->center()[0] + 10. * cell->center()[1]; };
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      state.plastic_internal_variable(cell->active_cell_index(), q) =
+          cell_value(cell);
+      state.set_stress(cell->active_cell_index(), q,
+                       make_tensor<dim>(cell_value(cell)));
+    }
+  }
+
+  // Refine the cells and check that the children inherit the state of the
+  // parent.
+  std::map<dealii::CellId, double> parent_values;
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    parent_values[cell->id()] = cell_value(cell);
+    cell->set_refine_flag();
+  }
+  state.prepare_for_coarsening_and_refinement(triangulation);
+  triangulation.execute_coarsening_and_refinement();
+  state.unpack(triangulation);
+  BOOST_TEST(state.n_cells() == triangulation.n_active_cells());
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    double const value = parent_values[cell->parent()->id()];
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      BOOST_TEST(state.plastic_internal_variable(cell->active_cell_index(),
+                                                 q) == value);
+      BOOST_TEST(state.get_stress(cell->active_cell_index(), q) ==
+                 make_tensor<dim>(value));
+      BOOST_TEST(state.get_back_stress(cell->active_cell_index(), q).norm() ==
+                 0.);
+    }
+  }
+
+  // Coarsen the cells and check that the parent gets the average state of
+  // the children.
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    state.plastic_internal_variable(cell->active_cell_index(), 0) =
+        cell_value(cell);
+    cell->set_coarsen_flag();
+  }
+  state.prepare_for_coarsening_and_refinement(triangulation);
+  triangulation.execute_coarsening_and_refinement();
+  state.unpack(triangulation);
+  BOOST_TEST(state.n_cells() == triangulation.n_active_cells());
+  for (auto const &cell : triangulation.active_cell_iterators() |
+                              dealii::IteratorFilters::LocallyOwnedCell())
+  {
+    // The average of the values of the children is the value at the center
+    // of the parent.
+    for (unsigned int q = 0; q < 2; ++q)
+    {
+      BOOST_TEST(state.plastic_internal_variable(cell->active_cell_index(),
+                                                 q) == cell_value(cell),
+                 boost::test_tools::tolerance(1e-12));
+    }
+  }
+}
@@ -11,6 +11,7 @@
 #include <GoldakHeatSource.hh>
 #include <MaterialProperty.hh>
 #include <MechanicalOperator.hh>
+#include <PlasticityState.hh>
 #include <PostProcessor.hh>
 #include <ThermalOperator.hh>
 
@@ -138,6 +139,33 @@ BOOST_AUTO_TEST_CASE(thermal_post_processor)
   std::remove("test.0.0.vtu");
   std::remove("test.1.0.vtu");
   std::remove("test.2.0.vtu");
+
+  // Write the files in the background
+  post_processor_database.put("filename_prefix", "test_async");
+  post_processor_database.put("asynchronous_output", true);
+  post_processor_database.put("compression_level", "best_compression");
+  adamantine::PostProcessor<2> async_post_processor(
+      communicator, post_processor_database, dof_handler);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    async_post_processor.write_thermal_output<Kokkos::LayoutRight>(
+        i, 0.1 * i, src, mat_properties.get_state(),
+        mat_properties.get_dofs_map(), mat_properties.get_dof_handler());
+    // The snapshot must not depend on the vector after the call
+    src *= 2.;
+  }
+  async_post_processor.write_pvd();
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    std::string const prefix = "test_async." + std::to_string(i);
+    BOOST_CHECK(std::filesystem::exists(prefix + ".pvtu"));
+    BOOST_CHECK(std::filesystem::exists(prefix + ".0.vtu"));
+    std::remove((prefix + ".pvtu").c_str());
+    std::remove((prefix + ".0.vtu").c_str());
+  }
+  BOOST_CHECK(std::filesystem::exists("test_async.pvd"));
+  std::remove("test_async.pvd");
 }
 
 BOOST_AUTO_TEST_CASE(mechanical_post_processor)
@@ -217,19 +245,21 @@ BOOST_AUTO_TEST_CASE(mechanical_post_processor)
 
   unsigned int const n_cells = geometry.get_triangulation().n_active_cells();
   unsigned int const n_q_points = q_collection.max_n_quadrature_points();
-  std::vector<std::vector<dealii::SymmetricTensor<2, dim>>> stress(
-      n_cells, std::vector<dealii::SymmetricTensor<2, dim>>(n_q_points));
+  dealii::SymmetricTensor<2, dim> stress_tensor;
+  for (unsigned int i = 0; i < dim; ++i)
+  {
+    for (unsigned int j = 0; j < dim; ++j)
+    {
+      stress_tensor[i][j] = i == j ? 3. : 1.;
+    }
+  }
+  adamantine::PlasticityState<dim> stress;
+  stress.reinit(n_cells, n_q_points);
   for (unsigned int c = 0; c < n_cells; ++c)
   {
     for (unsigned int q = 0; q < n_q_points; ++q)
     {
-      for (unsigned int i = 0; i < dim; ++i)
-      {
-        for (unsigned int j = 0; j < dim; ++j)
-        {
-          stress[c][q][i][j] = i == j ? 3. : 1.;
-        }
-      }
+      stress.set_stress(c, q, stress_tensor);
     }
   }
 
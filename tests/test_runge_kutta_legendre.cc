@@ -0,0 +1,100 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024, the adamantine authors.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#define BOOST_TEST_MODULE RungeKuttaLegendre
+
+#include <RungeKuttaLegendre.hh>
+
+#include <cmath>
+#include <vector>
+
+#include "main.cc"
+
+namespace tt = boost::test_tools;
+
+namespace
+{
+using VectorType =
+    dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host>;
+
+// Solve y_i' = -lambda_i y_i + cos(t) with y_i(0) = 1 up to t = 1.
+VectorType solve(std::vector<double> const &lambda, double delta_t,
+                 adamantine::RungeKuttaLegendre<dealii::MemorySpace::Host>
+                     &time_stepping)
+{
+  VectorType y(lambda.size());
+  y = 1.;
+  auto f = [&](double const t, VectorType const &v)
+  {
+    VectorType value(v.get_partitioner());
+    for (unsigned int i = 0; i < lambda.size(); ++i)
+      value[i] = -lambda[i] * v[i] + std::cos(t);
+    return value;
+  };
+  auto id_minus_tau_J_inverse =
+      [](double const, double const, VectorType const &v) { return v; };
+
+  double time = 0.;
+  unsigned int const n_time_steps = std::round(1. / delta_t);
+  for (unsigned int i = 0; i < n_time_steps; ++i)
+    time = time_stepping.evolve_one_time_step(f, id_minus_tau_J_inverse, time,
+                                              delta_t, y);
+  BOOST_TEST(time == 1., tt::tolerance(1e-12));
+
+  return y;
+}
+
+double exact_solution(double lambda)
+{
+  return std::exp(-lambda) * (1. - lambda / (lambda * lambda + 1.)) +
+         (lambda * std::cos(1.) + std::sin(1.)) / (lambda * lambda + 1.);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(n_stages)
+{
+  using RKL2 = adamantine::RungeKuttaLegendre<dealii::MemorySpace::Host>;
+
+  // At least two stages are always used.
+  BOOST_TEST(RKL2::compute_n_stages(1., 0.) == 2u);
+  BOOST_TEST(RKL2::compute_n_stages(1., 2.) == 2u);
+  // With s stages, the method is stable up to delta_t * spectral_radius =
+  // (s^2 + s - 2) / 2.
+  BOOST_TEST(RKL2::compute_n_stages(1., 54.) == 10u);
+  BOOST_TEST(RKL2::compute_n_stages(1., 54.5) == 11u);
+  BOOST_TEST(RKL2::compute_n_stages(0.5, 108.) == 10u);
+}
+
+BOOST_AUTO_TEST_CASE(stiff_ode)
+{
+  // The stiff component limits forward Euler to delta_t <= 2e-3.
+  std::vector<double> const lambda = {1., 10., 1000.};
+  double const safety_factor = 1.5;
+
+  std::vector<double> errors;
+  for (double delta_t : {0.1, 0.05, 0.025})
+  {
+    adamantine::RungeKuttaLegendre<dealii::MemorySpace::Host> time_stepping(
+        10, safety_factor, 0);
+    VectorType const y = solve(lambda, delta_t, time_stepping);
+
+    // The power method finds the stiff eigenvalue.
+    auto const &status = time_stepping.get_status();
+    BOOST_TEST(status.spectral_radius == safety_factor * lambda.back(),
+               tt::tolerance(1e-4));
+    BOOST_TEST(status.n_stages ==
+               time_stepping.compute_n_stages(delta_t,
+                                              status.spectral_radius));
+
+    // The solution is stable although the time step is 50 times larger than
+    // the stability limit of forward Euler.
+    for (unsigned int i = 0; i < lambda.size(); ++i)
+      BOOST_TEST(std::abs(y[i] - exact_solution(lambda[i])) < 1e-2);
+    errors.push_back(std::abs(y[0] - exact_solution(lambda[0])));
+  }
+
+  // The method is second order.
+  for (unsigned int i = 1; i < errors.size(); ++i)
+    BOOST_TEST(errors[i - 1] / errors[i] > 3.5);
+}
@@ -930,3 +930,335 @@ BOOST_AUTO_TEST_CASE(spmv_conv, *utf::tolerance(1e-12))
     BOOST_TEST(dst_1 == dst_2, tt::per_element());
   }
 }
+
+BOOST_AUTO_TEST_CASE(spmv_constant_coefficients, *utf::tolerance(1e-12))
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 12);
+  geometry_database.put("length_divisions", 4);
+  geometry_database.put("height", 6);
+  geometry_database.put("height_divisions", 2);
+  geometry_database.put("width", 6);
+  geometry_database.put("width_divisions", 2);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<3> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  // Create the DoFHandler
+  dealii::hp::FECollection<3> fe_collection;
+  fe_collection.push_back(dealii::FE_Q<3>(2));
+  fe_collection.push_back(dealii::FE_Nothing<3>());
+  dealii::DoFHandler<3> dof_handler(geometry.get_triangulation());
+  dof_handler.distribute_dofs(fe_collection);
+  dealii::AffineConstraints<double> affine_constraints;
+  affine_constraints.close();
+  dealii::hp::QCollection<1> q_collection;
+  q_collection.push_back(dealii::QGauss<1>(3));
+  q_collection.push_back(dealii::QGauss<1>(1));
+
+  // Create the MaterialProperty. The properties do not depend on the
+  // temperature but the liquid is different than the solid.
+  boost::property_tree::ptree mat_prop_database;
+  mat_prop_database.put("property_format", "polynomial");
+  mat_prop_database.put("n_materials", 1);
+  mat_prop_database.put("material_0.solidus", 10.);
+  mat_prop_database.put("material_0.liquidus", 20.);
+  mat_prop_database.put("material_0.latent_heat", 100.);
+  mat_prop_database.put("material_0.solid.density", 2.);
+  mat_prop_database.put("material_0.powder.density", 2.);
+  mat_prop_database.put("material_0.liquid.density", 1.5);
+  mat_prop_database.put("material_0.solid.specific_heat", 3.);
+  mat_prop_database.put("material_0.powder.specific_heat", 3.);
+  mat_prop_database.put("material_0.liquid.specific_heat", 4.);
+  mat_prop_database.put("material_0.solid.thermal_conductivity_x", 1.);
+  mat_prop_database.put("material_0.solid.thermal_conductivity_y", 0.8);
+  mat_prop_database.put("material_0.solid.thermal_conductivity_z", 0.6);
+  mat_prop_database.put("material_0.powder.thermal_conductivity_x", 1.);
+  mat_prop_database.put("material_0.powder.thermal_conductivity_y", 0.8);
+  mat_prop_database.put("material_0.powder.thermal_conductivity_z", 0.6);
+  mat_prop_database.put("material_0.liquid.thermal_conductivity_x", 2.);
+  mat_prop_database.put("material_0.liquid.thermal_conductivity_y", 2.);
+  mat_prop_database.put("material_0.liquid.thermal_conductivity_z", 2.);
+  // With p_order equal to zero, the cold cells use the precomputed
+  // coefficients. With p_order equal to one, the material properties are
+  // always evaluated.
+  adamantine::MaterialProperty<3, 0, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      constant_mat_properties(communicator, geometry.get_triangulation(),
+                              mat_prop_database);
+  adamantine::MaterialProperty<3, 1, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      mat_properties(communicator, geometry.get_triangulation(),
+                     mat_prop_database);
+
+  // Create the heat sources
+  std::vector<std::shared_ptr<adamantine::HeatSource<3>>> heat_sources;
+
+  // Initialize the ThermalOperators
+  adamantine::ThermalOperator<3, false, 0, 2, adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      constant_thermal_operator(communicator,
+                                adamantine::BoundaryType::adiabatic,
+                                constant_mat_properties, heat_sources);
+  adamantine::ThermalOperator<3, false, 1, 2, adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      thermal_operator(communicator, adamantine::BoundaryType::adiabatic,
+                       mat_properties, heat_sources);
+  double constexpr deposition_angle = M_PI / 6.;
+  std::vector<double> deposition_cos(
+      geometry.get_triangulation().n_locally_owned_active_cells(),
+      std::cos(deposition_angle));
+  std::vector<double> deposition_sin(
+      geometry.get_triangulation().n_locally_owned_active_cells(),
+      std::sin(deposition_angle));
+  constant_thermal_operator.reinit(dof_handler, affine_constraints,
+                                   q_collection);
+  constant_thermal_operator.set_material_deposition_orientation(
+      deposition_cos, deposition_sin);
+  constant_thermal_operator.get_state_from_material_properties();
+  thermal_operator.reinit(dof_handler, affine_constraints, q_collection);
+  thermal_operator.set_material_deposition_orientation(deposition_cos,
+                                                       deposition_sin);
+  thermal_operator.get_state_from_material_properties();
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> src;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_1;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_2;
+  dealii::MatrixFree<3, double> const &matrix_free =
+      thermal_operator.get_matrix_free();
+  matrix_free.initialize_dof_vector(src);
+  matrix_free.initialize_dof_vector(dst_1);
+  matrix_free.initialize_dof_vector(dst_2);
+
+  // The whole domain is below the solidus
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = 1. + 0.01 * i;
+  constant_thermal_operator.vmult(dst_1, src);
+  thermal_operator.vmult(dst_2, src);
+  BOOST_TEST(dst_1.l2_norm() > 0.);
+  BOOST_TEST(dst_1 == dst_2, tt::per_element());
+
+  // Part of the domain is above the solidus and part of the domain is mushy
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = 0.1 * i;
+  BOOST_TEST(src.linfty_norm() > 20.);
+  constant_thermal_operator.vmult(dst_1, src);
+  thermal_operator.vmult(dst_2, src);
+  BOOST_TEST(dst_1 == dst_2, tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(mixed_precision)
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 12);
+  geometry_database.put("length_divisions", 4);
+  geometry_database.put("height", 6);
+  geometry_database.put("height_divisions", 5);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  // Create the DoFHandler
+  dealii::hp::FECollection<2> fe_collection;
+  fe_collection.push_back(dealii::FE_Q<2>(2));
+  fe_collection.push_back(dealii::FE_Nothing<2>());
+  dealii::DoFHandler<2> dof_handler(geometry.get_triangulation());
+  dof_handler.distribute_dofs(fe_collection);
+  dealii::AffineConstraints<double> affine_constraints;
+  affine_constraints.close();
+  dealii::hp::QCollection<1> q_collection;
+  q_collection.push_back(dealii::QGauss<1>(3));
+  q_collection.push_back(dealii::QGauss<1>(1));
+
+  // Create the MaterialProperty
+  boost::property_tree::ptree mat_prop_database;
+  mat_prop_database.put("property_format", "polynomial");
+  mat_prop_database.put("n_materials", 1);
+  mat_prop_database.put("material_0.solidus", 1000.);
+  mat_prop_database.put("material_0.liquidus", 1100.);
+  mat_prop_database.put("material_0.latent_heat", 100.);
+  mat_prop_database.put("material_0.solid.density", 1.);
+  mat_prop_database.put("material_0.powder.density", 1.);
+  mat_prop_database.put("material_0.liquid.density", 1.);
+  mat_prop_database.put("material_0.solid.specific_heat", 1.);
+  mat_prop_database.put("material_0.powder.specific_heat", 1.);
+  mat_prop_database.put("material_0.liquid.specific_heat", 1.);
+  mat_prop_database.put("material_0.solid.thermal_conductivity_x", 1.);
+  mat_prop_database.put("material_0.solid.thermal_conductivity_z", 2.);
+  mat_prop_database.put("material_0.powder.thermal_conductivity_x", 1.);
+  mat_prop_database.put("material_0.powder.thermal_conductivity_z", 2.);
+  mat_prop_database.put("material_0.liquid.thermal_conductivity_x", 3.);
+  mat_prop_database.put("material_0.liquid.thermal_conductivity_z", 3.);
+  mat_prop_database.put("material_0.solid.emissivity", 0.5);
+  mat_prop_database.put("material_0.powder.emissivity", 0.5);
+  mat_prop_database.put("material_0.liquid.emissivity", 0.5);
+  mat_prop_database.put("material_0.radiation_temperature_infty", 300.);
+  adamantine::MaterialProperty<2, 1, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      mat_properties(communicator, geometry.get_triangulation(),
+                     mat_prop_database);
+
+  // Create the heat sources
+  std::vector<std::shared_ptr<adamantine::HeatSource<2>>> heat_sources;
+
+  // Initialize the ThermalOperators. The first one is applied in double
+  // precision and the second one in single precision.
+  adamantine::ThermalOperator<2, false, 1, 2, adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      thermal_operator(communicator, adamantine::BoundaryType::radiative,
+                       mat_properties, heat_sources);
+  adamantine::ThermalOperator<2, false, 1, 2, adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      mixed_thermal_operator(communicator, adamantine::BoundaryType::radiative,
+                             mat_properties, heat_sources);
+  mixed_thermal_operator.set_mixed_precision(true, true);
+  std::vector<double> deposition_cos(
+      geometry.get_triangulation().n_locally_owned_active_cells(), 1.);
+  std::vector<double> deposition_sin(
+      geometry.get_triangulation().n_locally_owned_active_cells(), 0.);
+  for (auto op : {&thermal_operator, &mixed_thermal_operator})
+  {
+    op->reinit(dof_handler, affine_constraints, q_collection);
+    op->set_material_deposition_orientation(deposition_cos, deposition_sin);
+    op->get_state_from_material_properties();
+  }
+  BOOST_TEST(thermal_operator.get_mixed_precision_difference() == 0.);
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> src;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_1;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_2;
+  thermal_operator.initialize_dof_vector(src);
+  thermal_operator.initialize_dof_vector(dst_1);
+  thermal_operator.initialize_dof_vector(dst_2);
+
+  // Part of the domain is mushy
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = 300. + 10. * i;
+  thermal_operator.vmult(dst_1, src);
+  mixed_thermal_operator.vmult(dst_2, src);
+  BOOST_TEST(dst_1.l2_norm() > 0.);
+
+  // The result of the single precision operator is close to the double
+  // precision one and the difference measured by the operator is consistent.
+  double const norm = dst_1.linfty_norm();
+  dst_2 -= dst_1;
+  double const difference = dst_2.linfty_norm() / norm;
+  BOOST_TEST(difference > 0.);
+  BOOST_TEST(difference < 1e-4);
+  BOOST_TEST(mixed_thermal_operator.get_mixed_precision_difference() ==
+                 difference,
+             tt::tolerance(1e-6));
+}
+
+BOOST_AUTO_TEST_CASE(quiet_cells, *utf::tolerance(1e-12))
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  // Create the Geometry
+  boost::property_tree::ptree geometry_database;
+  geometry_database.put("import_mesh", false);
+  geometry_database.put("length", 12);
+  geometry_database.put("length_divisions", 4);
+  geometry_database.put("height", 6);
+  geometry_database.put("height_divisions", 5);
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<2> geometry(communicator, geometry_database,
+                                   units_optional_database);
+  // Create the DoFHandler
+  dealii::hp::FECollection<2> fe_collection;
+  fe_collection.push_back(dealii::FE_Q<2>(2));
+  fe_collection.push_back(dealii::FE_Nothing<2>());
+  dealii::DoFHandler<2> dof_handler(geometry.get_triangulation());
+  dof_handler.distribute_dofs(fe_collection);
+  dealii::AffineConstraints<double> affine_constraints;
+  affine_constraints.close();
+  dealii::hp::QCollection<1> q_collection;
+  q_collection.push_back(dealii::QGauss<1>(3));
+  q_collection.push_back(dealii::QGauss<1>(1));
+
+  // Create the MaterialProperty
+  boost::property_tree::ptree mat_prop_database;
+  mat_prop_database.put("property_format", "polynomial");
+  mat_prop_database.put("n_materials", 1);
+  mat_prop_database.put("material_0.solidus", 1000.);
+  mat_prop_database.put("material_0.liquidus", 1100.);
+  mat_prop_database.put("material_0.latent_heat", 100.);
+  mat_prop_database.put("material_0.solid.density", 2.);
+  mat_prop_database.put("material_0.powder.density", 2.);
+  mat_prop_database.put("material_0.liquid.density", 2.);
+  mat_prop_database.put("material_0.solid.specific_heat", 3.);
+  mat_prop_database.put("material_0.powder.specific_heat", 3.);
+  mat_prop_database.put("material_0.liquid.specific_heat", 3.);
+  mat_prop_database.put("material_0.solid.thermal_conductivity_x", 1.);
+  mat_prop_database.put("material_0.solid.thermal_conductivity_z", 2.);
+  mat_prop_database.put("material_0.powder.thermal_conductivity_x", 1.);
+  mat_prop_database.put("material_0.powder.thermal_conductivity_z", 2.);
+  mat_prop_database.put("material_0.liquid.thermal_conductivity_x", 3.);
+  mat_prop_database.put("material_0.liquid.thermal_conductivity_z", 3.);
+  adamantine::MaterialProperty<2, 1, adamantine::SolidLiquidPowder,
+                               dealii::MemorySpace::Host>
+      mat_properties(communicator, geometry.get_triangulation(),
+                     mat_prop_database);
+
+  // Create the heat sources
+  std::vector<std::shared_ptr<adamantine::HeatSource<2>>> heat_sources;
+
+  // Initialize the ThermalOperators. All the cells of the second operator are
+  // quiet.
+  double constexpr conductivity_scaling = 1e-4;
+  double constexpr capacity_scaling = 1e-2;
+  adamantine::ThermalOperator<2, false, 1, 2, adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      thermal_operator(communicator, adamantine::BoundaryType::adiabatic,
+                       mat_properties, heat_sources);
+  adamantine::ThermalOperator<2, false, 1, 2, adamantine::SolidLiquidPowder,
+                              dealii::MemorySpace::Host>
+      quiet_thermal_operator(communicator, adamantine::BoundaryType::adiabatic,
+                             mat_properties, heat_sources);
+  unsigned int const n_cells =
+      geometry.get_triangulation().n_locally_owned_active_cells();
+  std::vector<double> deposition_cos(n_cells, 1.);
+  std::vector<double> deposition_sin(n_cells, 0.);
+  for (auto op : {&thermal_operator, &quiet_thermal_operator})
+  {
+    op->reinit(dof_handler, affine_constraints, q_collection);
+    op->set_material_deposition_orientation(deposition_cos, deposition_sin);
+    op->get_state_from_material_properties();
+  }
+  quiet_thermal_operator.set_quiet_cells(std::vector<bool>(n_cells, true),
+                                         conductivity_scaling,
+                                         capacity_scaling);
+
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> src;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_1;
+  dealii::LA::distributed::Vector<double, dealii::MemorySpace::Host> dst_2;
+  thermal_operator.initialize_dof_vector(src);
+  thermal_operator.initialize_dof_vector(dst_1);
+  thermal_operator.initialize_dof_vector(dst_2);
+
+  // The whole domain is below the solidus
+  for (unsigned int i = 0; i < src.locally_owned_size(); ++i)
+    src.local_element(i) = 300. + 2. * i;
+  thermal_operator.vmult(dst_1, src);
+  quiet_thermal_operator.vmult(dst_2, src);
+  BOOST_TEST(dst_1.l2_norm() > 0.);
+
+  // The diffusion in the quiet cells is slowed down by the ratio of the
+  // scaling factors.
+  dst_1 *= conductivity_scaling / capacity_scaling;
+  BOOST_TEST(dst_1 == dst_2, tt::per_element());
+
+  // Once the cells are activated, the operators are identical.
+  quiet_thermal_operator.set_quiet_cells(std::vector<bool>(n_cells, false),
+                                         conductivity_scaling,
+                                         capacity_scaling);
+  thermal_operator.vmult(dst_1, src);
+  quiet_thermal_operator.vmult(dst_2, src);
+  BOOST_TEST(dst_1 == dst_2, tt::per_element());
+}
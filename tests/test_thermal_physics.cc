@@ -39,6 +39,41 @@ BOOST_AUTO_TEST_CASE(thermal_2d_implicit_host)
   thermal_2d<dealii::MemorySpace::Host>(database, 0.025);
 }
 
+BOOST_AUTO_TEST_CASE(thermal_2d_implicit_cg_host)
+{
+  boost::property_tree::ptree database;
+  // Time-stepping database
+  database.put("time_stepping.method", "backward_euler");
+  database.put("time_stepping.linear_solver", "cg");
+  database.put("time_stepping.extrapolate_initial_guess", true);
+  database.put("time_stepping.max_iteration", 100);
+  database.put("time_stepping.tolerance", 1e-6);
+  database.put("sources.beam_0.scan_path_file",
+               "scan_path_test_thermal_physics.txt");
+  database.put("sources.beam_0.type", "electron_beam");
+  database.put("sources.beam_0.scan_path_file_format", "segment");
+
+  thermal_2d<dealii::MemorySpace::Host>(database, 0.025);
+}
+
+BOOST_AUTO_TEST_CASE(thermal_2d_newton_krylov_host)
+{
+  boost::property_tree::ptree database;
+  // Time-stepping database
+  database.put("time_stepping.method", "backward_euler");
+  database.put("time_stepping.newton_krylov", true);
+  database.put("time_stepping.chebyshev_degree", 3);
+  database.put("time_stepping.max_iteration", 100);
+  database.put("time_stepping.tolerance", 1e-6);
+  database.put("time_stepping.n_tmp_vectors", 30);
+  database.put("sources.beam_0.scan_path_file",
+               "scan_path_test_thermal_physics.txt");
+  database.put("sources.beam_0.type", "electron_beam");
+  database.put("sources.beam_0.scan_path_file_format", "segment");
+
+  thermal_2d<dealii::MemorySpace::Host>(database, 0.025);
+}
+
 BOOST_AUTO_TEST_CASE(thermal_2d_manufactured_solution_host)
 {
   thermal_2d_manufactured_solution<dealii::MemorySpace::Host>();
@@ -68,3 +103,23 @@ BOOST_AUTO_TEST_CASE(reference_temperature_host)
 {
   reference_temperature<dealii::MemorySpace::Host>();
 }
+
+BOOST_AUTO_TEST_CASE(multirate_host)
+{
+  multirate<dealii::MemorySpace::Host>();
+}
+
+BOOST_AUTO_TEST_CASE(dormant_host)
+{
+  dormant<dealii::MemorySpace::Host>();
+}
+
+BOOST_AUTO_TEST_CASE(ensemble_host)
+{
+  ensemble<dealii::MemorySpace::Host>();
+}
+
+BOOST_AUTO_TEST_CASE(shared_discretization_host)
+{
+  shared_discretization<dealii::MemorySpace::Host>();
+}
@@ -10,6 +10,8 @@
 
 #include <deal.II/base/quadrature_lib.h>
 
+#include <filesystem>
+
 namespace tt = boost::test_tools;
 
 boost::property_tree::ptree basic_geometry_database()
@@ -24,6 +26,15 @@ boost::property_tree::ptree basic_geometry_database()
   return geometry_database;
 }
 
+boost::property_tree::ptree multi_cell_geometry_database()
+{
+  auto geometry_database = basic_geometry_database();
+  geometry_database.put("length_divisions", 4);
+  geometry_database.put("height_divisions", 5);
+
+  return geometry_database;
+}
+
 boost::property_tree::ptree basic_material_properies_database()
 {
   // MaterialProperty database
@@ -72,6 +83,68 @@ boost::property_tree::ptree basic_input_database()
   return database;
 }
 
+template <typename MemorySpaceType>
+struct ThermalMembers
+{
+  using MaterialPropertyType =
+      adamantine::MaterialProperty<2, 2, adamantine::SolidLiquidPowder,
+                                   MemorySpaceType>;
+  using ThermalPhysicsType =
+      adamantine::ThermalPhysics<2, 2, 2, adamantine::SolidLiquidPowder,
+                                 MemorySpaceType, dealii::QGauss<1>>;
+  using VectorType = dealii::LA::distributed::Vector<double, MemorySpaceType>;
+
+  std::vector<boost::property_tree::ptree> databases;
+  std::vector<std::unique_ptr<adamantine::Geometry<2>>> geometries;
+  std::vector<std::unique_ptr<MaterialPropertyType>> material_properties;
+  std::vector<std::unique_ptr<ThermalPhysicsType>> physics;
+  std::vector<VectorType> solutions;
+};
+
+// Build n_members ThermalPhysics on the mesh of multi_cell_geometry_database()
+// and set their solution to zero. The absorption efficiency of the beam of the
+// member i is 0.1 * (1 + i % 2). If share_discretization is true, the second
+// member shares the mesh and the discretization of the first one.
+template <typename MemorySpaceType>
+ThermalMembers<MemorySpaceType> build_thermal_members(
+    boost::property_tree::ptree const &database,
+    boost::property_tree::ptree const &material_property_database,
+    unsigned int const n_members, bool const share_discretization = false)
+{
+  using Members = ThermalMembers<MemorySpaceType>;
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+
+  Members members;
+  members.databases.reserve(n_members);
+  members.solutions.resize(n_members);
+  for (unsigned int i = 0; i < n_members; ++i)
+  {
+    members.databases.push_back(database);
+    members.databases.back().put("sources.beam_0.absorption_efficiency",
+                                 0.1 * (1 + i % 2));
+    bool const shared = share_discretization && (i == 1);
+    if (!shared)
+      members.geometries.push_back(std::make_unique<adamantine::Geometry<2>>(
+          communicator, multi_cell_geometry_database(),
+          units_optional_database));
+    members.material_properties.push_back(
+        std::make_unique<typename Members::MaterialPropertyType>(
+            communicator, members.geometries.back()->get_triangulation(),
+            material_property_database));
+    members.physics.push_back(
+        std::make_unique<typename Members::ThermalPhysicsType>(
+            communicator, members.databases.back(),
+            *members.geometries.back(), *members.material_properties.back()));
+    if (shared)
+      members.physics[1]->share_discretization(*members.physics[0]);
+    members.physics.back()->setup();
+    members.physics.back()->initialize_dof_vector(0., members.solutions[i]);
+  }
+
+  return members;
+}
+
 template <typename MemorySpaceType>
 void thermal_2d(boost::property_tree::ptree &database, double time_step)
 {
@@ -671,3 +744,233 @@ void reference_temperature()
   for (auto indicator : has_melted)
     BOOST_CHECK(indicator == true);
 }
+
+template <typename MemorySpaceType>
+dealii::LA::distributed::Vector<double, MemorySpaceType>
+multirate_2d(boost::property_tree::ptree const &database, double time_step)
+{
+  auto members = build_thermal_members<MemorySpaceType>(
+      database, basic_material_properies_database(), 1);
+  auto &physics = *members.physics[0];
+  auto &solution = members.solutions[0];
+
+  std::vector<adamantine::Timer> timers(adamantine::Timing::n_timers);
+  double time = 0;
+  while (time < 0.1)
+  {
+    time = physics.evolve_one_time_step(time, time_step, solution, timers);
+  }
+  BOOST_TEST(time == 0.1, tt::tolerance(1e-12));
+
+  return solution;
+}
+
+template <typename MemorySpaceType>
+void multirate()
+{
+  auto reference_database = basic_input_database();
+  reference_database.put("time_stepping.method", "forward_euler");
+  auto const reference_fine =
+      multirate_2d<MemorySpaceType>(reference_database, 0.025);
+  auto const reference_coarse =
+      multirate_2d<MemorySpaceType>(reference_database, 0.05);
+
+  // All the cells are in the fast region: the multirate method is forward
+  // Euler with the time step divided by the number of substeps.
+  auto database = basic_input_database();
+  database.put("time_stepping.method", "forward_euler");
+  database.put("time_stepping.multirate_substeps", 2);
+  database.put("time_stepping.multirate_min_level", 0);
+  auto solution = multirate_2d<MemorySpaceType>(database, 0.05);
+  BOOST_TEST(solution.l2_norm() > 0.);
+  solution -= reference_fine;
+  BOOST_TEST(solution.l2_norm() <= 1e-12 * reference_fine.l2_norm());
+
+  // None of the cells are in the fast region: the multirate method is forward
+  // Euler with the full time step.
+  database.put("time_stepping.multirate_min_level", 1);
+  solution = multirate_2d<MemorySpaceType>(database, 0.05);
+  solution -= reference_coarse;
+  BOOST_TEST(solution.l2_norm() <= 1e-12 * reference_coarse.l2_norm());
+}
+
+template <typename MemorySpaceType>
+void dormant()
+{
+  auto reference_database = basic_input_database();
+  reference_database.put("time_stepping.method", "forward_euler");
+  auto const reference =
+      multirate_2d<MemorySpaceType>(reference_database, 0.025);
+
+  // The thresholds are zero: none of the cells become dormant.
+  auto database = basic_input_database();
+  database.put("time_stepping.method", "forward_euler");
+  database.put("time_stepping.dormant_update_interval", 4);
+  database.put("time_stepping.dormant_rate_threshold", 0.);
+  database.put("time_stepping.dormant_gradient_threshold", 0.);
+  database.put("time_stepping.dormant_distance", 0.);
+  auto solution = multirate_2d<MemorySpaceType>(database, 0.025);
+  BOOST_TEST(solution.l2_norm() > 0.);
+  solution -= reference;
+  BOOST_TEST(solution.l2_norm() <= 1e-12 * reference.l2_norm());
+
+  // All the cells are close to the heat source: none of the cells become
+  // dormant.
+  database.put("time_stepping.dormant_rate_threshold", 1e300);
+  database.put("time_stepping.dormant_gradient_threshold", 1e300);
+  database.put("time_stepping.dormant_distance", 1e100);
+  solution = multirate_2d<MemorySpaceType>(database, 0.025);
+  solution -= reference;
+  BOOST_TEST(solution.l2_norm() <= 1e-12 * reference.l2_norm());
+
+  // The cells away from the heat source become dormant but the dormant
+  // region is updated, with a full evaluation, at every time step.
+  database.put("time_stepping.dormant_update_interval", 1);
+  database.put("time_stepping.dormant_distance", 0.);
+  solution = multirate_2d<MemorySpaceType>(database, 0.025);
+  solution -= reference;
+  BOOST_TEST(solution.l2_norm() <= 1e-12 * reference.l2_norm());
+}
+
+template <typename MemorySpaceType>
+void ensemble()
+{
+  using VectorType = dealii::LA::distributed::Vector<double, MemorySpaceType>;
+
+  auto material_property_database = basic_material_properies_database();
+  for (std::string state : {"solid", "powder", "liquid"})
+  {
+    material_property_database.put("material_0." + state + ".emissivity", 1.);
+    material_property_database.put(
+        "material_0." + state + ".convection_heat_transfer_coef", 1.);
+  }
+  material_property_database.put("material_0.radiation_temperature_infty", 0.);
+  material_property_database.put("material_0.convection_temperature_infty",
+                                 20.);
+
+  // The first two members are evolved together and the last two members are
+  // evolved one after the other. The members have different absorption
+  // efficiencies.
+  auto database = basic_input_database();
+  database.put("time_stepping.method", "forward_euler");
+  database.put("boundary.type", "convective");
+  auto thermal_members = build_thermal_members<MemorySpaceType>(
+      database, material_property_database, 4);
+  auto &physics = thermal_members.physics;
+  auto &solutions = thermal_members.solutions;
+
+  std::vector<adamantine::ThermalPhysicsInterface<2, MemorySpaceType> *>
+      members = {physics[0].get(), physics[1].get()};
+  std::vector<VectorType *> member_solutions = {&solutions[0], &solutions[1]};
+  std::vector<adamantine::Timer> timers(adamantine::Timing::n_timers);
+  double const time_step = 0.025;
+  double time = 0;
+  while (time < 0.1)
+  {
+    physics[2]->evolve_one_time_step(time, time_step, solutions[2], timers);
+    physics[3]->evolve_one_time_step(time, time_step, solutions[3], timers);
+    time = physics[0]->evolve_ensemble_one_time_step(
+        time, time_step, members, member_solutions, timers);
+  }
+  BOOST_TEST(time == 0.1, tt::tolerance(1e-12));
+
+  // The members are heated differently.
+  BOOST_TEST(solutions[0].l2_norm() > 0.);
+  BOOST_TEST(solutions[1].l2_norm() > solutions[0].l2_norm());
+  // The batched operator gives the same result as the operators of the
+  // members.
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    solutions[i] -= solutions[i + 2];
+    BOOST_TEST(solutions[i].l2_norm() <= 1e-12 * solutions[i + 2].l2_norm());
+  }
+}
+
+template <typename MemorySpaceType>
+void shared_discretization()
+{
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  using Members = ThermalMembers<MemorySpaceType>;
+  using VectorType = typename Members::VectorType;
+
+  auto material_property_database = basic_material_properies_database();
+
+  // The first two members share the mesh and the discretization. The last
+  // two members have their own mesh. The members have different absorption
+  // efficiencies.
+  unsigned int const n_members = 4;
+  auto database = basic_input_database();
+  database.put("time_stepping.method", "forward_euler");
+  auto thermal_members = build_thermal_members<MemorySpaceType>(
+      database, material_property_database, n_members, true);
+  auto &physics = thermal_members.physics;
+  auto &solutions = thermal_members.solutions;
+  auto const &databases = thermal_members.databases;
+  BOOST_TEST(&physics[1]->get_dof_handler() == &physics[0]->get_dof_handler());
+  BOOST_TEST(&physics[2]->get_dof_handler() != &physics[0]->get_dof_handler());
+
+  std::vector<adamantine::ThermalPhysicsInterface<2, MemorySpaceType> *>
+      members = {physics[0].get(), physics[1].get()};
+  std::vector<VectorType *> member_solutions = {&solutions[0], &solutions[1]};
+  std::vector<adamantine::Timer> timers(adamantine::Timing::n_timers);
+  double const time_step = 0.025;
+  double time = 0;
+  while (time < 0.1)
+  {
+    for (unsigned int i = 0; i < n_members; ++i)
+      physics[i]->evolve_one_time_step(time, time_step, solutions[i], timers);
+    time += time_step;
+  }
+
+  // The members sharing the discretization give the same result as the
+  // members with their own mesh.
+  BOOST_TEST(solutions[1].l2_norm() > solutions[0].l2_norm());
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    VectorType difference(solutions[i]);
+    difference -= solutions[i + 2];
+    BOOST_TEST(difference.l2_norm() <= 1e-12 * solutions[i + 2].l2_norm());
+  }
+
+  // Save the members sharing the mesh in a single checkpoint and restart
+  // from it.
+  std::string const filename = "shared_discretization_checkpoint";
+  physics[0]->save_ensemble_checkpoint(filename, members, member_solutions);
+
+  boost::optional<boost::property_tree::ptree const &> units_optional_database;
+  adamantine::Geometry<2> restart_geometry(communicator,
+                                           multi_cell_geometry_database(),
+                                           units_optional_database);
+  std::vector<std::unique_ptr<typename Members::MaterialPropertyType>>
+      restart_material_properties;
+  std::vector<std::unique_ptr<typename Members::ThermalPhysicsType>>
+      restart_physics;
+  std::vector<VectorType> restart_solutions(2);
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    restart_material_properties.push_back(
+        std::make_unique<typename Members::MaterialPropertyType>(
+            communicator, restart_geometry.get_triangulation(),
+            material_property_database));
+    restart_physics.push_back(
+        std::make_unique<typename Members::ThermalPhysicsType>(
+            communicator, databases[i], restart_geometry,
+            *restart_material_properties.back()));
+    if (i == 1)
+      restart_physics[1]->share_discretization(*restart_physics[0]);
+  }
+  restart_physics[0]->load_ensemble_checkpoint(
+      filename, {restart_physics[0].get(), restart_physics[1].get()},
+      {&restart_solutions[0], &restart_solutions[1]});
+
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    restart_solutions[i] -= solutions[i];
+    BOOST_TEST(restart_solutions[i].l2_norm() == 0.);
+  }
+
+  std::filesystem::remove(filename);
+  std::filesystem::remove(filename + ".info");
+  std::filesystem::remove(filename + "_fixed.data");
+  std::filesystem::remove(filename + "_variable.data");
+}
@@ -7,6 +7,7 @@
 #include <Timer.hh>
 
 #include <chrono>
+#include <cmath>
 #include <fstream>
 #include <thread>
 
@@ -20,8 +21,7 @@ BOOST_AUTO_TEST_CASE(test_timer)
   timer.start();
   std::this_thread::sleep_for(std::chrono::milliseconds(200));
   timer.stop();
-  boost::chrono::process_cpu_clock::duration duration =
-      timer.get_elapsed_time();
+  boost::chrono::steady_clock::duration duration = timer.get_elapsed_time();
   boost::chrono::milliseconds ms =
       boost::chrono::duration_cast<boost::chrono::milliseconds>(duration);
   BOOST_TEST(std::abs(ms.count() - 200) < tolerance);
@@ -41,3 +41,46 @@ BOOST_AUTO_TEST_CASE(test_timer)
   ms = boost::chrono::duration_cast<boost::chrono::milliseconds>(duration);
   BOOST_TEST(std::abs(ms.count() - 200) < tolerance);
 }
+
+BOOST_AUTO_TEST_CASE(test_timer_disabled)
+{
+  adamantine::Timer timer(MPI_COMM_WORLD, "test");
+  timer.set_enabled(false);
+
+  timer.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  timer.stop();
+  BOOST_TEST(timer.get_elapsed_time().count() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_statistics)
+{
+  std::vector<adamantine::Timer> timers;
+  timers.push_back(adamantine::Timer(MPI_COMM_WORLD, "parent"));
+  timers.push_back(adamantine::Timer(MPI_COMM_WORLD, "child", 0));
+
+  timers[0].start();
+  timers[1].start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  timers[1].stop();
+  timers[0].stop();
+
+  auto const statistics = timers[1].compute_statistics();
+  BOOST_TEST(statistics.min <= statistics.mean);
+  BOOST_TEST(statistics.mean <= statistics.max);
+  BOOST_TEST(std::abs(statistics.max - 0.1) < 0.015);
+
+  adamantine::write_timers(timers, "timers.csv");
+  int rank = -1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0)
+  {
+    std::ifstream file("timers.csv");
+    std::string line;
+    std::getline(file, line);
+    BOOST_TEST(line == "section,min,mean,max,imbalance");
+    std::getline(file, line);
+    std::getline(file, line);
+    BOOST_TEST(line.substr(0, 15) == "\"parent/child\",");
+  }
+}